@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+// Heap allocations (operator new, any thread) since process start. Counted by the replacement
+// operator new in alloc_counter.cpp, which every benchmark binary links.
+uint64_t allocation_count();
+
+// Reports the allocations made while a benchmark loop runs as the "allocs/iter" counter:
+//
+//   AllocScope allocs(state);
+//   for (auto _ : state) ...
+class AllocScope
+{
+public:
+    explicit AllocScope(benchmark::State &state) : state_(state), start_(allocation_count()) {}
+    ~AllocScope()
+    {
+        state_.counters["allocs/iter"] = benchmark::Counter(static_cast<double>(allocation_count() - start_),
+                                                            benchmark::Counter::kAvgIterations);
+    }
+
+    AllocScope(const AllocScope &) = delete;
+    AllocScope &operator=(const AllocScope &) = delete;
+
+private:
+    benchmark::State &state_;
+    uint64_t start_;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Bybit v5 public messages shaped like the live linear stream, shared by the feed benchmarks.
+
+namespace bench
+{
+    inline std::string levels(double base, double step, int n)
+    {
+        std::string s = "[";
+        char buf[64];
+        for (int i = 0; i < n; ++i)
+        {
+            std::snprintf(buf, sizeof(buf), "%s[\"%.2f\",\"%.3f\"]", i ? "," : "", base + step * i, 0.001 * (i % 17 + 1));
+            s += buf;
+        }
+        return s + "]";
+    }
+
+    inline std::string book_message(const char *type, int depth, uint64_t u)
+    {
+        return std::string(R"({"topic":"orderbook.200.BTCUSDT","type":")") + type + R"(","ts":1672304484978,"data":{"s":"BTCUSDT","b":)" +
+               levels(65000.0, -0.1, depth) + R"(,"a":)" + levels(65000.1, 0.1, depth) + R"(,"u":)" + std::to_string(u) +
+               R"(,"seq":7961638724},"cts":1672304484976})";
+    }
+
+    inline const std::string kTicker =
+        R"({"topic":"tickers.BTCUSDT","type":"snapshot","data":{"symbol":"BTCUSDT","tickDirection":"PlusTick",)"
+        R"("price24hPcnt":"0.017103","lastPrice":"65000.10","prevPrice24h":"63906.00","highPrice24h":"65200.00",)"
+        R"("lowPrice24h":"63800.00","prevPrice1h":"64900.00","markPrice":"65000.51","indexPrice":"65010.02",)"
+        R"("openInterest":"52000.541","openInterestValue":"3380035165.00","turnover24h":"9620014520.1823",)"
+        R"("volume24h":"148000.3000","nextFundingTime":"1673280000000","fundingRate":"0.0001","bid1Price":"65000.00",)"
+        R"("bid1Size":"1.334","ask1Price":"65000.10","ask1Size":"0.958"},"cs":24987956059,"ts":1673272861686})";
+} // namespace bench
@@ -0,0 +1,91 @@
+// MarketDataFeed per-message cost on the WS thread: parse, merge into the book / ticker, publish
+// through the seqlock and bump the update sequence. ingest() is the code path handle_message() runs
+// after stamping the receive time.
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "bench_payloads.hpp"
+#include "market_data_feed.hpp"
+
+namespace
+{
+    constexpr int kBurst = 1024;
+
+    std::string delta_message(uint64_t u)
+    {
+        // One bid and one ask level near the top change per message, like a quiet linear book.
+        const int k = static_cast<int>(u % 8);
+        char bid[64];
+        char ask[64];
+        std::snprintf(bid, sizeof(bid), "[[\"%.2f\",\"%.3f\"]]", 65000.0 - 0.1 * k, 0.001 * (u % 13 + 1));
+        std::snprintf(ask, sizeof(ask), "[[\"%.2f\",\"%.3f\"]]", 65000.1 + 0.1 * k, 0.001 * (u % 11 + 1));
+        return std::string(R"({"topic":"orderbook.200.BTCUSDT","type":"delta","ts":1672304484978,"data":{"s":"BTCUSDT","b":)") +
+               bid + R"(,"a":)" + ask + R"(,"u":)" + std::to_string(u) + R"(,"seq":7961638724},"cts":1672304484976})";
+    }
+
+    void BM_FeedBookSnapshot(benchmark::State &state)
+    {
+        MarketDataFeed feed("");
+        feed.prepare({"BTCUSDT"}, 200);
+        const auto msg = bench::book_message("snapshot", static_cast<int>(state.range(0)), 1);
+        int64_t t = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+            feed.ingest(msg, ++t);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * msg.size()));
+    }
+
+    // Bursts of kBurst messages: a 50-level snapshot followed by consecutive deltas.
+    void BM_FeedBookDelta(benchmark::State &state)
+    {
+        MarketDataFeed feed("");
+        feed.prepare({"BTCUSDT"}, 200);
+        std::vector<std::string> msgs;
+        msgs.push_back(bench::book_message("snapshot", 50, 1));
+        for (uint64_t u = 2; u <= kBurst; ++u)
+            msgs.push_back(delta_message(u));
+        std::size_t i = 0;
+        int64_t t = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            feed.ingest(msgs[i], ++t);
+            i = i + 1 == msgs.size() ? 0 : i + 1;
+        }
+    }
+
+    void BM_FeedTicker(benchmark::State &state)
+    {
+        MarketDataFeed feed("");
+        feed.prepare({"BTCUSDT"}, 200);
+        int64_t t = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+            feed.ingest(bench::kTicker, ++t);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bench::kTicker.size()));
+    }
+
+    // Reader side: what the strategy thread pays per dispatch.
+    void BM_FeedReadBook(benchmark::State &state)
+    {
+        MarketDataFeed feed("");
+        feed.prepare({"BTCUSDT"}, 200);
+        feed.ingest(bench::book_message("snapshot", 200, 1), 1);
+        const std::string symbol = "BTCUSDT";
+        BookSnapshot snap;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            feed.read_book(symbol, snap);
+            benchmark::DoNotOptimize(snap);
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_FeedBookSnapshot)->Arg(50)->Arg(200);
+BENCHMARK(BM_FeedBookDelta);
+BENCHMARK(BM_FeedTicker);
+BENCHMARK(BM_FeedReadBook);
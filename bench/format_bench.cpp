@@ -0,0 +1,97 @@
+// Price/qty to decimal text, as order bodies need it: the ostringstream helper the strategies used
+// before fixed-point prices, the libc/C++17 alternatives, and the fixed-point writer used today.
+#include <benchmark/benchmark.h>
+
+#include <charconv>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "alloc_counter.hpp"
+#include "fixed_point.hpp"
+
+namespace
+{
+    constexpr double kValues[] = {65000.1, 0.001, 1234.5678, 0.30000001, 98765.4, 12.25, 3.0, 0.12345678};
+    constexpr std::size_t kValueCount = sizeof(kValues) / sizeof(kValues[0]);
+
+    // The former strategy helper, kept here as the reference point.
+    std::string to_string_prec(double v)
+    {
+        std::ostringstream oss;
+        oss.setf(std::ios::fixed);
+        oss.precision(8);
+        oss << v;
+        return oss.str();
+    }
+
+    void BM_FormatOstream(benchmark::State &state)
+    {
+        std::size_t i = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            auto s = to_string_prec(kValues[i++ % kValueCount]);
+            benchmark::DoNotOptimize(s.data());
+        }
+    }
+
+    void BM_FormatSnprintf(benchmark::State &state)
+    {
+        char buf[64];
+        std::size_t i = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            std::snprintf(buf, sizeof(buf), "%.8f", kValues[i++ % kValueCount]);
+            benchmark::DoNotOptimize(buf);
+        }
+    }
+
+    void BM_FormatToChars(benchmark::State &state)
+    {
+        char buf[64];
+        std::size_t i = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            auto r = std::to_chars(buf, buf + sizeof(buf), kValues[i++ % kValueCount], std::chars_format::fixed, 8);
+            benchmark::DoNotOptimize(r.ptr);
+        }
+    }
+
+    void BM_FormatFixedWrite(benchmark::State &state)
+    {
+        Price prices[kValueCount];
+        for (std::size_t k = 0; k < kValueCount; ++k)
+            prices[k] = Price::from_double(kValues[k]);
+        char buf[32];
+        std::size_t i = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            char *end = prices[i++ % kValueCount].write(buf);
+            benchmark::DoNotOptimize(end);
+        }
+    }
+
+    void BM_FormatFixedStr(benchmark::State &state)
+    {
+        Price prices[kValueCount];
+        for (std::size_t k = 0; k < kValueCount; ++k)
+            prices[k] = Price::from_double(kValues[k]);
+        std::size_t i = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            auto s = prices[i++ % kValueCount].str();
+            benchmark::DoNotOptimize(s.data());
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_FormatOstream);
+BENCHMARK(BM_FormatSnprintf);
+BENCHMARK(BM_FormatToChars);
+BENCHMARK(BM_FormatFixedWrite);
+BENCHMARK(BM_FormatFixedStr);
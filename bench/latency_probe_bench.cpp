@@ -0,0 +1,35 @@
+// Cost of one latency probe (clock read + histogram record), which the hot path pays per stage.
+#include <benchmark/benchmark.h>
+
+#include "alloc_counter.hpp"
+#include "latency_stats.hpp"
+
+namespace
+{
+    void BM_ClockRead(benchmark::State &state)
+    {
+        AllocScope allocs(state);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(latency_now_ns());
+    }
+    BENCHMARK(BM_ClockRead);
+
+    void BM_Record(benchmark::State &state)
+    {
+        int64_t v = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+            latency_record(LatencyStage::Strategy, (v += 977) & 0xfffff);
+    }
+    BENCHMARK(BM_Record);
+
+    void BM_Probe(benchmark::State &state)
+    {
+        const int64_t start = latency_now_ns();
+        AllocScope allocs(state);
+        for (auto _ : state)
+            latency_record(LatencyStage::Strategy, latency_now_ns() - start);
+    }
+    BENCHMARK(BM_Probe);
+    BENCHMARK(BM_Probe)->Threads(2);
+} // namespace
@@ -0,0 +1,75 @@
+// Caller-side cost of one strategy log line: formatting through an ostream (what on_snapshot used to
+// do, terminal excluded) vs handing raw arguments to the async logger.
+#include <benchmark/benchmark.h>
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include "alloc_counter.hpp"
+#include "async_logger.hpp"
+
+namespace
+{
+    class DiscardBuf : public std::streambuf
+    {
+    protected:
+        int overflow(int c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+    };
+
+    constexpr LogFormat kLogQuote{LogLevel::Info, "MM", LogColor::None,
+                                  "{} mid={} live_spread_bps={} target_spread_bps={} bid@{} ask@{} base_qty={} net={} [{}]"};
+
+    const std::string kSymbol = "BTCUSDT";
+
+    void BM_LogOstream(benchmark::State &state)
+    {
+        DiscardBuf buf;
+        std::ostream out(&buf);
+        double mid = 65000.05;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            out << "[MM] " << kSymbol << " mid=" << mid << " live_spread_bps=" << 0.0153 << " target_spread_bps=" << 1.0
+                << " bid@" << 64993.5 << " ask@" << 65006.5 << " base_qty=" << 0.001 << " net=" << 0.0 << " [live]" << "\n";
+            mid += 0.1;
+        }
+    }
+
+    // Producer side only: every kBurst records the timer is paused while the writer catches up, so
+    // records never hit a full ring (the dropped counter should stay 0).
+    void BM_LogAsync(benchmark::State &state)
+    {
+        constexpr int64_t kBurst = 1024;
+        DiscardBuf buf;
+        std::ostream out(&buf);
+        AsyncLogger::Config cfg;
+        cfg.ring_capacity = 2 * kBurst;
+        auto &logger = AsyncLogger::instance();
+        logger.start(cfg, out);
+        const uint64_t dropped_before = logger.dropped();
+        double mid = 65000.05;
+        int64_t n = 0;
+        {
+            AllocScope allocs(state);
+            for (auto _ : state)
+            {
+                log_event(kLogQuote, kSymbol, mid, 0.0153, 1.0, Price::from_double(64993.5), Price::from_double(65006.5),
+                          Qty::from_double(0.001), 0.0, "live");
+                mid += 0.1;
+                if (++n % kBurst == 0)
+                {
+                    state.PauseTiming();
+                    logger.flush();
+                    state.ResumeTiming();
+                }
+            }
+        }
+        logger.stop();
+        state.counters["dropped"] = benchmark::Counter(static_cast<double>(logger.dropped() - dropped_before));
+    }
+} // namespace
+
+BENCHMARK(BM_LogOstream);
+BENCHMARK(BM_LogAsync);
@@ -0,0 +1,55 @@
+// PnlTracker under a long session: execution updates and the totals() read done after every
+// execution, with 1e3 to 1e5 distinct orderLinkIds seen so far. 1e3 links fit the default per-order
+// window (4096); 1e5 links evict an order into its bucket on every call.
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "pnl_tracker.hpp"
+
+namespace
+{
+    std::vector<std::string> make_links(std::size_t n)
+    {
+        std::vector<std::string> links;
+        links.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            links.push_back((i % 2 ? "ask1_mm_1700000000000_" : "bid1_mm_1700000000000_") + std::to_string(i + 1));
+        return links;
+    }
+
+    // Steady state: each execution hits an order the tracker may or may not still hold.
+    void BM_PnlAddExecution(benchmark::State &state)
+    {
+        const auto links = make_links(static_cast<std::size_t>(state.range(0)));
+        const SymbolId btc = SymbolTable::global().intern("BTCUSDT");
+        PnlTracker pnl;
+        std::size_t i = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            pnl.add_execution(links[i], 0.01, 0.0002, btc);
+            i = i + 1 == links.size() ? 0 : i + 1;
+        }
+    }
+
+    void BM_PnlTotals(benchmark::State &state)
+    {
+        const auto links = make_links(static_cast<std::size_t>(state.range(0)));
+        PnlTracker pnl;
+        for (const auto &l : links)
+            pnl.add_execution(l, 0.01, 0.0002);
+        pnl.set_unrealized(SymbolTable::global().intern("BTCUSDT"), 1, 1.5);
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            auto t = pnl.totals();
+            benchmark::DoNotOptimize(t);
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_PnlAddExecution)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_PnlTotals)->Arg(1000)->Arg(100000);
@@ -0,0 +1,91 @@
+// RiskEngine cost per order with every check enabled: a new limit order and an amend of a working
+// one, on the fourth of four registered symbols (the worst case of the linear symbol lookup).
+#include <benchmark/benchmark.h>
+
+#include "alloc_counter.hpp"
+#include "risk_engine.hpp"
+
+namespace
+{
+    RiskEngine::Config config()
+    {
+        RiskEngine::Config cfg;
+        cfg.limits.max_order_notional = 100000.0;
+        cfg.limits.max_working_notional = 1e9;
+        cfg.limits.max_position_notional = 1e9;
+        cfg.limits.price_band_bps = 500.0;
+        cfg.limits.fat_finger_bps = 50.0;
+        cfg.max_msgs_per_sec = 1e9; // bucket always has credit; the refill arithmetic still runs
+        return cfg;
+    }
+
+    OrderRequest order()
+    {
+        OrderRequest r;
+        r.symbol.assign("SOLUSDT");
+        r.order_link_id.assign("bid1_mm_1700000000000_1");
+        r.side = OrderSide::Buy;
+        r.price = Price::from_double(149.9);
+        r.qty = Qty::from_double(1.0);
+        return r;
+    }
+
+    void setup(RiskEngine &risk)
+    {
+        for (const char *s : {"BTCUSDT", "ETHUSDT", "XRPUSDT", "SOLUSDT"})
+            risk.set_mid(risk.add_symbol(s), Price::from_double(150.0));
+        risk.set_position("SOLUSDT", Qty::from_double(2.0));
+    }
+
+    void BM_RiskCheckNew(benchmark::State &state)
+    {
+        RiskEngine risk(config());
+        setup(risk);
+        const OrderRequest req = order();
+        int64_t now = 1;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            auto c = risk.check_new(req, now += 1000);
+            benchmark::DoNotOptimize(c);
+        }
+    }
+
+    void BM_RiskCheckAmend(benchmark::State &state)
+    {
+        RiskEngine risk(config());
+        setup(risk);
+        OrderRecord current;
+        current.state = OrderState::New;
+        current.is_buy = true;
+        current.price = 149.8;
+        current.qty = 1.0;
+        const OrderRequest req = order();
+        int64_t now = 1;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            auto c = risk.check_amend(req, current, now += 1000);
+            benchmark::DoNotOptimize(c);
+        }
+    }
+
+    // The per-snapshot cost of re-deriving bands and caps.
+    void BM_RiskSetMid(benchmark::State &state)
+    {
+        RiskEngine risk(config());
+        setup(risk);
+        const int sol = risk.symbol_index("SOLUSDT");
+        int64_t raw = Price::from_double(150.0).raw;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            risk.set_mid(sol, Price::from_raw(raw ^= 1));
+            benchmark::ClobberMemory();
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_RiskCheckNew);
+BENCHMARK(BM_RiskCheckAmend);
+BENCHMARK(BM_RiskSetMid);
@@ -0,0 +1,168 @@
+// Strategy thread cost per snapshot: ExampleMarketMakerStrategy::on_snapshot against a trade transport
+// that acks everything instantly, so the numbers cover quoting logic, the QuoteManager diff, batch
+// encoding and ack bookkeeping but no I/O. Also compares the two batch body encoders.
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "order_request.hpp"
+#include "strategy.hpp"
+#include "trade_transport.hpp"
+#include "trading_helper.hpp"
+
+namespace
+{
+    class AckAllTransport : public ITradeTransport
+    {
+    public:
+        bool ready() const override { return true; }
+        std::string request(const std::string &, const std::string &) override
+        {
+            return R"({"retCode":0,"retMsg":"OK","result":{"list":[]},"retExtInfo":{"list":[]}})";
+        }
+        bool supports_cancel_all() const override { return true; }
+    };
+
+    // on_snapshot logs every tick; the formatting stays in the measurement, the terminal does not.
+    class DiscardBuf : public std::streambuf
+    {
+    protected:
+        int overflow(int c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+    };
+
+    class CoutSilencer
+    {
+    public:
+        CoutSilencer() : saved_(std::cout.rdbuf(&sink_)) {}
+        ~CoutSilencer() { std::cout.rdbuf(saved_); }
+
+    private:
+        DiscardBuf sink_;
+        std::streambuf *saved_;
+    };
+
+    MarketDataSnapshot make_snapshot(double mid)
+    {
+        MarketDataSnapshot snap;
+        snap.symbol = "BTCUSDT";
+        auto &book = snap.book;
+        book.bid_count = 5;
+        book.ask_count = 5;
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            book.bids[i] = {Price::from_double(mid - 0.05 - 0.1 * i), Qty::from_double(0.5)};
+            book.asks[i] = {Price::from_double(mid + 0.05 + 0.1 * i), Qty::from_double(0.5)};
+        }
+        return snap;
+    }
+
+    struct StrategyFixture
+    {
+        TradingHelper helper{"key", "secret", "linear", "http://127.0.0.1:9"};
+        ExampleMarketMakerStrategy strategy{"BTCUSDT",
+                                            InstrumentMeta{Price::from_double(0.1), Qty::from_double(0.001), Qty::from_double(0.001)},
+                                            1000.0, 1.0, 1.0, 1, 2, 50.0, 0.5, 3};
+        PositionView pos;
+
+        StrategyFixture()
+        {
+            helper.set_trade_transport(std::make_unique<AckAllTransport>());
+            // Iterations run far above the 10 orders/s limit; measure the requote, not its refusal.
+            RateLimiter::Config unlimited;
+            unlimited.enabled = false;
+            helper.set_rate_limiter(std::make_shared<RateLimiter>(unlimited));
+        }
+    };
+
+    // Unchanged book: the ladder matches the working orders, so no order traffic.
+    void BM_StrategySteady(benchmark::State &state)
+    {
+        CoutSilencer quiet;
+        StrategyFixture f;
+        const auto snap = make_snapshot(65000.0);
+        f.strategy.on_snapshot(snap, f.helper, true, f.pos);
+        AllocScope allocs(state);
+        for (auto _ : state)
+            f.strategy.on_snapshot(snap, f.helper, true, f.pos);
+    }
+
+    // Mid moves 10 ticks every snapshot: every ladder slot is amended.
+    void BM_StrategyRequote(benchmark::State &state)
+    {
+        CoutSilencer quiet;
+        StrategyFixture f;
+        const MarketDataSnapshot snaps[2] = {make_snapshot(65000.0), make_snapshot(65001.0)};
+        f.strategy.on_snapshot(snaps[0], f.helper, true, f.pos);
+        std::size_t i = 0;
+        AllocScope allocs(state);
+        for (auto _ : state)
+            f.strategy.on_snapshot(snaps[++i & 1], f.helper, true, f.pos);
+    }
+
+    std::vector<OrderRequest> make_orders(std::size_t n)
+    {
+        std::vector<OrderRequest> reqs(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto &r = reqs[i];
+            r.symbol.assign("BTCUSDT");
+            format_order_link(r.order_link_id, i % 2 ? "ask1" : "bid1", "mm", 1700000000000, i + 1);
+            r.price = Price::from_double(65000.0 + (i % 2 ? 1.0 : -1.0) * (0.1 * (i / 2 + 1)));
+            r.qty = Qty::from_double(0.001);
+            r.side = i % 2 ? OrderSide::Sell : OrderSide::Buy;
+            r.position_idx = i % 2 ? 2 : 1;
+        }
+        return reqs;
+    }
+
+    // The string-pair + nlohmann path batch orders used before OrderRequest encoding.
+    void BM_EncodeBatchJson(benchmark::State &state)
+    {
+        const auto reqs = make_orders(static_cast<std::size_t>(state.range(0)));
+        std::string body;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            nlohmann::json args;
+            args["category"] = "linear";
+            args["request"] = nlohmann::json::array();
+            for (const auto &r : reqs)
+            {
+                args["request"].push_back(order_fields_json({{"symbol", std::string(r.symbol.view())},
+                                                             {"side", r.is_buy() ? "Buy" : "Sell"},
+                                                             {"orderType", "Limit"},
+                                                             {"qty", r.qty.str()},
+                                                             {"price", r.price.str()},
+                                                             {"positionIdx", std::to_string(r.position_idx)},
+                                                             {"orderLinkId", std::string(r.order_link_id.view())},
+                                                             {"timeInForce", "GTC"}}));
+            }
+            body = args.dump();
+            benchmark::DoNotOptimize(body.data());
+        }
+    }
+
+    void BM_EncodeBatch(benchmark::State &state)
+    {
+        const auto reqs = make_orders(static_cast<std::size_t>(state.range(0)));
+        std::string body;
+        encode_batch(OrderAction::Create, "linear", reqs.data(), reqs.size(), body);
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            encode_batch(OrderAction::Create, "linear", reqs.data(), reqs.size(), body);
+            benchmark::DoNotOptimize(body.data());
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_StrategySteady);
+BENCHMARK(BM_StrategyRequote);
+BENCHMARK(BM_EncodeBatchJson)->Arg(1)->Arg(10);
+BENCHMARK(BM_EncodeBatch)->Arg(1)->Arg(10);
@@ -0,0 +1,150 @@
+// Feed-thread parse cost: nlohmann DOM (fallback path) vs the streaming parser, both applying into
+// an OrderBook / TickerSnapshot the way MarketDataFeed does.
+#include <benchmark/benchmark.h>
+
+#include <charconv>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "alloc_counter.hpp"
+#include "bench_payloads.hpp"
+#include "order_book.hpp"
+#include "ticker_snapshot.hpp"
+#include "ws_message_parser.hpp"
+
+namespace
+{
+    using bench::book_message;
+    using bench::kTicker;
+
+    template <typename T>
+    T dom_fixed(const nlohmann::json &v)
+    {
+        T out;
+        T::parse(v.get_ref<const std::string &>(), out);
+        return out;
+    }
+
+    void apply_dom(const std::string &msg, OrderBook &book)
+    {
+        auto j = nlohmann::json::parse(msg);
+        const auto &data = j["data"];
+        book.begin_update(j.value("type", std::string{}) == "snapshot", data.value("u", uint64_t{0}),
+                          data.value("seq", uint64_t{0}), j.value("ts", int64_t{0}));
+        for (const auto &lvl : data["b"])
+            book.set_bid(dom_fixed<Price>(lvl[0]), dom_fixed<Qty>(lvl[1]));
+        for (const auto &lvl : data["a"])
+            book.set_ask(dom_fixed<Price>(lvl[0]), dom_fixed<Qty>(lvl[1]));
+        book.end_update();
+    }
+
+    void apply_fast(const std::string &msg, OrderBook &book)
+    {
+        PublicMessage m;
+        if (!parse_public_message(msg, m))
+            return;
+        book.begin_update(m.is_snapshot, m.update_id, m.seq, m.ts_ms);
+        for_each_level(m.bids, [&](Price px, Qty qty)
+                       { book.set_bid(px, qty); });
+        for_each_level(m.asks, [&](Price px, Qty qty)
+                       { book.set_ask(px, qty); });
+        book.end_update();
+    }
+
+    void BM_BookSnapshotDom(benchmark::State &state)
+    {
+        const auto msg = book_message("snapshot", static_cast<int>(state.range(0)), 1);
+        OrderBook book(200);
+        AllocScope allocs(state);
+        for (auto _ : state)
+            apply_dom(msg, book);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * msg.size()));
+    }
+
+    void BM_BookSnapshotFast(benchmark::State &state)
+    {
+        const auto msg = book_message("snapshot", static_cast<int>(state.range(0)), 1);
+        OrderBook book(200);
+        AllocScope allocs(state);
+        for (auto _ : state)
+            apply_fast(msg, book);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * msg.size()));
+    }
+
+    // Steady state is a stream of small deltas; a 4-level message approximates one.
+    void BM_BookDeltaDom(benchmark::State &state)
+    {
+        const auto msg = book_message("snapshot", 4, 1);
+        OrderBook book(200);
+        AllocScope allocs(state);
+        for (auto _ : state)
+            apply_dom(msg, book);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * msg.size()));
+    }
+
+    void BM_BookDeltaFast(benchmark::State &state)
+    {
+        const auto msg = book_message("snapshot", 4, 1);
+        OrderBook book(200);
+        AllocScope allocs(state);
+        for (auto _ : state)
+            apply_fast(msg, book);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * msg.size()));
+    }
+
+    void BM_TickerDom(benchmark::State &state)
+    {
+        TickerSnapshot t;
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            auto j = nlohmann::json::parse(kTicker);
+            const auto &d = j["data"];
+            t.last_price = std::stod(d["lastPrice"].get<std::string>());
+            t.mark_price = std::stod(d["markPrice"].get<std::string>());
+            t.bid1_price = std::stod(d["bid1Price"].get<std::string>());
+            t.ask1_price = std::stod(d["ask1Price"].get<std::string>());
+            t.funding_rate = std::stod(d["fundingRate"].get<std::string>());
+            benchmark::DoNotOptimize(t);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kTicker.size()));
+    }
+
+    void BM_TickerFast(benchmark::State &state)
+    {
+        TickerSnapshot t;
+        auto set = [](std::string_view raw, double &out)
+        {
+            raw = ws_scan::unquote(raw);
+            std::from_chars(raw.data(), raw.data() + raw.size(), out);
+        };
+        AllocScope allocs(state);
+        for (auto _ : state)
+        {
+            PublicMessage m;
+            parse_public_message(kTicker, m);
+            for_each_member(m.data, [&](std::string_view key, std::string_view raw)
+                            {
+                if (key == "lastPrice")
+                    set(raw, t.last_price);
+                else if (key == "markPrice")
+                    set(raw, t.mark_price);
+                else if (key == "bid1Price")
+                    set(raw, t.bid1_price);
+                else if (key == "ask1Price")
+                    set(raw, t.ask1_price);
+                else if (key == "fundingRate")
+                    set(raw, t.funding_rate); });
+            benchmark::DoNotOptimize(t);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kTicker.size()));
+    }
+} // namespace
+
+BENCHMARK(BM_BookSnapshotDom)->Arg(50)->Arg(200);
+BENCHMARK(BM_BookSnapshotFast)->Arg(50)->Arg(200);
+BENCHMARK(BM_BookDeltaDom);
+BENCHMARK(BM_BookDeltaFast);
+BENCHMARK(BM_TickerDom);
+BENCHMARK(BM_TickerFast);
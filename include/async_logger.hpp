@@ -0,0 +1,266 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "fixed_point.hpp"
+#include "latency_stats.hpp"
+#include "order_request.hpp"
+#include "spsc_queue.hpp"
+
+enum class LogLevel : uint8_t
+{
+    Info,
+    Warn,
+    Error,
+};
+
+enum class LogColor : uint8_t
+{
+    None,
+    Green,
+    Yellow,
+    Magenta,
+    Cyan,
+    Red,
+};
+
+// One log statement, defined once as a static constant next to its call site. Records carry a pointer
+// to it rather than text, so the logging thread never formats; each "{}" in `text` is replaced by the
+// next argument when the writer thread renders the record.
+struct LogFormat
+{
+    LogLevel level;
+    const char *tag; // rendered as "[tag] "; empty for none
+    LogColor color;  // tag color when colors are enabled
+    const char *text;
+};
+
+// A double rendered green/red by sign when colors are enabled (PnL figures).
+struct LogSigned
+{
+    double value;
+};
+
+constexpr std::size_t kMaxLogArgs = 12;
+constexpr std::size_t kLogTextBytes = 192;
+
+struct LogArg
+{
+    enum class Kind : uint8_t
+    {
+        Int,
+        Uint,
+        Double,
+        Signed,
+        Fixed,
+        Str,
+    };
+    Kind kind;
+    uint8_t len;     // Str: length in the record's text pool
+    uint16_t offset; // Str: start in the record's text pool
+    union
+    {
+        int64_t i;
+        uint64_t u;
+        double d;
+    };
+};
+
+// Format pointer, timestamp and raw arguments. Strings are copied into the inline pool (truncated
+// when it runs out). Trivial on purpose: log calls encode straight into a ring slot and only the
+// fields encode_log() sets are ever read.
+struct LogRecord
+{
+    const LogFormat *format;
+    int64_t ts_ns; // steady clock, as latency_now_ns()
+    uint8_t argc;
+    uint16_t text_len;
+    LogArg args[kMaxLogArgs];
+    char text[kLogTextBytes];
+};
+
+namespace log_detail
+{
+    inline LogArg *next_arg(LogRecord &rec)
+    {
+        return rec.argc < kMaxLogArgs ? &rec.args[rec.argc++] : nullptr;
+    }
+
+    inline void put(LogRecord &rec, std::string_view s)
+    {
+        if (LogArg *a = next_arg(rec))
+        {
+            const std::size_t room = kLogTextBytes - rec.text_len;
+            const std::size_t n = s.size() < room ? (s.size() < 255 ? s.size() : 255) : room;
+            std::memcpy(rec.text + rec.text_len, s.data(), n);
+            a->kind = LogArg::Kind::Str;
+            a->offset = rec.text_len;
+            a->len = static_cast<uint8_t>(n);
+            rec.text_len = static_cast<uint16_t>(rec.text_len + n);
+        }
+    }
+    inline void put(LogRecord &rec, const std::string &s) { put(rec, std::string_view(s)); }
+    inline void put(LogRecord &rec, const char *s) { put(rec, std::string_view(s)); }
+    template <std::size_t N>
+    inline void put(LogRecord &rec, const FixedString<N> &s) { put(rec, s.view()); }
+    inline void put(LogRecord &rec, bool b) { put(rec, std::string_view(b ? "true" : "false")); }
+    inline void put(LogRecord &rec, LogSigned v)
+    {
+        if (LogArg *a = next_arg(rec))
+        {
+            a->kind = LogArg::Kind::Signed;
+            a->d = v.value;
+        }
+    }
+    template <typename Tag>
+    inline void put(LogRecord &rec, Fixed<Tag> v)
+    {
+        if (LogArg *a = next_arg(rec))
+        {
+            a->kind = LogArg::Kind::Fixed;
+            a->i = v.raw;
+        }
+    }
+    template <typename T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    inline void put(LogRecord &rec, T v)
+    {
+        LogArg *a = next_arg(rec);
+        if (!a)
+            return;
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            a->kind = LogArg::Kind::Double;
+            a->d = static_cast<double>(v);
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            a->kind = LogArg::Kind::Int;
+            a->i = static_cast<int64_t>(v);
+        }
+        else
+        {
+            a->kind = LogArg::Kind::Uint;
+            a->u = static_cast<uint64_t>(v);
+        }
+    }
+} // namespace log_detail
+
+template <typename... Args>
+inline void encode_log(LogRecord &rec, const LogFormat &fmt, int64_t ts_ns, const Args &...args)
+{
+    rec.format = &fmt;
+    rec.ts_ns = ts_ns;
+    rec.argc = 0;
+    rec.text_len = 0;
+    (log_detail::put(rec, args), ...);
+}
+
+// Process-wide asynchronous logger. Each producing thread gets its own SPSC ring on first use; a
+// log call stores the format pointer and raw arguments there (no formatting, no locks, no syscalls)
+// and a background thread renders, timestamps and writes the records. A full ring drops the record
+// and counts it rather than block the caller.
+//
+// Until start() is called (backtests, sweeps, tests) records are rendered synchronously to
+// std::cout / std::cerr without colors, so redirecting those streams keeps working.
+class AsyncLogger
+{
+public:
+    struct Config
+    {
+        bool color{true};                // ANSI colors on tags and signed values (text mode only)
+        bool json{false};                // one JSON object per line instead of text
+        std::string path;                // empty: info to stdout, warnings/errors to stderr
+        std::size_t ring_capacity{2048}; // records per producer thread
+        std::chrono::microseconds idle_sleep{500};
+    };
+
+    static AsyncLogger &instance();
+
+    // Throws std::runtime_error if cfg.path cannot be opened.
+    void start(const Config &cfg);
+    // Writes every level to `out` (tests, benchmarks).
+    void start(const Config &cfg, std::ostream &out);
+    // Drains every ring, flushes and joins the writer. Safe to call when not running.
+    void stop();
+    // Blocks until everything logged so far (by any thread) has been written.
+    void flush();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    template <typename... Args>
+    void log(const LogFormat &fmt, const Args &...args)
+    {
+        if (!running())
+        {
+            LogRecord rec;
+            encode_log(rec, fmt, latency_now_ns(), args...);
+            write_sync(rec);
+            return;
+        }
+        Ring *ring = tl_ring_ ? tl_ring_ : register_thread();
+        if (LogRecord *slot = ring->try_claim())
+        {
+            encode_log(*slot, fmt, latency_now_ns(), args...);
+            ring->publish();
+        }
+        else
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Renders one record (without the trailing newline) the way the writer thread does.
+    // wall_offset_ns converts the steady-clock timestamp to Unix time.
+    static void render(const LogRecord &rec, const Config &cfg, int64_t wall_offset_ns, std::string &out);
+
+    ~AsyncLogger();
+
+private:
+    using Ring = SpscQueue<LogRecord>;
+
+    AsyncLogger() = default;
+    void launch(const Config &cfg, std::ostream &out, std::ostream &err);
+    void write_sync(const LogRecord &rec);
+    Ring *register_thread();
+    void run();
+    bool drain();
+
+    Config cfg_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> dropped_{0};
+    int64_t wall_offset_ns_{0};
+
+    std::mutex drain_mu_; // held by the writer for a whole pass
+    std::mutex rings_mu_;
+    std::vector<std::unique_ptr<Ring>> rings_; // one per producer thread, kept for the process lifetime
+    inline static thread_local Ring *tl_ring_ = nullptr;
+
+    std::ofstream file_;
+    std::ostream *out_{nullptr};
+    std::ostream *err_{nullptr};
+    std::vector<LogRecord> batch_;
+    std::string out_buf_;
+    std::string err_buf_;
+    std::thread writer_;
+};
+
+template <typename... Args>
+inline void log_event(const LogFormat &fmt, const Args &...args)
+{
+    AsyncLogger::instance().log(fmt, args...);
+}
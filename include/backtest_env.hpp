@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "backtester.hpp"
+#include "env_config.hpp"
+
+// Command-line plumbing shared by market_maker_backtest and market_maker_sweep.
+
+// Directories expand to their *.bmd files; names sort chronologically (<prefix>-YYYYMMDD-HH.bmd,
+// then the hour's later sessions as <prefix>-YYYYMMDD-HH_NN.bmd).
+inline std::vector<std::string> expand_recordings(int argc, char **argv, int first)
+{
+    std::vector<std::string> files;
+    for (int i = first; i < argc; ++i)
+    {
+        const std::filesystem::path p(argv[i]);
+        if (!std::filesystem::is_directory(p))
+        {
+            files.push_back(p.string());
+            continue;
+        }
+        std::vector<std::string> dir_files;
+        for (const auto &entry : std::filesystem::directory_iterator(p))
+            if (entry.is_regular_file() && entry.path().extension() == ".bmd")
+                dir_files.push_back(entry.path().string());
+        std::sort(dir_files.begin(), dir_files.end());
+        files.insert(files.end(), dir_files.begin(), dir_files.end());
+    }
+    if (files.empty())
+        throw std::runtime_error("no recordings found");
+    return files;
+}
+
+template <typename T>
+T required_step(const char *name)
+{
+    T out;
+    if (!T::parse(get_env(name), out) || out.raw <= 0)
+        throw std::runtime_error(std::string("set ") + name + " to the instrument's step (e.g. 0.0001)");
+    return out;
+}
+
+// Instrument, simulator and replay settings from BYBIT_BT_* (and BYBIT_BOOK_DEPTH). The requote
+// throttle comes with the strategy params (StrategyParams::min_requote_ms).
+inline Backtester::Config backtest_config_from_env(std::string symbol, std::vector<std::string> files)
+{
+    Backtester::Config cfg;
+    cfg.symbol = std::move(symbol);
+    cfg.files = std::move(files);
+    cfg.sim.meta.tick_size = required_step<Price>("BYBIT_BT_TICK_SIZE");
+    cfg.sim.meta.lot_size = required_step<Qty>("BYBIT_BT_LOT_SIZE");
+    cfg.sim.meta.min_qty = required_step<Qty>("BYBIT_BT_MIN_QTY");
+    cfg.sim.ack_latency_ns = static_cast<int64_t>(std::stod(get_env("BYBIT_BT_ACK_LATENCY_MS", "5")) * 1e6);
+    cfg.sim.cancel_latency_ns = static_cast<int64_t>(std::stod(get_env("BYBIT_BT_CANCEL_LATENCY_MS", "5")) * 1e6);
+    cfg.sim.maker_fee_bps = std::stod(get_env("BYBIT_BT_MAKER_FEE_BPS", "2.0"));
+    cfg.sim.taker_fee_bps = std::stod(get_env("BYBIT_BT_TAKER_FEE_BPS", "5.5"));
+    cfg.out_dir = get_env("BYBIT_BT_OUT_DIR", "backtest_out");
+    cfg.book_depth = std::stoi(get_env("BYBIT_BOOK_DEPTH", "50"));
+    cfg.sample_interval_ns = std::max<int64_t>(1, std::stoll(get_env("BYBIT_BT_SAMPLE_MS", "1000"))) * 1000000;
+    // Same drift guard as the live loop.
+    cfg.urgent_mid_move = 2.0 * cfg.sim.meta.tick_size.to_double();
+    return cfg;
+}
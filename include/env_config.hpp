@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// BYBIT_* settings come from the environment, optionally seeded from a .env file.
+
+inline std::string get_env(const char *name, const std::string &fallback = "")
+{
+    const char *v = std::getenv(name);
+    return v ? std::string{v} : fallback;
+}
+
+// Sets KEY=VALUE lines from path (# comments allowed) for keys not already in the environment.
+// Comma-separated list ("BTCUSDT, ETHUSDT"), trimmed, empty items dropped.
+inline std::vector<std::string> split_list(const std::string &value)
+{
+    std::vector<std::string> out;
+    std::size_t start = 0;
+    while (start <= value.size())
+    {
+        std::size_t end = value.find(',', start);
+        if (end == std::string::npos)
+            end = value.size();
+        const auto first = value.find_first_not_of(" \t", start);
+        if (first != std::string::npos && first < end)
+        {
+            const auto last = value.find_last_not_of(" \t", end - 1);
+            out.push_back(value.substr(first, last - first + 1));
+        }
+        start = end + 1;
+    }
+    return out;
+}
+
+inline void load_env_file(const std::string &path)
+{
+    std::ifstream infile(path);
+    if (!infile.is_open())
+        return;
+    std::string line;
+    while (std::getline(infile, line))
+    {
+        // Trim leading/trailing spaces.
+        auto trim = [](std::string &s)
+        {
+            const char *ws = " \t\r\n";
+            auto start = s.find_first_not_of(ws);
+            auto end = s.find_last_not_of(ws);
+            if (start == std::string::npos)
+            {
+                s.clear();
+                return;
+            }
+            s = s.substr(start, end - start + 1);
+        };
+        trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+        auto eq = line.find('=');
+        if (eq == std::string::npos || eq == 0)
+            continue;
+        std::string key = line.substr(0, eq);
+        std::string val = line.substr(eq + 1);
+        trim(key);
+        trim(val);
+        if (key.empty())
+            continue;
+        // Only set if not already set in environment.
+        if (std::getenv(key.c_str()) == nullptr)
+        {
+#ifdef _WIN32
+            _putenv_s(key.c_str(), val.c_str());
+#else
+            setenv(key.c_str(), val.c_str(), 0);
+#endif
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "order_book.hpp"
+#include "ticker_snapshot.hpp"
+
+// On-disk format written by FeedRecorder. A file is a FileHeader followed by records; each record is
+// a RecordHeader plus `size` payload bytes. Raw WS messages are stored verbatim and, for public
+// messages the recorder understands, followed by a normalized record carrying the same data in
+// typed form. All integers are host-endian (x86-64 / aarch64 little-endian).
+
+constexpr char kRecordMagic[4] = {'B', 'M', 'D', 'R'};
+constexpr uint32_t kRecordVersion = 1;
+
+enum class RecordType : uint16_t
+{
+    RawPublic = 1,  // public WS message text
+    RawPrivate = 2, // private WS message text
+    BookUpdate = 3, // BookUpdateRecord + (bid_count + ask_count) LevelRecord
+    Ticker = 4,     // TickerRecord (merged state after the message)
+    Trades = 5,     // TradesRecord + count TradeRecord
+};
+
+struct FileHeader
+{
+    char magic[4];
+    uint32_t version;
+    // Clock anchor taken when the file was opened: maps record recv_ns (steady_clock) to wall time.
+    int64_t wall_ns;
+    int64_t steady_ns;
+};
+
+struct RecordHeader
+{
+    uint32_t size; // payload bytes following this header
+    RecordType type;
+    uint16_t reserved;
+    int64_t recv_ns; // local steady_clock receive time
+};
+
+using RecordSymbol = char[24];
+
+struct BookUpdateRecord
+{
+    RecordSymbol symbol;
+    uint64_t update_id;
+    uint64_t seq;
+    int64_t ts_ms;
+    uint32_t bid_count;
+    uint32_t ask_count;
+    uint8_t is_snapshot;
+    uint8_t pad[7];
+};
+
+struct LevelRecord
+{
+    int64_t price_raw; // Price::raw
+    int64_t qty_raw;   // Qty::raw; 0 removes the level
+};
+
+struct TickerRecord
+{
+    RecordSymbol symbol;
+    TickerSnapshot ticker;
+};
+
+struct TradesRecord
+{
+    RecordSymbol symbol;
+    uint32_t count;
+    uint32_t pad;
+};
+
+struct TradeRecord
+{
+    int64_t ts_ms;
+    int64_t price_raw;
+    int64_t qty_raw;
+    uint8_t is_buy;
+    uint8_t pad[7];
+};
+
+// One record as seen by a reader; payload points into the mapped file.
+struct RecordView
+{
+    RecordHeader header{};
+    std::string_view payload;
+
+    // Typed accessors; the caller must check header.type first.
+    const BookUpdateRecord &book() const { return *reinterpret_cast<const BookUpdateRecord *>(payload.data()); }
+    const LevelRecord *levels() const { return reinterpret_cast<const LevelRecord *>(payload.data() + sizeof(BookUpdateRecord)); }
+    const TickerRecord &ticker() const { return *reinterpret_cast<const TickerRecord *>(payload.data()); }
+    const TradesRecord &trades() const { return *reinterpret_cast<const TradesRecord *>(payload.data()); }
+    const TradeRecord *trade_list() const { return reinterpret_cast<const TradeRecord *>(payload.data() + sizeof(TradesRecord)); }
+};
+
+// Sequential reader over one recorded file, memory-mapped read-only. A truncated tail (recorder
+// killed mid-write) simply ends iteration. The const next() overload walks an external cursor, so
+// several threads can replay one mapping at once.
+class RecordFileReader
+{
+public:
+    RecordFileReader() = default;
+    ~RecordFileReader();
+    RecordFileReader(const RecordFileReader &) = delete;
+    RecordFileReader &operator=(const RecordFileReader &) = delete;
+
+    // Throws std::runtime_error if the file cannot be mapped or is not a recorder file.
+    void open(const std::string &path);
+    void close();
+    // For a mapping replayed by several readers at once: drops the sequential hint (which lets the
+    // kernel evict pages one reader has passed while another still needs them) and reads ahead.
+    void share();
+
+    const FileHeader &file_header() const { return *reinterpret_cast<const FileHeader *>(base_); }
+    // Next record, false at end of file.
+    bool next(RecordView &out) { return next(pos_, out); }
+    void rewind() { pos_ = begin(); }
+    // Cursor form: start with pos = begin().
+    std::size_t begin() const { return sizeof(FileHeader); }
+    bool next(std::size_t &pos, RecordView &out) const;
+
+private:
+    const char *base_{nullptr};
+    std::size_t size_{0};
+    std::size_t pos_{0};
+};
+
+// Copies symbol into a fixed record field (truncating, always NUL-terminated).
+void set_record_symbol(RecordSymbol &out, std::string_view symbol);
+inline std::string_view record_symbol(const RecordSymbol &s) { return std::string_view(s); }
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "feed_record.hpp"
+
+// Appends every WS message it is handed to hourly files under a directory (see feed_record.hpp for
+// the format). Producers (feed and private WS threads) only copy the message into a byte ring under
+// a short spinlock; a background thread drains the ring, adds normalized book/ticker/trade records
+// and writes in large chunks. If the ring is full the message is dropped and counted, never blocking
+// the feed.
+class FeedRecorder
+{
+public:
+    struct Config
+    {
+        std::string dir;
+        std::string prefix{"md"};
+        std::size_t ring_bytes{64u << 20}; // rounded up to a power of two
+        std::size_t write_chunk{1u << 20}; // bytes buffered before each write(2)
+        bool normalize{true};              // also write typed records for public messages
+    };
+
+    explicit FeedRecorder(Config cfg);
+    ~FeedRecorder();
+    FeedRecorder(const FeedRecorder &) = delete;
+    FeedRecorder &operator=(const FeedRecorder &) = delete;
+
+    // Throws std::runtime_error if the directory cannot be created.
+    void start();
+    // Drains what is queued, flushes and closes the current file.
+    void stop();
+
+    // Hot path. recv_ns is the steady_clock receive time used everywhere else in the feed.
+    void record_public(int64_t recv_ns, std::string_view msg) { push(RecordType::RawPublic, recv_ns, msg); }
+    void record_private(int64_t recv_ns, std::string_view msg) { push(RecordType::RawPrivate, recv_ns, msg); }
+
+    uint64_t recorded() const { return recorded_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t bytes_written() const { return bytes_written_.load(std::memory_order_relaxed); }
+    // Path of the file currently being written (empty before the first record).
+    std::string current_path() const;
+
+    // Name of the file covering the hour containing wall_ns: <dir>/<prefix>-YYYYMMDD-HH.bmd (UTC).
+    // A recorder started within an hour another session already recorded writes its own
+    // <prefix>-YYYYMMDD-HH_NN.bmd (session NN >= 1), which sorts after it and before the next hour.
+    static std::string file_name(const std::string &dir, const std::string &prefix, int64_t wall_ns, int session = 0);
+
+private:
+    void push(RecordType type, int64_t recv_ns, std::string_view msg);
+    void run();
+    // Copies the next queued record out of the ring into scratch_; false if empty.
+    bool pop(RecordHeader &hdr);
+    void append(RecordType type, int64_t recv_ns, const void *payload, std::size_t size);
+    void append_normalized(int64_t recv_ns, std::string_view msg);
+    void rotate_if_needed(int64_t recv_ns);
+    // Opens the first hour file that is new or carries this recorder's anchor, so records are never
+    // timed against another session's header. Sets path; -1 with errno on failure.
+    int open_hour_file(int64_t wall_ns, std::string &path);
+    void flush();
+    void close_file();
+
+    Config cfg_;
+    std::unique_ptr<char[]> ring_;
+    std::size_t mask_{0};
+    // head_ is written by producers (under lock_), tail_ by the writer.
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> tail_{0};
+    std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+
+    std::atomic<bool> running_{false};
+    std::thread writer_;
+    std::atomic<uint64_t> recorded_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> bytes_written_{0};
+
+    // Writer-thread state.
+    int fd_{-1};
+    int64_t file_hour_{-1};
+    int64_t open_retry_ns_{0}; // recv_ns before which a failed open is not retried
+    bool failing_{false};      // an open or write failure was logged and has not cleared yet
+    int64_t anchor_wall_ns_{0};
+    int64_t anchor_steady_ns_{0};
+    mutable std::mutex path_mu_;
+    std::string path_;
+    std::vector<char> out_;
+    std::string scratch_;
+    std::vector<char> norm_;
+    std::unordered_map<std::string, TickerSnapshot> tickers_;
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Prices and quantities are integers in units of 1e-8 (Bybit never quotes more than 8 decimals), so
+// tick/lot rounding is exact and formatting needs no floating point.
+constexpr int64_t kFixedScale = 100000000;
+constexpr int kFixedDecimals = 8;
+
+inline int64_t to_fixed(double v) { return static_cast<int64_t>(std::llround(v * static_cast<double>(kFixedScale))); }
+inline double from_fixed(int64_t v) { return static_cast<double>(v) / static_cast<double>(kFixedScale); }
+
+// Parses a plain decimal ("123", "-0.0105", "65432.10") into 1e-8 units without going through
+// double. Digits beyond the 8th decimal are truncated. Returns false on anything else.
+inline bool parse_fixed(std::string_view s, int64_t &out)
+{
+    std::size_t i = 0;
+    const bool neg = !s.empty() && s[0] == '-';
+    if (neg)
+        ++i;
+    int64_t int_part = 0;
+    std::size_t int_digits = 0;
+    for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i, ++int_digits)
+    {
+        int_part = int_part * 10 + (s[i] - '0');
+        if (int_part > INT64_MAX / kFixedScale)
+            return false;
+    }
+    int64_t frac = 0;
+    int frac_digits = 0;
+    if (i < s.size() && s[i] == '.')
+    {
+        for (++i; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i)
+        {
+            if (frac_digits < kFixedDecimals)
+            {
+                frac = frac * 10 + (s[i] - '0');
+                ++frac_digits;
+            }
+        }
+    }
+    if (i != s.size() || (int_digits == 0 && frac_digits == 0))
+        return false;
+    for (int d = frac_digits; d < kFixedDecimals; ++d)
+        frac *= 10;
+    if (frac > INT64_MAX - int_part * kFixedScale)
+        return false;
+    const int64_t v = int_part * kFixedScale + frac;
+    out = neg ? -v : v;
+    return true;
+}
+
+// Writes v / 1e8 as a plain decimal without trailing zeros ("100.5", "0.01", "3"). The buffer must
+// hold at least kMaxFixedChars characters. Returns the end of the written text.
+constexpr std::size_t kMaxFixedChars = 32;
+inline char *write_fixed(char *out, int64_t v)
+{
+    const uint64_t mag = v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+    if (v < 0)
+        *out++ = '-';
+    out = std::to_chars(out, out + 21, mag / kFixedScale).ptr;
+    uint64_t frac = mag % kFixedScale;
+    if (frac == 0)
+        return out;
+    char digits[kFixedDecimals];
+    for (int i = kFixedDecimals - 1; i >= 0; --i)
+    {
+        digits[i] = static_cast<char>('0' + frac % 10);
+        frac /= 10;
+    }
+    int n = kFixedDecimals;
+    while (digits[n - 1] == '0')
+        --n;
+    *out++ = '.';
+    std::memcpy(out, digits, static_cast<std::size_t>(n));
+    return out + n;
+}
+
+// Strongly typed fixed-point value. Price and Qty are distinct types, so a size can never be passed
+// where a price is expected; rounding takes the instrument step (tick or lot) of the same type.
+template <typename Tag>
+struct Fixed
+{
+    int64_t raw{0}; // value * kFixedScale
+
+    static constexpr Fixed from_raw(int64_t r) { return Fixed{r}; }
+    static Fixed from_double(double v) { return Fixed{to_fixed(v)}; }
+    static bool parse(std::string_view s, Fixed &out) { return parse_fixed(s, out.raw); }
+
+    double to_double() const { return from_fixed(raw); }
+    bool is_zero() const { return raw == 0; }
+    char *write(char *out) const { return write_fixed(out, raw); }
+    std::string str() const
+    {
+        char buf[kMaxFixedChars];
+        return std::string(buf, write(buf));
+    }
+
+    // Exact rounding to a multiple of step (step <= 0 leaves the value unchanged).
+    Fixed floor_to(Fixed step) const
+    {
+        if (step.raw <= 0)
+            return *this;
+        int64_t q = raw / step.raw;
+        if (raw % step.raw != 0 && raw < 0)
+            --q;
+        return Fixed{q * step.raw};
+    }
+    Fixed ceil_to(Fixed step) const
+    {
+        const Fixed f = floor_to(step);
+        return f.raw == raw || step.raw <= 0 ? f : Fixed{f.raw + step.raw};
+    }
+    Fixed round_to(Fixed step) const
+    {
+        const Fixed f = floor_to(step);
+        return step.raw > 0 && 2 * (raw - f.raw) >= step.raw ? Fixed{f.raw + step.raw} : f;
+    }
+    bool on_grid(Fixed step) const { return step.raw <= 0 || raw % step.raw == 0; }
+
+    Fixed operator+(Fixed o) const { return Fixed{raw + o.raw}; }
+    Fixed operator-(Fixed o) const { return Fixed{raw - o.raw}; }
+    Fixed operator*(int64_t n) const { return Fixed{raw * n}; }
+    Fixed operator-() const { return Fixed{-raw}; }
+    Fixed &operator+=(Fixed o)
+    {
+        raw += o.raw;
+        return *this;
+    }
+    Fixed &operator-=(Fixed o)
+    {
+        raw -= o.raw;
+        return *this;
+    }
+
+    friend bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+    friend bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+    friend bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+    friend bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+    friend bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+    friend bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+};
+
+struct PriceTag;
+struct QtyTag;
+using Price = Fixed<PriceTag>;
+using Qty = Fixed<QtyTag>;
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "strategy.hpp"
+
+// On-disk instrument cache written by InstrumentRegistry: an InstrumentCacheHeader followed by
+// `count` InstrumentCacheRecord sorted by symbol. Host-endian, like the feed recordings.
+constexpr char kInstrumentCacheMagic[4] = {'B', 'M', 'I', 'C'};
+constexpr uint32_t kInstrumentCacheVersion = 1;
+
+struct InstrumentCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+    int64_t fetched_ms; // wall clock of the instruments-info response the file was written from
+};
+
+struct InstrumentCacheRecord
+{
+    char symbol[24];     // NUL-padded
+    int64_t tick_raw;    // Price::raw
+    int64_t lot_raw;     // Qty::raw
+    int64_t min_qty_raw; // Qty::raw
+};
+
+// Tick size, lot size and minimum qty of one instruments-info list item. False if a filter is
+// missing or malformed.
+bool parse_instrument_item(const nlohmann::json &item, InstrumentMeta &out);
+
+// Instrument metadata for every symbol of a category, served from a compact binary cache so startup
+// needs no instruments-info download, and refreshed in the background so a tick or lot size changed
+// by the exchange reaches the running strategies.
+//
+// load_cache() maps the cache file written by the last refresh(); refresh() downloads the list
+// through `fetch`, swaps it in and rewrites the cache. Symbols passed to watch() get a dense id and
+// are compared on every refresh: each one whose filters changed is reported to the listener, from
+// the refreshing thread. Lookups are a binary search over the sorted list. Thread-safe.
+class InstrumentRegistry
+{
+public:
+    struct Config
+    {
+        std::string cache_path;                     // empty = no cache file
+        std::chrono::seconds refresh_interval{300}; // background refresh period (0 = none)
+    };
+    // Returns a parsed instruments-info response; may throw.
+    using Fetch = std::function<nlohmann::json()>;
+    using Listener = std::function<void(int id, const std::string &symbol, const InstrumentMeta &meta)>;
+
+    InstrumentRegistry(Config cfg, Fetch fetch);
+    ~InstrumentRegistry();
+
+    InstrumentRegistry(const InstrumentRegistry &) = delete;
+    InstrumentRegistry &operator=(const InstrumentRegistry &) = delete;
+
+    // True if the cache file existed and was valid; its instruments replace the current list.
+    bool load_cache();
+    // Downloads and swaps in the list, rewrites the cache and notifies the listener. Returns the
+    // number of watched symbols that changed. Throws if the download or parse fails, or the response
+    // has no usable instrument; the current list is kept then.
+    std::size_t refresh();
+
+    std::optional<InstrumentMeta> find(std::string_view symbol) const;
+    // Dense id of a symbol to watch for changes (the same id again for a symbol already watched).
+    int watch(const std::string &symbol);
+    // Last known metadata of a watched symbol; nullopt while it is not in the list.
+    std::optional<InstrumentMeta> meta(int id) const;
+    // Set before start().
+    void set_listener(Listener listener) { listener_ = std::move(listener); }
+
+    // Background thread calling refresh() every refresh_interval, the first time right away when
+    // `refresh_now` is set (e.g. to verify a list that came from the cache). Failures are logged and
+    // retried at the next interval.
+    void start(bool refresh_now);
+    void stop();
+
+    std::size_t size() const;
+    int64_t fetched_ms() const; // of the current list, 0 if none
+    uint64_t refreshes() const;
+
+private:
+    struct Watched
+    {
+        std::string symbol;
+        std::optional<InstrumentMeta> meta;
+    };
+
+    const InstrumentCacheRecord *lookup(std::string_view symbol) const; // mu_ held
+    void save_cache(const std::vector<InstrumentCacheRecord> &records, int64_t fetched_ms) const;
+    void run(bool refresh_now);
+
+    Config cfg_;
+    Fetch fetch_;
+    Listener listener_;
+    mutable std::mutex mu_;
+    std::vector<InstrumentCacheRecord> records_; // sorted by symbol
+    int64_t fetched_ms_{0};
+    uint64_t refreshes_{0};
+    std::vector<Watched> watched_; // index = id
+
+    std::mutex refresh_mu_; // one refresh at a time
+    std::mutex stop_mu_;
+    std::condition_variable stop_cv_;
+    bool stop_{false};
+    std::thread worker_;
+};
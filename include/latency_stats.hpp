@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Hot-path stages between a WS frame arriving and the resulting order being acknowledged.
+enum class LatencyStage : uint8_t
+{
+    WsParse,        // frame received -> message parsed
+    BookUpdate,     // parsed -> book/ticker merged and published
+    FeedToStrategy, // frame received -> strategy entry (includes throttling and coalescing)
+    Strategy,       // strategy entry -> exit
+    GatewayQueue,   // order batch queued -> handed to the transport (async gateway only)
+    OrderAck,       // order batch sent -> response received
+    TickToTrade,    // frame received -> order batch sent
+    HttpConnect,    // new REST connection: TCP + TLS setup (warm-ups included)
+    HttpRequest,    // REST request sent -> response received, any connection setup included
+    Count,
+};
+
+const char *latency_stage_name(LatencyStage stage);
+
+// Probe clock: steady_clock (CLOCK_MONOTONIC through the vDSO on Linux), the same clock as the
+// recv_ns stamps on books, tickers and recordings, so probes subtract directly from them.
+inline int64_t latency_now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Log-linear (HDR-style) histogram of nanosecond values: 16 sub-buckets per power of two, so any
+// recorded value is reported within 1/16 of itself, over the full int64 range. Lock-free: any
+// number of threads may record while another takes snapshots.
+class alignas(64) LatencyHistogram
+{
+public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSub = 1 << kSubBits;
+    static constexpr int kBuckets = (64 - kSubBits + 1) * kSub;
+
+    struct Summary
+    {
+        uint64_t count{0};
+        int64_t p50{0};
+        int64_t p99{0};
+        int64_t p999{0};
+        int64_t max{0};
+    };
+
+    static int bucket_of(uint64_t v)
+    {
+        if (v < static_cast<uint64_t>(kSub))
+            return static_cast<int>(v);
+        const int shift = 63 - __builtin_clzll(v) - kSubBits;
+        return (shift + 1) * kSub + static_cast<int>((v >> shift) - kSub);
+    }
+    // Largest value that falls into bucket idx.
+    static uint64_t bucket_high(int idx)
+    {
+        if (idx < kSub)
+            return static_cast<uint64_t>(idx);
+        const int shift = idx / kSub - 1;
+        const uint64_t mantissa = static_cast<uint64_t>(idx % kSub + kSub);
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    void record(int64_t ns)
+    {
+        const uint64_t v = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        counts_[bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t m = max_.load(std::memory_order_relaxed);
+        while (v > m && !max_.compare_exchange_weak(m, v, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Percentiles are bucket upper bounds, capped at the exact max. With reset, the counts move out
+    // of the histogram (records racing with the snapshot land in this one or the next).
+    Summary summary(bool reset = false);
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Process-wide histogram for a stage.
+LatencyHistogram &latency_histogram(LatencyStage stage);
+
+inline void latency_record(LatencyStage stage, int64_t ns) { latency_histogram(stage).record(ns); }
+
+// Takes an interval snapshot of every stage (resetting them), prints one line per stage that saw
+// samples and, if a path is set, appends the same numbers as CSV rows
+// (wall_ms,stage,count,p50_ns,p99_ns,p999_ns,max_ns). Called from the reporting loop.
+class LatencyReporter
+{
+public:
+    explicit LatencyReporter(std::string csv_path = {});
+    void report(std::ostream &log);
+
+private:
+    std::string csv_path_;
+    bool header_checked_{false};
+};
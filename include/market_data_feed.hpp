@@ -3,18 +3,32 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
-#include <nlohmann/json.hpp>
-
+#include "feed_recorder.hpp"
+#include "latency_stats.hpp"
+#include "order_book.hpp"
+#include "seqlock.hpp"
+#include "symbol_table.hpp"
+#include "thread_affinity.hpp"
+#include "ticker_snapshot.hpp"
 #include "ws_helper.hpp"
+#include "ws_message_parser.hpp"
 
 // MarketDataFeed maintains realtime state (ticker + orderbook) via Bybit WebSocket.
-// It can be consumed by strategies to get the latest snapshot without re-parsing messages.
+// Orderbook snapshot/delta messages are merged into a typed per-symbol OrderBook so strategies
+// can read top-of-book without re-parsing messages.
+//
+// The WS callback thread is the only writer. After each update it publishes fixed-size
+// BookSnapshot/TickerSnapshot values through per-symbol seqlocks, so readers (strategy loop,
+// risk checks) never take a lock or allocate. Symbols are interned in the global SymbolTable when
+// the feed is prepared; each message's symbol is resolved to its SymbolId once and per-symbol state
+// is a flat array indexed by it.
 class MarketDataFeed
 {
 public:
@@ -22,25 +36,105 @@ public:
     ~MarketDataFeed();
 
     // Connect and subscribe to tickers + orderbook (depth=1 by default) for symbols.
+    // The symbol set is fixed for the lifetime of the feed.
     void start(const std::vector<std::string> &symbols, int depth = 1);
     void stop();
 
+    // Build the per-symbol state without connecting (start() does this itself). Replay tools call
+    // prepare() and then feed recorded messages through ingest().
+    void prepare(const std::vector<std::string> &symbols, int depth = 1);
+    // Apply one public WS message as if it had been received at recv_ns (steady_clock). The live
+    // callback goes through here too, so replay exercises the same parsing and book code.
+    void ingest(std::string_view msg, int64_t recv_ns);
+
     // Wait until at least one ticker AND one orderbook update has been received for any symbol.
     bool wait_for_initial(std::chrono::milliseconds timeout = std::chrono::milliseconds{5000});
 
-    std::optional<nlohmann::json> latest_ticker(const std::string &symbol) const;
-    std::optional<nlohmann::json> latest_orderbook(const std::string &symbol) const;
+    // Lock-free reads. Return false for unknown symbols or while no valid data is published.
+    bool read_book(const std::string &symbol, BookSnapshot &out) const;
+    bool read_ticker(const std::string &symbol, TickerSnapshot &out) const;
+    bool best_bid_ask(const std::string &symbol, double &bid, double &ask) const;
+
+    // Dense index of a prepared symbol (its position in the start()/prepare() list), or -1. The
+    // index overloads skip the symbol lookup; shards quoting many symbols poll through them.
+    int symbol_index(const std::string &symbol) const;
+    bool read_book(int index, BookSnapshot &out) const;
+    bool read_ticker(int index, TickerSnapshot &out) const;
+    // Per-symbol counterpart of update_seq(): bumped whenever this symbol's book or ticker is published.
+    uint64_t symbol_seq(int index) const;
+
+    std::optional<TickerSnapshot> latest_ticker(const std::string &symbol) const;
+    // Top kBookSnapshotDepth levels per side; nullopt until a snapshot has been applied.
+    std::optional<BookSnapshot> latest_book(const std::string &symbol) const;
+
+    // Update notification. Every published book/ticker change bumps a feed-wide sequence.
+    uint64_t update_seq() const { return update_seq_.load(std::memory_order_acquire); }
+    // Block until update_seq() != seen or timeout; returns the current sequence. Readers that are
+    // slower than the feed simply see a larger jump, i.e. intermediate updates are coalesced.
+    uint64_t wait_for_update(uint64_t seen, std::chrono::microseconds timeout);
+
+    // A sequence gap invalidates the affected book; resync() reconnects so Bybit re-sends snapshots.
+    bool needs_resync() const { return resync_requested_.load(); }
+    void resync();
+    uint64_t gap_count() const { return gap_count_.load(); }
+
+    // Every received message is handed to the recorder before it is parsed. Set before start().
+    void set_recorder(FeedRecorder *recorder) { recorder_ = recorder; }
+    // Pin/prioritise the WS client's callback thread (applied on its first message). Set before start().
+    void set_callback_role(ThreadRole role) { callback_role_.set(std::move(role)); }
+    // Messages that missed the streaming parser and went through nlohmann::json.
+    uint64_t slow_path_count() const { return slow_path_count_.load(std::memory_order_relaxed); }
 
 private:
+    struct SymbolState
+    {
+        explicit SymbolState(std::size_t depth) : book(depth) {}
+
+        // Writer-only working state.
+        OrderBook book;
+        TickerSnapshot ticker;
+        BookSnapshot book_scratch;
+        // Published state.
+        SeqLock<BookSnapshot> book_pub;
+        SeqLock<TickerSnapshot> ticker_pub;
+        std::atomic<uint64_t> updates{0};
+    };
+
     void handle_message(const std::string &msg);
+    // Shared by the WS callback and ingest(); live messages feed the WsParse/BookUpdate probes.
+    void apply(std::string_view msg, int64_t recv_ns, bool live);
+    // Fast path for messages parse_public_message() understood; false means fall back to the DOM.
+    bool handle_public(const PublicMessage &m, int64_t recv_ns);
+    // Publish the book after an update. Returns true if readers should be notified as a normal update.
+    bool publish_book(SymbolState &st, std::string_view symbol, OrderBook::ApplyResult res, int64_t recv_ns);
+    void subscribe();
+    const SymbolState *find(const std::string &symbol) const;
+    SymbolState *find(SymbolId id) const;
+    const SymbolState *at(int index) const;
+    void mark_initial();
+    void notify_update(SymbolState &st);
 
     WsHelper ws_;
+    FeedRecorder *recorder_{nullptr};
+    LazyThreadRole callback_role_;
+    std::vector<std::string> symbols_;
+    int depth_{1};
     std::atomic<bool> running_{false};
     std::atomic<bool> got_ticker_{false};
     std::atomic<bool> got_orderbook_{false};
+    std::atomic<bool> initial_signalled_{false};
+    std::atomic<bool> resync_requested_{false};
+    std::atomic<uint64_t> gap_count_{0};
+    std::atomic<uint64_t> slow_path_count_{0};
+    std::atomic<uint64_t> update_seq_{0};
+    std::atomic<int> waiters_{0};
+
+    // Built once in start() and read-only afterwards, so lookups need no lock.
+    std::vector<std::unique_ptr<SymbolState>> states_;
+    std::vector<SymbolState *> by_id_;    // SymbolId -> state, null for symbols not subscribed here
+    std::vector<SymbolState *> by_index_; // parallel to symbols_
 
+    // Only used to wake blocked waiters; the writer skips it when nobody waits.
     mutable std::mutex m_;
     std::condition_variable cv_;
-    std::unordered_map<std::string, nlohmann::json> tickers_;
-    std::unordered_map<std::string, nlohmann::json> orderbooks_;
 };
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fixed_point.hpp"
+
+// Single L2 price level.
+struct BookLevel
+{
+    Price price;
+    Qty qty;
+};
+
+// Fixed-size, heap-free copy of the top of an OrderBook. Handed to strategies by value.
+constexpr std::size_t kBookSnapshotDepth = 25;
+
+struct BookSnapshot
+{
+    uint64_t update_id{0}; // Bybit "u"
+    uint64_t seq{0};       // Bybit cross sequence "seq"
+    int64_t ts_ms{0};      // exchange timestamp of the last applied message
+    int64_t recv_ns{0};    // local steady_clock time the message was received (0 for REST)
+    uint32_t bid_count{0};
+    uint32_t ask_count{0};
+    BookLevel bids[kBookSnapshotDepth]{}; // best first
+    BookLevel asks[kBookSnapshotDepth]{}; // best first
+
+    bool valid() const { return bid_count > 0 && ask_count > 0; }
+    Price best_bid() const { return bid_count ? bids[0].price : Price{}; }
+    Price best_ask() const { return ask_count ? asks[0].price : Price{}; }
+    double mid() const { return valid() ? 0.5 * (bids[0].price + asks[0].price).to_double() : 0.0; }
+};
+
+// Per-symbol L2 book maintained from Bybit orderbook snapshot/delta messages.
+// Each side is a flat array sorted so that the best level sits at the back: most updates
+// touch the top of book, so inserts/erases only shift a handful of trailing elements.
+class OrderBook
+{
+public:
+    enum class ApplyResult
+    {
+        Applied,
+        Gap,     // update id discontinuity or crossed book; caller must resync
+        Ignored, // delta received before any snapshot
+    };
+
+    explicit OrderBook(std::size_t max_depth = 200);
+
+    // Start applying one message. Snapshots clear the book; deltas are checked for "u" continuity.
+    // Follow with set_bid/set_ask per level and finish with end_update().
+    ApplyResult begin_update(bool is_snapshot, uint64_t update_id, uint64_t seq, int64_t ts_ms);
+    // qty == 0 removes the level.
+    void set_bid(Price price, Qty qty);
+    void set_ask(Price price, Qty qty);
+    // Validates the result (crossed book => Gap) and drops levels beyond max_depth.
+    ApplyResult end_update();
+
+    // Drop all state; the next message must be a snapshot.
+    void reset();
+
+    bool in_sync() const { return in_sync_; }
+    uint64_t update_id() const { return update_id_; }
+    uint64_t seq() const { return seq_; }
+    std::size_t bid_depth() const { return bids_.size(); }
+    std::size_t ask_depth() const { return asks_.size(); }
+
+    bool best_bid(BookLevel &out) const;
+    bool best_ask(BookLevel &out) const;
+
+    // Copy up to n levels, best first. Returns the number written.
+    std::size_t bids(BookLevel *out, std::size_t n) const;
+    std::size_t asks(BookLevel *out, std::size_t n) const;
+
+    void snapshot(BookSnapshot &out) const;
+
+private:
+    // Bids ascending by price, asks descending by price; best level is back().
+    std::vector<BookLevel> bids_;
+    std::vector<BookLevel> asks_;
+    std::size_t max_depth_;
+    uint64_t update_id_{0};
+    uint64_t seq_{0};
+    int64_t ts_ms_{0};
+    bool in_sync_{false};
+    bool applying_{false};
+};
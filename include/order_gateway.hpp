@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "order_request.hpp"
+#include "order_store.hpp"
+#include "rate_limiter.hpp"
+#include "rest_transport.hpp"
+#include "spsc_queue.hpp"
+
+enum class GatewayOp : uint8_t
+{
+    CreateBatch, // /v5/order/create-batch
+    AmendBatch,  // /v5/order/amend-batch
+    CancelBatch, // /v5/order/cancel-batch
+    CancelAll,   // /v5/order/cancel-all
+    CreateOrder, // /v5/order/create (orders[0])
+};
+
+struct GatewayResult
+{
+    uint64_t id{0};
+    GatewayOp op{GatewayOp::CreateBatch};
+    bool ok{false};             // transport succeeded and retCode == 0
+    std::vector<bool> item_ok;  // per batch item (size 1 for single-order ops)
+    std::string body;           // raw response
+    std::string error;          // transport error, empty on success
+    int64_t round_trip_ns{0};   // enqueue -> response
+    bool superseded{false};     // dropped unsent because a later request made it moot (not ok, no error)
+};
+
+// Per-item success flags of a batch response (retCode == 0 and retExtInfo.list[i].code == 0).
+std::vector<bool> parse_batch_results(const std::string &raw, std::size_t n);
+// Per-item codes of a batch response: retExtInfo.list[i].code, or the retCode of a failed call (-1
+// if the body is not JSON) for every item.
+std::vector<int> parse_batch_codes(const std::string &raw, std::size_t n);
+// True for a cancel failure meaning nothing rests any more: unknown, already filled or cancelled.
+bool order_gone_code(int code);
+
+using GatewayCallback = std::function<void(const GatewayResult &)>;
+
+// Bybit batch endpoints take at most 10 orders.
+constexpr std::size_t kMaxGatewayBatch = 10;
+
+// Orders are held inline, so queueing a request copies into a preallocated ring slot without
+// allocating (on_done should capture no more than two pointers to stay in std::function's
+// small-object buffer).
+struct GatewayRequest
+{
+    GatewayOp op{GatewayOp::CreateBatch};
+    SymbolName symbol;
+    uint32_t count{0};
+    OrderRequest orders[kMaxGatewayBatch];
+    GatewayCallback on_done; // run by OrderGateway::poll() on the submitting thread
+    uint64_t id{0};
+    int64_t enqueue_ns{0};
+    int64_t origin_ns{0}; // market data receive time behind the request (0 = none), for tick-to-trade
+};
+
+// Moves order I/O off the strategy thread. The strategy enqueues requests into a lock-free SPSC
+// ring (no syscalls on the hot path); a dedicated I/O thread encodes them, sends independent
+// requests concurrently over persistent connections (at most one in flight per symbol, so
+// cancel -> amend -> create ordering is kept), records acknowledgements in the OrderStore, and
+// hands results back through a second SPSC ring drained by poll().
+//
+// With a RateLimiter, requests are only sent once it grants them and wait in the I/O thread's
+// queue otherwise. Queued requests go out cancels first, then market orders, then quotes; market
+// orders may overtake their symbol's queued quotes, everything else stays FIFO per symbol. A
+// queued request that a newer one makes moot is dropped and completed as superseded: a cancel-all
+// supersedes the symbol's queued limit-order requests, and an amend batch an earlier queued amend
+// batch of the same orders (amends carry the absolute price and qty).
+//
+// The I/O thread opens its connections when it starts and, while idle, keeps them warm (see
+// RestTransport::keep_warm()).
+//
+// submit() and poll() must both be called from the same single strategy thread.
+class OrderGateway
+{
+public:
+    OrderGateway(std::string api_key,
+                 std::string api_secret,
+                 std::string category,
+                 std::string base_url,
+                 OrderStore *orders,
+                 std::size_t queue_capacity = 1024,
+                 RateLimiter *limiter = nullptr);
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway &) = delete;
+    OrderGateway &operator=(const OrderGateway &) = delete;
+
+    // Returns false if the queue is full (request not sent).
+    bool submit(GatewayRequest &&req);
+    // Runs callbacks of completed requests on the caller thread; returns how many ran.
+    std::size_t poll();
+
+    uint64_t submitted() const { return submitted_.load(std::memory_order_relaxed); }
+    uint64_t completed() const { return completed_.load(std::memory_order_relaxed); }
+    uint64_t failed() const { return failed_.load(std::memory_order_relaxed); }
+    uint64_t rejected_full() const { return rejected_full_.load(std::memory_order_relaxed); }
+    uint64_t superseded() const { return superseded_.load(std::memory_order_relaxed); }
+    RestTransport::Stats transport_stats() const { return transport_.stats(); }
+    std::size_t in_flight() const { return static_cast<std::size_t>(submitted() - completed()); }
+
+private:
+    struct Completion
+    {
+        GatewayResult result;
+        GatewayCallback on_done;
+    };
+
+    void run();
+    // Drops queued requests that `incoming` makes moot.
+    void supersede(std::vector<GatewayRequest> &pending, const GatewayRequest &incoming);
+    // Moves what may be sent now from pending into wave; returns the shortest rate-limit wait of
+    // what had to stay (0 if nothing did).
+    int64_t pick_wave(std::vector<GatewayRequest> &pending, std::vector<GatewayRequest> &wave);
+    void execute(std::vector<GatewayRequest> &wave);
+    // Records acks and hands the result to poll(); false if stopping.
+    bool complete(GatewayRequest &req, GatewayResult &&result);
+    void encode(const GatewayRequest &req, std::string &out) const;
+    void apply_acks(const GatewayRequest &req, const std::vector<bool> &item_ok);
+
+    std::string category_;
+    OrderStore *orders_;
+    RateLimiter *limiter_;
+    RestTransport transport_;
+    SpscQueue<GatewayRequest> requests_;
+    SpscQueue<Completion> completions_;
+    uint64_t next_id_{0};
+    std::vector<RestTransport::PostRequest> posts_; // I/O thread only; bodies keep their capacity
+    std::vector<char> picked_;                      // I/O thread only, per pending request
+
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> io_sleeping_{false};
+    std::mutex wake_mu_;
+    std::condition_variable wake_cv_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> rejected_full_{0};
+    std::atomic<uint64_t> superseded_{0};
+
+    std::thread io_;
+};
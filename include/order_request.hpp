@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "fixed_point.hpp"
+
+// Fixed-capacity, NUL-terminated string stored inline. Assignment never allocates; input longer than
+// N - 1 characters is truncated.
+template <std::size_t N>
+struct FixedString
+{
+    static_assert(N > 1 && N <= 256, "length is stored in one byte");
+
+    char data[N]{};
+    uint8_t len{0};
+
+    FixedString() = default;
+    explicit FixedString(std::string_view s) { assign(s); }
+
+    void assign(std::string_view s)
+    {
+        len = static_cast<uint8_t>(s.size() < N - 1 ? s.size() : N - 1);
+        std::memcpy(data, s.data(), len);
+        data[len] = '\0';
+    }
+    void clear() { assign({}); }
+
+    std::string_view view() const { return std::string_view(data, len); }
+    const char *c_str() const { return data; }
+    bool empty() const { return len == 0; }
+    std::size_t size() const { return len; }
+
+    friend bool operator==(const FixedString &a, const FixedString &b) { return a.view() == b.view(); }
+    friend bool operator!=(const FixedString &a, const FixedString &b) { return !(a == b); }
+    friend bool operator==(const FixedString &a, std::string_view b) { return a.view() == b; }
+    friend bool operator!=(const FixedString &a, std::string_view b) { return a.view() != b; }
+    friend bool operator==(const FixedString &a, const std::string &b) { return a.view() == b; }
+    friend bool operator==(const FixedString &a, const char *b) { return a.view() == b; }
+};
+
+// Same capacities as OrderRecord, so ids round-trip through the OrderStore unchanged.
+using OrderLinkId = FixedString<48>;
+// Bybit rejects longer orderLinkIds; the capacity above leaves headroom for ids read off the wire.
+constexpr std::size_t kMaxOrderLinkIdLen = 36;
+using SymbolName = FixedString<24>;
+
+enum class OrderSide : uint8_t
+{
+    Buy,
+    Sell,
+};
+
+enum class OrderType : uint8_t
+{
+    Limit,
+    Market,
+};
+
+enum class TimeInForce : uint8_t
+{
+    GTC,
+    IOC,
+    FOK,
+    PostOnly,
+};
+
+enum class OrderAction : uint8_t
+{
+    Create,
+    Amend,
+    Cancel,
+};
+
+// One order for create/amend/cancel. Trivially copyable: building and queueing it never touches the heap.
+struct OrderRequest
+{
+    SymbolName symbol;
+    OrderLinkId order_link_id;
+    Price price; // ignored for market orders
+    Qty qty;
+    OrderSide side{OrderSide::Buy};
+    OrderType type{OrderType::Limit};
+    TimeInForce tif{TimeInForce::GTC};
+    int8_t position_idx{0};
+
+    bool is_buy() const { return side == OrderSide::Buy; }
+};
+
+// "<slot>_<tag>_<ms>_<counter>", at most kMaxOrderLinkIdLen characters. The "_<ms>_<counter>" suffix
+// that makes the id unique is always kept whole; an over-long "<slot>_<tag>" is cut instead.
+void format_order_link(OrderLinkId &out, std::string_view slot, std::string_view tag, int64_t ms, uint64_t counter);
+// Process-wide source for the <counter> part, so strategies quoting different symbols on different
+// threads never generate the same link id within one millisecond.
+uint64_t next_order_link_counter();
+
+// Bybit v5 bodies, written into `out` (cleared first). `out` keeps its capacity between calls, so
+// steady-state encoding does not allocate. Symbols and link ids are emitted verbatim: Bybit only
+// allows [A-Za-z0-9_-] in them, so no JSON escaping is needed.
+//
+// {"category":..,"request":[..]} for /v5/order/{create,amend,cancel}-batch and the order.*-batch WS ops.
+void encode_batch(OrderAction action, std::string_view category, const OrderRequest *reqs, std::size_t n, std::string &out);
+// {"category":..,<fields>} for /v5/order/create and order.create.
+void encode_create(std::string_view category, const OrderRequest &req, std::string &out);
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+enum class OrderState : uint8_t
+{
+    PendingNew, // sent, no ack yet
+    New,
+    PartiallyFilled,
+    Filled,
+    Cancelled,
+    Rejected,
+};
+
+inline bool is_terminal(OrderState s)
+{
+    return s == OrderState::Filled || s == OrderState::Cancelled || s == OrderState::Rejected;
+}
+
+// Fixed-size record so the pool never allocates after construction.
+struct OrderRecord
+{
+    static constexpr std::size_t kLinkCap = 48; // Bybit orderLinkId is at most 36 chars
+    static constexpr std::size_t kIdCap = 40;
+    static constexpr std::size_t kSymbolCap = 24;
+
+    char order_link_id[kLinkCap]{};
+    char order_id[kIdCap]{};
+    char symbol[kSymbolCap]{};
+    OrderState state{OrderState::PendingNew};
+    bool is_buy{false};
+    double price{0.0};
+    double qty{0.0};
+    double cum_exec_qty{0.0};
+    double avg_price{0.0};
+    int64_t updated_ms{0}; // exchange updatedTime; older updates are ignored
+};
+
+// Normalized update from the private `order` topic or a REST acknowledgement.
+struct OrderUpdate
+{
+    std::string order_link_id;
+    std::string order_id;
+    std::string symbol;
+    OrderState state{OrderState::New};
+    bool is_buy{false};
+    double price{0.0};
+    double qty{0.0};
+    double cum_exec_qty{0.0};
+    double avg_price{0.0};
+    int64_t updated_ms{0};
+};
+
+// Parses one element of the private `order` topic's data array. Returns false if it has no orderLinkId.
+bool parse_order_update(const nlohmann::json &d, OrderUpdate &out);
+
+// Told whenever an order's open (unfilled, non-terminal) quantity or notional changes, as deltas in
+// 1e-8 fixed-point units, so a consumer (the RiskEngine) can keep working exposure without scanning
+// the store. Called with the store's lock held, from whichever thread updated it.
+class IOrderExposureSink
+{
+public:
+    virtual ~IOrderExposureSink() = default;
+    virtual void on_exposure(std::string_view symbol, bool is_buy, int64_t open_qty, int64_t open_notional) = 0;
+};
+
+// In-memory book of our own orders keyed by orderLinkId.
+// Open-addressing hash table (linear probing) over indices into a preallocated record pool with a
+// free list, so lookups are O(1) and steady-state updates never touch the heap. When the pool is
+// full, terminal orders are evicted to make room. Thread-safe: the private WS thread writes while
+// strategies read.
+class OrderStore
+{
+public:
+    explicit OrderStore(std::size_t capacity = 4096);
+
+    // Record an order we are about to send (PendingNew). Overwrites any previous record with the same id.
+    void on_submitted(std::string_view order_link_id, std::string_view symbol, bool is_buy, double price, double qty);
+    // REST acknowledgement for a previously submitted order.
+    void on_ack(std::string_view order_link_id, bool accepted, std::string_view order_id = {});
+    void on_amend_ack(std::string_view order_link_id, double price, double qty);
+    // Authoritative state from the private order stream.
+    void apply(const OrderUpdate &u);
+
+    // Copy the record out; false if unknown.
+    bool get(std::string_view order_link_id, OrderRecord &out) const;
+    bool state_of(std::string_view order_link_id, OrderState &out) const;
+    bool erase(std::string_view order_link_id);
+
+    std::size_t size() const;
+    std::size_t capacity() const { return pool_.size(); }
+    // Number of inserts dropped because the pool was full of live orders.
+    uint64_t dropped() const;
+
+    // Set before orders are recorded; the sink must outlive the store's last update.
+    void set_exposure_sink(IOrderExposureSink *sink);
+
+private:
+    static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+    static constexpr uint32_t kTombstone = 0xFFFFFFFEu;
+
+    struct Node
+    {
+        OrderRecord rec;
+        uint64_t hash{0};
+        uint32_t next_free{kEmpty};
+        bool used{false};
+    };
+
+    // Index into slots_ holding the key, or kEmpty.
+    std::size_t find_slot(const char *key, std::size_t len, uint64_t h) const;
+    OrderRecord *lookup(std::string_view key);
+    const OrderRecord *lookup(std::string_view key) const;
+    OrderRecord *insert(std::string_view key);
+    void remove_at(std::size_t slot);
+    bool evict_terminal();
+    void rebuild();
+
+    mutable std::mutex mu_;
+    std::vector<Node> pool_;
+    std::vector<uint32_t> slots_; // power of two, >= 2x pool size
+    std::size_t mask_{0};
+    uint32_t free_head_{kEmpty};
+    std::size_t live_{0};
+    std::size_t tombstones_{0};
+    uint64_t dropped_{0};
+    IOrderExposureSink *sink_{nullptr};
+};
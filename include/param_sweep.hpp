@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "backtester.hpp"
+#include "strategy.hpp"
+
+class RecordFileReader;
+class WorkStealingPool;
+
+// Strategy settings, named by the env variables the live binaries read them from.
+struct StrategyParams
+{
+    double budget_usd{10.0};
+    double min_spread_bps{0.2};
+    double spread_factor{1.0};
+    double max_net_qty{100.0};
+    double tp_spread_bps{0.5};
+    int ladder_levels{3};
+    double stop_loss_bps{-1.0};
+    double gross_notional_cap{-1.0};
+    double requote_tol_ticks{0.0};
+    bool long_only{false}; // BYBIT_SIDE_MODE=long_only
+    int64_t min_requote_ms{250};
+
+    static StrategyParams from_env();
+    // Sets one setting by env name. False if the name is unknown or the value does not parse.
+    bool set(const std::string &name, const std::string &value);
+};
+
+std::unique_ptr<IStrategy> make_strategy(const std::string &symbol, const InstrumentMeta &meta, const StrategyParams &params);
+
+// One sweep configuration: (env name, value) overrides applied on top of the base params.
+using SweepPoint = std::vector<std::pair<std::string, std::string>>;
+
+// Sweep spec, one setting per line ('#' starts a comment):
+//
+//   mode = grid                          # or random
+//   samples = 200                        # random mode: number of distinct points
+//   seed = 7                             # random mode
+//   BYBIT_MIN_SPREAD_BPS = 0.1, 0.2, 0.5 # value list
+//   BYBIT_SPREAD_FACTOR = 0.5:2:0.25     # lo:hi:step, inclusive
+//   BYBIT_SIDE_MODE = both, long_only
+//
+// Grid mode runs the full cross product; random mode draws distinct points from it uniformly.
+struct SweepSpec
+{
+    struct Axis
+    {
+        std::string name;
+        std::vector<std::string> values;
+    };
+
+    std::vector<Axis> axes;
+    bool random{false};
+    std::size_t samples{100};
+    uint64_t seed{1};
+
+    // Throws std::runtime_error naming the offending line.
+    static SweepSpec parse(std::istream &in);
+    static SweepSpec load(const std::string &path);
+
+    // Points in a stable order (the last axis varies fastest in grid mode).
+    std::vector<SweepPoint> expand() const;
+};
+
+struct SweepRun
+{
+    std::size_t index{0};
+    SweepPoint point;
+    Backtester::Result result;
+    std::string error; // non-empty if the run threw
+
+    double net_pnl() const { return result.realized - result.fees + result.unrealized; }
+};
+
+// Replays inputs once per point on the pool, each run with its own feed, simulator and strategy
+// over the shared read-only readers. bt.files and bt.out_dir are ignored. Results come back in
+// point order.
+std::vector<SweepRun> run_sweep(const Backtester::Config &bt,
+                                const StrategyParams &base,
+                                const std::vector<SweepPoint> &points,
+                                const std::vector<const RecordFileReader *> &inputs,
+                                WorkStealingPool &pool);
+
+// Ranked table, best net PnL first; failed runs go last with their error.
+void write_sweep_csv(std::ostream &out, const std::vector<SweepSpec::Axis> &axes, std::vector<SweepRun> runs);
@@ -1,14 +1,36 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
-// Strategy-local PnL tracker keyed by orderLinkId.
-// Accumulates realized PnL and fees from private execution stream.
+#include "seqlock.hpp"
+#include "symbol_table.hpp"
+
+// Account PnL from the private execution/position streams.
+//
+// Running totals are kept incrementally in 1e-8 fixed-point units (exact, so a week of additions
+// does not drift) and published through a seqlock after every update: totals() is a lock-free copy
+// whatever the session length. Per-order detail is kept for the most recent orders only; orders
+// beyond max_orders, or not updated for max_order_age, are folded into a per-symbol bucket, so
+// memory stays bounded by the config rather than by uptime. Buckets and unrealized slots are flat
+// arrays indexed by SymbolId.
 class PnlTracker
 {
 public:
+    struct Config
+    {
+        std::size_t max_orders{4096};
+        std::chrono::seconds max_order_age{std::chrono::hours{1}};
+    };
+
     struct Totals
     {
         double realized{0.0}; // execPnl
@@ -17,52 +39,92 @@ public:
         double unrealized{0.0};
     };
 
-    void add_execution(const std::string &order_link_id, double realized_pnl, double fee)
+    struct OrderPnl
     {
-        std::lock_guard<std::mutex> lg(mu_);
-        auto &t = per_order_[order_link_id];
-        t.realized += realized_pnl;
-        t.fees += fee;
-    }
+        double realized{0.0};
+        double fees{0.0};
+        uint32_t fills{0};
+    };
 
-    void add_funding(double funding_payment)
+    // Evicted orders of one symbol, summed.
+    struct Bucket
     {
-        std::lock_guard<std::mutex> lg(mu_);
-        funding_total_ += funding_payment;
-    }
+        double realized{0.0};
+        double fees{0.0};
+        uint64_t orders{0};
+        uint64_t fills{0};
+    };
 
-    void set_unrealized(const std::string &key, double upl)
-    {
-        std::lock_guard<std::mutex> lg(mu_);
-        unrealized_map_[key] = upl;
-    }
+    PnlTracker() : PnlTracker(Config{}) {}
+    explicit PnlTracker(Config cfg) : cfg_(cfg) {}
 
-    void clear_unrealized()
-    {
-        std::lock_guard<std::mutex> lg(mu_);
-        unrealized_map_.clear();
-    }
+    // `symbol` selects the bucket the order is folded into once evicted; kNoSymbol (e.g. a symbol
+    // this process never interned) goes to a shared unattributed bucket.
+    void add_execution(const std::string &order_link_id, double realized_pnl, double fee,
+                       SymbolId symbol = kNoSymbol);
+    // Same, with an explicit steady-clock time for the age-based eviction (tests, replay).
+    void add_execution(const std::string &order_link_id, double realized_pnl, double fee,
+                       SymbolId symbol, std::chrono::steady_clock::time_point now);
+    void add_funding(double funding_payment);
+    // Unrealized PnL of one position slot (positionIdx 0 one-way, 1/2 hedge-mode buy/sell); replaces
+    // the slot's last value. Ignored for kNoSymbol or a positionIdx outside 0..2.
+    void set_unrealized(SymbolId symbol, int position_idx, double upl);
+    void clear_unrealized();
 
+    // Lock-free; safe from any thread.
     Totals totals() const
     {
-        std::lock_guard<std::mutex> lg(mu_);
-        Totals agg;
-        for (const auto &kv : per_order_)
-        {
-            agg.realized += kv.second.realized;
-            agg.fees += kv.second.fees;
-        }
-        agg.funding = funding_total_;
-        for (const auto &kv : unrealized_map_)
-        {
-            agg.unrealized += kv.second;
-        }
-        return agg;
+        Totals t;
+        totals_.load(t);
+        return t;
     }
 
+    // Detail for a recent order; nullopt once it has been evicted into its bucket (or never seen).
+    std::optional<OrderPnl> order(const std::string &order_link_id) const;
+    // Zero until one of the symbol's orders is evicted; nullopt for symbols never seen.
+    std::optional<Bucket> bucket(SymbolId symbol) const;
+    std::size_t tracked_orders() const;
+
 private:
-    mutable std::mutex mu_;
-    std::unordered_map<std::string, Totals> per_order_;
-    double funding_total_{0.0};
-    std::unordered_map<std::string, double> unrealized_map_;
+    struct BucketUnits
+    {
+        int64_t realized{0};
+        int64_t fees{0};
+        uint64_t orders{0};
+        uint64_t fills{0};
+        bool seen{false};
+    };
+    struct OrderEntry
+    {
+        const std::string *link{nullptr}; // the order_index_ key
+        BucketUnits *bucket{nullptr};
+        int64_t realized{0}; // 1e-8 units
+        int64_t fees{0};
+        uint32_t fills{0};
+        std::chrono::steady_clock::time_point last_update;
+    };
+    using OrderList = std::list<OrderEntry>; // least recently updated first
+    using OrderIndex = std::unordered_map<std::string, OrderList::iterator>;
+
+    static constexpr std::size_t kPositionSlots = 3; // positionIdx 0..2
+
+    OrderList::iterator insert_order(const std::string &order_link_id, SymbolId symbol);
+    void evict(std::chrono::steady_clock::time_point now);
+    void publish();
+
+    Config cfg_;
+    mutable std::mutex mu_; // writers; readers of totals() never take it
+    OrderList orders_;
+    OrderIndex order_index_;
+    // Evicted list/index nodes, reused for the next new order so steady-state churn does not allocate.
+    OrderList spare_orders_;
+    OrderIndex::node_type spare_index_;
+    std::deque<BucketUnits> buckets_; // index = SymbolId; a deque so OrderEntry::bucket survives growth
+    BucketUnits unattributed_;
+    std::vector<int64_t> unrealized_slots_; // index = SymbolId * kPositionSlots + positionIdx
+    int64_t realized_{0};
+    int64_t fees_{0};
+    int64_t funding_{0};
+    int64_t unrealized_{0};
+    SeqLock<Totals> totals_;
 };
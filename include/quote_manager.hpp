@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "trading_helper.hpp"
+
+// One order the strategy wants resting on the book. `slot` names a stable ladder position
+// ("bid1", "ask2", "tp_sell", ...) so successive ladders can be matched to working orders.
+struct DesiredQuote
+{
+    std::string slot;
+    std::string side; // "Buy" | "Sell"
+    Price price;
+    Qty qty;
+    int position_idx{0};
+};
+
+// Minimal set of actions that turns the working orders into the desired ladder.
+struct QuotePlan
+{
+    struct Amend
+    {
+        OrderLinkId order_link_id;
+        DesiredQuote quote;
+    };
+
+    std::vector<DesiredQuote> place;
+    std::vector<Amend> amend;
+    std::vector<OrderLinkId> cancel;
+
+    bool empty() const { return place.empty() && amend.empty() && cancel.empty(); }
+    // Keeps capacity, so a reused plan stops allocating once it has seen its largest ladder.
+    void clear()
+    {
+        place.clear();
+        amend.clear();
+        cancel.clear();
+    }
+};
+
+// Tracks this strategy's working limit orders per ladder slot and re-quotes by diffing instead of
+// cancel_all + resubmit: unchanged slots are left alone (keeping queue priority), moved slots are
+// amended in place, and only missing/extra slots are placed/cancelled, each as one batch call.
+// Link ids are fixed-size and requests are encoded from OrderRequest PODs into reused buffers, so a
+// steady-state re-quote performs no heap allocations before the I/O layer.
+class QuoteManager
+{
+public:
+    struct Config
+    {
+        Price price_tolerance;      // leave an order alone if |price diff| <= this
+        Qty qty_tolerance;          // leave an order alone if |qty diff| <= this
+        std::string link_tag{"mm"}; // embedded in generated orderLinkIds; at most kMaxLinkTagLen
+    };
+
+    // With a ladder slot name and the "_<ms>_<counter>" suffix the id must stay within
+    // kMaxOrderLinkIdLen, or the exchange rejects every create.
+    static constexpr std::size_t kMaxLinkTagLen = 8;
+
+    struct WorkingOrder
+    {
+        OrderLinkId order_link_id;
+        DesiredQuote quote;
+    };
+
+    // Throws std::invalid_argument for a link_tag that is too long or not [A-Za-z0-9-].
+    QuoteManager(std::string symbol, Config cfg);
+
+    // Pure diff of desired quotes against the working set.
+    QuotePlan diff(const std::vector<DesiredQuote> &desired) const;
+    void diff_into(const std::vector<DesiredQuote> &desired, QuotePlan &out) const;
+
+    // Diff and send via batch cancel/amend/create. The first call cancels everything on the symbol
+    // so orders left over from a previous run are not orphaned. When the helper's async gateway is
+    // enabled the batches are queued instead and applied from poll_async() callbacks; a new diff is
+    // only sent once the previous round is fully acknowledged. The QuoteManager must outlive them.
+    // While the helper's kill switch is tripped `desired` is ignored: the trip itself cancels
+    // everything on the symbol, and nothing is quoted until the switch is reset.
+    void sync(const std::vector<DesiredQuote> &desired, TradingHelper &helper);
+
+    // Drop slots whose orders the order store reports as filled, cancelled or rejected, and queue
+    // cancels for unknown-outcome creates it reports live.
+    void reconcile(const OrderStore &orders);
+
+    // Bookkeeping, applied from exchange acknowledgements.
+    void on_placed(const DesiredQuote &quote, std::string_view order_link_id);
+    void on_amended(std::string_view order_link_id, const DesiredQuote &quote);
+    void on_gone(std::string_view order_link_id); // cancelled, filled, or rejected
+    // Create answered with kUnknownOutcomeCode: if the order stream later reports it live,
+    // reconcile() queues a cancel for it.
+    void on_create_unknown(std::string_view order_link_id);
+
+    // Forget all working orders (e.g. after an external cancel_all).
+    void reset();
+
+    // New amend tolerances, e.g. after the instrument's tick or lot size changed.
+    void set_tolerance(Price price_tolerance, Qty qty_tolerance)
+    {
+        cfg_.price_tolerance = price_tolerance;
+        cfg_.qty_tolerance = qty_tolerance;
+    }
+
+    const std::vector<WorkingOrder> &working() const { return working_; }
+
+    std::size_t in_flight() const { return in_flight_; }
+
+private:
+    // One batch call; index[i] points into plan_.place / plan_.amend for reqs[i].
+    struct Batch
+    {
+        OrderAction action{OrderAction::Create};
+        uint32_t count{0};
+        OrderRequest reqs[kMaxGatewayBatch];
+        uint32_t index[kMaxGatewayBatch]{};
+    };
+
+    struct UnknownCreate
+    {
+        OrderLinkId order_link_id;
+        int64_t since_ns; // steady clock
+    };
+
+    // Fills batches_ from plan_: cancels, then amends, then places.
+    void build();
+    // `raw` is the batch response, read for the codes of failed items.
+    void apply(const Batch &b, const std::vector<bool> &ok, const std::string &raw);
+    void sync_async(const std::vector<DesiredQuote> &desired, TradingHelper &helper);
+    void on_async_done(const GatewayResult &r);
+
+    void make_link(const std::string &slot, OrderLinkId &out);
+    WorkingOrder *find_slot(const std::string &slot);
+    const WorkingOrder *find_slot(const std::string &slot) const;
+
+    std::string symbol_;
+    Config cfg_;
+    std::vector<WorkingOrder> working_; // a handful of slots; linear scans beat hashing here
+    std::vector<OrderLinkId> orphaned_; // failed amends and cancels; cancelled on the next sync
+    std::vector<UnknownCreate> unknown_; // creates that may still land; watched by reconcile()
+    // Scratch reused across rounds. With the async gateway they stay valid until every callback of
+    // the round has run, since no new round starts while requests are in flight.
+    QuotePlan plan_;
+    std::vector<Batch> batches_;
+    bool synced_{false};
+    bool killed_{false}; // kill switch state seen by the last sync()
+    std::size_t in_flight_{0}; // async requests not yet completed
+};
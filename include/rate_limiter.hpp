@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+// Bybit v5 order endpoints with their own per-UID limit. The batch endpoints are counted per order
+// and share the bucket of their single-order counterpart.
+enum class RateEndpoint : uint8_t
+{
+    Create,    // /v5/order/create, /v5/order/create-batch
+    Amend,     // /v5/order/amend, /v5/order/amend-batch
+    Cancel,    // /v5/order/cancel, /v5/order/cancel-batch
+    CancelAll, // /v5/order/cancel-all
+};
+constexpr std::size_t kRateEndpointCount = 4;
+
+// Who goes first when tokens are short, highest first.
+enum class RatePriority : uint8_t
+{
+    Cancel, // pulling orders
+    Exit,   // market orders (take-profit / stop-loss flattening)
+    Quote,  // new and amended resting orders; never takes the reserve
+};
+
+// retCode of order calls held back locally: Bybit's own "too many visits" code, so callers handle a
+// local and an exchange-side rate-limit rejection alike.
+constexpr int kRateLimitedCode = 10006;
+
+// The X-Bapi-Limit* response headers (REST headers, or the "header" object of a trade WebSocket
+// response). -1 = header absent.
+struct RateLimitHeaders
+{
+    int64_t limit{-1};     // X-Bapi-Limit: requests allowed per window
+    int64_t remaining{-1}; // X-Bapi-Limit-Status
+    int64_t reset_ms{0};   // X-Bapi-Limit-Reset-Timestamp, epoch ms
+    bool present() const { return remaining >= 0; }
+};
+
+// Parses one "Name: value" header line into `out` if it is one of the rate-limit headers (names are
+// case-insensitive; HTTP/2 sends them lowercase). Returns true if it was.
+bool parse_rate_limit_header(std::string_view line, RateLimitHeaders &out);
+// Same, for a name and value already split apart.
+bool parse_rate_limit_header(std::string_view name, std::string_view value, RateLimitHeaders &out);
+
+// Client-side token buckets for the order endpoints, so bursts of requotes are held back here
+// instead of being rejected by the exchange (retCode 10006) exactly when quotes need to move.
+//
+// Each endpoint has a bucket refilled at orders_per_sec (Bybit's default per-UID limit for
+// linear/inverse order endpoints is 10/s), and every request also takes one token from a bucket
+// for the per-IP HTTP limit (600 requests per 5 s). The exchange's own view, from the X-Bapi-Limit*
+// headers of each response, overrides the local estimate: it resizes the bucket (VIP accounts get
+// higher limits) and an exhausted window blocks the endpoint until its reset time. Quote requests
+// may not take the last quote_reserve of either bucket, which is kept for cancels and exits.
+//
+// Thread-safe; one instance can be shared by every TradingHelper on the same account. Runs against
+// the steady clock, so backtests and benchmarks, which send orders far faster than real time to a
+// venue without limits, use a disabled one.
+class RateLimiter
+{
+public:
+    struct Config
+    {
+        double orders_per_sec{10.0}; // per endpoint, until a response says otherwise
+        double ip_per_sec{120.0};    // 600 per 5 s
+        double ip_burst{600.0};
+        double quote_reserve{0.2};   // fraction of each bucket quotes leave untouched
+        bool enabled{true};          // false: every acquire() is granted at once (replay, benchmarks)
+    };
+
+    RateLimiter() : RateLimiter(Config{}) {}
+    explicit RateLimiter(Config cfg);
+
+    // Takes `cost` tokens (orders in the request) from the endpoint and one from the IP bucket.
+    // Returns 0 when granted, otherwise the nanoseconds until it could be (nothing is taken).
+    int64_t acquire(RateEndpoint ep, uint32_t cost, RatePriority prio, int64_t now_ns);
+    // Applies the headers of a response from `ep`; wall_ms is the local epoch-ms clock, to place
+    // the reset timestamp on the steady clock.
+    void on_response(RateEndpoint ep, const RateLimitHeaders &h, int64_t now_ns, int64_t wall_ms);
+
+    // Current tokens of an endpoint's bucket, after refilling to now_ns.
+    double available(RateEndpoint ep, int64_t now_ns);
+
+    uint64_t granted() const;
+    uint64_t throttled() const; // acquire() calls answered with a wait (each retry counts)
+    uint64_t header_updates() const;
+
+private:
+    struct Bucket
+    {
+        double capacity{0.0};
+        double per_ns{0.0};
+        double tokens{0.0};
+        int64_t at_ns{0};
+        int64_t blocked_until_ns{0}; // exchange window exhausted
+    };
+
+    static void refill(Bucket &b, int64_t now_ns);
+    // ns until `cost` tokens are available above `floor`, 0 if they are now.
+    static int64_t wait_for(const Bucket &b, double cost, double floor, int64_t now_ns);
+
+    Config cfg_;
+    mutable std::mutex mu_;
+    Bucket endpoints_[kRateEndpointCount];
+    Bucket ip_;
+    uint64_t granted_{0};
+    uint64_t throttled_{0};
+    uint64_t header_updates_{0};
+};
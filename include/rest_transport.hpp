@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rate_limiter.hpp"
+
+typedef void CURL;
+typedef void CURLM;
+
+// Minimal signed Bybit v5 REST transport for endpoints bybit::RestClient does not expose
+// (e.g. /v5/order/amend-batch) and for the async order gateway. Reuses libcurl handles, so TCP/TLS
+// connections stay alive between calls. Throws std::runtime_error on transport failures.
+//
+// Connections can be opened ahead of the first request (warm(), warm_pool()) and kept from going
+// cold while idle (keep_warm()): a public GET /v5/market/time refreshes them before either end's
+// idle timeout, so an order after a quiet spell does not pay a new TCP + TLS handshake. Connection
+// setup and request times are recorded as the http_connect / http_request latency stages.
+class RestTransport
+{
+public:
+    struct Stats
+    {
+        uint64_t requests{0};   // API requests (warm-ups excluded)
+        uint64_t connects{0};   // new connections, warm-ups included
+        int64_t connect_ns{0};  // summed TCP + TLS setup time of those connections
+        int64_t request_ns{0};  // summed request time, connection setup included
+    };
+
+    // One request of a post_many() round.
+    struct PostRequest
+    {
+        std::string path;
+        std::string body;
+        // Filled by post_many().
+        long status{0};
+        std::string response;
+        std::string error; // non-empty on transport failure
+        RateLimitHeaders limits;
+    };
+
+    RestTransport(std::string api_key, std::string api_secret, std::string base_url, long recv_window_ms = 5000);
+    ~RestTransport();
+
+    RestTransport(const RestTransport &) = delete;
+    RestTransport &operator=(const RestTransport &) = delete;
+
+    // Signed POST of a JSON body; returns the raw response body. `limits`, if given, receives the
+    // response's rate-limit headers.
+    std::string post(const std::string &path, const std::string &body, RateLimitHeaders *limits = nullptr);
+    // Signed GET; query is the already-encoded query string without '?'.
+    std::string get(const std::string &path, const std::string &query);
+
+    // Sends independent signed POSTs concurrently over a curl multi handle (HTTP/2 multiplexed on one
+    // connection when the server supports it, parallel keep-alive connections otherwise) and waits
+    // for all of them. Never throws for per-request failures; see PostRequest::error.
+    void post_many(std::vector<PostRequest> &requests);
+
+    // Opens (or refreshes) the connection post()/get() use. False if the server was unreachable;
+    // any HTTP answer counts as reached.
+    bool warm();
+    // Same for the post_many() pool: `handles` concurrent requests (0 = as many as the pool has), so
+    // HTTP/2 opens its one multiplexed connection and HTTP/1.1 up to `handles` of them.
+    bool warm_pool(std::size_t handles);
+    // Re-warms whichever of the two has been used or warmed before and sat idle for `idle`. Cheap
+    // when there is nothing to do; call it from the thread issuing the requests while it is idle,
+    // since a warm-up holds the connection for a round trip.
+    void keep_warm(std::chrono::milliseconds idle = kKeepWarmIdle);
+
+    Stats stats() const;
+
+    static constexpr std::chrono::milliseconds kKeepWarmIdle{15000};
+
+    // Lowercase hex HMAC-SHA256, as used by every Bybit v5 signature (REST and WebSocket auth).
+    static std::string hmac_sha256_hex(const std::string &secret, const std::string &payload);
+
+private:
+    std::string perform(const std::string &url, const std::string *body, const std::string &sign_payload,
+                        RateLimitHeaders *limits = nullptr);
+    std::string sign(const std::string &payload) const;
+    void *signed_headers(const std::string &sign_payload) const; // curl_slist*
+    void configure(CURL *handle) const;
+    void grow_pool(std::size_t n); // multi_mu_ held
+    void run_multi();              // multi_mu_ held; until every added handle is done
+    // Connection and timing info of a finished transfer.
+    void record(CURL *handle, bool warm_up);
+
+    std::string api_key_;
+    std::string api_secret_;
+    std::string base_url_;
+    long recv_window_ms_;
+    std::mutex mu_; // a curl easy handle must not be used concurrently
+    CURL *curl_{nullptr};
+
+    std::mutex multi_mu_;
+    CURLM *multi_{nullptr};
+    std::vector<CURL *> multi_pool_; // reused easy handles for post_many()
+
+    std::atomic<int64_t> used_ns_{0};      // last request or warm-up on curl_ (0 = never)
+    std::atomic<int64_t> pool_used_ns_{0}; // same for the pool
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> connects_{0};
+    std::atomic<int64_t> connect_ns_{0};
+    std::atomic<int64_t> request_ns_{0};
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "fixed_point.hpp"
+#include "order_request.hpp"
+#include "order_store.hpp"
+
+// Why the RiskEngine refused an order (Ok = accepted).
+enum class RiskCheck : uint8_t
+{
+    Ok,
+    KillSwitch,      // kill switch tripped; only orders that reduce the position pass (see check_new)
+    UnknownSymbol,   // symbol not registered with the engine
+    NoReference,     // no mid yet, so bands and notional caps cannot be evaluated
+    OrderSize,       // qty above max_order_notional at the current mid
+    FatFinger,       // limit price through the mid by more than fat_finger_bps
+    PriceBand,       // limit price further than price_band_bps from the mid
+    WorkingNotional, // open notional on the order's side would exceed max_working_notional
+    Position,        // position + open orders on that side + this order beyond max_position_notional
+    MessageRate,     // creates/amends above max_msgs_per_sec
+};
+constexpr std::size_t kRiskCheckCount = 10;
+
+const char *risk_check_name(RiskCheck c);
+
+// retExtInfo code of orders refused locally, in the batch responses TradingHelper synthesizes.
+constexpr int kRiskRejectCode = -1;
+
+// Pre-trade checks in front of every create and amend. Everything a check compares against is kept
+// precomputed in 1e-8 fixed point: price bands and quantity caps are re-derived once per mid update
+// (set_mid), working exposure arrives as deltas from the OrderStore, the position from the private
+// stream. A check is then a symbol lookup plus a handful of integer compares, with no locks and no
+// allocation.
+//
+// Threading: configure()/add_symbol() before trading starts; set_mid() and the check_*() calls from
+// the one thread sending orders. set_position(), kill() and the exposure updates are atomic and may
+// come from any thread.
+class RiskEngine : public IOrderExposureSink
+{
+public:
+    // Notionals in quote currency, bands in basis points of the mid; 0 disables a check.
+    struct Limits
+    {
+        double max_order_notional{0.0};    // order size, as qty * mid
+        double max_working_notional{0.0};  // open orders per side, at their limit prices
+        double max_position_notional{0.0}; // |position + open orders on one side| * mid
+        double price_band_bps{0.0};        // limit price within mid +- band
+        double fat_finger_bps{0.0};        // buys at most this far above mid, sells this far below
+    };
+
+    struct Config
+    {
+        Limits limits;                // applied to every symbol added without its own
+        double max_msgs_per_sec{0.0}; // creates + amends over all symbols; bursts up to one second's worth
+    };
+
+    struct Exposure
+    {
+        Qty position; // net, long - short
+        Qty open_buy;
+        Qty open_sell;
+        int64_t open_buy_notional{0}; // 1e-8 units
+        int64_t open_sell_notional{0};
+    };
+
+    static constexpr std::size_t kMaxSymbols = 64;
+
+    RiskEngine() = default;
+    explicit RiskEngine(Config cfg) { configure(cfg); }
+
+    RiskEngine(const RiskEngine &) = delete;
+    RiskEngine &operator=(const RiskEngine &) = delete;
+
+    void configure(Config cfg);
+    // Returns the symbol's index (the existing one if already added). Throws once kMaxSymbols are in use.
+    int add_symbol(std::string_view symbol);
+    int add_symbol(std::string_view symbol, const Limits &limits);
+    int symbol_index(std::string_view symbol) const;
+    // False until a symbol is added; TradingHelper skips the checks entirely until then.
+    bool enabled() const { return count_ > 0; }
+
+    // Re-derives the symbol's bands and quantity caps; call on every book update the strategy acts on.
+    void set_mid(int index, Price mid);
+    void set_position(std::string_view symbol, Qty net);
+
+    // New limit or market order. An accepted order takes a message-rate token. While killed, a market
+    // order that does not cross the position through zero passes however much rests on its side.
+    RiskCheck check_new(const OrderRequest &req, int64_t now_ns);
+    // Amend of a working order; `current` is its OrderStore record (side, price, qty, filled qty).
+    // Refused outright while the kill switch is tripped.
+    RiskCheck check_amend(const OrderRequest &req, const OrderRecord &current, int64_t now_ns);
+
+    // Manual or automatic (e.g. loss limit) stop: from any thread.
+    void kill() { killed_.store(true, std::memory_order_release); }
+    void reset_kill() { killed_.store(false, std::memory_order_release); }
+    bool killed() const { return killed_.load(std::memory_order_acquire); }
+
+    Exposure exposure(int index) const;
+    uint64_t accepted() const { return accepted_.load(std::memory_order_relaxed); }
+    uint64_t refused(RiskCheck c) const { return refused_[static_cast<std::size_t>(c)].load(std::memory_order_relaxed); }
+    uint64_t refused_total() const;
+
+    void on_exposure(std::string_view symbol, bool is_buy, int64_t open_qty, int64_t open_notional) override;
+
+private:
+    // Thresholds derived from the mid, written and read only by the order thread.
+    struct Bands
+    {
+        int64_t mid{0};
+        int64_t band_lo{0};
+        int64_t band_hi{0};
+        int64_t buy_max{0};  // fat-finger ceiling for buys
+        int64_t sell_min{0}; // fat-finger floor for sells
+        int64_t max_order_qty{0};
+        int64_t max_position_qty{0};
+    };
+
+    struct alignas(64) SymbolState
+    {
+        SymbolName symbol;
+        Limits limits;
+        int64_t max_working_notional{0}; // precomputed from limits
+        bool needs_mid{false};           // some limit is relative to the mid
+        Bands bands;
+        // Written by other threads; kept off the line above.
+        alignas(64) std::atomic<int64_t> position{0};
+        std::atomic<int64_t> open_qty[2]{};      // [buy, sell]
+        std::atomic<int64_t> open_notional[2]{}; // [buy, sell]
+    };
+
+    SymbolState *find(std::string_view symbol);
+    const SymbolState *find(std::string_view symbol) const;
+    // open_delta/notional_delta: how much this order adds to its side's open qty/notional.
+    RiskCheck check(SymbolState &s, bool is_buy, bool limit, int64_t price, int64_t qty, int64_t open_delta,
+                    int64_t notional_delta, int64_t now_ns);
+    bool take_token(int64_t now_ns);
+    RiskCheck refuse(RiskCheck c);
+
+    Config cfg_;
+    SymbolState symbols_[kMaxSymbols];
+    std::size_t count_{0};
+    std::atomic<bool> killed_{false};
+    // Token bucket in nanoseconds of credit: each message costs 1e9 / max_msgs_per_sec.
+    int64_t msg_cost_ns_{0};
+    int64_t credit_ns_{0};
+    int64_t credit_at_ns_{0};
+    // Single writer (the order thread); atomics so reporting threads can read them.
+    std::atomic<uint64_t> accepted_{0};
+    std::atomic<uint64_t> refused_[kRiskCheckCount]{};
+};
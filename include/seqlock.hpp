@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer seqlock publishing a trivially copyable value to any number of readers.
+// Readers never block the writer and never allocate; they retry only if they overlap a write.
+// The payload is stored as relaxed atomic words so concurrent reads are well-defined.
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock()
+    {
+        T init{};
+        store(init);
+    }
+
+    // Writer side. Must only be called from one thread at a time.
+    void store(const T &value)
+    {
+        uint64_t buf[kWords] = {};
+        std::memcpy(buf, &value, sizeof(T));
+        const uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < kWords; ++i)
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // Reader side: copies a consistent value into out.
+    void load(T &out) const
+    {
+        uint64_t buf[kWords];
+        for (;;)
+        {
+            const uint64_t s1 = seq_.load(std::memory_order_acquire);
+            if (s1 & 1)
+                continue;
+            for (std::size_t i = 0; i < kWords; ++i)
+                buf[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == s1)
+                break;
+        }
+        std::memcpy(&out, buf, sizeof(T));
+    }
+
+    // Number of completed writes; changes whenever a new value is published.
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) >> 1; }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> words_[kWords];
+};
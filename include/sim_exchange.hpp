@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "order_book.hpp"
+#include "order_store.hpp"
+#include "strategy.hpp"
+#include "trade_transport.hpp"
+#include "ws_message_parser.hpp"
+
+struct SimFill
+{
+    int64_t time_ns{0};
+    std::string order_link_id;
+    bool is_buy{false};
+    bool maker{true};
+    Price price;
+    Qty qty;
+    double fee{0.0}; // quote currency, negative for a rebate
+    int position_idx{0};
+    std::string order_id;
+    double closed_pnl{0.0}; // realized by this fill (closing part only, before fees)
+};
+
+// Sees what the private order/execution streams would carry, in order, after the OrderStore does.
+class ISimListener
+{
+public:
+    virtual ~ISimListener() = default;
+    virtual void on_order(const OrderUpdate &update, int position_idx) = 0;
+    virtual void on_fill(const SimFill &fill) = 0;
+};
+
+// Single-symbol matching simulator for backtests. Order entry takes the same v5 ops and args as
+// ITradeTransport and answers immediately; the order reaches the book after ack_latency_ns and a
+// cancel takes effect after cancel_latency_ns. Order events are published to the OrderStore the
+// same way the private order stream would.
+//
+// Fill model: a resting order joins the back of its level, behind the displayed quantity. Trades
+// at our price consume the queue ahead first and then fill us (partially if they are small);
+// trades through our price, or the opposite side moving onto it, fill the remainder. The queue
+// ahead otherwise only shrinks when the displayed level drops below it. Orders that cross on
+// arrival take liquidity from the displayed book and pay the taker fee. Our own orders never
+// change the recorded book.
+class SimExchange
+{
+public:
+    struct Config
+    {
+        InstrumentMeta meta;
+        int64_t ack_latency_ns{5000000};
+        int64_t cancel_latency_ns{5000000};
+        double maker_fee_bps{2.0};
+        double taker_fee_bps{5.5};
+    };
+
+    SimExchange(std::string symbol, Config cfg, OrderStore &orders);
+
+    // Optional; called from whichever call produced the event.
+    void set_listener(ISimListener *listener) { listener_ = listener; }
+
+    // v5 order op with its JSON args; returns a REST-shaped response body.
+    std::string request(const std::string &op, const std::string &args_json);
+
+    // Move the clock to now_ns, applying order events that have become due (against the last book).
+    void advance(int64_t now_ns);
+    // Market data at now_ns; both advance the clock first. on_book takes the book after the update.
+    void on_book(int64_t now_ns, const BookSnapshot &book);
+    void on_trade(int64_t now_ns, const PublicTrade &trade);
+
+    // Hedge-mode view: positionIdx 1 is the long leg, 2 the short leg, 0 (one-way) maps to either.
+    PositionView position() const;
+    double net_qty() const;
+    double realized_pnl() const { return realized_; }
+    double fees() const { return fees_; }
+    double unrealized_pnl(double mark) const;
+    double traded_notional() const { return notional_; }
+
+    const std::vector<SimFill> &fills() const { return fills_; }
+    std::size_t open_orders() const { return orders_.size(); }
+    int64_t now_ns() const { return now_ns_; }
+
+private:
+    struct Order
+    {
+        std::string link;
+        std::string order_id;
+        bool is_buy{false};
+        bool market{false};
+        bool post_only{false};
+        bool active{false}; // reached the book
+        bool done{false};   // terminal; dropped by sweep()
+        Price price;
+        Qty qty;
+        Qty filled;
+        Qty queue_ahead;
+        double filled_notional{0.0};
+        int position_idx{0};
+    };
+
+    enum class EventKind : uint8_t
+    {
+        Activate,
+        Amend,
+        Cancel,
+    };
+
+    struct Event
+    {
+        int64_t due_ns{0};
+        EventKind kind{EventKind::Activate};
+        std::string link;
+        Price price;
+        Qty qty;
+    };
+
+    struct Leg
+    {
+        double size{0.0};
+        double entry{0.0};
+    };
+
+    int create(const nlohmann::json &args, std::string &order_id);
+    int amend(const nlohmann::json &args);
+    int cancel(const nlohmann::json &args);
+    void schedule(Event ev);
+    void apply(const Event &ev);
+
+    Order *find(const std::string &link);
+    // Displayed quantity at price on the order's side, or -1 if the price is outside the snapshot.
+    int64_t level_qty(bool is_buy, Price price) const;
+    // Cross the displayed opposite side up to the order's limit (no limit for market orders).
+    void take(Order &o);
+    void fill(Order &o, Price price, Qty qty, bool maker);
+    // Publish the order's state to the store; terminal states mark it done.
+    void publish(Order &o, OrderState state);
+    void sweep();
+    void book_position(int position_idx, bool is_buy, double price, double qty);
+
+    std::string symbol_;
+    Config cfg_;
+    OrderStore &store_;
+    ISimListener *listener_{nullptr};
+    int64_t now_ns_{0};
+    uint64_t next_order_id_{0};
+    BookSnapshot book_;
+    std::vector<Order> orders_; // working orders, in arrival order (a handful at a time)
+    std::vector<Event> events_; // sorted by due_ns, FIFO among equal times
+    std::vector<SimFill> fills_;
+    Leg long_;
+    Leg short_;
+    double realized_{0.0};
+    double fees_{0.0};
+    double notional_{0.0};
+};
+
+// ITradeTransport over a SimExchange, so TradingHelper and QuoteManager run unchanged in backtests.
+class SimTradeTransport : public ITradeTransport
+{
+public:
+    explicit SimTradeTransport(SimExchange &exchange) : exchange_(exchange) {}
+
+    bool ready() const override { return true; }
+    std::string request(const std::string &op, const std::string &args_json) override { return exchange_.request(op, args_json); }
+    bool supports_cancel_all() const override { return true; }
+
+private:
+    SimExchange &exchange_;
+};
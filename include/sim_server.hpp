@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "feed_record.hpp"
+#include "sim_venue.hpp"
+
+namespace ix
+{
+    class ConnectionState;
+    class HttpServer;
+    class WebSocket;
+    class WebSocketServer;
+}
+
+// Localhost Bybit stand-in: SimVenue behind an HTTP server (REST) and a WebSocket server that
+// serves /v5/public/linear, /v5/private and /v5/trade on one port. Point BYBIT_BASE_URL and the
+// BYBIT_WS_*_URL variables at rest_url()/ws_url() and the unmodified binaries trade against it.
+//
+// The recordings are replayed on their own thread at `speed` times their recorded pace, starting
+// when the first public session subscribes so every client sees the tape from the beginning.
+// After the tape ends the book stays where it was and the clock keeps running.
+class SimServer
+{
+public:
+    struct Config
+    {
+        std::string symbol;
+        std::vector<std::string> files; // replayed in the given order
+        SimVenue::Config venue;
+        std::string host{"127.0.0.1"};
+        int rest_port{18080};
+        int ws_port{18081};
+        double speed{1.0}; // <= 0 replays as fast as possible
+    };
+
+    explicit SimServer(Config cfg);
+    ~SimServer();
+
+    SimServer(const SimServer &) = delete;
+    SimServer &operator=(const SimServer &) = delete;
+
+    // Opens the recordings, binds both ports and starts replaying. Throws std::runtime_error on failure.
+    void start();
+    void stop();
+
+    std::string rest_url() const;
+    std::string ws_url(const char *path) const; // e.g. "/v5/public/linear"
+
+    bool replay_done() const { return done_.load(std::memory_order_acquire); }
+    uint64_t replayed() const { return replayed_.load(std::memory_order_relaxed); }
+    SimVenue &venue() { return venue_; }
+
+private:
+    void send(uint64_t session, const std::string &text);
+    void replay();
+
+    Config cfg_;
+    SimVenue venue_;
+    std::vector<RecordFileReader> readers_;
+    std::unique_ptr<ix::HttpServer> http_;
+    std::unique_ptr<ix::WebSocketServer> ws_;
+
+    std::mutex conns_mu_; // taken inside the venue's lock by send(), never the other way round
+    std::unordered_map<uint64_t, ix::WebSocket *> conns_;
+    std::unordered_map<const ix::ConnectionState *, uint64_t> sessions_;
+    uint64_t next_session_{0};
+
+    std::thread replay_thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> done_{false};
+    std::atomic<uint64_t> replayed_{0};
+};
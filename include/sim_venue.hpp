@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "market_data_feed.hpp"
+#include "order_store.hpp"
+#include "sim_exchange.hpp"
+
+// The Bybit v5 surface the market maker uses, answered from a SimExchange and replayed market
+// data instead of the real venue. Transport-free: SimServer (sim_server.hpp) puts it on localhost
+// HTTP/WebSocket, tests call it directly.
+//
+//   REST  GET  /v5/market/instruments-info, /v5/market/tickers, /v5/market/orderbook,
+//              /v5/account/wallet-balance, /v5/position/list
+//         POST /v5/order/{create,amend,cancel}[-batch], /v5/order/cancel-all
+//   WS    public  (/v5/public/linear): orderbook.N.SYM, tickers.SYM, publicTrade.SYM
+//         private (/v5/private): order, execution, position
+//         trade   (/v5/trade): order.* ops with reqId acks
+//
+// Any credentials are accepted, but private and trade sessions must send op=auth first. Recorded
+// public messages are forwarded verbatim to sessions subscribed to the same topic; an orderbook
+// subscription at another depth gets a snapshot of the top levels after every book change. A
+// session that subscribes mid-replay first gets a snapshot of the current book (top
+// kBookSnapshotDepth levels) and ticker, so the recorded deltas that follow apply cleanly.
+//
+// Every entry point is serialized on one mutex; send is called with it held.
+class SimVenue : private ISimListener
+{
+public:
+    enum class Channel : uint8_t
+    {
+        Public,
+        Private,
+        Trade,
+    };
+
+    struct Config
+    {
+        SimExchange::Config sim;
+        double wallet_usdt{10000.0}; // starting balance reported by wallet-balance
+    };
+
+    struct HttpReply
+    {
+        int status{200};
+        std::string body;
+    };
+
+    using Sender = std::function<void(uint64_t session, const std::string &text)>;
+
+    SimVenue(std::string symbol, Config cfg, Sender send);
+
+    // Recorded public message received at now_ns (any clock, as long as it only moves forward).
+    void on_market(int64_t now_ns, std::string_view raw);
+    // Moves the exchange clock, applying order events that came due.
+    void advance(int64_t now_ns);
+
+    // target is the request path with its query string. Requests are stamped with the last
+    // on_market()/advance() time.
+    HttpReply handle_http(const std::string &method, const std::string &target, const std::string &body);
+
+    // Maps a WebSocket request path to its channel; false for paths the venue does not serve.
+    static bool channel_for_path(std::string_view path, Channel &out);
+    void open_session(uint64_t session, Channel channel);
+    void close_session(uint64_t session);
+    void handle_ws(uint64_t session, const std::string &text);
+
+    std::size_t public_sessions() const;
+    std::size_t fill_count() const;
+    double net_pnl() const; // realized - fees + unrealized at the current mid
+
+private:
+    struct Session
+    {
+        Channel channel{Channel::Public};
+        bool authed{false};
+        std::vector<std::string> topics;
+
+        bool subscribed(std::string_view topic) const;
+    };
+
+    // ISimListener, called with mu_ held.
+    void on_order(const OrderUpdate &update, int position_idx) override;
+    void on_fill(const SimFill &fill) override;
+
+    void handle_public(uint64_t id, Session &s, const nlohmann::json &req);
+    void handle_private(uint64_t id, Session &s, const nlohmann::json &req);
+    void handle_trade(uint64_t id, Session &s, const nlohmann::json &req);
+    // Snapshot message for an orderbook.N topic from the current book.
+    std::string book_snapshot_message(const std::string &topic, int depth) const;
+    std::string ticker_snapshot_message() const;
+    void push_private(const char *topic, nlohmann::json data);
+    void push_position();
+    nlohmann::json positions_json() const;
+    int64_t now_ms() const { return sim_.now_ns() / 1000000; }
+
+    const std::string symbol_;
+    const Config cfg_;
+    Sender send_;
+
+    mutable std::mutex mu_;
+    MarketDataFeed feed_; // never connected; merges the replayed messages
+    OrderStore orders_;   // SimExchange publishes here; the private stream is what clients see
+    SimExchange sim_;
+    BookSnapshot book_;
+    PublicMessage msg_;
+    uint64_t seen_seq_{0};
+    uint64_t next_push_id_{0};
+    std::unordered_map<uint64_t, Session> sessions_;
+};
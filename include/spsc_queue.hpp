@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded single-producer/single-consumer ring. push/pop are wait-free: one relaxed load of the
+// local index, one acquire load of the remote index and one release store. Capacity is rounded up
+// to a power of two. Slots are default-constructed up front and reused, so T's move assignment is
+// the only per-item cost (no allocation if T's members keep their capacity).
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(std::size_t capacity)
+    {
+        std::size_t cap = 2;
+        while (cap < capacity)
+            cap <<= 1;
+        slots_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    // Producer thread only.
+    bool try_push(T &&value)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_)
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_)
+                return false;
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer thread only: in-place alternative to try_push for large T. Returns the next free slot,
+    // or nullptr when full; the caller fills it and makes it visible to the consumer with publish().
+    T *try_claim()
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_)
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_)
+                return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+    void publish() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer thread only.
+    bool try_pop(T &out)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_)
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return false;
+        }
+        out = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate; exact only when called from producer or consumer with the other side idle.
+    std::size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return slots_.size(); }
+
+private:
+    std::vector<T> slots_;
+    std::size_t mask_{0};
+    alignas(64) std::atomic<std::size_t> head_{0}; // consumer
+    std::size_t tail_cache_{0};                    // consumer's view of tail_
+    alignas(64) std::atomic<std::size_t> tail_{0}; // producer
+    std::size_t head_cache_{0};                    // producer's view of head_
+};
@@ -1,14 +1,46 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include "quote_manager.hpp"
 #include "trading_helper.hpp"
 
 struct InstrumentMeta
 {
-    double tick_size{0.0};
-    double lot_size{0.0};
-    double min_qty{0.0};
+    Price tick_size;
+    Qty lot_size;
+    Qty min_qty;
+};
+
+// Amend tolerance: anything within tol_ticks (plus half a tick of slack) counts as unchanged.
+inline Price requote_tolerance(const InstrumentMeta &meta, double tol_ticks)
+{
+    return Price::from_raw(static_cast<int64_t>((tol_ticks + 0.5) * static_cast<double>(meta.tick_size.raw)));
+}
+
+// Ladder size scaled by inventory skew, floored to the lot step and never below the exchange minimum.
+inline Qty scaled_qty(const InstrumentMeta &meta, Qty base, double scale)
+{
+    const Qty q = Qty::from_double(base.to_double() * scale).floor_to(meta.lot_size);
+    return q < meta.min_qty ? meta.min_qty.ceil_to(meta.lot_size) : q;
+}
+
+// Stop-loss market exit of one position side. A new exit is due only once the last one was rejected
+// or cancelled, or the position size changed; a stop that stays triggered while the fill and the
+// position update are in flight must not send another exit and over-flatten.
+struct StopExit
+{
+    std::string link;
+    double size{0.0}; // position size the exit was sent for
+
+    bool due(double position_size, const OrderStore &orders) const
+    {
+        OrderState st;
+        if (link.empty() || position_size != size || !orders.state_of(link, st))
+            return true;
+        return st == OrderState::Rejected || st == OrderState::Cancelled;
+    }
 };
 
 struct PositionView
@@ -25,6 +57,9 @@ class IStrategy
 public:
     virtual ~IStrategy() = default;
     virtual void on_snapshot(const MarketDataSnapshot &snapshot, TradingHelper &helper, bool live_trading, const PositionView &pos) = 0;
+    // The exchange changed the symbol's tick size, lot size or minimum qty. Called on the strategy's
+    // thread between snapshots; quotes on the old grid are moved by the next on_snapshot().
+    virtual void on_instrument_meta(const InstrumentMeta &) {}
 };
 
 // Market-making strategy: sizes from USD budget, respects tick/lot/min, and bases spread on live spread.
@@ -42,7 +77,8 @@ public:
                                double tp_spread_bps = 0.5,
                                int ladder_levels = 3,
                                double stop_loss_bps = -1.0,
-                               double gross_notional_cap = -1.0)
+                               double gross_notional_cap = -1.0,
+                               double requote_tol_ticks = 0.0)
         : symbol_(std::move(symbol)),
           meta_(meta),
           budget_usd_(budget_usd),
@@ -54,9 +90,12 @@ public:
           tp_spread_bps_(tp_spread_bps),
           ladder_levels_(ladder_levels),
           stop_loss_bps_(stop_loss_bps),
-          gross_notional_cap_(gross_notional_cap) {}
+          gross_notional_cap_(gross_notional_cap),
+          requote_tol_ticks_(requote_tol_ticks),
+          quotes_(symbol_, QuoteManager::Config{requote_tolerance(meta, requote_tol_ticks), Qty::from_raw(meta.lot_size.raw / 2), "mm"}) {}
 
     void on_snapshot(const MarketDataSnapshot &snapshot, TradingHelper &helper, bool live_trading, const PositionView &pos) override;
+    void on_instrument_meta(const InstrumentMeta &meta) override;
 
 private:
     std::string symbol_;
@@ -64,7 +103,6 @@ private:
     double budget_usd_;
     double min_spread_bps_;
     double spread_factor_;
-    uint64_t order_counter_{0};
     int buy_pos_idx_{0};
     int sell_pos_idx_{0};
     double max_net_qty_{0.0};
@@ -72,6 +110,11 @@ private:
     int ladder_levels_{1};
     double stop_loss_bps_{-1.0};
     double gross_notional_cap_{-1.0};
+    double requote_tol_ticks_{0.0};
+    QuoteManager quotes_;
+    std::vector<DesiredQuote> desired_;
+    StopExit long_exit_;
+    StopExit short_exit_;
 };
 
 // Long-only variant: bids only, TP sells, optional stop-loss and gross cap.
@@ -89,7 +132,8 @@ public:
                                 double tp_spread_bps = 0.5,
                                 int ladder_levels = 3,
                                 double stop_loss_bps = -1.0,
-                                double gross_notional_cap = -1.0)
+                                double gross_notional_cap = -1.0,
+                                double requote_tol_ticks = 0.0)
         : symbol_(std::move(symbol)),
           meta_(meta),
           budget_usd_(budget_usd),
@@ -101,9 +145,12 @@ public:
           tp_spread_bps_(tp_spread_bps),
           ladder_levels_(ladder_levels),
           stop_loss_bps_(stop_loss_bps),
-          gross_notional_cap_(gross_notional_cap) {}
+          gross_notional_cap_(gross_notional_cap),
+          requote_tol_ticks_(requote_tol_ticks),
+          quotes_(symbol_, QuoteManager::Config{requote_tolerance(meta, requote_tol_ticks), Qty::from_raw(meta.lot_size.raw / 2), "mmlo"}) {}
 
     void on_snapshot(const MarketDataSnapshot &snapshot, TradingHelper &helper, bool live_trading, const PositionView &pos) override;
+    void on_instrument_meta(const InstrumentMeta &meta) override;
 
 private:
     std::string symbol_;
@@ -111,7 +158,6 @@ private:
     double budget_usd_;
     double min_spread_bps_;
     double spread_factor_;
-    uint64_t order_counter_{0};
     int buy_pos_idx_{0};
     int sell_pos_idx_{0};
     double max_net_qty_{0.0};
@@ -119,4 +165,8 @@ private:
     int ladder_levels_{1};
     double stop_loss_bps_{-1.0};
     double gross_notional_cap_{-1.0};
+    double requote_tol_ticks_{0.0};
+    QuoteManager quotes_;
+    std::vector<DesiredQuote> desired_;
+    StopExit long_exit_;
 };
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "latency_stats.hpp"
+#include "market_data_feed.hpp"
+#include "trading_helper.hpp"
+
+// Wakes the strategy as soon as the feed publishes new data for its symbol, instead of polling on
+// a fixed sleep. Updates arriving while the strategy is busy are coalesced: the next dispatch sees
+// only the latest book/ticker. A minimum re-quote interval throttles dispatch unless the mid has
+// moved by at least urgent_mid_move since the last dispatch.
+class StrategyDispatcher
+{
+public:
+    struct Config
+    {
+        std::chrono::microseconds min_requote_interval{std::chrono::milliseconds{250}};
+        std::chrono::microseconds idle_timeout{std::chrono::seconds{1}};
+        double urgent_mid_move{0.0}; // absolute price move that bypasses the interval (0 = never)
+    };
+
+    StrategyDispatcher(MarketDataFeed &feed, std::string symbol, Config cfg);
+
+    // Fill snap with the latest state and return true when the strategy should run. Returns false
+    // if no valid data arrived within idle_timeout, so the caller can do housekeeping.
+    bool next(MarketDataSnapshot &snap);
+
+    // Non-blocking variant for a thread that multiplexes several symbols (StrategyShard): looks only
+    // at this symbol's updates and returns true, with snap filled, when the strategy should run now.
+    // If an update is pending but throttled, wake_at is lowered to when it becomes due.
+    bool poll(MarketDataSnapshot &snap, std::chrono::steady_clock::time_point now,
+              std::chrono::steady_clock::time_point &wake_at);
+
+    // E.g. when the drift threshold is expressed in ticks and the tick size changed.
+    void set_urgent_mid_move(double move) { cfg_.urgent_mid_move = move; }
+
+    // Receive time (steady_clock ns) of the newest book/ticker in the last dispatch.
+    int64_t origin_ns() const { return origin_ns_; }
+    // Feed updates folded into a later dispatch since the last reset_stats().
+    uint64_t coalesced() const { return coalesced_; }
+    void reset_stats();
+
+private:
+    bool read_latest(MarketDataSnapshot &snap);
+    bool is_urgent(double mid) const;
+    void dispatched(const MarketDataSnapshot &snap);
+
+    MarketDataFeed &feed_;
+    std::string symbol_;
+    int index_; // feed symbol index; resolved once, the feed must be prepared first
+    Config cfg_;
+    uint64_t seen_seq_{0};
+    uint64_t seen_symbol_seq_{0}; // poll() only
+    bool pending_{false};         // poll(): an update arrived but was throttled
+    uint64_t coalesced_{0};
+    double last_mid_{0.0};
+    std::chrono::steady_clock::time_point last_dispatch_{};
+    int64_t origin_ns_{0};
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "market_data_feed.hpp"
+#include "strategy.hpp"
+#include "strategy_dispatcher.hpp"
+#include "thread_affinity.hpp"
+#include "trading_helper.hpp"
+
+// A worker thread quoting a fixed group of symbols off the shared MarketDataFeed. Each symbol has
+// its own strategy, dispatcher (throttle derived from its InstrumentMeta) and position; the group
+// shares one TradingHelper, so order connections and gateway threads scale with the number of
+// shards rather than the number of symbols.
+class StrategyShard
+{
+public:
+    struct Config
+    {
+        int id{0};
+        ThreadRole thread; // worker name, CPU pinning and SCHED_FIFO priority
+        // Spin on the feed sequence instead of sleeping on its condition variable: no futex wake-up
+        // per update, at the cost of one fully busy core per shard.
+        bool busy_poll{false};
+        bool live{false};
+        StrategyDispatcher::Config dispatch;
+        double drift_threshold_ticks{2.0}; // per-symbol urgent_mid_move, in that symbol's ticks
+        RiskEngine::Config risk;           // pre-trade limits for every symbol of the shard
+        std::chrono::seconds report_interval{1};
+    };
+
+    StrategyShard(Config cfg, MarketDataFeed &feed, std::unique_ptr<TradingHelper> helper);
+    ~StrategyShard();
+
+    StrategyShard(const StrategyShard &) = delete;
+    StrategyShard &operator=(const StrategyShard &) = delete;
+
+    // Before start() only; the feed must already have been prepared/started with the symbol.
+    void add_symbol(const std::string &symbol, const InstrumentMeta &meta, std::unique_ptr<IStrategy> strategy);
+    void start();
+    // Joins the worker; it notices within one idle timeout.
+    void stop();
+
+    int id() const { return cfg_.id; }
+    std::vector<std::string> symbols() const;
+    TradingHelper &helper() { return *helper_; }
+
+    // Private-stream routing, safe from any thread. A position message replaces the listed sides of
+    // its symbol; clear_position() comes first so a side missing from the message reads as flat.
+    // The net position is also handed to the helper's RiskEngine.
+    void clear_position(const std::string &symbol);
+    void set_position(const std::string &symbol, const std::string &side, double size, double entry);
+    PositionView position(const std::string &symbol) const;
+    // New instrument filters for a symbol, safe from any thread: the worker hands them to the
+    // strategy (IStrategy::on_instrument_meta) and rescales the drift threshold before its next dispatch.
+    void update_meta(const std::string &symbol, const InstrumentMeta &meta);
+
+    // Trips the helper's kill switch, safe from any thread. A live worker then cancels everything on
+    // its symbols before the next dispatch, so quotes rest no longer than one loop even when no
+    // book update arrives.
+    void kill();
+
+    // Set when a strategy threw; the worker has stopped and error() says why.
+    bool failed() const { return failed_.load(std::memory_order_acquire); }
+    const std::string &error() const { return error_; }
+    uint64_t dispatches() const { return dispatches_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        Slot(MarketDataFeed &feed, const std::string &symbol, StrategyDispatcher::Config dispatch,
+             std::unique_ptr<IStrategy> strategy);
+
+        std::unique_ptr<IStrategy> strategy;
+        StrategyDispatcher dispatcher;
+        int risk_index{-1};
+        MarketDataSnapshot snap;
+        mutable std::mutex pos_mu; // written by the private WS thread
+        PositionView pos;
+        std::mutex meta_mu; // pending_meta is written by the instrument refresh thread
+        InstrumentMeta pending_meta;
+        std::atomic<bool> meta_pending{false};
+    };
+
+    void run();
+    void apply_pending_meta(Slot &slot);
+    void report(std::chrono::steady_clock::time_point now);
+    void cancel_all_symbols();
+    Slot *find(const std::string &symbol) const;
+
+    Config cfg_;
+    MarketDataFeed &feed_;
+    std::unique_ptr<TradingHelper> helper_;
+    std::vector<std::unique_ptr<Slot>> slots_; // fixed once started
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> failed_{false};
+    std::atomic<bool> kill_pending_{false};
+    std::atomic<uint64_t> dispatches_{0};
+    std::string error_;
+    uint64_t report_dispatches_{0};
+    uint64_t reported_refusals_{0};
+    std::chrono::steady_clock::time_point last_report_{};
+    std::thread worker_;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+// Dense id of an interned symbol: index into the flat per-symbol arrays of the feed, PnL tracker
+// and private-stream routing.
+using SymbolId = uint16_t;
+constexpr SymbolId kNoSymbol = 0xFFFF;
+
+// Process-wide symbol -> SymbolId map. Symbols are interned once, when they are configured or
+// subscribed; message handlers then resolve the symbol field of each message with find(), a
+// lock-free probe of a fixed open-addressed table (no allocation), and index arrays with the id
+// from there on. Ids are assigned 0, 1, 2, ... in interning order and never reused.
+class SymbolTable
+{
+public:
+    static constexpr std::size_t kCapacity = 4096;
+    static constexpr std::size_t kMaxLength = 23;
+
+    static SymbolTable &global();
+
+    // The symbol's id, assigning the next one on first use. Thread-safe. Throws std::invalid_argument
+    // for an empty or over-long symbol and std::length_error once kCapacity symbols are interned.
+    SymbolId intern(std::string_view symbol);
+    // kNoSymbol if the symbol was never interned. Lock-free; safe concurrently with intern().
+    SymbolId find(std::string_view symbol) const;
+    // Empty for an unknown id.
+    std::string_view name(SymbolId id) const;
+    // Ids in use are [0, size()).
+    std::size_t size() const { return size_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::size_t kSlots = kCapacity * 2; // load factor <= 0.5
+    static uint32_t hash(std::string_view s);
+
+    struct Name
+    {
+        char text[kMaxLength + 1];
+        uint8_t length;
+    };
+
+    std::mutex mu_; // writers
+    std::atomic<std::size_t> size_{0};
+    Name names_[kCapacity]{};
+    std::atomic<uint16_t> slots_[kSlots]{}; // id + 1, 0 = empty
+};
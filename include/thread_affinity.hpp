@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Placement and scheduling for one latency-critical thread (feed callback, strategy shard, ...).
+struct ThreadRole
+{
+    std::string name;     // thread name (first 15 chars), shown by top -H / perf
+    int cpu{-1};          // pin to this CPU; -1 leaves placement to the scheduler
+    int fifo_priority{0}; // SCHED_FIFO priority 1-99; 0 keeps the default policy
+
+    bool active() const { return cpu >= 0 || fifo_priority > 0; }
+};
+
+// Pin the calling thread to one CPU. Returns false if the CPU is invalid or pinning is unsupported.
+bool pin_current_thread(int cpu);
+// Switch the calling thread to SCHED_FIFO. Returns false without CAP_SYS_NICE / RLIMIT_RTPRIO.
+bool set_current_thread_fifo(int priority);
+// Name, pin and prioritise the calling thread. Each failed step is logged once and skipped, so a
+// config written for an isolated production box still runs on a laptop. Returns true if all applied.
+bool apply_thread_role(const ThreadRole &role);
+
+// For threads we don't create (WebSocket client callbacks): ensure() applies the role the first time
+// it runs on a thread, and again if the client moves its callbacks to a new thread on reconnect.
+// Tracked per thread rather than by thread id, which the OS reuses once a thread has exited.
+class LazyThreadRole
+{
+public:
+    void set(ThreadRole role) { role_ = std::move(role); }
+    void ensure()
+    {
+        if (tl_applied_ == this || !role_.active())
+            return;
+        apply_thread_role(role_);
+        tl_applied_ = this;
+    }
+
+private:
+    ThreadRole role_;
+    inline static thread_local const LazyThreadRole *tl_applied_ = nullptr;
+};
+
+// Pre-fault `heap_bytes` of heap and `stack_bytes` of the calling thread's stack, stop malloc from
+// returning memory to the kernel, then mlockall(current | future) so the hot path never takes a page
+// fault. Call once at startup before spawning threads. Returns false (and logs) if locking is not
+// permitted, e.g. RLIMIT_MEMLOCK too low; the pre-faulting still happens.
+bool lock_process_memory(std::size_t heap_bytes, std::size_t stack_bytes);
+
+// Spin-wait hint: yields to the sibling hyperthread and avoids the memory-order mis-speculation
+// penalty when the spin exits.
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
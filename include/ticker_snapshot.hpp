@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// Typed view of the Bybit tickers.* stream. Linear tickers arrive as a snapshot followed by
+// deltas carrying only changed fields, so the feed merges into this struct before publishing.
+struct TickerSnapshot
+{
+    double last_price{0.0};
+    double mark_price{0.0};
+    double index_price{0.0};
+    double bid1_price{0.0};
+    double bid1_size{0.0};
+    double ask1_price{0.0};
+    double ask1_size{0.0};
+    double funding_rate{0.0};
+    double open_interest{0.0};
+    double volume_24h{0.0};
+    double turnover_24h{0.0};
+    int64_t next_funding_time_ms{0};
+    int64_t ts_ms{0};
+    int64_t recv_ns{0}; // local steady_clock receive time
+    uint64_t updates{0}; // messages merged so far; 0 means no data yet
+
+    bool valid() const { return updates > 0; }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// Order-entry path that TradingHelper prefers over REST when installed. request() takes a v5 trade
+// op ("order.create", "order.amend", "order.cancel", "order.create-batch", "order.amend-batch",
+// "order.cancel-batch") with its args object as JSON text (identical to the REST body of the matching
+// endpoint) and returns a REST-shaped response body
+// ({retCode, retMsg, result, retExtInfo}, plus the ack's "header" object of X-Bapi-Limit* values
+// when it has one). Throws std::runtime_error if the request could not be
+// completed; TradingHelper then retries amends and cancels over REST, and cancels creates by
+// orderLinkId (they may have gone through).
+class ITradeTransport
+{
+public:
+    virtual ~ITradeTransport() = default;
+
+    virtual bool ready() const = 0;
+    virtual std::string request(const std::string &op, const std::string &args_json) = 0;
+    // The trade WebSocket has no cancel-all; transports that do accept "order.cancel-all" (args as
+    // the /v5/order/cancel-all body) say so here.
+    virtual bool supports_cancel_all() const { return false; }
+};
+
+// Order fields as a v5 JSON object: positionIdx is an integer in the API, everything else a string.
+inline nlohmann::json order_fields_json(const std::vector<std::pair<std::string, std::string>> &fields)
+{
+    nlohmann::json obj = nlohmann::json::object();
+    for (const auto &kv : fields)
+    {
+        if (kv.first == "positionIdx")
+            obj[kv.first] = std::atoi(kv.second.c_str());
+        else
+            obj[kv.first] = kv.second;
+    }
+    return obj;
+}
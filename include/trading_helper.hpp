@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -7,14 +8,31 @@
 #include <nlohmann/json.hpp>
 #include <bybit/rest_client.hpp>
 
+#include "order_book.hpp"
+#include "order_gateway.hpp"
+#include "order_request.hpp"
+#include "order_store.hpp"
+#include "rate_limiter.hpp"
+#include "rest_transport.hpp"
+#include "risk_engine.hpp"
+#include "trade_transport.hpp"
+#include "ticker_snapshot.hpp"
+
 struct MarketDataSnapshot
 {
   std::string symbol;
-  nlohmann::json ticker;    // raw ticker JSON
-  nlohmann::json orderbook; // raw orderbook JSON
+  nlohmann::json ticker;    // raw ticker JSON (REST snapshots only)
+  nlohmann::json orderbook; // raw orderbook JSON (REST snapshots only)
+  BookSnapshot book;        // typed top of book; what strategies should read
+  TickerSnapshot tick;      // typed ticker (WS feed only)
 };
 
-// TradingHelper wraps bybit::RestClient to provide typed helpers for strategies.
+// retCode of creates that were cancelled by orderLinkId after the trade transport lost their ack.
+// The create itself may still reach the exchange after that cancel.
+constexpr int kUnknownOutcomeCode = -2;
+
+// TradingHelper wraps bybit::RestClient to provide typed helpers for strategies. Order entry can be
+// routed through an ITradeTransport (e.g. the trade WebSocket) with automatic fallback to REST.
 class TradingHelper
 {
 public:
@@ -53,14 +71,131 @@ public:
   // Batch order submission - all orders in one request
   std::string batch_submit_orders(const std::vector<std::vector<std::pair<std::string, std::string>>> &order_requests);
   std::string batch_cancel_orders(const std::vector<std::vector<std::pair<std::string, std::string>>> &cancel_requests);
+  // Batch amend (price/qty) of working orders identified by orderId or orderLinkId.
+  std::string batch_amend_orders(const std::vector<std::vector<std::pair<std::string, std::string>>> &amend_requests);
+
+  // Typed batch calls (at most 10 orders, one symbol). Bodies are encoded straight into a reused
+  // buffer, so building a request does not allocate. Same routing as above.
+  std::string batch_submit_orders(const OrderRequest *reqs, std::size_t n);
+  std::string batch_amend_orders(const OrderRequest *reqs, std::size_t n);
+  std::string batch_cancel_orders(const OrderRequest *reqs, std::size_t n);
 
   bool has_credentials() const { return has_keys_; }
 
+  // Prefer this transport for create/amend/cancel (cancel_all only if it supports_cancel_all()); REST
+  // is used whenever it is not ready or a request through it fails.
+  void set_trade_transport(std::unique_ptr<ITradeTransport> transport);
+  bool has_trade_transport() const { return trade_transport_ != nullptr; }
+  uint64_t trade_fallbacks() const { return trade_fallbacks_; }
+
+  // Receive time (steady_clock ns) of the market data the strategy is reacting to; typed batch
+  // sends and async requests made until it is cleared (0) report tick-to-trade latency.
+  void set_tick_origin(int64_t recv_ns) { tick_origin_ns_ = recv_ns; }
+
+  // Our own orders, updated from REST acknowledgements here and from the private order stream.
+  OrderStore &orders() { return orders_; }
+  const OrderStore &orders() const { return orders_; }
+
+  // Pre-trade risk checks on every create and amend sent through this helper (typed, string and async
+  // calls alike) once a symbol has been added to it; cancels are never held back. Refused orders are
+  // not sent: batches report them as failed items (retExtInfo code kRiskRejectCode), async callbacks
+  // as item_ok == false (all-refused calls complete from the next poll_async()), single orders as a
+  // retCode error. String batches are refused as a whole if any order fails.
+  RiskEngine &risk() { return risk_; }
+  const RiskEngine &risk() const { return risk_; }
+
+  // Client-side rate limiting of every order call (sync and async) against Bybit's per-UID limits,
+  // resynced from the X-Bapi-Limit* headers of REST and trade WebSocket responses. Synchronous
+  // cancels and market orders wait for a token; synchronous quotes (limit creates/amends) that would
+  // have to wait are not sent and get retCode kRateLimitedCode instead. Async requests wait in the
+  // gateway (see OrderGateway). Each helper has its own limiter until set_rate_limiter() shares one
+  // across helpers trading the same account; it must be called before enable_async_gateway().
+  void set_rate_limiter(std::shared_ptr<RateLimiter> limiter);
+  RateLimiter &rate_limiter() { return *limiter_; }
+
+  // Opens the REST connection synchronous order calls use ahead of the first order (the async
+  // gateway warms its own). False if the venue was unreachable.
+  bool warm_connections();
+  // Refreshes that connection after RestTransport::kKeepWarmIdle without a request; a no-op until
+  // it has been used or warmed. Call from the thread placing synchronous orders while it is idle.
+  void keep_warm();
+  // Synchronous-path connection and request counters (the gateway's: gateway()->transport_stats()).
+  RestTransport::Stats connection_stats() const { return transport_->stats(); }
+
+  // Per-item success flags of a batch response (retCode == 0 and retExtInfo.list[i].code == 0).
+  static std::vector<bool> batch_item_results(const std::string &raw, std::size_t n);
+
+  // Async order path: requests are queued to an OrderGateway I/O thread and return immediately
+  // (false if the queue is full). Callbacks run inside poll_async() on the calling thread.
+  // All async_* calls and poll_async() must come from one thread.
+  void enable_async_gateway(std::size_t queue_capacity = 1024);
+  bool async_enabled() const { return gateway_ != nullptr; }
+  const OrderGateway *gateway() const { return gateway_.get(); }
+  bool async_batch_submit_orders(const OrderRequest *reqs, std::size_t n, GatewayCallback on_done);
+  bool async_batch_amend_orders(const OrderRequest *reqs, std::size_t n, GatewayCallback on_done);
+  bool async_batch_cancel_orders(const OrderRequest *reqs, std::size_t n, GatewayCallback on_done);
+  bool async_cancel_all(const std::string &symbol, GatewayCallback on_done);
+  bool async_submit_market_order(const std::string &symbol,
+                                 const std::string &side,
+                                 const std::string &qty,
+                                 int position_idx,
+                                 const std::string &order_link_id,
+                                 GatewayCallback on_done);
+  std::size_t poll_async();
+
 private:
+  using OrderFields = std::vector<std::pair<std::string, std::string>>;
+  using OrderBatch = std::vector<OrderFields>;
+  nlohmann::json order_create_args(const OrderFields &fields) const;
+  nlohmann::json batch_args(const OrderBatch &requests) const;
+  // True if raw was filled via the trade transport; false means the caller should use REST.
+  bool via_trade_transport(const char *op, RateEndpoint ep, const std::string &args_json, std::string &raw);
+  // After a create over the trade transport failed without an answer: cancels the orders of
+  // `args_json` by orderLinkId over REST and returns a failed response for them. Throws if the
+  // outcome stays unknown (no orderLinkId, or the cancel failed too).
+  std::string cancel_unknown_creates(const std::string &args_json);
+  // Takes rate-limit tokens for a synchronous call: cancels and exits wait, quotes give up (false).
+  bool throttle(RateEndpoint ep, std::size_t cost, RatePriority prio);
+  void note_limits(RateEndpoint ep, const RateLimitHeaders &limits);
+  std::string send_batch(OrderAction action, const OrderRequest *reqs, std::size_t n);
+  bool enqueue(GatewayOp op, std::string_view symbol, const OrderRequest *reqs, std::size_t n, GatewayCallback on_done);
+
+  // Orders of one call that passed the risk checks; `refused` is a bitmask over the caller's items.
+  struct Admitted
+  {
+    const OrderRequest *reqs;
+    std::size_t count;
+    uint32_t refused;
+  };
+  // Risk-checks creates/amends and records passing creates in the OrderStore one at a time, so later
+  // orders of a batch see the exposure of earlier ones.
+  Admitted admit(OrderAction action, const OrderRequest *reqs, std::size_t n);
+  // Resolves the PendingNew records admit() made for creates that were never sent (queue full,
+  // transport error), so their exposure is released.
+  void abandon_creates(const Admitted &a);
+  // Batch response for all n items: the exchange's results for admitted ones, the refusal for the rest.
+  std::string refused_response(const Admitted &a, std::size_t n, const std::string &raw) const;
+  bool enqueue_admitted(GatewayOp op, std::string_view symbol, const Admitted &a, std::size_t n, GatewayCallback on_done);
+
   bool has_keys_;
   std::string category_;
   std::string base_url_;
   std::string api_key_;
   std::string api_secret_;
   std::unique_ptr<bybit::RestClient> rest_client_;
+  std::unique_ptr<RestTransport> transport_; // endpoints not covered by rest_client_, account calls
+  std::shared_ptr<RateLimiter> limiter_;
+  RiskEngine risk_; // before orders_, which reports exposure into it
+  OrderStore orders_;
+  std::unique_ptr<ITradeTransport> trade_transport_;
+  uint64_t trade_fallbacks_{0};
+  int64_t tick_origin_ns_{0};
+  std::string body_buf_; // reused by the typed batch calls
+  OrderRequest risk_pass_[kMaxGatewayBatch];
+  RiskCheck risk_result_[kMaxGatewayBatch]{};
+  std::vector<std::pair<GatewayCallback, GatewayResult>> risk_deferred_; // all-refused async calls
+  int64_t risk_log_ns_{0};
+  uint64_t risk_logged_{0};
+  // Declared last: its I/O thread references orders_ and must stop first.
+  std::unique_ptr<OrderGateway> gateway_;
 };
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool with one deque per worker. A worker pops its own deque from the back
+// (newest first, so tasks it spawns run while their data is warm) and, when that is empty, steals
+// from the front of the others. Tasks submitted from outside the pool are dealt round-robin.
+// Meant for coarse tasks (whole replays), so each deque is guarded by a plain mutex.
+//
+// The first exception thrown by a task is rethrown from wait(); the other tasks still run.
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    // threads == 0 uses every hardware thread.
+    explicit WorkStealingPool(std::size_t threads = 0)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t i = 0; i < threads; ++i)
+            queues_.push_back(std::make_unique<Queue>());
+        for (std::size_t i = 0; i < threads; ++i)
+            threads_.emplace_back([this, i]
+                                  { worker(i); });
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto &t : threads_)
+            t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    void submit(Task task)
+    {
+        const std::size_t n = queues_.size();
+        const std::size_t idx = current_pool() == this ? current_index() : next_.fetch_add(1, std::memory_order_relaxed) % n;
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        // Counted before it is visible, so a worker that takes it never sees the count at zero.
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            ++queued_;
+        }
+        {
+            std::lock_guard<std::mutex> lk(queues_[idx]->mu);
+            queues_[idx]->tasks.push_back(std::move(task));
+        }
+        work_cv_.notify_one();
+    }
+
+    // Blocks until every submitted task has finished. Not callable from a task.
+    void wait()
+    {
+        std::unique_lock<std::mutex> lk(mu_);
+        idle_cv_.wait(lk, [this]
+                      { return pending_.load(std::memory_order_acquire) == 0; });
+        if (error_)
+        {
+            auto err = error_;
+            error_ = nullptr;
+            std::rethrow_exception(err);
+        }
+    }
+
+    std::size_t size() const { return threads_.size(); }
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue
+    {
+        std::mutex mu;
+        std::deque<Task> tasks;
+    };
+
+    static const WorkStealingPool *&current_pool()
+    {
+        static thread_local const WorkStealingPool *pool = nullptr;
+        return pool;
+    }
+    static std::size_t &current_index()
+    {
+        static thread_local std::size_t index = 0;
+        return index;
+    }
+
+    bool pop_local(std::size_t i, Task &out)
+    {
+        std::lock_guard<std::mutex> lk(queues_[i]->mu);
+        if (queues_[i]->tasks.empty())
+            return false;
+        out = std::move(queues_[i]->tasks.back());
+        queues_[i]->tasks.pop_back();
+        return true;
+    }
+
+    bool steal(std::size_t i, Task &out)
+    {
+        const std::size_t n = queues_.size();
+        for (std::size_t k = 1; k < n; ++k)
+        {
+            Queue &victim = *queues_[(i + k) % n];
+            std::lock_guard<std::mutex> lk(victim.mu);
+            if (victim.tasks.empty())
+                continue;
+            out = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void worker(std::size_t i)
+    {
+        current_pool() = this;
+        current_index() = i;
+        for (;;)
+        {
+            Task task;
+            if (pop_local(i, task) || steal(i, task))
+            {
+                {
+                    std::lock_guard<std::mutex> lk(mu_);
+                    --queued_;
+                }
+                try
+                {
+                    task();
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lk(mu_);
+                    if (!error_)
+                        error_ = std::current_exception();
+                }
+                task = nullptr;
+                if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    std::lock_guard<std::mutex> lk(mu_);
+                    idle_cv_.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lk(mu_);
+            work_cv_.wait(lk, [this]
+                          { return stop_ || queued_ > 0; });
+            if (stop_ && queued_ == 0)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> next_{0};
+    std::atomic<std::size_t> pending_{0}; // submitted and not yet finished
+    std::atomic<uint64_t> steals_{0};
+
+    std::mutex mu_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    std::size_t queued_{0}; // sitting in some deque; guarded by mu_
+    bool stop_{false};
+    std::exception_ptr error_;
+};
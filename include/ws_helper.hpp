@@ -22,6 +22,8 @@ public:
     // Subscribe to ticker/orderbook for symbols.
     void subscribe_tickers(const std::vector<std::string> &symbols);
     void subscribe_orderbook(const std::vector<std::string> &symbols, int depth = 1);
+    // publicTrade.<symbol> prints (aggressor side, price, size).
+    void subscribe_trades(const std::vector<std::string> &symbols);
 
 private:
     std::unique_ptr<bybit::WebSocketClient> client_;
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "fixed_point.hpp"
+#include "ticker_snapshot.hpp"
+
+// On-demand scanner for the public Bybit WS schemas (orderbook.*, tickers.*, publicTrade.*).
+// Nothing is materialized: the parser records where the interesting values sit in the message and
+// callers walk the level arrays / ticker fields straight into their typed state. Anything it does
+// not recognise (subscription acks, escaped strings, unexpected shapes) is rejected so the caller
+// can fall back to nlohmann::json.
+
+enum class PublicTopic : uint8_t
+{
+    Unknown,
+    Orderbook,
+    Ticker,
+    PublicTrade,
+};
+
+// All views point into the parsed message and are only valid while it is alive.
+struct PublicMessage
+{
+    PublicTopic kind{PublicTopic::Unknown};
+    std::string_view topic;
+    std::string_view symbol; // topic suffix after the last '.'
+    bool is_snapshot{false};
+    int64_t ts_ms{0};
+    std::string_view data; // raw JSON text of "data"
+    // Orderbook only.
+    uint64_t update_id{0}; // "u"
+    uint64_t seq{0};
+    std::string_view bids; // raw "b" array
+    std::string_view asks; // raw "a" array
+};
+
+// One element of a publicTrade "data" array.
+struct PublicTrade
+{
+    int64_t ts_ms{0}; // "T"
+    Price price;
+    Qty qty;
+    bool is_buy{false}; // taker side
+};
+
+// Returns false when msg is not a well-formed message for one of the known topics.
+bool parse_public_message(std::string_view msg, PublicMessage &out);
+// Merges the fields present in a tickers.* "data" object (deltas carry only changed ones). Returns
+// false, with t untouched, when data cannot be scanned.
+bool merge_ticker_fields(std::string_view data, int64_t ts_ms, TickerSnapshot &t);
+
+namespace ws_scan
+{
+    inline const char *skip_ws(const char *p, const char *end)
+    {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+            ++p;
+        return p;
+    }
+
+    // p at the opening quote; returns one past the closing quote. Escaped strings are rejected
+    // (Bybit never escapes in public payloads), which keeps this a pair of memchr calls.
+    inline const char *scan_string(const char *p, const char *end, std::string_view &out)
+    {
+        if (p >= end || *p != '"')
+            return nullptr;
+        ++p;
+        const auto *q = static_cast<const char *>(std::memchr(p, '"', static_cast<std::size_t>(end - p)));
+        if (!q || std::memchr(p, '\\', static_cast<std::size_t>(q - p)))
+            return nullptr;
+        out = std::string_view(p, static_cast<std::size_t>(q - p));
+        return q + 1;
+    }
+
+    // Skips one value of any type; returns one past it or nullptr if malformed.
+    inline const char *skip_value(const char *p, const char *end)
+    {
+        if (p >= end)
+            return nullptr;
+        std::string_view s;
+        if (*p == '"')
+            return scan_string(p, end, s);
+        if (*p == '{' || *p == '[')
+        {
+            int depth = 0;
+            while (p < end)
+            {
+                const char c = *p;
+                if (c == '"')
+                {
+                    p = scan_string(p, end, s);
+                    if (!p)
+                        return nullptr;
+                    continue;
+                }
+                if (c == '{' || c == '[')
+                    ++depth;
+                else if ((c == '}' || c == ']') && --depth == 0)
+                    return p + 1;
+                ++p;
+            }
+            return nullptr;
+        }
+        const char *start = p;
+        while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')
+            ++p;
+        return p == start ? nullptr : p;
+    }
+
+    // Strips the quotes from a raw string value; other values are returned unchanged.
+    inline std::string_view unquote(std::string_view raw)
+    {
+        if (raw.size() >= 2 && raw.front() == '"')
+            return raw.substr(1, raw.size() - 2);
+        return raw;
+    }
+
+    // Integer from a raw number or numeric string.
+    template <typename T>
+    bool parse_int(std::string_view raw, T &out)
+    {
+        raw = unquote(raw);
+        auto res = std::from_chars(raw.data(), raw.data() + raw.size(), out);
+        return res.ec == std::errc{} && res.ptr == raw.data() + raw.size();
+    }
+} // namespace ws_scan
+
+// Calls f(key, raw_value) for every member of a JSON object. Returns false if malformed.
+template <typename F>
+bool for_each_member(std::string_view object, F &&f)
+{
+    using namespace ws_scan;
+    const char *p = object.data();
+    const char *end = p + object.size();
+    p = skip_ws(p, end);
+    if (p >= end || *p != '{')
+        return false;
+    p = skip_ws(p + 1, end);
+    if (p < end && *p == '}')
+        return true;
+    while (p < end)
+    {
+        std::string_view key;
+        p = scan_string(p, end, key);
+        if (!p)
+            return false;
+        p = skip_ws(p, end);
+        if (p >= end || *p != ':')
+            return false;
+        p = skip_ws(p + 1, end);
+        const char *v = p;
+        p = skip_value(p, end);
+        if (!p)
+            return false;
+        f(key, std::string_view(v, static_cast<std::size_t>(p - v)));
+        p = skip_ws(p, end);
+        if (p < end && *p == '}')
+            return true;
+        if (p >= end || *p != ',')
+            return false;
+        p = skip_ws(p + 1, end);
+    }
+    return false;
+}
+
+// Walks an orderbook level array [["price","size"],...] calling f(Price, Qty) per level.
+template <typename F>
+bool for_each_level(std::string_view levels, F &&f)
+{
+    using namespace ws_scan;
+    const char *p = levels.data();
+    const char *end = p + levels.size();
+    p = skip_ws(p, end);
+    if (p >= end || *p != '[')
+        return false;
+    p = skip_ws(p + 1, end);
+    if (p < end && *p == ']')
+        return true;
+    while (p < end)
+    {
+        std::string_view px, sz;
+        if (*p != '[')
+            return false;
+        p = scan_string(skip_ws(p + 1, end), end, px);
+        if (!p)
+            return false;
+        p = skip_ws(p, end);
+        if (p >= end || *p != ',')
+            return false;
+        p = scan_string(skip_ws(p + 1, end), end, sz);
+        if (!p)
+            return false;
+        p = skip_ws(p, end);
+        if (p >= end || *p != ']')
+            return false;
+        Price price;
+        Qty qty;
+        if (!Price::parse(px, price) || !Qty::parse(sz, qty))
+            return false;
+        f(price, qty);
+        p = skip_ws(p + 1, end);
+        if (p < end && *p == ']')
+            return true;
+        if (p >= end || *p != ',')
+            return false;
+        p = skip_ws(p + 1, end);
+    }
+    return false;
+}
+
+// Calls f(raw_element) for every element of a JSON array. Returns false if malformed.
+template <typename F>
+bool for_each_element(std::string_view array, F &&f)
+{
+    using namespace ws_scan;
+    const char *p = array.data();
+    const char *end = p + array.size();
+    p = skip_ws(p, end);
+    if (p >= end || *p != '[')
+        return false;
+    p = skip_ws(p + 1, end);
+    if (p < end && *p == ']')
+        return true;
+    while (p < end)
+    {
+        const char *v = p;
+        p = skip_value(p, end);
+        if (!p)
+            return false;
+        f(std::string_view(v, static_cast<std::size_t>(p - v)));
+        p = skip_ws(p, end);
+        if (p < end && *p == ']')
+            return true;
+        if (p >= end || *p != ',')
+            return false;
+        p = skip_ws(p + 1, end);
+    }
+    return false;
+}
+
+// Walks a publicTrade "data" array calling f(const PublicTrade &) per trade.
+template <typename F>
+bool for_each_trade(std::string_view data, F &&f)
+{
+    bool ok = true;
+    const bool shaped = for_each_element(data, [&](std::string_view element)
+                                         {
+        PublicTrade t;
+        bool has_px = false, has_qty = false;
+        ok = ok && for_each_member(element, [&](std::string_view key, std::string_view raw)
+                                   {
+            if (key == "T")
+                ws_scan::parse_int(raw, t.ts_ms);
+            else if (key == "p")
+                has_px = Price::parse(ws_scan::unquote(raw), t.price);
+            else if (key == "v")
+                has_qty = Qty::parse(ws_scan::unquote(raw), t.qty);
+            else if (key == "S")
+                t.is_buy = ws_scan::unquote(raw) == "Buy"; });
+        ok = ok && has_px && has_qty;
+        if (ok)
+            f(t); });
+    return shaped && ok;
+}
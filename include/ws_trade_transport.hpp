@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "trade_transport.hpp"
+
+namespace ix
+{
+    class WebSocket;
+}
+
+// Order entry over Bybit's authenticated trade WebSocket (/v5/trade). Each request carries a
+// unique reqId; the caller blocks until the ack with that reqId arrives (acks may come back in any
+// order) or the ack timeout expires. A disconnect fails all outstanding requests immediately.
+// The connection re-authenticates by itself after automatic reconnects.
+class WsTradeTransport : public ITradeTransport
+{
+public:
+    struct Config
+    {
+        std::string url{"wss://stream.bybit.com/v5/trade"};
+        std::string api_key;
+        std::string api_secret;
+        std::chrono::milliseconds ack_timeout{2000};
+        long recv_window_ms{5000};
+    };
+
+    explicit WsTradeTransport(Config cfg);
+    ~WsTradeTransport() override;
+
+    WsTradeTransport(const WsTradeTransport &) = delete;
+    WsTradeTransport &operator=(const WsTradeTransport &) = delete;
+
+    // Connects and waits until authenticated. Returns false on timeout (the socket keeps retrying).
+    bool start(std::chrono::milliseconds timeout = std::chrono::milliseconds{5000});
+    void stop();
+
+    bool ready() const override { return authed_.load(std::memory_order_acquire); }
+    std::string request(const std::string &op, const std::string &args_json) override;
+
+    uint64_t timeouts() const { return timeouts_.load(std::memory_order_relaxed); }
+
+private:
+    struct Pending
+    {
+        bool done{false};
+        bool failed{false};
+        std::string response;
+    };
+
+    void send_auth();
+    void on_text(const std::string &text);
+    void on_disconnect(const std::string &reason);
+
+    Config cfg_;
+    std::unique_ptr<ix::WebSocket> ws_;
+    std::atomic<bool> authed_{false};
+    std::atomic<uint64_t> next_req_id_{0};
+    std::atomic<uint64_t> timeouts_{0};
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::unordered_map<std::string, std::shared_ptr<Pending>> pending_; // by reqId
+};
@@ -0,0 +1,310 @@
+#include "async_logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    const char *color_code(LogColor c)
+    {
+        switch (c)
+        {
+        case LogColor::Green:
+            return "\033[32m";
+        case LogColor::Yellow:
+            return "\033[33m";
+        case LogColor::Magenta:
+            return "\033[35m";
+        case LogColor::Cyan:
+            return "\033[36m";
+        case LogColor::Red:
+            return "\033[31m";
+        case LogColor::None:
+            break;
+        }
+        return "";
+    }
+    constexpr const char *kReset = "\033[0m";
+
+    const char *level_name(LogLevel level)
+    {
+        switch (level)
+        {
+        case LogLevel::Info:
+            return "info";
+        case LogLevel::Warn:
+            return "warn";
+        case LogLevel::Error:
+            return "error";
+        }
+        return "info";
+    }
+
+    int64_t wall_offset_now()
+    {
+        const int64_t wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch())
+                                 .count();
+        return wall - latency_now_ns();
+    }
+
+    void append_arg(const LogRecord &rec, const LogArg &a, bool color, std::string &out)
+    {
+        char buf[64];
+        int n = 0;
+        switch (a.kind)
+        {
+        case LogArg::Kind::Int:
+            n = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(a.i));
+            break;
+        case LogArg::Kind::Uint:
+            n = std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(a.u));
+            break;
+        case LogArg::Kind::Double:
+            n = std::snprintf(buf, sizeof(buf), "%g", a.d);
+            break;
+        case LogArg::Kind::Signed:
+            n = std::snprintf(buf, sizeof(buf), "%f", a.d);
+            if (color && a.d != 0.0)
+            {
+                out += a.d > 0 ? color_code(LogColor::Green) : color_code(LogColor::Red);
+                out.append(buf, static_cast<std::size_t>(n));
+                out += kReset;
+                return;
+            }
+            break;
+        case LogArg::Kind::Fixed:
+            n = static_cast<int>(write_fixed(buf, a.i) - buf);
+            break;
+        case LogArg::Kind::Str:
+            out.append(rec.text + a.offset, a.len);
+            return;
+        }
+        out.append(buf, static_cast<std::size_t>(n));
+    }
+
+    // Replaces each "{}" with the next argument; surplus placeholders stay as "{}".
+    void append_message(const LogRecord &rec, bool color, std::string &out)
+    {
+        std::size_t next = 0;
+        for (const char *p = rec.format->text; *p; ++p)
+        {
+            if (p[0] == '{' && p[1] == '}' && next < rec.argc)
+            {
+                append_arg(rec, rec.args[next++], color, out);
+                ++p;
+            }
+            else
+            {
+                out += *p;
+            }
+        }
+    }
+
+    void append_json_escaped(std::string_view s, std::string &out)
+    {
+        for (const char c : s)
+        {
+            switch (c)
+            {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    out += buf;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+    }
+} // namespace
+
+AsyncLogger &AsyncLogger::instance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::~AsyncLogger() { stop(); }
+
+void AsyncLogger::render(const LogRecord &rec, const Config &cfg, int64_t wall_offset_ns, std::string &out)
+{
+    const int64_t wall_ns = rec.ts_ns + wall_offset_ns;
+    const LogFormat &fmt = *rec.format;
+    if (cfg.json)
+    {
+        std::string msg;
+        append_message(rec, false, msg);
+        char head[64];
+        std::snprintf(head, sizeof(head), "{\"ts_ns\":%lld,\"level\":\"", static_cast<long long>(wall_ns));
+        out += head;
+        out += level_name(fmt.level);
+        out += "\",\"tag\":\"";
+        append_json_escaped(fmt.tag, out);
+        out += "\",\"msg\":\"";
+        append_json_escaped(msg, out);
+        out += "\"}";
+        return;
+    }
+    const std::time_t secs = static_cast<std::time_t>(wall_ns / 1000000000);
+    std::tm tm{};
+    gmtime_r(&secs, &tm);
+    char stamp[32];
+    std::snprintf(stamp, sizeof(stamp), "%02d:%02d:%02d.%06lld ", tm.tm_hour, tm.tm_min, tm.tm_sec,
+                  static_cast<long long>((wall_ns % 1000000000) / 1000));
+    out += stamp;
+    if (fmt.tag[0] != '\0')
+    {
+        const bool tint = cfg.color && fmt.color != LogColor::None;
+        if (tint)
+            out += color_code(fmt.color);
+        out += '[';
+        out += fmt.tag;
+        out += ']';
+        if (tint)
+            out += kReset;
+        out += ' ';
+    }
+    append_message(rec, cfg.color, out);
+}
+
+void AsyncLogger::start(const Config &cfg)
+{
+    if (running())
+        return;
+    if (cfg.path.empty())
+    {
+        launch(cfg, std::cout, std::cerr);
+        return;
+    }
+    file_.open(cfg.path, std::ios::out | std::ios::app);
+    if (!file_.is_open())
+        throw std::runtime_error("cannot open log file " + cfg.path);
+    launch(cfg, file_, file_);
+}
+
+void AsyncLogger::start(const Config &cfg, std::ostream &out)
+{
+    if (!running())
+        launch(cfg, out, out);
+}
+
+void AsyncLogger::launch(const Config &cfg, std::ostream &out, std::ostream &err)
+{
+    cfg_ = cfg;
+    out_ = &out;
+    err_ = &err;
+    wall_offset_ns_ = wall_offset_now();
+    stop_.store(false, std::memory_order_relaxed);
+    running_.store(true, std::memory_order_release);
+    writer_ = std::thread([this]
+                          { run(); });
+}
+
+void AsyncLogger::stop()
+{
+    if (!writer_.joinable())
+        return;
+    stop_.store(true, std::memory_order_release);
+    writer_.join();
+    running_.store(false, std::memory_order_release);
+    drain(); // records pushed between the writer's last pass and running_ going false
+    out_->flush();
+    err_->flush();
+    if (file_.is_open())
+        file_.close();
+}
+
+void AsyncLogger::write_sync(const LogRecord &rec)
+{
+    Config plain;
+    plain.color = false;
+    std::string line;
+    render(rec, plain, wall_offset_now(), line);
+    line += '\n';
+    (rec.format->level == LogLevel::Info ? std::cout : std::cerr) << line;
+}
+
+void AsyncLogger::flush()
+{
+    while (running())
+    {
+        {
+            std::lock_guard<std::mutex> drain_lg(drain_mu_);
+            std::lock_guard<std::mutex> lg(rings_mu_);
+            if (std::all_of(rings_.begin(), rings_.end(), [](const auto &r)
+                            { return r->empty(); }))
+                return;
+        }
+        std::this_thread::sleep_for(cfg_.idle_sleep);
+    }
+}
+
+AsyncLogger::Ring *AsyncLogger::register_thread()
+{
+    std::lock_guard<std::mutex> lg(rings_mu_);
+    rings_.push_back(std::make_unique<Ring>(cfg_.ring_capacity));
+    tl_ring_ = rings_.back().get();
+    return tl_ring_;
+}
+
+void AsyncLogger::run()
+{
+    while (!stop_.load(std::memory_order_acquire))
+    {
+        if (!drain())
+            std::this_thread::sleep_for(cfg_.idle_sleep);
+    }
+    drain();
+}
+
+bool AsyncLogger::drain()
+{
+    std::lock_guard<std::mutex> drain_lg(drain_mu_);
+    batch_.clear();
+    {
+        std::lock_guard<std::mutex> lg(rings_mu_);
+        LogRecord rec{};
+        for (auto &ring : rings_)
+            while (ring->try_pop(rec))
+                batch_.push_back(rec);
+    }
+    if (batch_.empty())
+        return false;
+    // Rings are drained one after another; restore cross-thread order before writing.
+    std::stable_sort(batch_.begin(), batch_.end(), [](const LogRecord &a, const LogRecord &b)
+                     { return a.ts_ns < b.ts_ns; });
+    out_buf_.clear();
+    err_buf_.clear();
+    for (const auto &rec : batch_)
+    {
+        std::string &dst = (rec.format->level == LogLevel::Info || out_ == err_) ? out_buf_ : err_buf_;
+        render(rec, cfg_, wall_offset_ns_, dst);
+        dst += '\n';
+    }
+    if (!out_buf_.empty())
+        out_->write(out_buf_.data(), static_cast<std::streamsize>(out_buf_.size()));
+    if (!err_buf_.empty())
+        err_->write(err_buf_.data(), static_cast<std::streamsize>(err_buf_.size()));
+    out_->flush();
+    return true;
+}
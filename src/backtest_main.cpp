@@ -0,0 +1,69 @@
+#include <chrono>
+#include <iostream>
+
+#include "backtest_env.hpp"
+#include "param_sweep.hpp"
+
+namespace
+{
+    void usage()
+    {
+        std::cerr << "usage: market_maker_backtest <symbol> <recording.bmd | directory>...\n"
+                     "  Instrument steps: BYBIT_BT_TICK_SIZE, BYBIT_BT_LOT_SIZE, BYBIT_BT_MIN_QTY (required)\n"
+                     "  Strategy settings are the same BYBIT_* variables as the live binaries.\n";
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    load_env_file(".env");
+    if (argc < 3)
+    {
+        usage();
+        return 2;
+    }
+
+    try
+    {
+        Backtester::Config cfg = backtest_config_from_env(argv[1], expand_recordings(argc, argv, 2));
+        const auto params = StrategyParams::from_env();
+        cfg.min_requote_ns = params.min_requote_ms * 1000000;
+        const auto strategy = make_strategy(cfg.symbol, cfg.sim.meta, params);
+
+        // The strategies log every dispatch; at replay speed that would dominate the run.
+        const bool verbose = get_env("BYBIT_BT_VERBOSE", "0") == "1";
+        auto *cout_buf = std::cout.rdbuf();
+        if (!verbose)
+            std::cout.rdbuf(nullptr);
+        const auto wall_start = std::chrono::steady_clock::now();
+        Backtester bt(cfg);
+        Backtester::Result res;
+        try
+        {
+            res = bt.run(*strategy);
+        }
+        catch (...)
+        {
+            std::cout.rdbuf(cout_buf);
+            throw;
+        }
+        const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        std::cout.rdbuf(cout_buf);
+        std::cout.clear();
+
+        const double sim_s = static_cast<double>(res.last_ns - res.first_ns) / 1e9;
+        std::cout << "[BT] " << cfg.symbol << " files=" << cfg.files.size() << " messages=" << res.messages
+                  << " dispatches=" << res.dispatches << " gaps=" << res.gaps << "\n"
+                  << "[BT] replayed " << sim_s << "s in " << wall_s << "s (" << (wall_s > 0.0 ? sim_s / wall_s : 0.0) << "x)\n"
+                  << "[BT] fills=" << res.fills << " notional=" << res.traded_notional << " realized=" << res.realized
+                  << " fees=" << res.fees << " upl=" << res.unrealized << " net_pnl=" << res.realized - res.fees + res.unrealized
+                  << " net_qty=" << res.net_qty << " max_dd=" << res.max_drawdown << "\n"
+                  << "[BT] wrote " << cfg.out_dir << "/fills.csv and " << cfg.out_dir << "/pnl.csv" << std::endl;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
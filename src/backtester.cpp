@@ -0,0 +1,183 @@
+#include "backtester.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#include "feed_record.hpp"
+#include "market_data_feed.hpp"
+#include "ws_message_parser.hpp"
+
+namespace
+{
+    // Link ids end in _<ms>_<counter> taken from the wall clock of the replaying machine; only the
+    // slot/tag part is stable across runs.
+    std::string_view link_slot(std::string_view link)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            const auto pos = link.rfind('_');
+            if (pos == std::string_view::npos)
+                break;
+            link = link.substr(0, pos);
+        }
+        return link;
+    }
+
+    std::ofstream open_csv(const std::filesystem::path &path, const char *header)
+    {
+        std::ofstream out(path);
+        if (!out)
+            throw std::runtime_error("Backtester: cannot create " + path.string());
+        out.precision(10);
+        out << header << "\n";
+        return out;
+    }
+} // namespace
+
+Backtester::Backtester(Config cfg) : cfg_(std::move(cfg)) {}
+
+Backtester::Result Backtester::run(IStrategy &strategy)
+{
+    std::vector<RecordFileReader> readers(cfg_.files.size());
+    std::vector<const RecordFileReader *> inputs;
+    for (std::size_t i = 0; i < cfg_.files.size(); ++i)
+    {
+        readers[i].open(cfg_.files[i]);
+        inputs.push_back(&readers[i]);
+    }
+    return run(strategy, inputs);
+}
+
+Backtester::Result Backtester::run(IStrategy &strategy, const std::vector<const RecordFileReader *> &inputs)
+{
+    // Never connected: replay goes through ingest() only.
+    MarketDataFeed feed("");
+    feed.prepare({cfg_.symbol}, cfg_.book_depth);
+    // Dummy keys unlock the order methods; every order call is answered by the simulator.
+    TradingHelper helper("sim", "sim");
+    SimExchange sim(cfg_.symbol, cfg_.sim, helper.orders());
+    helper.set_trade_transport(std::make_unique<SimTradeTransport>(sim));
+    // Replay runs far faster than real time and the simulator has no rate limit to protect.
+    RateLimiter::Config unlimited;
+    unlimited.enabled = false;
+    helper.set_rate_limiter(std::make_shared<RateLimiter>(unlimited));
+
+    std::ofstream fills_out;
+    std::ofstream pnl_out;
+    if (!cfg_.out_dir.empty())
+    {
+        std::filesystem::create_directories(cfg_.out_dir);
+        fills_out = open_csv(std::filesystem::path(cfg_.out_dir) / "fills.csv",
+                             "time_ms,slot,side,price,qty,liquidity,fee,position_idx");
+        pnl_out = open_csv(std::filesystem::path(cfg_.out_dir) / "pnl.csv",
+                           "time_ms,mid,long_qty,short_qty,net_qty,realized,fees,unrealized,equity,open_orders");
+    }
+
+    Result res;
+    MarketDataSnapshot snap;
+    snap.symbol = cfg_.symbol;
+    BookSnapshot book;
+    PublicMessage msg;
+    uint64_t seen_seq = 0;
+    bool pending = false;
+    int64_t now = 0;
+    int64_t last_dispatch = 0;
+    double last_mid = 0.0;
+    int64_t next_sample = 0;
+    std::size_t fills_written = 0;
+    double peak_equity = 0.0;
+
+    auto write_fills = [&]
+    {
+        const auto &fills = sim.fills();
+        for (; fills_written < fills.size(); ++fills_written)
+        {
+            const auto &f = fills[fills_written];
+            if (fills_out.is_open())
+                fills_out << f.time_ns / 1000000 << ',' << link_slot(f.order_link_id) << ',' << (f.is_buy ? "Buy" : "Sell")
+                          << ',' << f.price.str() << ',' << f.qty.str() << ',' << (f.maker ? "maker" : "taker") << ','
+                          << f.fee << ',' << f.position_idx << "\n";
+        }
+    };
+    auto sample = [&]
+    {
+        const double mid = book.mid();
+        const double upl = mid > 0.0 ? sim.unrealized_pnl(mid) : 0.0;
+        const double equity = sim.realized_pnl() - sim.fees() + upl;
+        peak_equity = std::max(peak_equity, equity);
+        res.max_drawdown = std::max(res.max_drawdown, peak_equity - equity);
+        res.max_abs_net_qty = std::max(res.max_abs_net_qty, std::abs(sim.net_qty()));
+        if (!pnl_out.is_open())
+            return;
+        const auto pos = sim.position();
+        pnl_out << now / 1000000 << ',' << mid << ',' << pos.long_size << ',' << pos.short_size << ',' << sim.net_qty() << ','
+                << sim.realized_pnl() << ',' << sim.fees() << ',' << upl << ',' << equity << ',' << sim.open_orders() << "\n";
+    };
+
+    for (const RecordFileReader *reader : inputs)
+    {
+        // Files from different sessions have unrelated steady clocks; wall time orders them.
+        const int64_t to_wall = reader->file_header().wall_ns - reader->file_header().steady_ns;
+        RecordView r;
+        for (std::size_t pos = reader->begin(); reader->next(pos, r);)
+        {
+            if (r.header.type != RecordType::RawPublic)
+                continue;
+            now = std::max(now, r.header.recv_ns + to_wall);
+            if (res.messages++ == 0)
+                res.first_ns = now;
+
+            // Order events that came due before this message see the book as it was.
+            sim.advance(now);
+            feed.ingest(r.payload, now);
+            const uint64_t seq = feed.update_seq();
+            if (seq != seen_seq)
+            {
+                seen_seq = seq;
+                pending = true;
+                feed.read_book(cfg_.symbol, book);
+                sim.on_book(now, book);
+            }
+            if (parse_public_message(r.payload, msg) && msg.kind == PublicTopic::PublicTrade && msg.symbol == cfg_.symbol)
+                for_each_trade(msg.data, [&](const PublicTrade &t)
+                               { sim.on_trade(now, t); });
+
+            if (pending && book.valid())
+            {
+                const double mid = book.mid();
+                const bool urgent = cfg_.urgent_mid_move > 0.0 && last_mid > 0.0 && std::abs(mid - last_mid) >= cfg_.urgent_mid_move;
+                if (urgent || now - last_dispatch >= cfg_.min_requote_ns)
+                {
+                    snap.book = book;
+                    feed.read_ticker(cfg_.symbol, snap.tick);
+                    strategy.on_snapshot(snap, helper, true, sim.position());
+                    pending = false;
+                    last_dispatch = now;
+                    last_mid = mid;
+                    ++res.dispatches;
+                }
+            }
+            write_fills();
+            if (now >= next_sample)
+            {
+                sample();
+                next_sample = (now / cfg_.sample_interval_ns + 1) * cfg_.sample_interval_ns;
+            }
+        }
+    }
+    sample();
+
+    res.last_ns = now;
+    res.fills = sim.fills().size();
+    res.realized = sim.realized_pnl();
+    res.fees = sim.fees();
+    res.unrealized = book.valid() ? sim.unrealized_pnl(book.mid()) : 0.0;
+    res.net_qty = sim.net_qty();
+    res.traded_notional = sim.traded_notional();
+    res.gaps = feed.gap_count();
+    return res;
+}
@@ -0,0 +1,82 @@
+#include "feed_record.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr std::size_t align8(std::size_t n) { return (n + 7) & ~std::size_t{7}; }
+}
+
+void set_record_symbol(RecordSymbol &out, std::string_view symbol)
+{
+    const std::size_t n = std::min(symbol.size(), sizeof(RecordSymbol) - 1);
+    std::memcpy(out, symbol.data(), n);
+    std::memset(out + n, 0, sizeof(RecordSymbol) - n);
+}
+
+RecordFileReader::~RecordFileReader() { close(); }
+
+void RecordFileReader::open(const std::string &path)
+{
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("RecordFileReader: cannot open " + path + ": " + std::strerror(errno));
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error("RecordFileReader: " + path + " is too short");
+    }
+    void *p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        throw std::runtime_error("RecordFileReader: mmap " + path + ": " + std::strerror(errno));
+    // Replay reads front to back exactly once.
+    ::madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+    base_ = static_cast<const char *>(p);
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (std::memcmp(file_header().magic, kRecordMagic, sizeof(kRecordMagic)) != 0 || file_header().version != kRecordVersion)
+    {
+        close();
+        throw std::runtime_error("RecordFileReader: " + path + " is not a feed recording");
+    }
+    pos_ = sizeof(FileHeader);
+}
+
+void RecordFileReader::share()
+{
+    if (!base_)
+        return;
+    ::madvise(const_cast<char *>(base_), size_, MADV_NORMAL);
+    ::madvise(const_cast<char *>(base_), size_, MADV_WILLNEED);
+}
+
+void RecordFileReader::close()
+{
+    if (base_)
+        ::munmap(const_cast<char *>(base_), size_);
+    base_ = nullptr;
+    size_ = 0;
+    pos_ = 0;
+}
+
+bool RecordFileReader::next(std::size_t &pos, RecordView &out) const
+{
+    if (!base_ || pos + sizeof(RecordHeader) > size_)
+        return false;
+    std::memcpy(&out.header, base_ + pos, sizeof(RecordHeader));
+    const std::size_t body = pos + sizeof(RecordHeader);
+    if (body + out.header.size > size_)
+        return false;
+    out.payload = std::string_view(base_ + body, out.header.size);
+    pos = body + align8(out.header.size);
+    return true;
+}
@@ -0,0 +1,370 @@
+#include "feed_recorder.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "async_logger.hpp"
+#include "ws_message_parser.hpp"
+
+namespace
+{
+    constexpr std::size_t align8(std::size_t n) { return (n + 7) & ~std::size_t{7}; }
+    constexpr int64_t kHourNs = int64_t{3600} * 1000000000;
+    // A file that failed to open is retried after this, or at once when the hour changes.
+    constexpr int64_t kOpenRetryNs = int64_t{10} * 1000000000;
+    // Recorder restarts within one hour before open_hour_file() gives up (two-digit suffix).
+    constexpr int kMaxSessionsPerHour = 100;
+
+    constexpr LogFormat kLogOpenFailed{LogLevel::Error, "REC", LogColor::Red, "cannot open {}: {}; records are dropped until it opens"};
+    constexpr LogFormat kLogWriteFailed{LogLevel::Error, "REC", LogColor::Red, "write to {} failed: {}; records are dropped until writes succeed"};
+    constexpr LogFormat kLogRecovered{LogLevel::Info, "REC", LogColor::Cyan, "recording to {} again"};
+
+    std::size_t round_pow2(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    template <typename Clock>
+    int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    template <typename T>
+    void put(std::vector<char> &buf, const T &v)
+    {
+        const auto *p = reinterpret_cast<const char *>(&v);
+        buf.insert(buf.end(), p, p + sizeof(T));
+    }
+} // namespace
+
+FeedRecorder::FeedRecorder(Config cfg) : cfg_(std::move(cfg))
+{
+    const std::size_t cap = round_pow2(cfg_.ring_bytes < 4096 ? 4096 : cfg_.ring_bytes);
+    ring_.reset(new char[cap]);
+    mask_ = cap - 1;
+    out_.reserve(cfg_.write_chunk + 4096);
+}
+
+FeedRecorder::~FeedRecorder() { stop(); }
+
+std::string FeedRecorder::file_name(const std::string &dir, const std::string &prefix, int64_t wall_ns, int session)
+{
+    const std::time_t secs = static_cast<std::time_t>(wall_ns / 1000000000);
+    std::tm tm{};
+    gmtime_r(&secs, &tm);
+    char buf[32];
+    std::size_t n = std::strftime(buf, sizeof(buf), "%Y%m%d-%H", &tm);
+    if (session > 0)
+        std::snprintf(buf + n, sizeof(buf) - n, "_%02d", session);
+    return (std::filesystem::path(dir) / (prefix + "-" + buf + ".bmd")).string();
+}
+
+std::string FeedRecorder::current_path() const
+{
+    std::lock_guard<std::mutex> lk(path_mu_);
+    return path_;
+}
+
+void FeedRecorder::start()
+{
+    if (running_)
+        return;
+    std::error_code ec;
+    std::filesystem::create_directories(cfg_.dir, ec);
+    if (ec)
+        throw std::runtime_error("FeedRecorder: cannot create " + cfg_.dir + ": " + ec.message());
+    anchor_wall_ns_ = now_ns<std::chrono::system_clock>();
+    anchor_steady_ns_ = now_ns<std::chrono::steady_clock>();
+    running_ = true;
+    writer_ = std::thread([this]
+                          { run(); });
+}
+
+void FeedRecorder::stop()
+{
+    if (!running_.exchange(false))
+        return;
+    if (writer_.joinable())
+        writer_.join();
+}
+
+void FeedRecorder::push(RecordType type, int64_t recv_ns, std::string_view msg)
+{
+    const std::size_t cap = mask_ + 1;
+    const std::size_t need = sizeof(RecordHeader) + align8(msg.size());
+    if (!running_.load(std::memory_order_relaxed) || need > cap)
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    RecordHeader hdr{};
+    hdr.size = static_cast<uint32_t>(msg.size());
+    hdr.type = type;
+    hdr.recv_ns = recv_ns;
+
+    auto copy_in = [&](uint64_t pos, const char *src, std::size_t n)
+    {
+        const std::size_t off = pos & mask_;
+        const std::size_t first = std::min(n, cap - off);
+        std::memcpy(ring_.get() + off, src, first);
+        std::memcpy(ring_.get(), src + first, n - first);
+    };
+
+    while (lock_.test_and_set(std::memory_order_acquire))
+        ;
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head + need - tail_.load(std::memory_order_acquire) > cap)
+    {
+        lock_.clear(std::memory_order_release);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    copy_in(head, reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    copy_in(head + sizeof(hdr), msg.data(), msg.size());
+    head_.store(head + need, std::memory_order_release);
+    lock_.clear(std::memory_order_release);
+    recorded_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool FeedRecorder::pop(RecordHeader &hdr)
+{
+    const std::size_t cap = mask_ + 1;
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+        return false;
+    auto copy_out = [&](uint64_t pos, char *dst, std::size_t n)
+    {
+        const std::size_t off = pos & mask_;
+        const std::size_t first = std::min(n, cap - off);
+        std::memcpy(dst, ring_.get() + off, first);
+        std::memcpy(dst + first, ring_.get(), n - first);
+    };
+    copy_out(tail, reinterpret_cast<char *>(&hdr), sizeof(hdr));
+    scratch_.resize(hdr.size);
+    copy_out(tail + sizeof(hdr), scratch_.data(), hdr.size);
+    tail_.store(tail + sizeof(hdr) + align8(hdr.size), std::memory_order_release);
+    return true;
+}
+
+void FeedRecorder::run()
+{
+    RecordHeader hdr{};
+    auto process = [&]
+    {
+        append(hdr.type, hdr.recv_ns, scratch_.data(), scratch_.size());
+        if (cfg_.normalize && hdr.type == RecordType::RawPublic)
+            append_normalized(hdr.recv_ns, scratch_);
+    };
+    for (;;)
+    {
+        if (pop(hdr))
+        {
+            process();
+            continue;
+        }
+        // Idle: push what we have to the kernel so a crash loses at most the ring.
+        flush();
+        if (!running_.load())
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // Producers may have raced the shutdown; drain what made it in.
+    while (pop(hdr))
+        process();
+    flush();
+    close_file();
+}
+
+void FeedRecorder::append(RecordType type, int64_t recv_ns, const void *payload, std::size_t size)
+{
+    rotate_if_needed(recv_ns);
+    if (fd_ < 0)
+        return;
+    RecordHeader hdr{};
+    hdr.size = static_cast<uint32_t>(size);
+    hdr.type = type;
+    hdr.recv_ns = recv_ns;
+    const auto *h = reinterpret_cast<const char *>(&hdr);
+    out_.insert(out_.end(), h, h + sizeof(hdr));
+    const auto *p = static_cast<const char *>(payload);
+    out_.insert(out_.end(), p, p + size);
+    out_.resize(out_.size() + (align8(size) - size), '\0');
+    if (out_.size() >= cfg_.write_chunk)
+        flush();
+}
+
+void FeedRecorder::append_normalized(int64_t recv_ns, std::string_view msg)
+{
+    PublicMessage m;
+    if (!parse_public_message(msg, m))
+        return;
+    norm_.clear();
+    switch (m.kind)
+    {
+    case PublicTopic::Orderbook:
+    {
+        BookUpdateRecord rec{};
+        set_record_symbol(rec.symbol, m.symbol);
+        rec.update_id = m.update_id;
+        rec.seq = m.seq;
+        rec.ts_ms = m.ts_ms;
+        rec.is_snapshot = m.is_snapshot ? 1 : 0;
+        put(norm_, rec);
+        uint32_t n = 0;
+        auto add = [&](Price px, Qty qty)
+        {
+            put(norm_, LevelRecord{px.raw, qty.raw});
+            ++n;
+        };
+        if (!m.bids.empty() && !for_each_level(m.bids, add))
+            return;
+        rec.bid_count = n;
+        n = 0;
+        if (!m.asks.empty() && !for_each_level(m.asks, add))
+            return;
+        rec.ask_count = n;
+        std::memcpy(norm_.data(), &rec, sizeof(rec));
+        append(RecordType::BookUpdate, recv_ns, norm_.data(), norm_.size());
+        break;
+    }
+    case PublicTopic::Ticker:
+    {
+        TickerRecord rec{};
+        set_record_symbol(rec.symbol, m.symbol);
+        auto &t = tickers_[std::string(m.symbol)];
+        if (!merge_ticker_fields(m.data, m.ts_ms, t))
+            return;
+        t.recv_ns = recv_ns;
+        rec.ticker = t;
+        append(RecordType::Ticker, recv_ns, &rec, sizeof(rec));
+        break;
+    }
+    case PublicTopic::PublicTrade:
+    {
+        TradesRecord rec{};
+        set_record_symbol(rec.symbol, m.symbol);
+        put(norm_, rec);
+        const bool ok = for_each_trade(m.data, [&](const PublicTrade &t)
+                                       {
+            TradeRecord tr{};
+            tr.ts_ms = t.ts_ms;
+            tr.price_raw = t.price.raw;
+            tr.qty_raw = t.qty.raw;
+            tr.is_buy = t.is_buy ? 1 : 0;
+            put(norm_, tr);
+            ++rec.count; });
+        if (!ok)
+            return;
+        std::memcpy(norm_.data(), &rec, sizeof(rec));
+        append(RecordType::Trades, recv_ns, norm_.data(), norm_.size());
+        break;
+    }
+    case PublicTopic::Unknown:
+        break;
+    }
+}
+
+void FeedRecorder::rotate_if_needed(int64_t recv_ns)
+{
+    const int64_t wall_ns = anchor_wall_ns_ + (recv_ns - anchor_steady_ns_);
+    const int64_t hour = wall_ns / kHourNs;
+    if (hour == file_hour_ && (fd_ >= 0 || recv_ns < open_retry_ns_))
+        return;
+    flush();
+    close_file();
+    file_hour_ = hour;
+    std::string path;
+    fd_ = open_hour_file(wall_ns, path);
+    if (fd_ < 0)
+    {
+        // Reported once per outage; every append would otherwise retry the open.
+        open_retry_ns_ = recv_ns + kOpenRetryNs;
+        if (!failing_)
+            log_event(kLogOpenFailed, path, std::strerror(errno));
+        failing_ = true;
+        return;
+    }
+    if (failing_)
+        log_event(kLogRecovered, path);
+    failing_ = false;
+    std::lock_guard<std::mutex> lk(path_mu_);
+    path_ = path;
+}
+
+int FeedRecorder::open_hour_file(int64_t wall_ns, std::string &path)
+{
+    for (int session = 0; session < kMaxSessionsPerHour; ++session)
+    {
+        path = file_name(cfg_.dir, cfg_.prefix, wall_ns, session);
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return -1;
+        struct stat st{};
+        if (::fstat(fd, &st) == 0 && st.st_size == 0)
+        {
+            FileHeader fh{};
+            std::memcpy(fh.magic, kRecordMagic, sizeof(fh.magic));
+            fh.version = kRecordVersion;
+            fh.wall_ns = anchor_wall_ns_;
+            fh.steady_ns = anchor_steady_ns_;
+            const auto *p = reinterpret_cast<const char *>(&fh);
+            out_.insert(out_.end(), p, p + sizeof(fh));
+            return fd;
+        }
+        // Reopened after a failure within this session: the anchor in the header is ours.
+        FileHeader fh{};
+        if (::pread(fd, &fh, sizeof(fh), 0) == static_cast<ssize_t>(sizeof(fh)) &&
+            std::memcmp(fh.magic, kRecordMagic, sizeof(fh.magic)) == 0 && fh.wall_ns == anchor_wall_ns_ &&
+            fh.steady_ns == anchor_steady_ns_)
+            return fd;
+        ::close(fd);
+    }
+    errno = EEXIST;
+    return -1;
+}
+
+void FeedRecorder::flush()
+{
+    std::size_t off = 0;
+    while (fd_ >= 0 && off < out_.size())
+    {
+        const ssize_t n = ::write(fd_, out_.data() + off, out_.size() - off);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (!failing_)
+                log_event(kLogWriteFailed, current_path(), std::strerror(errno));
+            failing_ = true;
+            break;
+        }
+        off += static_cast<std::size_t>(n);
+    }
+    if (failing_ && off > 0 && off == out_.size())
+    {
+        log_event(kLogRecovered, current_path());
+        failing_ = false;
+    }
+    bytes_written_.fetch_add(off, std::memory_order_relaxed);
+    out_.clear();
+}
+
+void FeedRecorder::close_file()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = -1;
+}
@@ -0,0 +1,321 @@
+#include "instrument_registry.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "async_logger.hpp"
+
+namespace
+{
+    constexpr LogFormat kLogRefreshFailed{LogLevel::Warn, "META", LogColor::Yellow, "instrument refresh failed: {}"};
+    constexpr LogFormat kLogCacheFailed{LogLevel::Warn, "META", LogColor::Yellow, "instrument cache {} not written: {}"};
+    constexpr LogFormat kLogChanged{LogLevel::Warn, "META", LogColor::Yellow, "{} changed: tick={} lot={} min_qty={}"};
+
+    std::string_view record_symbol(const InstrumentCacheRecord &r)
+    {
+        return std::string_view(r.symbol, strnlen(r.symbol, sizeof(r.symbol)));
+    }
+
+    bool symbol_less(const InstrumentCacheRecord &a, const InstrumentCacheRecord &b)
+    {
+        return record_symbol(a) < record_symbol(b);
+    }
+
+    InstrumentMeta to_meta(const InstrumentCacheRecord &r)
+    {
+        return InstrumentMeta{Price::from_raw(r.tick_raw), Qty::from_raw(r.lot_raw), Qty::from_raw(r.min_qty_raw)};
+    }
+
+    bool same(const InstrumentMeta &a, const InstrumentMeta &b)
+    {
+        return a.tick_size == b.tick_size && a.lot_size == b.lot_size && a.min_qty == b.min_qty;
+    }
+
+    int64_t wall_ms()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+} // namespace
+
+bool parse_instrument_item(const nlohmann::json &item, InstrumentMeta &out)
+{
+    // Exact decimal parse so tick/lot rounding later has no representation error.
+    auto step = [](const nlohmann::json &obj, const char *key, auto &value)
+    {
+        const auto it = obj.find(key);
+        return it != obj.end() && it->is_string() && std::decay_t<decltype(value)>::parse(it->get_ref<const std::string &>(), value);
+    };
+    const auto pf = item.find("priceFilter");
+    const auto lf = item.find("lotSizeFilter");
+    if (pf == item.end() || lf == item.end() || !pf->is_object() || !lf->is_object())
+        return false;
+    InstrumentMeta meta{};
+    if (!step(*pf, "tickSize", meta.tick_size) || !step(*lf, "qtyStep", meta.lot_size))
+        return false;
+    if (!step(*lf, "minQty", meta.min_qty) && !step(*lf, "minOrderQty", meta.min_qty) && !step(*lf, "minTradeNum", meta.min_qty))
+        return false;
+    out = meta;
+    return true;
+}
+
+InstrumentRegistry::InstrumentRegistry(Config cfg, Fetch fetch) : cfg_(std::move(cfg)), fetch_(std::move(fetch)) {}
+
+InstrumentRegistry::~InstrumentRegistry() { stop(); }
+
+bool InstrumentRegistry::load_cache()
+{
+    if (cfg_.cache_path.empty())
+        return false;
+    const int fd = ::open(cfg_.cache_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(InstrumentCacheHeader))
+    {
+        ::close(fd);
+        return false;
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+        return false;
+    InstrumentCacheHeader header;
+    std::memcpy(&header, p, sizeof(header));
+    const bool valid = std::memcmp(header.magic, kInstrumentCacheMagic, sizeof(kInstrumentCacheMagic)) == 0 &&
+                       header.version == kInstrumentCacheVersion && header.count > 0 &&
+                       size == sizeof(InstrumentCacheHeader) + header.count * sizeof(InstrumentCacheRecord);
+    std::vector<InstrumentCacheRecord> records;
+    if (valid)
+    {
+        const auto *first = reinterpret_cast<const InstrumentCacheRecord *>(static_cast<const char *>(p) + sizeof(InstrumentCacheHeader));
+        records.assign(first, first + header.count);
+    }
+    ::munmap(p, size);
+    if (!valid || !std::is_sorted(records.begin(), records.end(), symbol_less))
+        return false;
+
+    std::lock_guard<std::mutex> lg(mu_);
+    records_ = std::move(records);
+    fetched_ms_ = header.fetched_ms;
+    for (auto &w : watched_)
+    {
+        const auto *r = lookup(w.symbol);
+        w.meta = r ? std::optional<InstrumentMeta>(to_meta(*r)) : std::nullopt;
+    }
+    return true;
+}
+
+std::size_t InstrumentRegistry::refresh()
+{
+    std::lock_guard<std::mutex> one(refresh_mu_);
+    const nlohmann::json response = fetch_();
+    const int64_t fetched = wall_ms();
+    const auto result = response.find("result");
+    if (response.value("retCode", -1) != 0 || result == response.end() || !result->contains("list"))
+        throw std::runtime_error("unexpected instruments-info response: " + response.dump().substr(0, 200));
+
+    std::vector<InstrumentCacheRecord> records;
+    records.reserve((*result)["list"].size());
+    for (const auto &item : (*result)["list"])
+    {
+        const auto sym = item.find("symbol");
+        InstrumentMeta meta;
+        if (sym == item.end() || !sym->is_string() || !parse_instrument_item(item, meta))
+            continue;
+        const auto &name = sym->get_ref<const std::string &>();
+        if (name.empty() || name.size() >= sizeof(InstrumentCacheRecord::symbol))
+            continue;
+        InstrumentCacheRecord r{};
+        std::memcpy(r.symbol, name.data(), name.size());
+        r.tick_raw = meta.tick_size.raw;
+        r.lot_raw = meta.lot_size.raw;
+        r.min_qty_raw = meta.min_qty.raw;
+        records.push_back(r);
+    }
+    if (records.empty())
+        throw std::runtime_error("instruments-info listed no usable instrument");
+    std::sort(records.begin(), records.end(), symbol_less);
+
+    struct Change
+    {
+        int id;
+        std::string symbol;
+        InstrumentMeta meta;
+    };
+    std::vector<Change> changes;
+    {
+        std::lock_guard<std::mutex> lg(mu_);
+        records_ = records;
+        fetched_ms_ = fetched;
+        ++refreshes_;
+        for (std::size_t i = 0; i < watched_.size(); ++i)
+        {
+            auto &w = watched_[i];
+            const auto *r = lookup(w.symbol);
+            if (!r)
+                continue; // delisted or missing from this page; keep trading on the last known filters
+            const InstrumentMeta now = to_meta(*r);
+            if (w.meta && !same(*w.meta, now))
+                changes.push_back({static_cast<int>(i), w.symbol, now});
+            w.meta = now;
+        }
+    }
+
+    if (!cfg_.cache_path.empty())
+    {
+        try
+        {
+            save_cache(records, fetched);
+        }
+        catch (const std::exception &ex)
+        {
+            log_event(kLogCacheFailed, cfg_.cache_path, ex.what());
+        }
+    }
+    for (const auto &c : changes)
+    {
+        log_event(kLogChanged, c.symbol, c.meta.tick_size.str(), c.meta.lot_size.str(), c.meta.min_qty.str());
+        if (listener_)
+            listener_(c.id, c.symbol, c.meta);
+    }
+    return changes.size();
+}
+
+void InstrumentRegistry::save_cache(const std::vector<InstrumentCacheRecord> &records, int64_t fetched_ms) const
+{
+    InstrumentCacheHeader header{};
+    std::memcpy(header.magic, kInstrumentCacheMagic, sizeof(kInstrumentCacheMagic));
+    header.version = kInstrumentCacheVersion;
+    header.count = static_cast<uint32_t>(records.size());
+    header.fetched_ms = fetched_ms;
+
+    // Write aside and rename, so a reader (or a crash) never sees a half-written file.
+    const std::string tmp = cfg_.cache_path + ".tmp";
+    std::FILE *f = std::fopen(tmp.c_str(), "wb");
+    if (!f)
+        throw std::runtime_error(std::strerror(errno));
+    const bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+                    std::fwrite(records.data(), sizeof(InstrumentCacheRecord), records.size(), f) == records.size();
+    if (std::fclose(f) != 0 || !ok)
+    {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("short write");
+    }
+    if (std::rename(tmp.c_str(), cfg_.cache_path.c_str()) != 0)
+    {
+        const std::string err = std::strerror(errno);
+        std::remove(tmp.c_str());
+        throw std::runtime_error(err);
+    }
+}
+
+const InstrumentCacheRecord *InstrumentRegistry::lookup(std::string_view symbol) const
+{
+    const auto it = std::lower_bound(records_.begin(), records_.end(), symbol,
+                                     [](const InstrumentCacheRecord &r, std::string_view s)
+                                     { return record_symbol(r) < s; });
+    return it != records_.end() && record_symbol(*it) == symbol ? &*it : nullptr;
+}
+
+std::optional<InstrumentMeta> InstrumentRegistry::find(std::string_view symbol) const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    const auto *r = lookup(symbol);
+    if (!r)
+        return std::nullopt;
+    return to_meta(*r);
+}
+
+int InstrumentRegistry::watch(const std::string &symbol)
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    for (std::size_t i = 0; i < watched_.size(); ++i)
+        if (watched_[i].symbol == symbol)
+            return static_cast<int>(i);
+    const auto *r = lookup(symbol);
+    watched_.push_back({symbol, r ? std::optional<InstrumentMeta>(to_meta(*r)) : std::nullopt});
+    return static_cast<int>(watched_.size() - 1);
+}
+
+std::optional<InstrumentMeta> InstrumentRegistry::meta(int id) const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    if (id < 0 || static_cast<std::size_t>(id) >= watched_.size())
+        return std::nullopt;
+    return watched_[static_cast<std::size_t>(id)].meta;
+}
+
+void InstrumentRegistry::start(bool refresh_now)
+{
+    if (worker_.joinable() || cfg_.refresh_interval.count() <= 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lg(stop_mu_);
+        stop_ = false;
+    }
+    worker_ = std::thread([this, refresh_now]
+                          { run(refresh_now); });
+}
+
+void InstrumentRegistry::stop()
+{
+    {
+        std::lock_guard<std::mutex> lg(stop_mu_);
+        stop_ = true;
+    }
+    stop_cv_.notify_all();
+    if (worker_.joinable())
+        worker_.join();
+}
+
+void InstrumentRegistry::run(bool refresh_now)
+{
+    bool due = refresh_now;
+    while (true)
+    {
+        if (due)
+        {
+            try
+            {
+                refresh();
+            }
+            catch (const std::exception &ex)
+            {
+                log_event(kLogRefreshFailed, ex.what());
+            }
+        }
+        std::unique_lock<std::mutex> lk(stop_mu_);
+        if (stop_cv_.wait_for(lk, cfg_.refresh_interval, [this]
+                              { return stop_; }))
+            return;
+        due = true;
+    }
+}
+
+std::size_t InstrumentRegistry::size() const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    return records_.size();
+}
+
+int64_t InstrumentRegistry::fetched_ms() const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    return fetched_ms_;
+}
+
+uint64_t InstrumentRegistry::refreshes() const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    return refreshes_;
+}
@@ -0,0 +1,108 @@
+#include "latency_stats.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    constexpr std::size_t kStages = static_cast<std::size_t>(LatencyStage::Count);
+
+    std::array<LatencyHistogram, kStages> g_histograms;
+
+    double us(int64_t ns) { return static_cast<double>(ns) / 1000.0; }
+} // namespace
+
+const char *latency_stage_name(LatencyStage stage)
+{
+    switch (stage)
+    {
+    case LatencyStage::WsParse:
+        return "ws_parse";
+    case LatencyStage::BookUpdate:
+        return "book_update";
+    case LatencyStage::FeedToStrategy:
+        return "feed_to_strategy";
+    case LatencyStage::Strategy:
+        return "strategy";
+    case LatencyStage::GatewayQueue:
+        return "gateway_queue";
+    case LatencyStage::OrderAck:
+        return "order_ack";
+    case LatencyStage::TickToTrade:
+        return "tick_to_trade";
+    case LatencyStage::HttpConnect:
+        return "http_connect";
+    case LatencyStage::HttpRequest:
+        return "http_request";
+    case LatencyStage::Count:
+        break;
+    }
+    return "unknown";
+}
+
+LatencyHistogram &latency_histogram(LatencyStage stage) { return g_histograms[static_cast<std::size_t>(stage)]; }
+
+LatencyHistogram::Summary LatencyHistogram::summary(bool reset)
+{
+    std::array<uint64_t, kBuckets> counts;
+    Summary s;
+    for (int i = 0; i < kBuckets; ++i)
+    {
+        counts[i] = reset ? counts_[i].exchange(0, std::memory_order_relaxed) : counts_[i].load(std::memory_order_relaxed);
+        s.count += counts[i];
+    }
+    const uint64_t max = reset ? max_.exchange(0, std::memory_order_relaxed) : max_.load(std::memory_order_relaxed);
+    s.max = static_cast<int64_t>(max);
+    if (s.count == 0)
+        return s;
+
+    auto at = [&](double q)
+    {
+        // Smallest value with at least q of the samples at or below it.
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(s.count) + 0.999999));
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+                return static_cast<int64_t>(std::min(bucket_high(i), max));
+        }
+        return s.max;
+    };
+    s.p50 = at(0.50);
+    s.p99 = at(0.99);
+    s.p999 = at(0.999);
+    return s;
+}
+
+LatencyReporter::LatencyReporter(std::string csv_path) : csv_path_(std::move(csv_path)) {}
+
+void LatencyReporter::report(std::ostream &log)
+{
+    std::ofstream csv;
+    if (!csv_path_.empty())
+    {
+        const bool fresh = !header_checked_ && !std::filesystem::exists(csv_path_);
+        csv.open(csv_path_, std::ios::app);
+        if (!csv.is_open())
+            std::cerr << "[T2T] cannot open " << csv_path_ << "\n";
+        else if (fresh)
+            csv << "wall_ms,stage,count,p50_ns,p99_ns,p999_ns,max_ns\n";
+        header_checked_ = true;
+    }
+    const auto wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    for (std::size_t i = 0; i < kStages; ++i)
+    {
+        const auto stage = static_cast<LatencyStage>(i);
+        const auto s = g_histograms[i].summary(true);
+        if (s.count == 0)
+            continue;
+        log << "[T2T] " << latency_stage_name(stage) << " n=" << s.count << " p50_us=" << us(s.p50) << " p99_us=" << us(s.p99)
+            << " p999_us=" << us(s.p999) << " max_us=" << us(s.max) << "\n";
+        if (csv.is_open())
+            csv << wall_ms << ',' << latency_stage_name(stage) << ',' << s.count << ',' << s.p50 << ',' << s.p99 << ','
+                << s.p999 << ',' << s.max << '\n';
+    }
+}
@@ -1,56 +1,41 @@
 #include "strategy.hpp"
 
 #include <cmath>
-#include <iostream>
-#include <sstream>
 #include <chrono>
-#include <nlohmann/json.hpp>
+
+#include "async_logger.hpp"
 
 namespace
 {
-    double round_down(double value, double step)
-    {
-        if (step <= 0)
-            return value;
-        return std::floor(value / step) * step;
-    }
-
-    std::string to_string_prec(double v)
-    {
-        std::ostringstream oss;
-        oss.setf(std::ios::fixed);
-        oss.precision(8);
-        oss << v;
-        return oss.str();
-    }
+    // Exact: the double is only used to get onto the 1e-8 grid, the tick floor is integer math.
+    Price round_down(double value, Price tick) { return Price::from_double(value).floor_to(tick); }
+
+    constexpr LogFormat kLogEmptyBook{LogLevel::Warn, "", LogColor::None, "Orderbook empty for {}"};
+    constexpr LogFormat kLogBadSpread{LogLevel::Warn, "", LogColor::None, "Non-positive spread for {}"};
+    constexpr LogFormat kLogQuote{LogLevel::Info, "MM-LO", LogColor::None,
+                                  "{} mid={} live_spread_bps={} target_spread_bps={} bid@{} base_qty={} net={} [{}]"};
+    constexpr LogFormat kLogFlattenDeferred{LogLevel::Warn, "SL", LogColor::Red, "order queue full, flatten of {} deferred"};
+    constexpr LogFormat kLogGrossCap{LogLevel::Info, "MM-LO", LogColor::None, "gross cap hit, skip new bids gross={} cap={}"};
+    constexpr LogFormat kLogStop{LogLevel::Info, "SL-LO", LogColor::Red, "flattening long size={} at mid={} stop={}"};
+    constexpr LogFormat kLogSnapshotError{LogLevel::Error, "", LogColor::None, "Error processing snapshot for {}: {}"};
 } // namespace
 
 void LongOnlyMarketMakerStrategy::on_snapshot(const MarketDataSnapshot &snapshot, TradingHelper &helper, bool live_trading, const PositionView &pos)
 {
-    const nlohmann::json *ob_ptr = &snapshot.orderbook;
-    if (snapshot.orderbook.contains("result"))
-        ob_ptr = &snapshot.orderbook["result"];
-    const auto &ob = *ob_ptr;
-    if (!ob.contains("b") || !ob.contains("a"))
+    const auto &book = snapshot.book;
+    if (!book.valid())
     {
-        std::cerr << "Orderbook missing b/a for " << snapshot.symbol << "\n";
+        log_event(kLogEmptyBook, snapshot.symbol);
         return;
     }
     try
     {
-        const auto &bids = ob["b"];
-        const auto &asks = ob["a"];
-        if (bids.empty() || asks.empty())
-        {
-            std::cerr << "Orderbook empty for " << snapshot.symbol << "\n";
-            return;
-        }
-        const double best_bid = std::stod(bids[0][0].get<std::string>());
-        const double best_ask = std::stod(asks[0][0].get<std::string>());
+        const double best_bid = book.best_bid().to_double();
+        const double best_ask = book.best_ask().to_double();
         const double live_spread = best_ask - best_bid;
         if (live_spread <= 0)
         {
-            std::cerr << "Non-positive spread for " << snapshot.symbol << "\n";
+            log_event(kLogBadSpread, snapshot.symbol);
             return;
         }
         const double mid = 0.5 * (best_ask + best_bid);
@@ -62,12 +47,12 @@ void LongOnlyMarketMakerStrategy::on_snapshot(const MarketDataSnapshot &snapshot
 
         // Price rounding.
         const double raw_bid_px = mid - half_spread_abs;
-        const double bid_px = round_down(raw_bid_px, meta_.tick_size);
+        const Price bid_px = round_down(raw_bid_px, meta_.tick_size);
 
         // Base size: min tradable size.
-        double base_qty = round_down(meta_.min_qty, meta_.lot_size);
-        if (base_qty < meta_.min_qty)
-            base_qty = meta_.min_qty;
+        const Qty base_qty = meta_.min_qty.ceil_to(meta_.lot_size);
+
+        const double min_qty = meta_.min_qty.to_double();
 
         // Inventory control: respect max net qty; if too long, pause bids.
         double net_qty = pos.long_size - pos.short_size;
@@ -77,64 +62,83 @@ void LongOnlyMarketMakerStrategy::on_snapshot(const MarketDataSnapshot &snapshot
         else
             bid_scale = std::max(0.2, 1.0 - (net_qty / max_net_qty_));
 
-        std::cout << "[MM-LO] " << snapshot.symbol << " mid=" << mid << " live_spread_bps=" << live_spread_bps
-                  << " target_spread_bps=" << target_spread_bps << " bid@" << bid_px
-                  << " base_qty=" << base_qty << " net=" << net_qty << (live_trading ? " [live]" : " [dry-run]") << "\n";
+        log_event(kLogQuote, snapshot.symbol, mid, live_spread_bps, target_spread_bps, bid_px, base_qty, net_qty,
+                  live_trading ? "live" : "dry-run");
 
         auto make_link = [&](const std::string &side)
         {
             const auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                                     std::chrono::system_clock::now().time_since_epoch())
                                     .count();
-            return side + "_mmlo_" + std::to_string(now_ms) + "_" + std::to_string(++order_counter_);
+            return side + "_mmlo_" + std::to_string(now_ms) + "_" + std::to_string(next_order_link_counter());
+        };
+        // Market exits go through the async gateway when enabled so the strategy thread never blocks on HTTP.
+        auto flatten = [&](const std::string &side, double qty, int pos_idx, const std::string &link)
+        {
+            const std::string lots = Qty::from_double(qty).round_to(meta_.lot_size).str();
+            if (helper.async_enabled())
+            {
+                if (!helper.async_submit_market_order(symbol_, side, lots, pos_idx, link, {}))
+                    log_event(kLogFlattenDeferred, symbol_);
+            }
+            else
+            {
+                helper.submit_market_order(symbol_, side, lots, pos_idx, link);
+            }
         };
 
         if (!live_trading || !helper.has_credentials())
             return;
 
-        // Cancel previous working orders.
-        helper.cancel_all(symbol_);
-
         // Gross notional guard.
         double gross_notional = (pos.long_size + pos.short_size) * mid;
         bool skip_new_bids = (gross_notional_cap_ > 0.0 && gross_notional >= gross_notional_cap_);
         if (skip_new_bids)
         {
-            std::cout << "[MM-LO] gross cap hit, skip new bids gross=" << gross_notional << " cap=" << gross_notional_cap_ << "\n";
+            log_event(kLogGrossCap, gross_notional, gross_notional_cap_);
         }
 
-        // Place bid ladder only.
+        // Bid ladder only; QuoteManager diffs against working orders.
+        desired_.clear();
         if (!skip_new_bids && bid_scale > 0.0)
         {
             for (int level = 1; level <= ladder_levels_; ++level)
             {
                 double level_offset = half_spread_abs * level;
-                double bid_ladder_px = round_down(mid - level_offset, meta_.tick_size);
-                double lvl_qty = base_qty;
-                helper.submit_limit_order(symbol_, "Buy", to_string_prec(lvl_qty * bid_scale), to_string_prec(bid_ladder_px), buy_pos_idx_, "Limit", make_link("bid"));
+                Price bid_ladder_px = round_down(mid - level_offset, meta_.tick_size);
+                desired_.push_back({"bid" + std::to_string(level), "Buy", bid_ladder_px, scaled_qty(meta_, base_qty, bid_scale), buy_pos_idx_});
             }
         }
 
         // Take-profit sells to lighten inventory.
-        if (net_qty > meta_.min_qty)
+        if (net_qty > min_qty)
         {
-            double tp_px = round_down(mid + (tp_spread_bps_ * 0.0001) * mid, meta_.tick_size);
-            helper.submit_limit_order(symbol_, "Sell", to_string_prec(base_qty), to_string_prec(tp_px), sell_pos_idx_, "Limit", make_link("tp_sell"));
+            Price tp_px = round_down(mid + (tp_spread_bps_ * 0.0001) * mid, meta_.tick_size);
+            desired_.push_back({"tp_sell", "Sell", tp_px, base_qty, sell_pos_idx_});
         }
 
+        quotes_.sync(desired_, helper);
+
         // Stop-loss: flatten long if price falls beyond threshold.
-        if (stop_loss_bps_ > 0.0 && pos.long_size > meta_.min_qty && pos.long_entry > 0.0)
+        if (stop_loss_bps_ > 0.0 && pos.long_size > min_qty && pos.long_entry > 0.0)
         {
             double stop_px = pos.long_entry * (1.0 - stop_loss_bps_ * 0.0001);
-            if (mid <= stop_px)
+            if (mid <= stop_px && long_exit_.due(pos.long_size, helper.orders()))
             {
-                helper.submit_market_order(symbol_, "Sell", to_string_prec(pos.long_size), sell_pos_idx_, make_link("sl_long"));
-                std::cout << "[SL-LO] flattening long size=" << pos.long_size << " at mid=" << mid << " stop=" << stop_px << "\n";
+                long_exit_ = {make_link("sl_long"), pos.long_size};
+                flatten("Sell", pos.long_size, sell_pos_idx_, long_exit_.link);
+                log_event(kLogStop, pos.long_size, mid, stop_px);
             }
         }
     }
     catch (const std::exception &ex)
     {
-        std::cerr << "Error processing snapshot for " << snapshot.symbol << ": " << ex.what() << "\n";
+        log_event(kLogSnapshotError, snapshot.symbol, ex.what());
     }
 }
+
+void LongOnlyMarketMakerStrategy::on_instrument_meta(const InstrumentMeta &meta)
+{
+    meta_ = meta;
+    quotes_.set_tolerance(requote_tolerance(meta_, requote_tol_ticks_), Qty::from_raw(meta_.lot_size.raw / 2));
+}
@@ -1,60 +1,92 @@
+#include <algorithm>
+#include <atomic>
+#include <csignal>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
 #include <thread>
 #include <vector>
-#include <fstream>
 #include <sstream>
-#include <mutex>
+#include <stdexcept>
+#include <type_traits>
 
 #include <nlohmann/json.hpp>
 #include <bybit/websocket_client.hpp>
 
+#include "async_logger.hpp"
+#include "env_config.hpp"
+#include "feed_recorder.hpp"
+#include "instrument_registry.hpp"
+#include "latency_stats.hpp"
 #include "market_data_feed.hpp"
 #include "pnl_tracker.hpp"
 #include "strategy.hpp"
+#include "strategy_shard.hpp"
+#include "symbol_table.hpp"
+#include "thread_affinity.hpp"
 #include "trading_helper.hpp"
+#include "ws_trade_transport.hpp"
 
 #ifndef DEFAULT_SIDE_MODE
 #define DEFAULT_SIDE_MODE "both"
 #endif
 
-// ANSI color helpers for log readability.
-constexpr const char *CLR_RESET = "\033[0m";
-constexpr const char *CLR_CYAN = "\033[36m";
-constexpr const char *CLR_YELLOW = "\033[33m";
-constexpr const char *CLR_GREEN = "\033[32m";
-constexpr const char *CLR_MAGENTA = "\033[35m";
-constexpr const char *CLR_BLUE = "\033[34m";
-constexpr const char *CLR_RED = "\033[31m";
+constexpr LogFormat kLogExecution{LogLevel::Info, "EXE", LogColor::Green, "link={} qty={} price={} pnl={} fee={} side={}"};
+constexpr LogFormat kLogKill{LogLevel::Error, "RISK", LogColor::Red, "net pnl {} below -{}: kill switch tripped, cancelling quotes; only position-reducing orders pass"};
+constexpr LogFormat kLogPnl{LogLevel::Info, "PNL", LogColor::Magenta, "realized={} fees={} funding={} upl={} net={}"};
+constexpr LogFormat kLogPosition{LogLevel::Info, "POS", LogColor::Yellow, "{} {} size={} entry={} upl={}"};
+constexpr LogFormat kLogPrivateError{LogLevel::Warn, "private_ws", LogColor::None, "parse error: {} raw={}"};
+constexpr LogFormat kLogResync{LogLevel::Warn, "", LogColor::None, "Resyncing orderbook (gaps={})"};
+constexpr LogFormat kLogRecorder{LogLevel::Info, "REC", LogColor::Cyan, "records={} dropped={} bytes={} file={}"};
+constexpr LogFormat kLogLine{LogLevel::Info, "", LogColor::None, "{}"};
+constexpr LogFormat kLogStopping{LogLevel::Info, "", LogColor::None, "Stopping: cancelling quotes"};
+constexpr LogFormat kLogShardFailed{LogLevel::Error, "SHARD", LogColor::Red, "strategy shard {} failed: {}"};
+constexpr LogFormat kLogCancelFailed{LogLevel::Error, "", LogColor::Red, "cancel_all {} failed on shutdown: {}"};
 
-inline std::string color_num(double v)
+namespace
 {
-    if (v > 0)
-        return std::string(CLR_GREEN) + std::to_string(v) + CLR_RESET;
-    if (v < 0)
-        return std::string(CLR_RED) + std::to_string(v) + CLR_RESET;
-    return std::to_string(v);
+    std::atomic<bool> g_stop{false};
+
+    void on_signal(int) { g_stop = true; }
+} // namespace
+
+void log_pnl(const PnlTracker::Totals &totals)
+{
+    log_event(kLogPnl, LogSigned{totals.realized}, totals.fees, LogSigned{totals.funding}, LogSigned{totals.unrealized},
+              LogSigned{totals.realized - totals.fees + totals.funding + totals.unrealized});
 }
 
-std::string get_env(const char *name, const std::string &fallback = "")
+// Shard quoting each symbol, indexed by SymbolId; null for symbols this process does not quote.
+using ShardRoutes = std::vector<StrategyShard *>;
+
+StrategyShard *route_of(const ShardRoutes &routes, SymbolId id)
 {
-    const char *v = std::getenv(name);
-    return v ? std::string{v} : fallback;
+    return id < routes.size() ? routes[id] : nullptr;
 }
 
 std::unique_ptr<bybit::WebSocketClient> start_private_ws(const std::string &endpoint,
                                                          const std::string &api_key,
                                                          const std::string &api_secret,
                                                          PnlTracker &pnl_tracker,
-                                                         PositionView &pos_view,
-                                                         std::mutex &pos_mu)
+                                                         const ShardRoutes &routes,
+                                                         FeedRecorder *recorder,
+                                                         ThreadRole role)
 {
     auto ws = std::make_unique<bybit::WebSocketClient>(endpoint, api_key, api_secret);
     ws->enable_auto_reconnect(true, 8);
-    ws->set_message_handler([&pnl_tracker, &pos_view, &pos_mu](const std::string &msg)
+    auto callback_role = std::make_shared<LazyThreadRole>();
+    callback_role->set(std::move(role));
+    // Order and position updates go to the shard quoting their symbol; PnL stays account-wide.
+    ws->set_message_handler([&pnl_tracker, &routes, recorder, callback_role](const std::string &msg)
                             {
+        callback_role->ensure();
+        if (recorder)
+            recorder->record_private(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count(),
+                                     msg);
         try
         {
             auto j = nlohmann::json::parse(msg);
@@ -95,7 +127,26 @@ std::unique_ptr<bybit::WebSocketClient> start_private_ws(const std::string &endp
                     return std::string{};
                 return as_string(obj.at(key));
             };
-            if (topic.find("execution") != std::string::npos && j.contains("data"))
+            // Resolved in place, without copying the symbol out of the parsed message.
+            auto symbol_id = [](const nlohmann::json &obj) -> SymbolId
+            {
+                const auto it = obj.find("symbol");
+                if (it == obj.end() || !it->is_string())
+                    return kNoSymbol;
+                return SymbolTable::global().find(it->get_ref<const std::string &>());
+            };
+            if ((topic == "order" || topic.rfind("order.", 0) == 0) && j.contains("data"))
+            {
+                OrderUpdate u;
+                for (const auto &d : j["data"])
+                {
+                    if (!parse_order_update(d, u))
+                        continue;
+                    if (auto *shard = route_of(routes, SymbolTable::global().find(u.symbol)))
+                        shard->helper().orders().apply(u);
+                }
+            }
+            else if (topic.find("execution") != std::string::npos && j.contains("data"))
             {
                 for (const auto &d : j["data"])
                 {
@@ -106,160 +157,64 @@ std::unique_ptr<bybit::WebSocketClient> start_private_ws(const std::string &endp
                     double pnl = get_num_field(d, "execPnl");
                     if (pnl == 0.0 && d.contains("closedPnl"))
                         pnl = get_num_field(d, "closedPnl");
-                    pnl_tracker.add_execution(link, pnl, fee);
-                    std::cout << CLR_GREEN << "[EXE]" << CLR_RESET << " link=" << link << " qty=" << get_str_field(d, "execQty") << " price=" << get_str_field(d, "execPrice")
-                              << " pnl=" << color_num(pnl) << " fee=" << fee << " side=" << get_str_field(d, "side") << "\n";
-                    auto totals = pnl_tracker.totals();
-                    double net = (totals.realized - totals.fees + totals.funding + totals.unrealized);
-                    std::cout << CLR_MAGENTA << "[PNL]" << CLR_RESET << " realized=" << color_num(totals.realized) << " fees=" << totals.fees
-                              << " funding=" << color_num(totals.funding) << " upl=" << color_num(totals.unrealized)
-                              << " net=" << color_num(net) << "\n";
+                    pnl_tracker.add_execution(link, pnl, fee, symbol_id(d));
+                    log_event(kLogExecution, link, get_str_field(d, "execQty"), get_str_field(d, "execPrice"), LogSigned{pnl}, fee,
+                              get_str_field(d, "side"));
+                    log_pnl(pnl_tracker.totals());
                 }
             }
             else if (topic.find("position") != std::string::npos && j.contains("data"))
             {
-                pnl_tracker.clear_unrealized();
                 double upl_sum = 0.0;
-                {
-                    std::lock_guard<std::mutex> lg(pos_mu);
-                    pos_view.long_size = 0.0;
-                    pos_view.short_size = 0.0;
-                    pos_view.long_entry = 0.0;
-                    pos_view.short_entry = 0.0;
-                }
+                std::vector<SymbolId> cleared;
                 for (const auto &p : j["data"])
                 {
                     const std::string sym = get_str_field(p, "symbol");
+                    const SymbolId id = symbol_id(p);
                     const std::string side = get_str_field(p, "side");
                     double size_val = as_double(p.value("size", "0"));
                     double upl_val = 0.0;
                     if (p.contains("unrealisedPnl"))
                         upl_val = as_double(p.at("unrealisedPnl"));
                     double funding_fee = get_num_field(p, "occFundingFee");
+                    auto *route = route_of(routes, id);
+                    if (route && std::find(cleared.begin(), cleared.end(), id) == cleared.end())
+                    {
+                        // The message replaces this symbol's position; sides it leaves out are flat.
+                        route->clear_position(sym);
+                        cleared.push_back(id);
+                    }
+                    // Keyed by position slot: a closed hedge side arrives with an empty side and zero UPL,
+                    // and must still overwrite that slot. Other symbols' slots are left alone. Positions in
+                    // symbols not quoted here are interned on first sight so account UPL stays complete.
+                    if (!sym.empty())
+                        pnl_tracker.set_unrealized(id != kNoSymbol ? id : SymbolTable::global().intern(sym),
+                                                   p.value("positionIdx", 0), upl_val);
                     if (!sym.empty() && !side.empty())
                     {
-                        pnl_tracker.set_unrealized(sym + "_" + side, upl_val);
                         if (funding_fee != 0.0)
                             pnl_tracker.add_funding(funding_fee);
-                        std::lock_guard<std::mutex> lg(pos_mu);
-                        if (side == "Buy")
-                        {
-                            pos_view.long_size = size_val;
-                            pos_view.long_entry = as_double(p.value("avgPrice", "0"));
-                        }
-                        else if (side == "Sell")
-                        {
-                            pos_view.short_size = size_val;
-                            pos_view.short_entry = as_double(p.value("avgPrice", "0"));
-                        }
+                        if (route)
+                            route->set_position(sym, side, size_val, as_double(p.value("avgPrice", "0")));
                         upl_sum += upl_val;
                     }
                     if (size_val > 0)
                     {
-                        std::cout << CLR_YELLOW << "[POS]" << CLR_RESET << " " << side << " size=" << size_val
-                                  << " entry=" << get_str_field(p, "avgPrice") << " upl=" << color_num(upl_val) << "\n";
+                        log_event(kLogPosition, sym, side, size_val, get_str_field(p, "avgPrice"), LogSigned{upl_val});
                     }
                 }
-                auto totals = pnl_tracker.totals();
-                double net = (totals.realized - totals.fees + totals.funding + totals.unrealized);
-                std::cout << CLR_MAGENTA << "[PNL]" << CLR_RESET << " realized=" << color_num(totals.realized) << " fees=" << totals.fees
-                          << " funding=" << color_num(totals.funding) << " upl=" << color_num(totals.unrealized)
-                          << " net=" << color_num(net) << "\n";
+                log_pnl(pnl_tracker.totals());
             }
         }
         catch (const std::exception &ex)
         {
-            std::cerr << "[private_ws] parse error: " << ex.what() << " raw=" << msg << "\n";
+            log_event(kLogPrivateError, ex.what(), msg);
         } });
     ws->connect();
-    ws->subscribe_topics({"privateExecution", "execution", "position"}, "private");
+    ws->subscribe_topics({"privateExecution", "execution", "position", "order"}, "private");
     return ws;
 }
 
-void load_env_file(const std::string &path)
-{
-    std::ifstream infile(path);
-    if (!infile.is_open())
-        return;
-    std::string line;
-    while (std::getline(infile, line))
-    {
-        // Trim leading/trailing spaces.
-        auto trim = [](std::string &s)
-        {
-            const char *ws = " \t\r\n";
-            auto start = s.find_first_not_of(ws);
-            auto end = s.find_last_not_of(ws);
-            if (start == std::string::npos)
-            {
-                s.clear();
-                return;
-            }
-            s = s.substr(start, end - start + 1);
-        };
-        trim(line);
-        if (line.empty() || line[0] == '#')
-            continue;
-        auto eq = line.find('=');
-        if (eq == std::string::npos || eq == 0)
-            continue;
-        std::string key = line.substr(0, eq);
-        std::string val = line.substr(eq + 1);
-        trim(key);
-        trim(val);
-        if (key.empty())
-            continue;
-        // Only set if not already set in environment.
-        if (std::getenv(key.c_str()) == nullptr)
-        {
-#ifdef _WIN32
-            _putenv_s(key.c_str(), val.c_str());
-#else
-            setenv(key.c_str(), val.c_str(), 0);
-#endif
-        }
-    }
-}
-
-std::optional<InstrumentMeta> parse_instrument_meta(const nlohmann::json &instruments, const std::string &symbol)
-{
-    if (!instruments.contains("result") || !instruments["result"].contains("list"))
-        return std::nullopt;
-    for (const auto &item : instruments["result"]["list"])
-    {
-        if (!item.contains("symbol"))
-            continue;
-        if (item["symbol"].get<std::string>() != symbol)
-            continue;
-        InstrumentMeta meta{};
-        try
-        {
-            if (item.contains("priceFilter") && item["priceFilter"].contains("tickSize"))
-            {
-                meta.tick_size = std::stod(item["priceFilter"]["tickSize"].get<std::string>());
-            }
-            if (item.contains("lotSizeFilter"))
-            {
-                const auto &lf = item["lotSizeFilter"];
-                if (lf.contains("qtyStep"))
-                    meta.lot_size = std::stod(lf["qtyStep"].get<std::string>());
-                if (lf.contains("minQty"))
-                    meta.min_qty = std::stod(lf["minQty"].get<std::string>());
-                else if (lf.contains("minOrderQty"))
-                    meta.min_qty = std::stod(lf["minOrderQty"].get<std::string>());
-                else if (lf.contains("minTradeNum"))
-                    meta.min_qty = std::stod(lf["minTradeNum"].get<std::string>());
-            }
-        }
-        catch (...)
-        {
-            return std::nullopt;
-        }
-        return meta;
-    }
-    return std::nullopt;
-}
-
 std::vector<std::string> list_symbols(const nlohmann::json &instruments, size_t limit = 10)
 {
     std::vector<std::string> out;
@@ -282,7 +237,16 @@ int main(int argc, char **argv)
     // Load .env if present so BYBIT_* vars can be picked up without exporting.
     load_env_file(".env");
 
-    const std::string symbol = (argc > 1) ? argv[1] : get_env("BYBIT_SYMBOL", "SUIUSDT");
+    // One symbol or a comma-separated list; every symbol shares the public feed subscription.
+    std::vector<std::string> symbols;
+    for (const auto &s : split_list((argc > 1) ? argv[1] : get_env("BYBIT_SYMBOLS", get_env("BYBIT_SYMBOL", "SUIUSDT"))))
+        if (std::find(symbols.begin(), symbols.end(), s) == symbols.end())
+            symbols.push_back(s);
+    if (symbols.empty())
+    {
+        std::cerr << "No symbols configured" << std::endl;
+        return 1;
+    }
     const std::string api_key = get_env("BYBIT_API_KEY");
     const std::string api_secret = get_env("BYBIT_API_SECRET");
     const std::string base_url = get_env("BYBIT_BASE_URL", "https://api.bybit.com");
@@ -292,7 +256,7 @@ int main(int argc, char **argv)
     const std::string ws_url = get_env("BYBIT_WS_PUBLIC_URL", "wss://stream.bybit.com/v5/public/linear");
     const std::string ws_private_url = get_env("BYBIT_WS_PRIVATE_URL", "wss://stream.bybit.com/v5/private");
     const bool run_live = get_env("BYBIT_RUN_LIVE", "0") == "1";
-    const double budget_usd = std::stod(get_env("BYBIT_BUDGET_USD", "10.0"));
+    const double budget_usd = std::stod(get_env("BYBIT_BUDGET_USD", "10.0")); // per symbol
     const double min_spread_bps = std::stod(get_env("BYBIT_MIN_SPREAD_BPS", "0.2"));
     const double spread_factor = std::stod(get_env("BYBIT_SPREAD_FACTOR", "1.0"));
     const double max_net_qty = std::stod(get_env("BYBIT_MAX_NET_QTY", "100.0"));
@@ -301,40 +265,102 @@ int main(int argc, char **argv)
     const double stop_loss_bps = std::stod(get_env("BYBIT_STOP_LOSS_BPS", "-1"));
     const double gross_notional_cap = std::stod(get_env("BYBIT_GROSS_NOTIONAL_CAP", "-1"));
     const std::string side_mode = get_env("BYBIT_SIDE_MODE", "both"); // both|long_only
+    const int book_depth = std::stoi(get_env("BYBIT_BOOK_DEPTH", "1")); // 1|50|200|500 (linear)
+    const int min_requote_ms = std::stoi(get_env("BYBIT_MIN_REQUOTE_MS", "250"));
+    const double requote_tol_ticks = std::stod(get_env("BYBIT_REQUOTE_TOL_TICKS", "0"));
+    const bool async_gateway = get_env("BYBIT_ASYNC_GATEWAY", "1") == "1";
+    const std::string trade_transport = get_env("BYBIT_TRADE_TRANSPORT", "rest"); // rest|ws
+    const std::string ws_trade_url = get_env("BYBIT_WS_TRADE_URL", "wss://stream.bybit.com/v5/trade");
+    const std::string record_dir = get_env("BYBIT_RECORD_DIR", ""); // empty = no recording
+    // Instrument metadata cache read at startup instead of downloading instruments-info; see README.
+    InstrumentRegistry::Config instrument_cfg;
+    instrument_cfg.cache_path = get_env("BYBIT_INSTRUMENT_CACHE", "instruments.cache"); // empty = always download
+    instrument_cfg.refresh_interval = std::chrono::seconds{std::stoi(get_env("BYBIT_INSTRUMENT_REFRESH_S", "300"))};
+    const int latency_report_s = std::stoi(get_env("BYBIT_LATENCY_REPORT_S", "10"));
+    const std::string latency_file = get_env("BYBIT_LATENCY_FILE", "latency.csv"); // empty = log only
+    // Worker threads; symbols are dealt round-robin. Never more shards than symbols.
+    const std::size_t shard_count = std::clamp<std::size_t>(std::stoul(get_env("BYBIT_SHARDS", "1")), 1, symbols.size());
+    std::vector<int> shard_cpus; // shard i is pinned to shard_cpus[i] when listed
+    for (const auto &c : split_list(get_env("BYBIT_SHARD_CPUS", "")))
+        shard_cpus.push_back(std::stoi(c));
+    // Thread placement: -1 = unpinned. The RT priority (SCHED_FIFO, 0 = off) applies to the feed,
+    // private stream and shard threads; busy-poll makes shards spin instead of sleeping.
+    const int feed_cpu = std::stoi(get_env("BYBIT_FEED_CPU", "-1"));
+    const int private_cpu = std::stoi(get_env("BYBIT_PRIVATE_CPU", "-1"));
+    const int main_cpu = std::stoi(get_env("BYBIT_MAIN_CPU", "-1"));
+    const int rt_priority = std::stoi(get_env("BYBIT_RT_PRIORITY", "0"));
+    const bool busy_poll = get_env("BYBIT_BUSY_POLL", "0") == "1";
+    const bool lock_memory = get_env("BYBIT_MLOCK", "0") == "1";
+    const std::size_t prefault_mb = std::stoul(get_env("BYBIT_PREFAULT_MB", "64"));
+    // Pre-trade risk limits applied to every order (0 = off); see README "Risk limits".
+    RiskEngine::Config risk_cfg;
+    risk_cfg.limits.max_order_notional = std::stod(get_env("BYBIT_RISK_MAX_ORDER_NOTIONAL", "0"));
+    risk_cfg.limits.max_working_notional = std::stod(get_env("BYBIT_RISK_MAX_WORKING_NOTIONAL", "0"));
+    risk_cfg.limits.max_position_notional = std::stod(get_env("BYBIT_RISK_MAX_POSITION_NOTIONAL", "0"));
+    risk_cfg.limits.price_band_bps = std::stod(get_env("BYBIT_RISK_PRICE_BAND_BPS", "0"));
+    risk_cfg.limits.fat_finger_bps = std::stod(get_env("BYBIT_RISK_FAT_FINGER_BPS", "0"));
+    risk_cfg.max_msgs_per_sec = std::stod(get_env("BYBIT_RISK_MAX_MSGS_PER_SEC", "0"));
+    const double max_loss = std::stod(get_env("BYBIT_RISK_MAX_LOSS", "0")); // trips the kill switch
+    // Client-side order rate limits, shared by every shard (they trade one account); see README "Rate limits".
+    RateLimiter::Config rate_cfg;
+    rate_cfg.orders_per_sec = std::stod(get_env("BYBIT_RATE_ORDERS_PER_SEC", "10"));
+    rate_cfg.quote_reserve = std::stod(get_env("BYBIT_RATE_QUOTE_RESERVE", "0.2"));
+    const auto rate_limiter = std::make_shared<RateLimiter>(rate_cfg);
+    AsyncLogger::Config log_cfg;
+    log_cfg.color = get_env("BYBIT_LOG_COLOR", "1") == "1";
+    log_cfg.json = get_env("BYBIT_LOG_JSON", "0") == "1";
+    log_cfg.path = get_env("BYBIT_LOG_FILE", ""); // empty = stdout/stderr
 
+    int exit_code = 0;
     try
     {
+        AsyncLogger::instance().start(log_cfg);
+        if (lock_memory && lock_process_memory(prefault_mb << 20, std::size_t{1} << 20))
+            std::cout << "Memory locked (" << prefault_mb << " MB heap pre-faulted)" << std::endl;
+        apply_thread_role({"main", main_cpu, 0});
+        // Startup queries only; each shard gets its own helper below.
         TradingHelper helper(api_key, api_secret, trade_category, base_url);
+        const bool trading = run_live && helper.has_credentials();
         PnlTracker pnl_tracker;
-        PositionView pos_view;
-        std::mutex pos_mu;
-        std::unique_ptr<bybit::WebSocketClient> private_ws;
-        if (run_live && helper.has_credentials())
+        std::unique_ptr<FeedRecorder> recorder;
+        if (!record_dir.empty())
         {
-            private_ws = start_private_ws(ws_private_url, api_key, api_secret, pnl_tracker, pos_view, pos_mu);
+            FeedRecorder::Config rec_cfg;
+            rec_cfg.dir = record_dir;
+            recorder = std::make_unique<FeedRecorder>(rec_cfg);
+            recorder->start();
+            std::cout << "Recording WS messages to " << record_dir << std::endl;
         }
 
-        // Instrument metadata for sizing/rounding (always query market category linear for perp instruments)
-        auto instruments = helper.fetch_instruments_info_for_category("linear");
-        std::cout << "[debug] instruments_info fetched\n";
-        auto meta_opt = parse_instrument_meta(instruments, symbol);
-        if (!meta_opt)
+        // Instrument metadata for sizing/rounding (always the linear category, for perp instruments).
+        // A complete cache skips the download; the background refresh then checks it right away.
+        InstrumentRegistry instruments(instrument_cfg, [&helper]
+                                       { return helper.fetch_instruments_info_for_category("linear"); });
+        auto cached_metas = [&]
+        {
+            for (const auto &symbol : symbols)
+                if (!instruments.find(symbol))
+                    return false;
+            return true;
+        };
+        const bool from_cache = instruments.load_cache() && cached_metas();
+        if (!from_cache)
+            instruments.refresh();
+        std::vector<InstrumentMeta> metas;
+        for (const auto &symbol : symbols)
         {
-            std::cerr << "Unable to parse instrument meta for " << symbol << "\n";
+            instruments.watch(symbol);
+            const auto meta = instruments.find(symbol);
+            if (!meta)
             {
-                for (const auto &item : instruments["result"]["list"])
-                {
-                    if (item.contains("symbol") && item["symbol"].get<std::string>() == symbol)
-                    {
-                        std::cerr << "\nInstrument entry for " << symbol << ": " << item.dump() << std::endl;
-                        break;
-                    }
-                }
+                std::cerr << "No usable linear instrument " << symbol << " in instruments-info (" << instruments.size()
+                          << " listed)" << std::endl;
+                return 1;
             }
-            std::cerr << "\nRaw instruments response (truncated): " << instruments.dump().substr(0, 2000) << std::endl;
-            return 1;
+            metas.push_back(*meta);
         }
-        auto meta = *meta_opt;
+        std::cout << "Instrument metadata for " << instruments.size() << " symbols "
+                  << (from_cache ? "loaded from " + instrument_cfg.cache_path : std::string("downloaded")) << std::endl;
 
         if (helper.has_credentials())
         {
@@ -354,83 +380,180 @@ int main(int argc, char **argv)
         }
 
         MarketDataFeed feed(ws_url);
-        feed.start({symbol}, 1);
+        feed.set_recorder(recorder.get());
+        feed.set_callback_role({"feed", feed_cpu, rt_priority});
+        feed.start(symbols, book_depth);
         if (!feed.wait_for_initial(std::chrono::milliseconds{5000}))
         {
             std::cerr << "Timed out waiting for initial market data" << std::endl;
             return 1;
         }
 
-        std::unique_ptr<IStrategy> strategy;
-        if (side_mode == "long_only")
+        std::vector<std::unique_ptr<StrategyShard>> shards;
+        for (std::size_t i = 0; i < shard_count; ++i)
         {
-            strategy = std::make_unique<LongOnlyMarketMakerStrategy>(symbol, meta, budget_usd, min_spread_bps, spread_factor, 1, 2, max_net_qty, tp_spread_bps, ladder_levels, stop_loss_bps, gross_notional_cap);
+            auto shard_helper = std::make_unique<TradingHelper>(api_key, api_secret, trade_category, base_url);
+            shard_helper->set_rate_limiter(rate_limiter);
+            if (trading)
+            {
+                if (trade_transport == "ws")
+                {
+                    WsTradeTransport::Config trade_cfg;
+                    trade_cfg.url = ws_trade_url;
+                    trade_cfg.api_key = api_key;
+                    trade_cfg.api_secret = api_secret;
+                    auto trade_ws = std::make_unique<WsTradeTransport>(trade_cfg);
+                    if (!trade_ws->start())
+                        std::cerr << "Trade WebSocket not authenticated yet; orders use REST until it is" << std::endl;
+                    shard_helper->set_trade_transport(std::move(trade_ws));
+                }
+                if (async_gateway)
+                    shard_helper->enable_async_gateway();
+                // Connect now rather than on the first order.
+                if (!shard_helper->warm_connections())
+                    std::cerr << "REST warm-up failed; the first order will open its own connection" << std::endl;
+            }
+            StrategyShard::Config shard_cfg;
+            shard_cfg.id = static_cast<int>(i);
+            shard_cfg.thread = {"shard-" + std::to_string(i), i < shard_cpus.size() ? shard_cpus[i] : -1, rt_priority};
+            shard_cfg.busy_poll = busy_poll;
+            shard_cfg.live = run_live;
+            shard_cfg.dispatch.min_requote_interval = std::chrono::milliseconds{min_requote_ms};
+            // Drift guard: a mid move of this many ticks re-quotes immediately; QuoteManager then amends
+            // the stale orders in place instead of cancelling them.
+            shard_cfg.drift_threshold_ticks = 2.0;
+            shard_cfg.risk = risk_cfg;
+            shards.push_back(std::make_unique<StrategyShard>(shard_cfg, feed, std::move(shard_helper)));
         }
-        else
+
+        ShardRoutes routes;
+        for (std::size_t i = 0; i < symbols.size(); ++i)
         {
-            strategy = std::make_unique<ExampleMarketMakerStrategy>(symbol, meta, budget_usd, min_spread_bps, spread_factor, 1, 2, max_net_qty, tp_spread_bps, ladder_levels, stop_loss_bps, gross_notional_cap);
+            const auto &symbol = symbols[i];
+            const auto &meta = metas[i];
+            std::unique_ptr<IStrategy> strategy;
+            if (side_mode == "long_only")
+            {
+                strategy = std::make_unique<LongOnlyMarketMakerStrategy>(symbol, meta, budget_usd, min_spread_bps, spread_factor, 1, 2, max_net_qty, tp_spread_bps, ladder_levels, stop_loss_bps, gross_notional_cap, requote_tol_ticks);
+            }
+            else
+            {
+                strategy = std::make_unique<ExampleMarketMakerStrategy>(symbol, meta, budget_usd, min_spread_bps, spread_factor, 1, 2, max_net_qty, tp_spread_bps, ladder_levels, stop_loss_bps, gross_notional_cap, requote_tol_ticks);
+            }
+            auto &shard = *shards[i % shard_count];
+            shard.add_symbol(symbol, meta, std::move(strategy));
+            const SymbolId id = SymbolTable::global().intern(symbol);
+            if (routes.size() <= id)
+                routes.resize(id + 1u, nullptr);
+            routes[id] = &shard;
         }
 
-        int i = 0;
-        double last_mid = -1.0;
-        const double drift_threshold_ticks = 2.0; // cancel/refresh if mid moves this many ticks
-        while (true)
+        // Exchange-side tick/lot changes go to the owning shard. The guard stops the refresh thread
+        // before the shards it feeds are destroyed.
+        instruments.set_listener([&routes](int, const std::string &symbol, const InstrumentMeta &meta)
+                                 {
+            if (auto *shard = route_of(routes, SymbolTable::global().find(symbol)))
+                shard->update_meta(symbol, meta); });
+        struct RefreshGuard
+        {
+            InstrumentRegistry &registry;
+            ~RefreshGuard() { registry.stop(); }
+        } refresh_guard{instruments};
+        instruments.start(from_cache);
+
+        // Routes are complete before the private stream starts, so its thread only ever reads them.
+        std::unique_ptr<bybit::WebSocketClient> private_ws;
+        if (trading)
+            private_ws = start_private_ws(ws_private_url, api_key, api_secret, pnl_tracker, routes, recorder.get(),
+                                          {"private", private_cpu, rt_priority});
+        for (auto &shard : shards)
+            shard->start();
+        std::signal(SIGINT, on_signal);
+        std::signal(SIGTERM, on_signal);
+        std::cout << "Quoting " << symbols.size() << " symbol(s) on " << shard_count << " shard(s); Ctrl-C to stop" << std::endl;
+
+        auto last_report = std::chrono::steady_clock::now();
+        auto last_latency_report = last_report;
+        LatencyReporter latency_reporter(latency_file);
+        std::ostringstream latency_text;
+        bool killed = false;
+        while (!g_stop)
         {
-            auto ob = feed.latest_orderbook(symbol);
-            auto tk = feed.latest_ticker(symbol);
-            if (!ob || !tk)
+            if (feed.needs_resync())
             {
-                std::cerr << "Missing data on tick " << i << std::endl;
+                log_event(kLogResync, feed.gap_count());
+                feed.resync();
+            }
+            // A failed shard stops the process, through the cleanup below so nothing is left quoting.
+            const auto failed = std::find_if(shards.begin(), shards.end(), [](const auto &shard)
+                                             { return shard->failed(); });
+            if (failed != shards.end())
+            {
+                log_event(kLogShardFailed, (*failed)->id(), (*failed)->error());
+                exit_code = 1;
                 break;
             }
-            MarketDataSnapshot snap{symbol, *tk, *ob};
-            // Detect mid drift vs last iteration to ensure stale orders are refreshed promptly.
-            double mid = 0.0;
-            try
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            if (trading && max_loss > 0.0 && !killed)
             {
-                const auto &bids = snap.orderbook["b"];
-                const auto &asks = snap.orderbook["a"];
-                if (!bids.empty() && !asks.empty())
+                const auto t = pnl_tracker.totals();
+                const double net = t.realized - t.fees + t.funding + t.unrealized;
+                if (net < -max_loss)
                 {
-                    double best_bid = std::stod(bids[0][0].get<std::string>());
-                    double best_ask = std::stod(asks[0][0].get<std::string>());
-                    mid = 0.5 * (best_bid + best_ask);
+                    // New risk stops here; each shard cancels its resting quotes on its own thread.
+                    killed = true;
+                    log_event(kLogKill, LogSigned{net}, max_loss);
+                    for (auto &shard : shards)
+                        shard->kill();
                 }
             }
-            catch (...)
-            {
-            }
-            if (last_mid > 0 && mid > 0)
+
+            // Shards log their own dispatch and gateway stats; account-wide reports stay here.
+            const auto now = std::chrono::steady_clock::now();
+            if (now - last_report >= std::chrono::seconds{1})
             {
-                double ticks_moved = std::abs(mid - last_mid) / meta.tick_size;
-                if (ticks_moved >= drift_threshold_ticks && run_live && helper.has_credentials())
+                last_report = now;
+                if (latency_report_s > 0 && now - last_latency_report >= std::chrono::seconds{latency_report_s})
                 {
-                    helper.cancel_all(symbol);
+                    last_latency_report = now;
+                    latency_text.str({});
+                    latency_reporter.report(latency_text);
+                    std::istringstream lines(latency_text.str());
+                    for (std::string line; std::getline(lines, line);)
+                        log_event(kLogLine, line);
+                }
+                if (recorder)
+                {
+                    log_event(kLogRecorder, recorder->recorded(), recorder->dropped(), recorder->bytes_written(), recorder->current_path());
+                }
+                if (trading)
+                {
+                    log_pnl(pnl_tracker.totals());
                 }
             }
-            PositionView pos_snapshot;
-            {
-                std::lock_guard<std::mutex> lg(pos_mu);
-                pos_snapshot = pos_view;
-            }
-            strategy->on_snapshot(snap, helper, run_live && helper.has_credentials(), pos_snapshot);
-            if (mid > 0)
-                last_mid = mid;
-            if (run_live && helper.has_credentials())
-            {
-                auto totals = pnl_tracker.totals();
-                std::cout << "[PNL] realized=" << color_num(totals.realized) << " fees=" << totals.fees
-                          << " funding=" << color_num(totals.funding) << " upl=" << color_num(totals.unrealized)
-                          << " net=" << color_num(totals.realized - totals.fees + totals.funding + totals.unrealized) << "\n";
-            }
-            ++i;
-            std::this_thread::sleep_for(std::chrono::seconds{1});
         }
 
         // Cleanup
-        if (run_live && helper.has_credentials())
+        log_event(kLogStopping);
+        for (auto &shard : shards)
         {
-            helper.cancel_all(symbol);
+            shard->stop();
+            if (trading)
+            {
+                for (const auto &symbol : shard->symbols())
+                {
+                    // One failed cancel must not skip the rest of the shutdown.
+                    try
+                    {
+                        shard->helper().cancel_all(symbol);
+                    }
+                    catch (const std::exception &ex)
+                    {
+                        log_event(kLogCancelFailed, symbol, ex.what());
+                        exit_code = 1;
+                    }
+                }
+            }
         }
         if (private_ws)
         {
@@ -438,6 +561,9 @@ int main(int argc, char **argv)
         }
 
         feed.stop();
+        if (recorder)
+            recorder->stop();
+        AsyncLogger::instance().stop();
         std::cout << "Done." << std::endl;
     }
     catch (const std::exception &ex)
@@ -445,5 +571,5 @@ int main(int argc, char **argv)
         std::cerr << "Error: " << ex.what() << std::endl;
         return 1;
     }
-    return 0;
+    return exit_code;
 }
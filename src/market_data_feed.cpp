@@ -1,37 +1,122 @@
 #include "market_data_feed.hpp"
 
-#include <iostream>
+#include <cstdlib>
 #include <optional>
 
 #include <nlohmann/json.hpp>
 
+#include "async_logger.hpp"
+
 namespace
 {
+    constexpr LogFormat kLogGap{LogLevel::Warn, "", LogColor::None, "Orderbook gap for {}, awaiting resync"};
+    constexpr LogFormat kLogBadMessage{LogLevel::Warn, "", LogColor::None, "Failed to handle WS message: {}"};
+
     bool is_ticker_topic(const std::string &topic) { return topic.rfind("tickers.", 0) == 0; }
     bool is_orderbook_topic(const std::string &topic) { return topic.rfind("orderbook.", 0) == 0; }
 
-    std::string extract_symbol(const std::string &topic)
+    std::string_view extract_symbol(std::string_view topic)
     {
         auto pos = topic.rfind('.');
-        if (pos == std::string::npos || pos + 1 >= topic.size())
+        if (pos == std::string_view::npos || pos + 1 >= topic.size())
             return topic;
         return topic.substr(pos + 1);
     }
+
+    double level_field(const nlohmann::json &v)
+    {
+        if (v.is_string())
+            return std::strtod(v.get_ref<const std::string &>().c_str(), nullptr);
+        if (v.is_number())
+            return v.get<double>();
+        return 0.0;
+    }
+
+    // Book levels arrive as decimal strings; parse them straight into fixed point.
+    template <typename T>
+    T fixed_field(const nlohmann::json &v)
+    {
+        T out;
+        if (v.is_string())
+            T::parse(v.get_ref<const std::string &>(), out);
+        else if (v.is_number())
+            out = T::from_double(v.get<double>());
+        return out;
+    }
+
+    // Ticker deltas only carry changed fields; leave absent ones untouched.
+    template <typename T>
+    void merge_field(const nlohmann::json &data, const char *key, T &out)
+    {
+        auto it = data.find(key);
+        if (it == data.end() || it->is_null())
+            return;
+        const double v = level_field(*it);
+        out = static_cast<T>(v);
+    }
+
+    void merge_ticker(const nlohmann::json &data, int64_t ts_ms, TickerSnapshot &t)
+    {
+        merge_field(data, "lastPrice", t.last_price);
+        merge_field(data, "markPrice", t.mark_price);
+        merge_field(data, "indexPrice", t.index_price);
+        merge_field(data, "bid1Price", t.bid1_price);
+        merge_field(data, "bid1Size", t.bid1_size);
+        merge_field(data, "ask1Price", t.ask1_price);
+        merge_field(data, "ask1Size", t.ask1_size);
+        merge_field(data, "fundingRate", t.funding_rate);
+        merge_field(data, "openInterest", t.open_interest);
+        merge_field(data, "volume24h", t.volume_24h);
+        merge_field(data, "turnover24h", t.turnover_24h);
+        merge_field(data, "nextFundingTime", t.next_funding_time_ms);
+        t.ts_ms = ts_ms;
+        ++t.updates;
+    }
 } // namespace
 
 MarketDataFeed::MarketDataFeed(std::string ws_url) : ws_(std::move(ws_url)) {}
 
 MarketDataFeed::~MarketDataFeed() { stop(); }
 
+void MarketDataFeed::prepare(const std::vector<std::string> &symbols, int depth)
+{
+    if (!states_.empty())
+        return;
+    symbols_ = symbols;
+    depth_ = depth;
+    auto &table = SymbolTable::global();
+    for (const auto &s : symbols_)
+    {
+        const SymbolId id = table.intern(s);
+        if (by_id_.size() <= id)
+            by_id_.resize(id + 1, nullptr);
+        if (!by_id_[id])
+        {
+            states_.push_back(std::make_unique<SymbolState>(static_cast<std::size_t>(depth > 0 ? depth : 1)));
+            by_id_[id] = states_.back().get();
+        }
+        by_index_.push_back(by_id_[id]);
+    }
+}
+
 void MarketDataFeed::start(const std::vector<std::string> &symbols, int depth)
 {
     if (running_)
         return;
+    prepare(symbols, depth);
     running_ = true;
     ws_.connect([this](const std::string &msg)
                 { handle_message(msg); });
-    ws_.subscribe_tickers(symbols);
-    ws_.subscribe_orderbook(symbols, depth);
+    subscribe();
+}
+
+void MarketDataFeed::subscribe()
+{
+    ws_.subscribe_tickers(symbols_);
+    ws_.subscribe_orderbook(symbols_, depth_);
+    // Trades are not used live, but the backtester's queue model needs them in recordings.
+    if (recorder_)
+        ws_.subscribe_trades(symbols_);
 }
 
 void MarketDataFeed::stop()
@@ -40,6 +125,20 @@ void MarketDataFeed::stop()
         return;
     running_ = false;
     ws_.close();
+    std::lock_guard<std::mutex> lk(m_);
+    cv_.notify_all();
+}
+
+void MarketDataFeed::resync()
+{
+    if (!running_)
+        return;
+    resync_requested_ = false;
+    // Reconnecting makes Bybit start every orderbook topic with a fresh snapshot.
+    ws_.close();
+    ws_.connect([this](const std::string &msg)
+                { handle_message(msg); });
+    subscribe();
 }
 
 bool MarketDataFeed::wait_for_initial(std::chrono::milliseconds timeout)
@@ -50,26 +149,228 @@ bool MarketDataFeed::wait_for_initial(std::chrono::milliseconds timeout)
                           { return got_ticker_.load() && got_orderbook_.load(); });
 }
 
-std::optional<nlohmann::json> MarketDataFeed::latest_ticker(const std::string &symbol) const
+uint64_t MarketDataFeed::wait_for_update(uint64_t seen, std::chrono::microseconds timeout)
 {
+    uint64_t cur = update_seq_.load(std::memory_order_acquire);
+    if (cur != seen)
+        return cur;
+    std::unique_lock<std::mutex> lk(m_);
+    ++waiters_;
+    cv_.wait_for(lk, timeout, [&]
+                 { return update_seq_.load() != seen || !running_.load(); });
+    --waiters_;
+    return update_seq_.load(std::memory_order_acquire);
+}
+
+void MarketDataFeed::notify_update(SymbolState &st)
+{
+    st.updates.fetch_add(1, std::memory_order_release);
+    update_seq_.fetch_add(1);
+    if (waiters_.load() > 0)
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        cv_.notify_all();
+    }
+}
+
+void MarketDataFeed::mark_initial()
+{
+    if (initial_signalled_.load(std::memory_order_relaxed) || !got_ticker_.load() || !got_orderbook_.load())
+        return;
+    initial_signalled_ = true;
     std::lock_guard<std::mutex> lk(m_);
-    auto it = tickers_.find(symbol);
-    if (it == tickers_.end())
+    cv_.notify_all();
+}
+
+const MarketDataFeed::SymbolState *MarketDataFeed::find(const std::string &symbol) const
+{
+    return find(SymbolTable::global().find(symbol));
+}
+
+MarketDataFeed::SymbolState *MarketDataFeed::find(SymbolId id) const
+{
+    return id < by_id_.size() ? by_id_[id] : nullptr;
+}
+
+bool MarketDataFeed::read_book(const std::string &symbol, BookSnapshot &out) const
+{
+    const auto *st = find(symbol);
+    if (!st)
+        return false;
+    st->book_pub.load(out);
+    return out.valid();
+}
+
+bool MarketDataFeed::read_ticker(const std::string &symbol, TickerSnapshot &out) const
+{
+    const auto *st = find(symbol);
+    if (!st)
+        return false;
+    st->ticker_pub.load(out);
+    return out.valid();
+}
+
+int MarketDataFeed::symbol_index(const std::string &symbol) const
+{
+    for (std::size_t i = 0; i < symbols_.size(); ++i)
+        if (symbols_[i] == symbol)
+            return static_cast<int>(i);
+    return -1;
+}
+
+const MarketDataFeed::SymbolState *MarketDataFeed::at(int index) const
+{
+    return index >= 0 && static_cast<std::size_t>(index) < by_index_.size() ? by_index_[index] : nullptr;
+}
+
+bool MarketDataFeed::read_book(int index, BookSnapshot &out) const
+{
+    const auto *st = at(index);
+    if (!st)
+        return false;
+    st->book_pub.load(out);
+    return out.valid();
+}
+
+bool MarketDataFeed::read_ticker(int index, TickerSnapshot &out) const
+{
+    const auto *st = at(index);
+    if (!st)
+        return false;
+    st->ticker_pub.load(out);
+    return out.valid();
+}
+
+uint64_t MarketDataFeed::symbol_seq(int index) const
+{
+    const auto *st = at(index);
+    return st ? st->updates.load(std::memory_order_acquire) : 0;
+}
+
+bool MarketDataFeed::best_bid_ask(const std::string &symbol, double &bid, double &ask) const
+{
+    BookSnapshot snap;
+    if (!read_book(symbol, snap))
+        return false;
+    bid = snap.best_bid().to_double();
+    ask = snap.best_ask().to_double();
+    return true;
+}
+
+std::optional<TickerSnapshot> MarketDataFeed::latest_ticker(const std::string &symbol) const
+{
+    TickerSnapshot t;
+    if (!read_ticker(symbol, t))
         return std::nullopt;
-    return it->second;
+    return t;
 }
 
-std::optional<nlohmann::json> MarketDataFeed::latest_orderbook(const std::string &symbol) const
+std::optional<BookSnapshot> MarketDataFeed::latest_book(const std::string &symbol) const
 {
-    std::lock_guard<std::mutex> lk(m_);
-    auto it = orderbooks_.find(symbol);
-    if (it == orderbooks_.end())
+    BookSnapshot snap;
+    if (!read_book(symbol, snap))
         return std::nullopt;
-    return it->second;
+    return snap;
+}
+
+bool MarketDataFeed::publish_book(SymbolState &st, std::string_view symbol, OrderBook::ApplyResult res, int64_t recv_ns)
+{
+    auto &book = st.book;
+    if (res == OrderBook::ApplyResult::Gap)
+    {
+        // Publish the now-empty book so readers stop quoting off stale levels.
+        book.snapshot(st.book_scratch);
+        st.book_scratch.recv_ns = recv_ns;
+        st.book_pub.store(st.book_scratch);
+        notify_update(st);
+        ++gap_count_;
+        resync_requested_ = true;
+        log_event(kLogGap, symbol);
+        return false;
+    }
+    if (res != OrderBook::ApplyResult::Applied)
+        return false;
+    book.snapshot(st.book_scratch);
+    st.book_scratch.recv_ns = recv_ns;
+    st.book_pub.store(st.book_scratch);
+    got_orderbook_ = true;
+    return true;
+}
+
+bool MarketDataFeed::handle_public(const PublicMessage &m, int64_t recv_ns)
+{
+    if (m.kind == PublicTopic::PublicTrade)
+        return true; // not consumed yet
+    auto *state = find(SymbolTable::global().find(m.symbol));
+    if (!state)
+        return true;
+    auto &st = *state;
+
+    if (m.kind == PublicTopic::Ticker)
+    {
+        if (!merge_ticker_fields(m.data, m.ts_ms, st.ticker))
+            return false;
+        st.ticker.recv_ns = recv_ns;
+        st.ticker_pub.store(st.ticker);
+        got_ticker_ = true;
+    }
+    else
+    {
+        auto &book = st.book;
+        auto res = book.begin_update(m.is_snapshot, m.update_id, m.seq, m.ts_ms);
+        if (res == OrderBook::ApplyResult::Applied)
+        {
+            bool levels_ok = m.bids.empty() || for_each_level(m.bids, [&](Price px, Qty qty)
+                                                               { book.set_bid(px, qty); });
+            levels_ok = levels_ok && (m.asks.empty() || for_each_level(m.asks, [&](Price px, Qty qty)
+                                                                       { book.set_ask(px, qty); }));
+            if (levels_ok)
+            {
+                res = book.end_update();
+            }
+            else
+            {
+                // Levels may have been half applied; treat as a gap rather than publish a bad book.
+                book.reset();
+                res = OrderBook::ApplyResult::Gap;
+            }
+        }
+        if (!publish_book(st, m.symbol, res, recv_ns))
+            return true;
+    }
+    notify_update(st);
+    mark_initial();
+    return true;
 }
 
 void MarketDataFeed::handle_message(const std::string &msg)
 {
+    callback_role_.ensure();
+    const int64_t recv_ns = latency_now_ns();
+    if (recorder_)
+        recorder_->record_public(recv_ns, msg);
+    apply(msg, recv_ns, true);
+}
+
+void MarketDataFeed::ingest(std::string_view msg, int64_t recv_ns) { apply(msg, recv_ns, false); }
+
+void MarketDataFeed::apply(std::string_view msg, int64_t recv_ns, bool live)
+{
+    PublicMessage fast;
+    const bool parsed = parse_public_message(msg, fast);
+    int64_t parsed_ns = 0;
+    if (live)
+    {
+        parsed_ns = latency_now_ns();
+        latency_record(LatencyStage::WsParse, parsed_ns - recv_ns);
+    }
+    if (parsed && handle_public(fast, recv_ns))
+    {
+        if (live)
+            latency_record(LatencyStage::BookUpdate, latency_now_ns() - parsed_ns);
+        return;
+    }
+    slow_path_count_.fetch_add(1, std::memory_order_relaxed);
     try
     {
         auto j = nlohmann::json::parse(msg);
@@ -80,26 +381,46 @@ void MarketDataFeed::handle_message(const std::string &msg)
         if (!j.contains("data"))
             return;
         const auto &data = j["data"];
+        auto *state = find(SymbolTable::global().find(symbol));
+        if (!state)
+            return;
+        auto &st = *state;
 
-        std::lock_guard<std::mutex> lk(m_);
         if (is_ticker_topic(topic))
         {
-            tickers_[symbol] = data;
+            merge_ticker(data, j.value("ts", int64_t{0}), st.ticker);
+            st.ticker.recv_ns = recv_ns;
+            st.ticker_pub.store(st.ticker);
             got_ticker_ = true;
         }
         else if (is_orderbook_topic(topic))
         {
-            orderbooks_[symbol] = data;
-            got_orderbook_ = true;
+            auto &book = st.book;
+            const bool is_snapshot = j.value("type", std::string{}) == "snapshot";
+            auto res = book.begin_update(is_snapshot, data.value("u", uint64_t{0}), data.value("seq", uint64_t{0}),
+                                         j.value("ts", int64_t{0}));
+            if (res == OrderBook::ApplyResult::Applied)
+            {
+                if (data.contains("b"))
+                    for (const auto &lvl : data["b"])
+                        book.set_bid(fixed_field<Price>(lvl[0]), fixed_field<Qty>(lvl[1]));
+                if (data.contains("a"))
+                    for (const auto &lvl : data["a"])
+                        book.set_ask(fixed_field<Price>(lvl[0]), fixed_field<Qty>(lvl[1]));
+                res = book.end_update();
+            }
+            if (!publish_book(st, symbol, res, recv_ns))
+                return;
         }
         else
         {
             return;
         }
-        cv_.notify_all();
+        notify_update(st);
+        mark_initial();
     }
     catch (const std::exception &e)
     {
-        std::cerr << "Failed to handle WS message: " << e.what() << "\n";
+        log_event(kLogBadMessage, e.what());
     }
 }
@@ -0,0 +1,140 @@
+#include "order_book.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+    // Insert/update/erase one level in a side sorted with Compare (best level at back()).
+    template <typename Compare>
+    void set_level(std::vector<BookLevel> &side, Price price, Qty qty, Compare cmp)
+    {
+        auto it = std::lower_bound(side.begin(), side.end(), price,
+                                   [&](const BookLevel &lvl, Price px)
+                                   { return cmp(lvl.price, px); });
+        const bool found = it != side.end() && it->price == price;
+        if (qty.raw <= 0)
+        {
+            if (found)
+                side.erase(it);
+            return;
+        }
+        if (found)
+            it->qty = qty;
+        else
+            side.insert(it, BookLevel{price, qty});
+    }
+
+    std::size_t copy_best_first(const std::vector<BookLevel> &side, BookLevel *out, std::size_t n)
+    {
+        const std::size_t count = std::min(n, side.size());
+        auto it = side.rbegin();
+        for (std::size_t i = 0; i < count; ++i, ++it)
+            out[i] = *it;
+        return count;
+    }
+} // namespace
+
+OrderBook::OrderBook(std::size_t max_depth) : max_depth_(max_depth == 0 ? 1 : max_depth)
+{
+    // Headroom so deltas that insert before end_update() trims do not reallocate.
+    bids_.reserve(2 * max_depth_);
+    asks_.reserve(2 * max_depth_);
+}
+
+void OrderBook::reset()
+{
+    bids_.clear();
+    asks_.clear();
+    update_id_ = 0;
+    seq_ = 0;
+    ts_ms_ = 0;
+    in_sync_ = false;
+    applying_ = false;
+}
+
+OrderBook::ApplyResult OrderBook::begin_update(bool is_snapshot, uint64_t update_id, uint64_t seq, int64_t ts_ms)
+{
+    applying_ = false;
+    if (is_snapshot)
+    {
+        bids_.clear();
+        asks_.clear();
+        in_sync_ = true;
+    }
+    else
+    {
+        if (!in_sync_)
+            return ApplyResult::Ignored;
+        if (update_id <= update_id_)
+            return ApplyResult::Ignored; // duplicate/stale delta
+        if (update_id != update_id_ + 1)
+        {
+            reset();
+            return ApplyResult::Gap;
+        }
+    }
+    update_id_ = update_id;
+    seq_ = seq;
+    ts_ms_ = ts_ms;
+    applying_ = true;
+    return ApplyResult::Applied;
+}
+
+void OrderBook::set_bid(Price price, Qty qty)
+{
+    if (applying_)
+        set_level(bids_, price, qty, std::less<Price>{});
+}
+
+void OrderBook::set_ask(Price price, Qty qty)
+{
+    if (applying_)
+        set_level(asks_, price, qty, std::greater<Price>{});
+}
+
+OrderBook::ApplyResult OrderBook::end_update()
+{
+    if (!applying_)
+        return in_sync_ ? ApplyResult::Ignored : ApplyResult::Gap;
+    applying_ = false;
+    if (!bids_.empty() && !asks_.empty() && bids_.back().price >= asks_.back().price)
+    {
+        reset();
+        return ApplyResult::Gap;
+    }
+    if (bids_.size() > max_depth_)
+        bids_.erase(bids_.begin(), bids_.begin() + static_cast<std::ptrdiff_t>(bids_.size() - max_depth_));
+    if (asks_.size() > max_depth_)
+        asks_.erase(asks_.begin(), asks_.begin() + static_cast<std::ptrdiff_t>(asks_.size() - max_depth_));
+    return ApplyResult::Applied;
+}
+
+bool OrderBook::best_bid(BookLevel &out) const
+{
+    if (bids_.empty())
+        return false;
+    out = bids_.back();
+    return true;
+}
+
+bool OrderBook::best_ask(BookLevel &out) const
+{
+    if (asks_.empty())
+        return false;
+    out = asks_.back();
+    return true;
+}
+
+std::size_t OrderBook::bids(BookLevel *out, std::size_t n) const { return copy_best_first(bids_, out, n); }
+
+std::size_t OrderBook::asks(BookLevel *out, std::size_t n) const { return copy_best_first(asks_, out, n); }
+
+void OrderBook::snapshot(BookSnapshot &out) const
+{
+    out.update_id = update_id_;
+    out.seq = seq_;
+    out.ts_ms = ts_ms_;
+    out.bid_count = static_cast<uint32_t>(bids(out.bids, kBookSnapshotDepth));
+    out.ask_count = static_cast<uint32_t>(asks(out.asks, kBookSnapshotDepth));
+}
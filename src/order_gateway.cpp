@@ -0,0 +1,409 @@
+#include "order_gateway.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include <nlohmann/json.hpp>
+
+#include "latency_stats.hpp"
+
+namespace
+{
+    // At most this many requests share one post_many() round.
+    constexpr std::size_t kMaxWave = 8;
+
+    const char *path_for(GatewayOp op)
+    {
+        switch (op)
+        {
+        case GatewayOp::CreateBatch:
+            return "/v5/order/create-batch";
+        case GatewayOp::AmendBatch:
+            return "/v5/order/amend-batch";
+        case GatewayOp::CancelBatch:
+            return "/v5/order/cancel-batch";
+        case GatewayOp::CancelAll:
+            return "/v5/order/cancel-all";
+        case GatewayOp::CreateOrder:
+            return "/v5/order/create";
+        }
+        return "";
+    }
+
+    RateEndpoint endpoint_of(GatewayOp op)
+    {
+        switch (op)
+        {
+        case GatewayOp::CreateBatch:
+        case GatewayOp::CreateOrder:
+            return RateEndpoint::Create;
+        case GatewayOp::AmendBatch:
+            return RateEndpoint::Amend;
+        case GatewayOp::CancelBatch:
+            return RateEndpoint::Cancel;
+        case GatewayOp::CancelAll:
+            return RateEndpoint::CancelAll;
+        }
+        return RateEndpoint::Create;
+    }
+
+    RatePriority priority_of(const GatewayRequest &req)
+    {
+        if (req.op == GatewayOp::CancelBatch || req.op == GatewayOp::CancelAll)
+            return RatePriority::Cancel;
+        if (req.op == GatewayOp::CreateOrder && req.orders[0].type == OrderType::Market)
+            return RatePriority::Exit;
+        return RatePriority::Quote;
+    }
+
+    // Requests that place, move or pull resting orders; a cancel-all makes them moot.
+    bool touches_resting_orders(const GatewayRequest &req)
+    {
+        return req.op != GatewayOp::CreateOrder || req.orders[0].type == OrderType::Limit;
+    }
+
+    bool amends_subset(const GatewayRequest &older, const GatewayRequest &newer)
+    {
+        for (uint32_t i = 0; i < older.count; ++i)
+        {
+            const auto &link = older.orders[i].order_link_id;
+            bool found = false;
+            for (uint32_t j = 0; j < newer.count && !found; ++j)
+                found = newer.orders[j].order_link_id == link;
+            if (link.empty() || !found)
+                return false;
+        }
+        return true;
+    }
+
+    bool supersedes(const GatewayRequest &newer, const GatewayRequest &older)
+    {
+        if (newer.symbol != older.symbol)
+            return false;
+        if (newer.op == GatewayOp::CancelAll)
+            return touches_resting_orders(older);
+        if (newer.op == GatewayOp::AmendBatch)
+            return older.op == GatewayOp::AmendBatch && amends_subset(older, newer);
+        return false;
+    }
+
+    int64_t wall_ms_now()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+} // namespace
+
+std::vector<bool> parse_batch_results(const std::string &raw, std::size_t n)
+{
+    std::vector<bool> ok(n, false);
+    auto j = nlohmann::json::parse(raw, nullptr, false);
+    if (j.is_discarded() || j.value("retCode", -1) != 0)
+        return ok;
+    const nlohmann::json *ext = nullptr;
+    if (j.contains("retExtInfo") && j["retExtInfo"].contains("list"))
+        ext = &j["retExtInfo"]["list"];
+    for (std::size_t i = 0; i < n; ++i)
+        ok[i] = !ext || i >= ext->size() || (*ext)[i].value("code", -1) == 0;
+    return ok;
+}
+
+std::vector<int> parse_batch_codes(const std::string &raw, std::size_t n)
+{
+    auto j = nlohmann::json::parse(raw, nullptr, false);
+    const int ret = j.is_object() ? j.value("retCode", -1) : -1;
+    std::vector<int> codes(n, ret);
+    if (ret != 0 || !j.contains("retExtInfo") || !j["retExtInfo"].contains("list"))
+        return codes;
+    const auto &ext = j["retExtInfo"]["list"];
+    for (std::size_t i = 0; i < n && i < ext.size(); ++i)
+        codes[i] = ext[i].value("code", -1);
+    return codes;
+}
+
+bool order_gone_code(int code)
+{
+    // order not exists / already completed or cancelled / already cancelled, and the spot variant
+    return code == 110001 || code == 110008 || code == 110010 || code == 170213;
+}
+
+OrderGateway::OrderGateway(std::string api_key,
+                           std::string api_secret,
+                           std::string category,
+                           std::string base_url,
+                           OrderStore *orders,
+                           std::size_t queue_capacity,
+                           RateLimiter *limiter)
+    : category_(std::move(category)),
+      orders_(orders),
+      limiter_(limiter),
+      transport_(std::move(api_key), std::move(api_secret), std::move(base_url)),
+      requests_(queue_capacity),
+      completions_(queue_capacity)
+{
+    io_ = std::thread([this]
+                      { run(); });
+}
+
+OrderGateway::~OrderGateway()
+{
+    stop_ = true;
+    {
+        std::lock_guard<std::mutex> lk(wake_mu_);
+        wake_cv_.notify_one();
+    }
+    if (io_.joinable())
+        io_.join();
+}
+
+bool OrderGateway::submit(GatewayRequest &&req)
+{
+    req.id = ++next_id_;
+    req.enqueue_ns = latency_now_ns();
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    if (!requests_.try_push(std::move(req)))
+    {
+        submitted_.fetch_sub(1, std::memory_order_relaxed);
+        rejected_full_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Pairs with the fence in run(): either we see the I/O thread asleep, or it sees our request.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (io_sleeping_.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lk(wake_mu_);
+        wake_cv_.notify_one();
+    }
+    return true;
+}
+
+std::size_t OrderGateway::poll()
+{
+    std::size_t n = 0;
+    Completion c;
+    while (completions_.try_pop(c))
+    {
+        if (c.on_done)
+            c.on_done(c.result);
+        ++n;
+    }
+    return n;
+}
+
+void OrderGateway::run()
+{
+    std::vector<GatewayRequest> pending;
+    std::vector<GatewayRequest> wave;
+    GatewayRequest req;
+    // Open the pool's connections before the first order needs them.
+    transport_.warm_pool(kMaxWave);
+    while (!stop_.load())
+    {
+        while (requests_.try_pop(req))
+        {
+            supersede(pending, req);
+            pending.push_back(std::move(req));
+        }
+        const int64_t wait_ns = pick_wave(pending, wave);
+        if (wave.empty())
+        {
+            // Idle, or everything queued is waiting for rate-limit tokens; a new request wakes us early.
+            if (pending.empty())
+                transport_.keep_warm();
+            std::unique_lock<std::mutex> lk(wake_mu_);
+            io_sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (requests_.empty() && !stop_.load())
+                wake_cv_.wait_for(lk, std::chrono::nanoseconds{wait_ns > 0 ? std::min<int64_t>(wait_ns, 1000000) : 1000000});
+            io_sleeping_.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        execute(wave);
+    }
+}
+
+void OrderGateway::supersede(std::vector<GatewayRequest> &pending, const GatewayRequest &incoming)
+{
+    for (auto it = pending.begin(); it != pending.end();)
+    {
+        if (!supersedes(incoming, *it))
+        {
+            ++it;
+            continue;
+        }
+        GatewayResult r;
+        r.id = it->id;
+        r.op = it->op;
+        r.superseded = true;
+        r.item_ok.assign(it->count == 0 ? 1 : it->count, false);
+        r.round_trip_ns = latency_now_ns() - it->enqueue_ns;
+        superseded_.fetch_add(1, std::memory_order_relaxed);
+        if (!complete(*it, std::move(r)))
+            return;
+        it = pending.erase(it);
+    }
+}
+
+int64_t OrderGateway::pick_wave(std::vector<GatewayRequest> &pending, std::vector<GatewayRequest> &wave)
+{
+    wave.clear();
+    if (pending.empty())
+        return 0;
+    auto &picked = picked_;
+    picked.assign(pending.size(), 0);
+    const int64_t now_ns = latency_now_ns();
+    int64_t wait_ns = 0;
+    std::size_t count = 0;
+    for (auto prio : {RatePriority::Cancel, RatePriority::Exit, RatePriority::Quote})
+    {
+        for (std::size_t i = 0; i < pending.size() && count < kMaxWave; ++i)
+        {
+            const auto &r = pending[i];
+            if (picked[i] || priority_of(r) != prio)
+                continue;
+            // One request per symbol per wave; an earlier queued request of the symbol goes first,
+            // except that market orders do not wait behind quotes.
+            bool blocked = false;
+            for (std::size_t j = 0; j < pending.size() && !blocked; ++j)
+            {
+                if (j == i || pending[j].symbol != r.symbol)
+                    continue;
+                blocked = picked[j] || (j < i && (prio != RatePriority::Exit || priority_of(pending[j]) == RatePriority::Exit));
+            }
+            if (blocked)
+                continue;
+            if (limiter_)
+            {
+                const int64_t w = limiter_->acquire(endpoint_of(r.op), r.count == 0 ? 1 : r.count, prio, now_ns);
+                if (w > 0)
+                {
+                    wait_ns = wait_ns == 0 ? w : std::min(wait_ns, w);
+                    continue;
+                }
+            }
+            picked[i] = 1;
+            ++count;
+        }
+    }
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < pending.size(); ++i)
+    {
+        if (picked[i])
+            wave.push_back(std::move(pending[i]));
+        else if (kept++ != i)
+            pending[kept - 1] = std::move(pending[i]);
+    }
+    pending.resize(kept);
+    return wait_ns;
+}
+
+void OrderGateway::encode(const GatewayRequest &req, std::string &out) const
+{
+    switch (req.op)
+    {
+    case GatewayOp::CreateBatch:
+        encode_batch(OrderAction::Create, category_, req.orders, req.count, out);
+        break;
+    case GatewayOp::AmendBatch:
+        encode_batch(OrderAction::Amend, category_, req.orders, req.count, out);
+        break;
+    case GatewayOp::CancelBatch:
+        encode_batch(OrderAction::Cancel, category_, req.orders, req.count, out);
+        break;
+    case GatewayOp::CancelAll:
+        out.clear();
+        out.append("{\"category\":\"").append(category_).append("\",\"symbol\":\"");
+        out.append(req.symbol.view().data(), req.symbol.size()).append("\"}");
+        break;
+    case GatewayOp::CreateOrder:
+        encode_create(category_, req.orders[0], out);
+        break;
+    }
+}
+
+void OrderGateway::apply_acks(const GatewayRequest &req, const std::vector<bool> &item_ok)
+{
+    if (!orders_)
+        return;
+    for (std::size_t i = 0; i < req.count && i < item_ok.size(); ++i)
+    {
+        const auto &o = req.orders[i];
+        if (o.order_link_id.empty())
+            continue;
+        if (req.op == GatewayOp::CreateBatch || req.op == GatewayOp::CreateOrder)
+            orders_->on_ack(o.order_link_id.view(), item_ok[i]);
+        else if (req.op == GatewayOp::AmendBatch && item_ok[i])
+            orders_->on_amend_ack(o.order_link_id.view(), o.price.to_double(), o.qty.to_double());
+    }
+}
+
+void OrderGateway::execute(std::vector<GatewayRequest> &wave)
+{
+    auto &posts = posts_;
+    posts.resize(wave.size());
+    for (std::size_t i = 0; i < wave.size(); ++i)
+    {
+        posts[i].path = path_for(wave[i].op);
+        encode(wave[i], posts[i].body);
+        posts[i].status = 0;
+        posts[i].response.clear();
+        posts[i].error.clear();
+    }
+    const int64_t sent_ns = latency_now_ns();
+    for (const auto &req : wave)
+    {
+        latency_record(LatencyStage::GatewayQueue, sent_ns - req.enqueue_ns);
+        if (req.origin_ns > 0)
+            latency_record(LatencyStage::TickToTrade, sent_ns - req.origin_ns);
+    }
+    try
+    {
+        transport_.post_many(posts);
+    }
+    catch (const std::exception &ex)
+    {
+        for (auto &p : posts)
+            p.error = ex.what();
+    }
+    // post_many() returns when the whole wave is answered; each request is charged the wave's time.
+    const int64_t acked_ns = latency_now_ns();
+
+    const int64_t wall_ms = limiter_ ? wall_ms_now() : 0;
+    for (std::size_t i = 0; i < wave.size(); ++i)
+    {
+        auto &req = wave[i];
+        GatewayResult r;
+        r.id = req.id;
+        r.op = req.op;
+        r.error = std::move(posts[i].error);
+        r.body = std::move(posts[i].response);
+        const std::size_t items = req.count == 0 ? 1 : req.count;
+        r.item_ok = r.error.empty() ? parse_batch_results(r.body, items) : std::vector<bool>(items, false);
+        auto j = nlohmann::json::parse(r.body, nullptr, false);
+        r.ok = r.error.empty() && !j.is_discarded() && j.value("retCode", -1) == 0;
+        r.round_trip_ns = acked_ns - req.enqueue_ns;
+        latency_record(LatencyStage::OrderAck, acked_ns - sent_ns);
+        if (limiter_)
+            limiter_->on_response(endpoint_of(req.op), posts[i].limits, acked_ns, wall_ms);
+        if (!complete(req, std::move(r)))
+            return;
+    }
+}
+
+bool OrderGateway::complete(GatewayRequest &req, GatewayResult &&result)
+{
+    apply_acks(req, result.item_ok);
+    if (!result.ok && !result.superseded)
+        failed_.fetch_add(1, std::memory_order_relaxed);
+    Completion c;
+    c.result = std::move(result);
+    c.on_done = std::move(req.on_done);
+    completed_.fetch_add(1, std::memory_order_relaxed);
+    while (!completions_.try_push(std::move(c)))
+    {
+        if (stop_.load())
+            return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
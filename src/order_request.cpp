@@ -0,0 +1,154 @@
+#include "order_request.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+
+namespace
+{
+    const char *side_name(OrderSide s) { return s == OrderSide::Buy ? "Buy" : "Sell"; }
+
+    const char *type_name(OrderType t) { return t == OrderType::Limit ? "Limit" : "Market"; }
+
+    const char *tif_name(TimeInForce t)
+    {
+        switch (t)
+        {
+        case TimeInForce::IOC:
+            return "IOC";
+        case TimeInForce::FOK:
+            return "FOK";
+        case TimeInForce::PostOnly:
+            return "PostOnly";
+        case TimeInForce::GTC:
+            break;
+        }
+        return "GTC";
+    }
+
+    // Appends ,"key":"value" (or without the leading comma for the first field).
+    void put_str(std::string &out, bool &first, const char *key, std::string_view value)
+    {
+        if (!first)
+            out.push_back(',');
+        first = false;
+        out.push_back('"');
+        out.append(key);
+        out.append("\":\"");
+        out.append(value.data(), value.size());
+        out.push_back('"');
+    }
+
+    template <typename Tag>
+    void put_fixed(std::string &out, bool &first, const char *key, Fixed<Tag> v)
+    {
+        char buf[kMaxFixedChars];
+        put_str(out, first, key, std::string_view(buf, static_cast<std::size_t>(v.write(buf) - buf)));
+    }
+
+    void put_int(std::string &out, bool &first, const char *key, int64_t v)
+    {
+        if (!first)
+            out.push_back(',');
+        first = false;
+        char buf[24];
+        const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        out.push_back('"');
+        out.append(key);
+        out.append("\":");
+        out.append(buf, static_cast<std::size_t>(r.ptr - buf));
+    }
+
+    void put_fields(std::string &out, bool &first, OrderAction action, const OrderRequest &r)
+    {
+        put_str(out, first, "symbol", r.symbol.view());
+        switch (action)
+        {
+        case OrderAction::Create:
+            put_str(out, first, "side", side_name(r.side));
+            put_str(out, first, "orderType", type_name(r.type));
+            put_fixed(out, first, "qty", r.qty);
+            if (r.type == OrderType::Limit)
+            {
+                put_fixed(out, first, "price", r.price);
+                put_str(out, first, "timeInForce", tif_name(r.tif));
+            }
+            put_int(out, first, "positionIdx", r.position_idx);
+            if (!r.order_link_id.empty())
+                put_str(out, first, "orderLinkId", r.order_link_id.view());
+            break;
+        case OrderAction::Amend:
+            put_str(out, first, "orderLinkId", r.order_link_id.view());
+            put_fixed(out, first, "price", r.price);
+            put_fixed(out, first, "qty", r.qty);
+            break;
+        case OrderAction::Cancel:
+            put_str(out, first, "orderLinkId", r.order_link_id.view());
+            break;
+        }
+    }
+} // namespace
+
+uint64_t next_order_link_counter()
+{
+    static std::atomic<uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+void format_order_link(OrderLinkId &out, std::string_view slot, std::string_view tag, int64_t ms, uint64_t counter)
+{
+    static_assert(kMaxOrderLinkIdLen < sizeof(out.data), "link id capacity below the exchange limit");
+    // Suffix first, so the prefix can be cut to the room it leaves. Epoch ms has 13 digits until 2286
+    // and the counter at most 20, so the suffix alone always fits.
+    char suffix[48];
+    char *s = suffix;
+    *s++ = '_';
+    s = std::to_chars(s, suffix + sizeof(suffix), ms).ptr;
+    *s++ = '_';
+    s = std::to_chars(s, suffix + sizeof(suffix), counter).ptr;
+    const std::size_t suffix_len = static_cast<std::size_t>(s - suffix);
+
+    char buf[kMaxOrderLinkIdLen];
+    char *p = buf;
+    char *const end = buf + kMaxOrderLinkIdLen - suffix_len;
+    auto put = [&](std::string_view v)
+    {
+        const std::size_t n = std::min(v.size(), static_cast<std::size_t>(end - p));
+        std::memcpy(p, v.data(), n);
+        p += n;
+    };
+    put(slot);
+    put("_");
+    put(tag);
+    std::memcpy(p, suffix, suffix_len);
+    p += suffix_len;
+    out.assign(std::string_view(buf, static_cast<std::size_t>(p - buf)));
+}
+
+void encode_batch(OrderAction action, std::string_view category, const OrderRequest *reqs, std::size_t n, std::string &out)
+{
+    out.clear();
+    out.append("{\"category\":\"");
+    out.append(category.data(), category.size());
+    out.append("\",\"request\":[");
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (i)
+            out.push_back(',');
+        out.push_back('{');
+        bool first = true;
+        put_fields(out, first, action, reqs[i]);
+        out.push_back('}');
+    }
+    out.append("]}");
+}
+
+void encode_create(std::string_view category, const OrderRequest &req, std::string &out)
+{
+    out.clear();
+    out.push_back('{');
+    bool first = true;
+    put_str(out, first, "category", category);
+    put_fields(out, first, OrderAction::Create, req);
+    out.push_back('}');
+}
@@ -0,0 +1,383 @@
+#include "order_store.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "fixed_point.hpp"
+
+namespace
+{
+    uint64_t fnv1a(const char *s, std::size_t len)
+    {
+        uint64_t h = 1469598103934665603ULL;
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            h ^= static_cast<unsigned char>(s[i]);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    void copy_str(char *dst, std::size_t cap, std::string_view src)
+    {
+        const std::size_t n = src.size() < cap - 1 ? src.size() : cap - 1;
+        std::memcpy(dst, src.data(), n);
+        dst[n] = '\0';
+    }
+
+    std::size_t next_pow2(std::size_t v)
+    {
+        std::size_t p = 1;
+        while (p < v)
+            p <<= 1;
+        return p;
+    }
+
+    double num_field(const nlohmann::json &d, const char *key)
+    {
+        auto it = d.find(key);
+        if (it == d.end())
+            return 0.0;
+        if (it->is_string())
+            return std::strtod(it->get_ref<const std::string &>().c_str(), nullptr);
+        if (it->is_number())
+            return it->get<double>();
+        return 0.0;
+    }
+
+    std::string str_field(const nlohmann::json &d, const char *key)
+    {
+        auto it = d.find(key);
+        if (it == d.end() || !it->is_string())
+            return std::string{};
+        return it->get<std::string>();
+    }
+
+    OrderState map_status(const std::string &s)
+    {
+        if (s == "PartiallyFilled")
+            return OrderState::PartiallyFilled;
+        if (s == "Filled")
+            return OrderState::Filled;
+        if (s == "Cancelled" || s == "PartiallyFilledCanceled" || s == "Deactivated")
+            return OrderState::Cancelled;
+        if (s == "Rejected")
+            return OrderState::Rejected;
+        return OrderState::New; // New, Untriggered, Triggered
+    }
+
+    struct Exposure
+    {
+        bool is_buy{false};
+        int64_t qty{0};
+        int64_t notional{0};
+    };
+
+    Exposure open_exposure(const OrderRecord &rec)
+    {
+        if (is_terminal(rec.state))
+            return Exposure{rec.is_buy, 0, 0};
+        const double open = std::max(rec.qty - rec.cum_exec_qty, 0.0);
+        return Exposure{rec.is_buy, to_fixed(open), to_fixed(open * rec.price)};
+    }
+
+    // Reports the change in one record's open exposure between construction and destruction. Both
+    // ends see the record through the same rounding, so the sink's running sums never drift.
+    class ExposureDelta
+    {
+    public:
+        ExposureDelta(IOrderExposureSink *sink, const OrderRecord *rec) : sink_(rec ? sink : nullptr), rec_(rec)
+        {
+            if (!sink_)
+                return;
+            before_ = open_exposure(*rec_);
+            std::memcpy(symbol_, rec_->symbol, sizeof(symbol_));
+        }
+        ~ExposureDelta()
+        {
+            if (!sink_)
+                return;
+            const Exposure after = open_exposure(*rec_);
+            const std::string_view symbol(rec_->symbol);
+            if (after.is_buy == before_.is_buy && symbol == symbol_)
+            {
+                if (after.qty != before_.qty || after.notional != before_.notional)
+                    sink_->on_exposure(symbol, after.is_buy, after.qty - before_.qty, after.notional - before_.notional);
+                return;
+            }
+            if (before_.qty != 0 || before_.notional != 0)
+                sink_->on_exposure(symbol_, before_.is_buy, -before_.qty, -before_.notional);
+            if (after.qty != 0 || after.notional != 0)
+                sink_->on_exposure(symbol, after.is_buy, after.qty, after.notional);
+        }
+
+        ExposureDelta(const ExposureDelta &) = delete;
+        ExposureDelta &operator=(const ExposureDelta &) = delete;
+
+    private:
+        IOrderExposureSink *sink_;
+        const OrderRecord *rec_;
+        Exposure before_;
+        char symbol_[OrderRecord::kSymbolCap]{};
+    };
+} // namespace
+
+bool parse_order_update(const nlohmann::json &d, OrderUpdate &out)
+{
+    out.order_link_id = str_field(d, "orderLinkId");
+    if (out.order_link_id.empty())
+        return false;
+    out.order_id = str_field(d, "orderId");
+    out.symbol = str_field(d, "symbol");
+    out.state = map_status(str_field(d, "orderStatus"));
+    out.is_buy = str_field(d, "side") == "Buy";
+    out.price = num_field(d, "price");
+    out.qty = num_field(d, "qty");
+    out.cum_exec_qty = num_field(d, "cumExecQty");
+    out.avg_price = num_field(d, "avgPrice");
+    out.updated_ms = static_cast<int64_t>(num_field(d, "updatedTime"));
+    return true;
+}
+
+OrderStore::OrderStore(std::size_t capacity)
+{
+    if (capacity == 0)
+        capacity = 1;
+    pool_.resize(capacity);
+    for (std::size_t i = 0; i < capacity; ++i)
+        pool_[i].next_free = (i + 1 < capacity) ? static_cast<uint32_t>(i + 1) : kEmpty;
+    free_head_ = 0;
+    slots_.assign(next_pow2(capacity * 2), kEmpty);
+    mask_ = slots_.size() - 1;
+}
+
+std::size_t OrderStore::find_slot(const char *key, std::size_t len, uint64_t h) const
+{
+    for (std::size_t i = h & mask_;; i = (i + 1) & mask_)
+    {
+        const uint32_t s = slots_[i];
+        if (s == kEmpty)
+            return kEmpty;
+        if (s == kTombstone)
+            continue;
+        const Node &n = pool_[s];
+        if (n.hash == h && std::strncmp(n.rec.order_link_id, key, len) == 0 && n.rec.order_link_id[len] == '\0')
+            return i;
+    }
+}
+
+OrderRecord *OrderStore::lookup(std::string_view key)
+{
+    if (key.size() >= OrderRecord::kLinkCap)
+        return nullptr;
+    const std::size_t slot = find_slot(key.data(), key.size(), fnv1a(key.data(), key.size()));
+    return slot == kEmpty ? nullptr : &pool_[slots_[slot]].rec;
+}
+
+const OrderRecord *OrderStore::lookup(std::string_view key) const
+{
+    return const_cast<OrderStore *>(this)->lookup(key);
+}
+
+OrderRecord *OrderStore::insert(std::string_view key)
+{
+    if (key.empty() || key.size() >= OrderRecord::kLinkCap)
+        return nullptr;
+    if (free_head_ == kEmpty && !evict_terminal())
+    {
+        ++dropped_;
+        return nullptr;
+    }
+    const uint32_t idx = free_head_;
+    Node &n = pool_[idx];
+    free_head_ = n.next_free;
+    n.rec = OrderRecord{};
+    copy_str(n.rec.order_link_id, OrderRecord::kLinkCap, key);
+    n.hash = fnv1a(key.data(), key.size());
+    n.used = true;
+    std::size_t i = n.hash & mask_;
+    while (slots_[i] != kEmpty && slots_[i] != kTombstone)
+        i = (i + 1) & mask_;
+    if (slots_[i] == kTombstone)
+        --tombstones_;
+    slots_[i] = idx;
+    ++live_;
+    return &n.rec;
+}
+
+void OrderStore::remove_at(std::size_t slot)
+{
+    const uint32_t idx = slots_[slot];
+    slots_[slot] = kTombstone;
+    ++tombstones_;
+    Node &n = pool_[idx];
+    n.used = false;
+    n.next_free = free_head_;
+    free_head_ = idx;
+    --live_;
+    if (tombstones_ > slots_.size() / 4)
+        rebuild();
+}
+
+void OrderStore::rebuild()
+{
+    std::fill(slots_.begin(), slots_.end(), kEmpty);
+    tombstones_ = 0;
+    for (std::size_t idx = 0; idx < pool_.size(); ++idx)
+    {
+        if (!pool_[idx].used)
+            continue;
+        std::size_t i = pool_[idx].hash & mask_;
+        while (slots_[i] != kEmpty)
+            i = (i + 1) & mask_;
+        slots_[i] = static_cast<uint32_t>(idx);
+    }
+}
+
+bool OrderStore::evict_terminal()
+{
+    bool freed = false;
+    for (auto &n : pool_)
+    {
+        if (!n.used || !is_terminal(n.rec.state))
+            continue;
+        const std::size_t slot = find_slot(n.rec.order_link_id, std::strlen(n.rec.order_link_id), n.hash);
+        if (slot != kEmpty)
+        {
+            remove_at(slot);
+            freed = true;
+        }
+    }
+    return freed;
+}
+
+void OrderStore::on_submitted(std::string_view order_link_id, std::string_view symbol, bool is_buy, double price, double qty)
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    OrderRecord *rec = lookup(order_link_id);
+    if (!rec)
+        rec = insert(order_link_id);
+    if (!rec)
+        return;
+    ExposureDelta delta(sink_, rec);
+    rec->order_id[0] = '\0';
+    copy_str(rec->symbol, OrderRecord::kSymbolCap, symbol);
+    rec->state = OrderState::PendingNew;
+    rec->is_buy = is_buy;
+    rec->price = price;
+    rec->qty = qty;
+    rec->cum_exec_qty = 0.0;
+    rec->avg_price = 0.0;
+    rec->updated_ms = 0;
+}
+
+void OrderStore::on_ack(std::string_view order_link_id, bool accepted, std::string_view order_id)
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    OrderRecord *rec = lookup(order_link_id);
+    if (!rec)
+        return;
+    ExposureDelta delta(sink_, rec);
+    if (!order_id.empty())
+        copy_str(rec->order_id, OrderRecord::kIdCap, order_id);
+    // The order stream may already have moved the order on; only resolve the pending state.
+    if (rec->state == OrderState::PendingNew)
+        rec->state = accepted ? OrderState::New : OrderState::Rejected;
+}
+
+void OrderStore::on_amend_ack(std::string_view order_link_id, double price, double qty)
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    OrderRecord *rec = lookup(order_link_id);
+    if (!rec || is_terminal(rec->state))
+        return;
+    ExposureDelta delta(sink_, rec);
+    rec->price = price;
+    rec->qty = qty;
+}
+
+void OrderStore::apply(const OrderUpdate &u)
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    OrderRecord *rec = lookup(u.order_link_id);
+    if (!rec)
+        rec = insert(u.order_link_id);
+    if (!rec)
+        return;
+    // Drop out-of-order updates: older timestamp, or a non-terminal state after a terminal one.
+    if (rec->updated_ms > u.updated_ms)
+        return;
+    if (is_terminal(rec->state) && !is_terminal(u.state) && rec->updated_ms != 0)
+        return;
+    ExposureDelta delta(sink_, rec);
+    if (!u.order_id.empty())
+        copy_str(rec->order_id, OrderRecord::kIdCap, u.order_id);
+    if (!u.symbol.empty())
+        copy_str(rec->symbol, OrderRecord::kSymbolCap, u.symbol);
+    rec->state = u.state;
+    rec->is_buy = u.is_buy;
+    rec->price = u.price;
+    rec->qty = u.qty;
+    rec->cum_exec_qty = u.cum_exec_qty;
+    rec->avg_price = u.avg_price;
+    rec->updated_ms = u.updated_ms;
+}
+
+bool OrderStore::get(std::string_view order_link_id, OrderRecord &out) const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    const OrderRecord *rec = lookup(order_link_id);
+    if (!rec)
+        return false;
+    out = *rec;
+    return true;
+}
+
+bool OrderStore::state_of(std::string_view order_link_id, OrderState &out) const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    const OrderRecord *rec = lookup(order_link_id);
+    if (!rec)
+        return false;
+    out = rec->state;
+    return true;
+}
+
+bool OrderStore::erase(std::string_view order_link_id)
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    if (order_link_id.size() >= OrderRecord::kLinkCap)
+        return false;
+    const std::size_t slot = find_slot(order_link_id.data(), order_link_id.size(),
+                                       fnv1a(order_link_id.data(), order_link_id.size()));
+    if (slot == kEmpty)
+        return false;
+    if (sink_)
+    {
+        const OrderRecord &rec = pool_[slots_[slot]].rec;
+        const Exposure e = open_exposure(rec);
+        if (e.qty != 0 || e.notional != 0)
+            sink_->on_exposure(rec.symbol, e.is_buy, -e.qty, -e.notional);
+    }
+    remove_at(slot);
+    return true;
+}
+
+std::size_t OrderStore::size() const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    return live_;
+}
+
+uint64_t OrderStore::dropped() const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    return dropped_;
+}
+
+void OrderStore::set_exposure_sink(IOrderExposureSink *sink)
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    sink_ = sink;
+}
@@ -0,0 +1,352 @@
+#include "param_sweep.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "env_config.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace
+{
+    const char *const kParamNames[] = {
+        "BYBIT_BUDGET_USD",
+        "BYBIT_MIN_SPREAD_BPS",
+        "BYBIT_SPREAD_FACTOR",
+        "BYBIT_MAX_NET_QTY",
+        "BYBIT_TP_SPREAD_BPS",
+        "BYBIT_LADDER_LEVELS",
+        "BYBIT_STOP_LOSS_BPS",
+        "BYBIT_GROSS_NOTIONAL_CAP",
+        "BYBIT_REQUOTE_TOL_TICKS",
+        "BYBIT_SIDE_MODE",
+        "BYBIT_MIN_REQUOTE_MS",
+    };
+
+    bool parse_double(const std::string &s, double &out)
+    {
+        if (s.empty())
+            return false;
+        char *end = nullptr;
+        errno = 0;
+        out = std::strtod(s.c_str(), &end);
+        return errno == 0 && end == s.c_str() + s.size() && std::isfinite(out);
+    }
+
+    bool parse_int(const std::string &s, int64_t &out)
+    {
+        if (s.empty())
+            return false;
+        char *end = nullptr;
+        errno = 0;
+        out = std::strtoll(s.c_str(), &end, 10);
+        return errno == 0 && end == s.c_str() + s.size();
+    }
+
+    std::string trim(const std::string &s)
+    {
+        const auto b = s.find_first_not_of(" \t\r");
+        if (b == std::string::npos)
+            return {};
+        const auto e = s.find_last_not_of(" \t\r");
+        return s.substr(b, e - b + 1);
+    }
+
+    // Shortest form that round-trips the usual decimal steps (0.1 + 0.2 prints as 0.3).
+    std::string format_value(double v)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.10g", v);
+        return buf;
+    }
+
+    [[noreturn]] void spec_error(std::size_t line, const std::string &what)
+    {
+        throw std::runtime_error("sweep spec line " + std::to_string(line) + ": " + what);
+    }
+
+    std::vector<std::string> expand_values(const std::string &rhs, std::size_t line)
+    {
+        std::vector<std::string> values;
+        if (rhs.find(':') != std::string::npos)
+        {
+            double v[3];
+            std::size_t start = 0;
+            for (int i = 0; i < 3; ++i)
+            {
+                const auto colon = rhs.find(':', start);
+                if ((i < 2) != (colon != std::string::npos) || !parse_double(trim(rhs.substr(start, colon - start)), v[i]))
+                    spec_error(line, "range must be lo:hi:step");
+                start = colon + 1;
+            }
+            const double lo = v[0], hi = v[1], step = v[2];
+            if (step <= 0.0 || hi < lo)
+                spec_error(line, "range needs lo <= hi and step > 0");
+            const auto n = static_cast<std::size_t>(std::floor((hi - lo) / step + 1e-9)) + 1;
+            if (n > 100000)
+                spec_error(line, "range has more than 100000 values");
+            for (std::size_t i = 0; i < n; ++i)
+                values.push_back(format_value(lo + static_cast<double>(i) * step));
+            return values;
+        }
+        std::size_t start = 0;
+        for (;;)
+        {
+            const auto comma = rhs.find(',', start);
+            const auto v = trim(rhs.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+            if (v.empty())
+                spec_error(line, "empty value");
+            values.push_back(v);
+            if (comma == std::string::npos)
+                break;
+            start = comma + 1;
+        }
+        return values;
+    }
+} // namespace
+
+StrategyParams StrategyParams::from_env()
+{
+    StrategyParams p;
+    for (const char *name : kParamNames)
+    {
+        const auto value = get_env(name);
+        if (!value.empty() && !p.set(name, value))
+            throw std::runtime_error(std::string("invalid ") + name + "=" + value);
+    }
+    return p;
+}
+
+bool StrategyParams::set(const std::string &name, const std::string &value)
+{
+    double d = 0.0;
+    int64_t i = 0;
+    if (name == "BYBIT_SIDE_MODE")
+    {
+        if (value != "both" && value != "long_only")
+            return false;
+        long_only = value == "long_only";
+        return true;
+    }
+    if (name == "BYBIT_LADDER_LEVELS")
+    {
+        if (!parse_int(value, i) || i < 1 || i > 1000)
+            return false;
+        ladder_levels = static_cast<int>(i);
+        return true;
+    }
+    if (name == "BYBIT_MIN_REQUOTE_MS")
+    {
+        if (!parse_int(value, i) || i < 0)
+            return false;
+        min_requote_ms = i;
+        return true;
+    }
+    if (!parse_double(value, d))
+        return false;
+    if (name == "BYBIT_BUDGET_USD")
+        budget_usd = d;
+    else if (name == "BYBIT_MIN_SPREAD_BPS")
+        min_spread_bps = d;
+    else if (name == "BYBIT_SPREAD_FACTOR")
+        spread_factor = d;
+    else if (name == "BYBIT_MAX_NET_QTY")
+        max_net_qty = d;
+    else if (name == "BYBIT_TP_SPREAD_BPS")
+        tp_spread_bps = d;
+    else if (name == "BYBIT_STOP_LOSS_BPS")
+        stop_loss_bps = d;
+    else if (name == "BYBIT_GROSS_NOTIONAL_CAP")
+        gross_notional_cap = d;
+    else if (name == "BYBIT_REQUOTE_TOL_TICKS")
+        requote_tol_ticks = d;
+    else
+        return false;
+    return true;
+}
+
+std::unique_ptr<IStrategy> make_strategy(const std::string &symbol, const InstrumentMeta &meta, const StrategyParams &p)
+{
+    if (p.long_only)
+        return std::make_unique<LongOnlyMarketMakerStrategy>(symbol, meta, p.budget_usd, p.min_spread_bps, p.spread_factor, 1, 2, p.max_net_qty, p.tp_spread_bps, p.ladder_levels, p.stop_loss_bps, p.gross_notional_cap, p.requote_tol_ticks);
+    return std::make_unique<ExampleMarketMakerStrategy>(symbol, meta, p.budget_usd, p.min_spread_bps, p.spread_factor, 1, 2, p.max_net_qty, p.tp_spread_bps, p.ladder_levels, p.stop_loss_bps, p.gross_notional_cap, p.requote_tol_ticks);
+}
+
+SweepSpec SweepSpec::parse(std::istream &in)
+{
+    SweepSpec spec;
+    std::string raw;
+    std::size_t line = 0;
+    while (std::getline(in, raw))
+    {
+        ++line;
+        const auto text = trim(raw.substr(0, raw.find('#')));
+        if (text.empty())
+            continue;
+        const auto eq = text.find('=');
+        if (eq == std::string::npos)
+            spec_error(line, "expected NAME = values");
+        const auto name = trim(text.substr(0, eq));
+        const auto rhs = trim(text.substr(eq + 1));
+        int64_t n = 0;
+        if (name == "mode")
+        {
+            if (rhs != "grid" && rhs != "random")
+                spec_error(line, "mode must be grid or random");
+            spec.random = rhs == "random";
+            continue;
+        }
+        if (name == "samples" || name == "seed")
+        {
+            if (!parse_int(rhs, n) || n < (name == "samples" ? 1 : 0))
+                spec_error(line, name + " must be a " + (name == "samples" ? "positive" : "non-negative") + " integer");
+            if (name == "samples")
+                spec.samples = static_cast<std::size_t>(n);
+            else
+                spec.seed = static_cast<uint64_t>(n);
+            continue;
+        }
+        for (const auto &axis : spec.axes)
+            if (axis.name == name)
+                spec_error(line, name + " is given twice");
+        Axis axis{name, expand_values(rhs, line)};
+        StrategyParams probe;
+        for (const auto &v : axis.values)
+            if (!probe.set(name, v))
+                spec_error(line, "unknown setting or bad value: " + name + " = " + v);
+        spec.axes.push_back(std::move(axis));
+    }
+    return spec;
+}
+
+SweepSpec SweepSpec::load(const std::string &path)
+{
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open sweep spec " + path);
+    return parse(in);
+}
+
+std::vector<SweepPoint> SweepSpec::expand() const
+{
+    // Mixed-radix index over the axes, last axis least significant.
+    uint64_t total = 1;
+    for (const auto &axis : axes)
+    {
+        if (total > UINT64_MAX / axis.values.size())
+            throw std::runtime_error("sweep grid is too large");
+        total *= axis.values.size();
+    }
+    auto point_at = [&](uint64_t index)
+    {
+        SweepPoint p(axes.size());
+        for (std::size_t a = axes.size(); a-- > 0;)
+        {
+            const auto &values = axes[a].values;
+            p[a] = {axes[a].name, values[index % values.size()]};
+            index /= values.size();
+        }
+        return p;
+    };
+
+    std::vector<SweepPoint> points;
+    if (!random || samples >= total)
+    {
+        if (total > 10000000)
+            throw std::runtime_error("sweep grid has " + std::to_string(total) + " points; use mode = random");
+        for (uint64_t i = 0; i < total; ++i)
+            points.push_back(point_at(i));
+        return points;
+    }
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<uint64_t> pick(0, total - 1);
+    std::unordered_set<uint64_t> seen;
+    while (points.size() < samples)
+    {
+        const uint64_t i = pick(rng);
+        if (seen.insert(i).second)
+            points.push_back(point_at(i));
+    }
+    return points;
+}
+
+std::vector<SweepRun> run_sweep(const Backtester::Config &bt,
+                                const StrategyParams &base,
+                                const std::vector<SweepPoint> &points,
+                                const std::vector<const RecordFileReader *> &inputs,
+                                WorkStealingPool &pool)
+{
+    std::vector<SweepRun> runs(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        runs[i].index = i;
+        runs[i].point = points[i];
+        pool.submit([&bt, &base, &inputs, &run = runs[i]]
+                    {
+            try
+            {
+                StrategyParams params = base;
+                for (const auto &[name, value] : run.point)
+                    if (!params.set(name, value))
+                        throw std::runtime_error("bad setting " + name + "=" + value);
+                Backtester::Config cfg = bt;
+                cfg.files.clear();
+                cfg.out_dir.clear();
+                cfg.min_requote_ns = params.min_requote_ms * 1000000;
+                const auto strategy = make_strategy(cfg.symbol, cfg.sim.meta, params);
+                run.result = Backtester(std::move(cfg)).run(*strategy, inputs);
+            }
+            catch (const std::exception &ex)
+            {
+                run.error = ex.what();
+            } });
+    }
+    pool.wait();
+    return runs;
+}
+
+void write_sweep_csv(std::ostream &out, const std::vector<SweepSpec::Axis> &axes, std::vector<SweepRun> runs)
+{
+    std::stable_sort(runs.begin(), runs.end(), [](const SweepRun &a, const SweepRun &b)
+                     {
+        if (a.error.empty() != b.error.empty())
+            return a.error.empty();
+        return a.net_pnl() > b.net_pnl(); });
+
+    out.precision(10);
+    out << "rank,run";
+    for (const auto &axis : axes)
+        out << ',' << axis.name;
+    out << ",net_pnl,realized,fees,unrealized,max_drawdown,fills,dispatches,traded_notional,max_abs_net_qty,net_qty,error\n";
+    std::size_t rank = 0;
+    for (const auto &run : runs)
+    {
+        out << ++rank << ',' << run.index;
+        for (const auto &axis : axes)
+        {
+            out << ',';
+            for (const auto &[name, value] : run.point)
+                if (name == axis.name)
+                    out << value;
+        }
+        const auto &r = run.result;
+        out << ',' << run.net_pnl() << ',' << r.realized << ',' << r.fees << ',' << r.unrealized << ',' << r.max_drawdown << ','
+            << r.fills << ',' << r.dispatches << ',' << r.traded_notional << ',' << r.max_abs_net_qty << ',' << r.net_qty << ',';
+        if (!run.error.empty())
+        {
+            out << '"';
+            for (const char c : run.error)
+                out << (c == '"' ? "\"\"" : std::string(1, c));
+            out << '"';
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,150 @@
+#include "pnl_tracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double kScale = 1e8;
+
+    int64_t to_units(double v) { return std::llround(v * kScale); }
+    double from_units(int64_t u) { return static_cast<double>(u) / kScale; }
+} // namespace
+
+void PnlTracker::add_execution(const std::string &order_link_id, double realized_pnl, double fee, SymbolId symbol)
+{
+    add_execution(order_link_id, realized_pnl, fee, symbol, std::chrono::steady_clock::now());
+}
+
+void PnlTracker::add_execution(const std::string &order_link_id, double realized_pnl, double fee, SymbolId symbol,
+                               std::chrono::steady_clock::time_point now)
+{
+    const int64_t pnl = to_units(realized_pnl);
+    const int64_t fee_units = to_units(fee);
+    std::lock_guard<std::mutex> lg(mu_);
+    realized_ += pnl;
+    fees_ += fee_units;
+
+    OrderList::iterator node;
+    auto it = order_index_.find(order_link_id);
+    if (it == order_index_.end())
+    {
+        node = insert_order(order_link_id, symbol);
+    }
+    else
+    {
+        node = it->second;
+        orders_.splice(orders_.end(), orders_, node); // most recently updated goes last
+    }
+    auto &e = *node;
+    e.realized += pnl;
+    e.fees += fee_units;
+    ++e.fills;
+    e.last_update = now;
+    evict(now);
+    publish();
+}
+
+PnlTracker::OrderList::iterator PnlTracker::insert_order(const std::string &order_link_id, SymbolId symbol)
+{
+    if (symbol != kNoSymbol && buckets_.size() <= symbol)
+        buckets_.resize(symbol + 1u);
+    BucketUnits &b = symbol == kNoSymbol ? unattributed_ : buckets_[symbol];
+    b.seen = true;
+    if (spare_orders_.empty())
+        orders_.emplace_back();
+    else
+        orders_.splice(orders_.end(), spare_orders_, spare_orders_.begin());
+    const auto node = std::prev(orders_.end());
+    OrderIndex::iterator key;
+    if (spare_index_.empty())
+    {
+        key = order_index_.emplace(order_link_id, node).first;
+    }
+    else
+    {
+        spare_index_.key() = order_link_id; // reuses the evicted key's capacity
+        spare_index_.mapped() = node;
+        key = order_index_.insert(std::move(spare_index_)).position;
+    }
+    *node = OrderEntry{&key->first, &b, 0, 0, 0, {}};
+    return node;
+}
+
+void PnlTracker::evict(std::chrono::steady_clock::time_point now)
+{
+    while (!orders_.empty() &&
+           (orders_.size() > cfg_.max_orders || now - orders_.front().last_update > cfg_.max_order_age))
+    {
+        const auto &e = orders_.front();
+        e.bucket->realized += e.realized;
+        e.bucket->fees += e.fees;
+        e.bucket->fills += e.fills;
+        ++e.bucket->orders;
+        auto index_node = order_index_.extract(*e.link);
+        if (spare_index_.empty())
+            spare_index_ = std::move(index_node);
+        spare_orders_.splice(spare_orders_.end(), orders_, orders_.begin());
+    }
+}
+
+void PnlTracker::add_funding(double funding_payment)
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    funding_ += to_units(funding_payment);
+    publish();
+}
+
+void PnlTracker::set_unrealized(SymbolId symbol, int position_idx, double upl)
+{
+    if (symbol == kNoSymbol || position_idx < 0 || static_cast<std::size_t>(position_idx) >= kPositionSlots)
+        return;
+    const int64_t units = to_units(upl);
+    const std::size_t index = symbol * kPositionSlots + static_cast<std::size_t>(position_idx);
+    std::lock_guard<std::mutex> lg(mu_);
+    if (unrealized_slots_.size() <= index)
+        unrealized_slots_.resize((symbol + 1u) * kPositionSlots, 0);
+    auto &slot = unrealized_slots_[index];
+    unrealized_ += units - slot;
+    slot = units;
+    publish();
+}
+
+void PnlTracker::clear_unrealized()
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    std::fill(unrealized_slots_.begin(), unrealized_slots_.end(), 0);
+    unrealized_ = 0;
+    publish();
+}
+
+void PnlTracker::publish()
+{
+    totals_.store(Totals{from_units(realized_), from_units(fees_), from_units(funding_), from_units(unrealized_)});
+}
+
+std::optional<PnlTracker::OrderPnl> PnlTracker::order(const std::string &order_link_id) const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    auto it = order_index_.find(order_link_id);
+    if (it == order_index_.end())
+        return std::nullopt;
+    const auto &e = *it->second;
+    return OrderPnl{from_units(e.realized), from_units(e.fees), e.fills};
+}
+
+std::optional<PnlTracker::Bucket> PnlTracker::bucket(SymbolId symbol) const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    const BucketUnits *found = symbol == kNoSymbol ? &unattributed_ : symbol < buckets_.size() ? &buckets_[symbol] : nullptr;
+    if (!found || !found->seen)
+        return std::nullopt;
+    const auto &b = *found;
+    return Bucket{from_units(b.realized), from_units(b.fees), b.orders, b.fills};
+}
+
+std::size_t PnlTracker::tracked_orders() const
+{
+    std::lock_guard<std::mutex> lg(mu_);
+    return orders_.size();
+}
@@ -0,0 +1,399 @@
+#include "quote_manager.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "async_logger.hpp"
+
+namespace
+{
+    constexpr LogFormat kLogSyncFailed{LogLevel::Warn, "QM", LogColor::Yellow, "{} sync failed, will cancel_all and rebuild: {}"};
+    constexpr LogFormat kLogAsyncFailed{LogLevel::Warn, "QM", LogColor::Yellow, "{} async request failed, will cancel_all and rebuild: {}"};
+    // The exchange drops requests older than their recv window (5 s by default), so a create not
+    // seen on the order stream by then never will be.
+    constexpr int64_t kUnknownCreateWatchNs = 30000000000;
+    const std::vector<DesiredQuote> kNoQuotes;
+
+    int64_t steady_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+} // namespace
+
+QuoteManager::QuoteManager(std::string symbol, Config cfg) : symbol_(std::move(symbol)), cfg_(std::move(cfg))
+{
+    const bool allowed = std::all_of(cfg_.link_tag.begin(), cfg_.link_tag.end(), [](char c)
+                                     { return std::isalnum(static_cast<unsigned char>(c)) || c == '-'; });
+    if (cfg_.link_tag.size() > kMaxLinkTagLen || !allowed)
+        throw std::invalid_argument("QuoteManager: link_tag must be 0.." + std::to_string(kMaxLinkTagLen) +
+                                    " characters of [A-Za-z0-9-]: " + cfg_.link_tag);
+}
+
+QuoteManager::WorkingOrder *QuoteManager::find_slot(const std::string &slot)
+{
+    for (auto &w : working_)
+        if (w.quote.slot == slot)
+            return &w;
+    return nullptr;
+}
+
+const QuoteManager::WorkingOrder *QuoteManager::find_slot(const std::string &slot) const
+{
+    for (const auto &w : working_)
+        if (w.quote.slot == slot)
+            return &w;
+    return nullptr;
+}
+
+QuotePlan QuoteManager::diff(const std::vector<DesiredQuote> &desired) const
+{
+    QuotePlan plan;
+    diff_into(desired, plan);
+    return plan;
+}
+
+void QuoteManager::diff_into(const std::vector<DesiredQuote> &desired, QuotePlan &plan) const
+{
+    plan.clear();
+    plan.cancel.insert(plan.cancel.end(), orphaned_.begin(), orphaned_.end());
+    for (const auto &d : desired)
+    {
+        const auto *w = find_slot(d.slot);
+        if (!w)
+        {
+            plan.place.push_back(d);
+            continue;
+        }
+        if (w->quote.side != d.side || w->quote.position_idx != d.position_idx)
+        {
+            plan.cancel.push_back(w->order_link_id);
+            plan.place.push_back(d);
+            continue;
+        }
+        const bool px_moved = std::llabs(w->quote.price.raw - d.price.raw) > cfg_.price_tolerance.raw;
+        const bool qty_moved = std::llabs(w->quote.qty.raw - d.qty.raw) > cfg_.qty_tolerance.raw;
+        if (px_moved || qty_moved)
+            plan.amend.push_back({w->order_link_id, d});
+    }
+    for (const auto &w : working_)
+    {
+        const bool wanted = std::any_of(desired.begin(), desired.end(),
+                                        [&](const DesiredQuote &d)
+                                        { return d.slot == w.quote.slot; });
+        if (!wanted)
+            plan.cancel.push_back(w.order_link_id);
+    }
+}
+
+void QuoteManager::make_link(const std::string &slot, OrderLinkId &out)
+{
+    const auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count();
+    format_order_link(out, slot, cfg_.link_tag, now_ms, next_order_link_counter());
+}
+
+void QuoteManager::build()
+{
+    batches_.clear();
+    auto start = [&](OrderAction action) -> Batch &
+    {
+        if (batches_.empty() || batches_.back().action != action || batches_.back().count == kMaxGatewayBatch)
+        {
+            batches_.emplace_back();
+            batches_.back().action = action;
+        }
+        return batches_.back();
+    };
+    // Cancels first so their margin is released before new orders need it.
+    for (std::size_t i = 0; i < plan_.cancel.size(); ++i)
+    {
+        auto &b = start(OrderAction::Cancel);
+        auto &r = b.reqs[b.count];
+        r.symbol.assign(symbol_);
+        r.order_link_id = plan_.cancel[i];
+        b.index[b.count++] = static_cast<uint32_t>(i);
+    }
+    for (std::size_t i = 0; i < plan_.amend.size(); ++i)
+    {
+        const auto &a = plan_.amend[i];
+        auto &b = start(OrderAction::Amend);
+        auto &r = b.reqs[b.count];
+        r.symbol.assign(symbol_);
+        r.order_link_id = a.order_link_id;
+        r.price = a.quote.price;
+        r.qty = a.quote.qty;
+        b.index[b.count++] = static_cast<uint32_t>(i);
+    }
+    for (std::size_t i = 0; i < plan_.place.size(); ++i)
+    {
+        const auto &q = plan_.place[i];
+        auto &b = start(OrderAction::Create);
+        auto &r = b.reqs[b.count];
+        r.symbol.assign(symbol_);
+        make_link(q.slot, r.order_link_id);
+        r.price = q.price;
+        r.qty = q.qty;
+        r.side = q.side == "Buy" ? OrderSide::Buy : OrderSide::Sell;
+        r.type = OrderType::Limit;
+        r.tif = TimeInForce::GTC;
+        r.position_idx = static_cast<int8_t>(q.position_idx);
+        b.index[b.count++] = static_cast<uint32_t>(i);
+    }
+}
+
+void QuoteManager::apply(const Batch &b, const std::vector<bool> &ok, const std::string &raw)
+{
+    std::vector<int> codes; // parsed on the first failed item only
+    for (uint32_t i = 0; i < b.count; ++i)
+    {
+        const auto link = b.reqs[i].order_link_id.view();
+        switch (b.action)
+        {
+        case OrderAction::Cancel:
+            on_gone(link);
+            if (ok[i])
+                break;
+            if (codes.empty())
+                codes = parse_batch_codes(raw, b.count);
+            // Only "not found / already filled or cancelled" means it is gone. Rate limits, timeouts
+            // and server errors leave it resting: cancel it again next round.
+            if (!order_gone_code(codes[i]))
+                orphaned_.push_back(b.reqs[i].order_link_id);
+            break;
+        case OrderAction::Amend:
+            if (ok[i])
+            {
+                on_amended(link, plan_.amend[b.index[i]].quote);
+                break;
+            }
+            if (codes.empty())
+                codes = parse_batch_codes(raw, b.count);
+            // Held back by the rate limit (ours or the exchange's): the order rests unchanged, so
+            // keep the slot and amend again next round instead of turning it into cancel + create.
+            if (codes[i] == kRateLimitedCode)
+                break;
+            // Usually filled in the meantime; cancel defensively next round in case it still rests.
+            on_gone(link);
+            orphaned_.push_back(b.reqs[i].order_link_id);
+            break;
+        case OrderAction::Create:
+            if (ok[i])
+            {
+                on_placed(plan_.place[b.index[i]], link);
+                break;
+            }
+            if (codes.empty())
+                codes = parse_batch_codes(raw, b.count);
+            if (codes[i] == kUnknownOutcomeCode)
+                on_create_unknown(link);
+            break;
+        }
+    }
+}
+
+void QuoteManager::sync(const std::vector<DesiredQuote> &quotes, TradingHelper &helper)
+{
+    // Tripping the kill switch goes through the same cancel_all as a fresh start; resting quotes
+    // within tolerance would otherwise never be touched again.
+    const bool killed = helper.risk().killed();
+    if (killed && !killed_)
+        synced_ = false;
+    killed_ = killed;
+    const auto &desired = killed ? kNoQuotes : quotes;
+    if (helper.async_enabled())
+    {
+        sync_async(desired, helper);
+        return;
+    }
+    if (!synced_)
+    {
+        helper.cancel_all(symbol_);
+        reset();
+        synced_ = true;
+    }
+    reconcile(helper.orders());
+    diff_into(desired, plan_);
+    orphaned_.clear();
+    if (plan_.empty())
+        return;
+
+    try
+    {
+        build();
+        for (const auto &b : batches_)
+        {
+            std::string raw;
+            switch (b.action)
+            {
+            case OrderAction::Cancel:
+                raw = helper.batch_cancel_orders(b.reqs, b.count);
+                break;
+            case OrderAction::Amend:
+                raw = helper.batch_amend_orders(b.reqs, b.count);
+                break;
+            case OrderAction::Create:
+                raw = helper.batch_submit_orders(b.reqs, b.count);
+                break;
+            }
+            apply(b, TradingHelper::batch_item_results(raw, b.count), raw);
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        // Outcome of the in-flight request is unknown; start from a clean slate next time.
+        log_event(kLogSyncFailed, symbol_, ex.what());
+        synced_ = false;
+        throw;
+    }
+}
+
+void QuoteManager::on_async_done(const GatewayResult &r)
+{
+    --in_flight_;
+    if (!r.error.empty())
+    {
+        // Outcome unknown; same recovery as a throwing synchronous sync().
+        log_event(kLogAsyncFailed, symbol_, r.error);
+        synced_ = false;
+    }
+}
+
+void QuoteManager::sync_async(const std::vector<DesiredQuote> &desired, TradingHelper &helper)
+{
+    helper.poll_async();
+    // The gateway keeps per-symbol order, but diffing against unacknowledged state would double-place.
+    if (in_flight_ > 0)
+        return;
+    if (!synced_)
+    {
+        reset();
+        ++in_flight_;
+        synced_ = helper.async_cancel_all(symbol_, [this](const GatewayResult &r)
+                                          {
+                                              on_async_done(r);
+                                              if (!r.ok)
+                                                  synced_ = false; });
+        if (!synced_)
+            --in_flight_;
+        return; // place against a clean book once the cancel_all is acknowledged
+    }
+    reconcile(helper.orders());
+    diff_into(desired, plan_);
+    orphaned_.clear();
+    if (plan_.empty())
+        return;
+
+    build();
+    // Enqueued cancel -> amend -> place; the gateway sends same-symbol requests in FIFO order.
+    for (std::size_t i = 0; i < batches_.size(); ++i)
+    {
+        const auto &b = batches_[i];
+        // Captures fit std::function's small buffer, so queueing does not allocate.
+        GatewayCallback done = [this, i](const GatewayResult &r)
+        {
+            on_async_done(r);
+            if (!r.superseded) // a later request of ours carries the outcome
+                apply(batches_[i], r.item_ok, r.body);
+        };
+        bool queued = false;
+        switch (b.action)
+        {
+        case OrderAction::Cancel:
+            queued = helper.async_batch_cancel_orders(b.reqs, b.count, std::move(done));
+            break;
+        case OrderAction::Amend:
+            queued = helper.async_batch_amend_orders(b.reqs, b.count, std::move(done));
+            break;
+        case OrderAction::Create:
+            queued = helper.async_batch_submit_orders(b.reqs, b.count, std::move(done));
+            break;
+        }
+        if (!queued)
+        {
+            synced_ = false; // queue full: resync from scratch rather than guess what was sent
+            return;
+        }
+        ++in_flight_;
+    }
+}
+
+void QuoteManager::reconcile(const OrderStore &orders)
+{
+    OrderState st;
+    for (std::size_t i = 0; i < working_.size();)
+    {
+        if (orders.state_of(working_[i].order_link_id.view(), st) && is_terminal(st))
+            working_.erase(working_.begin() + static_cast<std::ptrdiff_t>(i));
+        else
+            ++i;
+    }
+    orphaned_.erase(std::remove_if(orphaned_.begin(), orphaned_.end(),
+                                   [&](const OrderLinkId &link)
+                                   { return orders.state_of(link.view(), st) && is_terminal(st); }),
+                    orphaned_.end());
+    if (unknown_.empty())
+        return;
+    // Our own record says rejected; only an update from the order stream (updated_ms set) is news.
+    const int64_t now = steady_ns();
+    OrderRecord rec;
+    for (std::size_t i = 0; i < unknown_.size();)
+    {
+        const auto &u = unknown_[i];
+        const bool known = orders.get(u.order_link_id.view(), rec);
+        if (known && rec.updated_ms == 0 && now - u.since_ns < kUnknownCreateWatchNs)
+        {
+            ++i;
+            continue;
+        }
+        if (known && rec.updated_ms != 0 && !is_terminal(rec.state))
+            orphaned_.push_back(u.order_link_id); // it landed after the cancel: cancel it again
+        unknown_.erase(unknown_.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+void QuoteManager::on_placed(const DesiredQuote &quote, std::string_view order_link_id)
+{
+    if (auto *w = find_slot(quote.slot))
+    {
+        const OrderLinkId old = w->order_link_id; // on_gone() shifts working_ under w
+        orphaned_.push_back(old);
+        on_gone(old.view());
+    }
+    working_.push_back({OrderLinkId(order_link_id), quote});
+}
+
+void QuoteManager::on_amended(std::string_view order_link_id, const DesiredQuote &quote)
+{
+    for (auto &w : working_)
+    {
+        if (w.order_link_id == order_link_id)
+        {
+            w.quote = quote;
+            return;
+        }
+    }
+}
+
+void QuoteManager::on_gone(std::string_view order_link_id)
+{
+    working_.erase(std::remove_if(working_.begin(), working_.end(),
+                                  [&](const WorkingOrder &w)
+                                  { return w.order_link_id == order_link_id; }),
+                   working_.end());
+}
+
+void QuoteManager::on_create_unknown(std::string_view order_link_id)
+{
+    unknown_.push_back({OrderLinkId(order_link_id), steady_ns()});
+}
+
+void QuoteManager::reset()
+{
+    working_.clear();
+    orphaned_.clear();
+}
@@ -0,0 +1,164 @@
+#include "rate_limiter.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace
+{
+    constexpr int64_t kWaitForever = 1000000000; // no refill configured: check again in a second
+
+    bool iequals(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            const char ca = a[i] >= 'A' && a[i] <= 'Z' ? static_cast<char>(a[i] - 'A' + 'a') : a[i];
+            if (ca != b[i])
+                return false;
+        }
+        return true;
+    }
+
+    std::string_view trim(std::string_view s)
+    {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+            s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '\n'))
+            s.remove_suffix(1);
+        return s;
+    }
+
+    bool parse_int(std::string_view s, int64_t &out)
+    {
+        s = trim(s);
+        return !s.empty() && std::from_chars(s.data(), s.data() + s.size(), out).ec == std::errc{};
+    }
+} // namespace
+
+bool parse_rate_limit_header(std::string_view name, std::string_view value, RateLimitHeaders &out)
+{
+    name = trim(name);
+    if (iequals(name, "x-bapi-limit"))
+        return parse_int(value, out.limit);
+    if (iequals(name, "x-bapi-limit-status"))
+        return parse_int(value, out.remaining);
+    if (iequals(name, "x-bapi-limit-reset-timestamp"))
+        return parse_int(value, out.reset_ms);
+    return false;
+}
+
+bool parse_rate_limit_header(std::string_view line, RateLimitHeaders &out)
+{
+    const auto colon = line.find(':');
+    if (colon == std::string_view::npos)
+        return false;
+    return parse_rate_limit_header(line.substr(0, colon), line.substr(colon + 1), out);
+}
+
+RateLimiter::RateLimiter(Config cfg) : cfg_(cfg)
+{
+    for (auto &b : endpoints_)
+    {
+        b.capacity = cfg_.orders_per_sec;
+        b.per_ns = cfg_.orders_per_sec * 1e-9;
+        b.tokens = b.capacity;
+    }
+    ip_.capacity = cfg_.ip_burst;
+    ip_.per_ns = cfg_.ip_per_sec * 1e-9;
+    ip_.tokens = ip_.capacity;
+}
+
+void RateLimiter::refill(Bucket &b, int64_t now_ns)
+{
+    if (now_ns > b.at_ns)
+    {
+        b.tokens = std::min(b.capacity, b.tokens + static_cast<double>(now_ns - b.at_ns) * b.per_ns);
+        b.at_ns = now_ns;
+    }
+}
+
+int64_t RateLimiter::wait_for(const Bucket &b, double cost, double floor, int64_t now_ns)
+{
+    if (now_ns < b.blocked_until_ns)
+        return b.blocked_until_ns - now_ns;
+    // A request larger than the bucket waits for a full one and leaves it in debt.
+    const double need = std::min(cost + floor, b.capacity);
+    if (b.tokens >= need)
+        return 0;
+    if (b.per_ns <= 0.0)
+        return kWaitForever;
+    return std::max<int64_t>(1, static_cast<int64_t>(std::ceil((need - b.tokens) / b.per_ns)));
+}
+
+int64_t RateLimiter::acquire(RateEndpoint ep, uint32_t cost, RatePriority prio, int64_t now_ns)
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!cfg_.enabled)
+    {
+        ++granted_;
+        return 0;
+    }
+    auto &b = endpoints_[static_cast<std::size_t>(ep)];
+    refill(b, now_ns);
+    refill(ip_, now_ns);
+    const double reserve = prio == RatePriority::Quote ? cfg_.quote_reserve : 0.0;
+    const int64_t wait = std::max(wait_for(b, cost, reserve * b.capacity, now_ns),
+                                  wait_for(ip_, 1.0, reserve * ip_.capacity, now_ns));
+    if (wait > 0)
+    {
+        ++throttled_;
+        return wait;
+    }
+    b.tokens -= cost;
+    ip_.tokens -= 1.0;
+    ++granted_;
+    return 0;
+}
+
+void RateLimiter::on_response(RateEndpoint ep, const RateLimitHeaders &h, int64_t now_ns, int64_t wall_ms)
+{
+    if (!h.present() || !cfg_.enabled)
+        return;
+    std::lock_guard<std::mutex> lk(mu_);
+    auto &b = endpoints_[static_cast<std::size_t>(ep)];
+    refill(b, now_ns);
+    if (h.limit > 0)
+    {
+        // Order endpoint windows are one second long.
+        b.capacity = static_cast<double>(h.limit);
+        b.per_ns = static_cast<double>(h.limit) * 1e-9;
+    }
+    // The exchange counted the response before our later sends; never trust it above our own count.
+    b.tokens = std::min({b.tokens, b.capacity, static_cast<double>(h.remaining)});
+    if (h.remaining == 0 && h.reset_ms > wall_ms)
+        b.blocked_until_ns = std::max(b.blocked_until_ns, now_ns + (h.reset_ms - wall_ms) * 1000000);
+    ++header_updates_;
+}
+
+double RateLimiter::available(RateEndpoint ep, int64_t now_ns)
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    auto &b = endpoints_[static_cast<std::size_t>(ep)];
+    refill(b, now_ns);
+    return b.tokens;
+}
+
+uint64_t RateLimiter::granted() const
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    return granted_;
+}
+
+uint64_t RateLimiter::throttled() const
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    return throttled_;
+}
+
+uint64_t RateLimiter::header_updates() const
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    return header_updates_;
+}
@@ -0,0 +1,346 @@
+#include "rest_transport.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <curl/curl.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#include "latency_stats.hpp"
+
+namespace
+{
+    // Public, tiny and outside the per-UID order limits: what warm-ups request.
+    constexpr const char *kWarmPath = "/v5/market/time";
+
+    size_t write_body(char *ptr, size_t size, size_t nmemb, void *userdata)
+    {
+        auto *out = static_cast<std::string *>(userdata);
+        out->append(ptr, size * nmemb);
+        return size * nmemb;
+    }
+
+    size_t read_header(char *buf, size_t size, size_t nitems, void *userdata)
+    {
+        if (userdata)
+            parse_rate_limit_header(std::string_view(buf, size * nitems), *static_cast<RateLimitHeaders *>(userdata));
+        return size * nitems;
+    }
+
+    struct CurlGlobal
+    {
+        CurlGlobal() { curl_global_init(CURL_GLOBAL_DEFAULT); }
+    };
+} // namespace
+
+RestTransport::RestTransport(std::string api_key, std::string api_secret, std::string base_url, long recv_window_ms)
+    : api_key_(std::move(api_key)),
+      api_secret_(std::move(api_secret)),
+      base_url_(std::move(base_url)),
+      recv_window_ms_(recv_window_ms)
+{
+    static CurlGlobal global;
+    curl_ = curl_easy_init();
+    if (!curl_)
+        throw std::runtime_error("curl_easy_init failed");
+    configure(curl_);
+}
+
+RestTransport::~RestTransport()
+{
+    if (curl_)
+        curl_easy_cleanup(curl_);
+    for (auto *h : multi_pool_)
+        curl_easy_cleanup(h);
+    if (multi_)
+        curl_multi_cleanup(multi_);
+}
+
+void RestTransport::configure(CURL *handle) const
+{
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    // Probe idle connections well inside the usual 60 s NAT / load-balancer timeouts.
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPIDLE, 15L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPINTVL, 15L);
+    curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, 10000L);
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_body);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, read_header);
+}
+
+std::string RestTransport::hmac_sha256_hex(const std::string &secret, const std::string &payload)
+{
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int len = 0;
+    HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()),
+         reinterpret_cast<const unsigned char *>(payload.data()), payload.size(), digest, &len);
+    static const char *hex = "0123456789abcdef";
+    std::string out(len * 2, '0');
+    for (unsigned int i = 0; i < len; ++i)
+    {
+        out[2 * i] = hex[digest[i] >> 4];
+        out[2 * i + 1] = hex[digest[i] & 0x0f];
+    }
+    return out;
+}
+
+std::string RestTransport::sign(const std::string &payload) const { return hmac_sha256_hex(api_secret_, payload); }
+
+void *RestTransport::signed_headers(const std::string &sign_payload) const
+{
+    const auto ts = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       std::chrono::system_clock::now().time_since_epoch())
+                                       .count());
+    const auto recv_window = std::to_string(recv_window_ms_);
+    // Bybit v5 signature: HMAC_SHA256(timestamp + api_key + recv_window + (body | query)).
+    const auto signature = sign(ts + api_key_ + recv_window + sign_payload);
+
+    curl_slist *headers = nullptr;
+    headers = curl_slist_append(headers, "Content-Type: application/json");
+    headers = curl_slist_append(headers, ("X-BAPI-API-KEY: " + api_key_).c_str());
+    headers = curl_slist_append(headers, ("X-BAPI-TIMESTAMP: " + ts).c_str());
+    headers = curl_slist_append(headers, ("X-BAPI-RECV-WINDOW: " + recv_window).c_str());
+    headers = curl_slist_append(headers, ("X-BAPI-SIGN: " + signature).c_str());
+    // Large batch bodies would otherwise wait on "Expect: 100-continue", a stall for servers that
+    // never send the interim response (the local simulator among them).
+    headers = curl_slist_append(headers, "Expect:");
+    return headers;
+}
+
+std::string RestTransport::perform(const std::string &url, const std::string *body, const std::string &sign_payload,
+                                   RateLimitHeaders *limits)
+{
+    auto *headers = static_cast<curl_slist *>(signed_headers(sign_payload));
+    std::string response;
+    std::lock_guard<std::mutex> lg(mu_);
+    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response);
+    if (limits)
+        *limits = RateLimitHeaders{};
+    curl_easy_setopt(curl_, CURLOPT_HEADERDATA, limits);
+    if (body)
+    {
+        curl_easy_setopt(curl_, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, body->c_str());
+        curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, static_cast<long>(body->size()));
+    }
+    else
+    {
+        curl_easy_setopt(curl_, CURLOPT_HTTPGET, 1L);
+    }
+    const CURLcode rc = curl_easy_perform(curl_);
+    curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, nullptr);
+    curl_slist_free_all(headers);
+    used_ns_.store(latency_now_ns(), std::memory_order_relaxed);
+    if (rc != CURLE_OK)
+        throw std::runtime_error(std::string("HTTP request failed: ") + curl_easy_strerror(rc));
+    record(curl_, false);
+    long status = 0;
+    curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &status);
+    if (status >= 400)
+        throw std::runtime_error("HTTP " + std::to_string(status) + ": " + response);
+    return response;
+}
+
+std::string RestTransport::post(const std::string &path, const std::string &body, RateLimitHeaders *limits)
+{
+    return perform(base_url_ + path, &body, body, limits);
+}
+
+std::string RestTransport::get(const std::string &path, const std::string &query)
+{
+    return perform(base_url_ + path + (query.empty() ? "" : "?" + query), nullptr, query);
+}
+
+void RestTransport::post_many(std::vector<PostRequest> &requests)
+{
+    if (requests.empty())
+        return;
+    std::lock_guard<std::mutex> lg(multi_mu_);
+    grow_pool(requests.size());
+
+    std::vector<std::string> urls(requests.size());
+    std::vector<curl_slist *> headers(requests.size(), nullptr);
+    for (std::size_t i = 0; i < requests.size(); ++i)
+    {
+        auto &r = requests[i];
+        CURL *h = multi_pool_[i];
+        r.response.clear();
+        r.error.clear();
+        r.status = 0;
+        r.limits = RateLimitHeaders{};
+        urls[i] = base_url_ + r.path;
+        headers[i] = static_cast<curl_slist *>(signed_headers(r.body));
+        curl_easy_setopt(h, CURLOPT_URL, urls[i].c_str());
+        curl_easy_setopt(h, CURLOPT_HTTPHEADER, headers[i]);
+        curl_easy_setopt(h, CURLOPT_WRITEDATA, &r.response);
+        curl_easy_setopt(h, CURLOPT_HEADERDATA, &r.limits);
+        curl_easy_setopt(h, CURLOPT_POST, 1L);
+        curl_easy_setopt(h, CURLOPT_POSTFIELDS, r.body.c_str());
+        curl_easy_setopt(h, CURLOPT_POSTFIELDSIZE, static_cast<long>(r.body.size()));
+        curl_easy_setopt(h, CURLOPT_PRIVATE, reinterpret_cast<char *>(i));
+        curl_multi_add_handle(multi_, h);
+    }
+
+    run_multi();
+
+    int left = 0;
+    while (CURLMsg *msg = curl_multi_info_read(multi_, &left))
+    {
+        if (msg->msg != CURLMSG_DONE)
+            continue;
+        char *priv = nullptr;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &priv);
+        auto &r = requests[reinterpret_cast<std::size_t>(priv)];
+        if (msg->data.result != CURLE_OK)
+            r.error = curl_easy_strerror(msg->data.result);
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &r.status);
+        if (r.error.empty() && r.status >= 400)
+            r.error = "HTTP " + std::to_string(r.status);
+    }
+    for (std::size_t i = 0; i < requests.size(); ++i)
+    {
+        curl_multi_remove_handle(multi_, multi_pool_[i]);
+        curl_easy_setopt(multi_pool_[i], CURLOPT_HTTPHEADER, nullptr);
+        curl_slist_free_all(headers[i]);
+        if (requests[i].error.empty())
+            record(multi_pool_[i], false);
+    }
+    pool_used_ns_.store(latency_now_ns(), std::memory_order_relaxed);
+}
+
+void RestTransport::grow_pool(std::size_t n)
+{
+    if (!multi_)
+    {
+        multi_ = curl_multi_init();
+        if (!multi_)
+            throw std::runtime_error("curl_multi_init failed");
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    }
+    while (multi_pool_.size() < n)
+    {
+        CURL *h = curl_easy_init();
+        if (!h)
+            throw std::runtime_error("curl_easy_init failed");
+        configure(h);
+        // Prefer waiting for an existing HTTP/2 connection over opening a new one.
+        curl_easy_setopt(h, CURLOPT_PIPEWAIT, 1L);
+        multi_pool_.push_back(h);
+    }
+}
+
+void RestTransport::run_multi()
+{
+    int running = 0;
+    do
+    {
+        curl_multi_perform(multi_, &running);
+        if (running)
+            curl_multi_poll(multi_, nullptr, 0, 100, nullptr);
+    } while (running);
+}
+
+void RestTransport::record(CURL *handle, bool warm_up)
+{
+    long connects = 0;
+    curl_off_t connect_us = 0;
+    curl_off_t tls_us = 0;
+    curl_off_t total_us = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME_T, &connect_us);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME_T, &tls_us);
+    curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME_T, &total_us);
+    if (connects > 0)
+    {
+        // Both are measured from the start of the transfer; the TLS one is 0 for plain HTTP.
+        const int64_t ns = static_cast<int64_t>(std::max(connect_us, tls_us)) * 1000;
+        connects_.fetch_add(static_cast<uint64_t>(connects), std::memory_order_relaxed);
+        connect_ns_.fetch_add(ns, std::memory_order_relaxed);
+        latency_record(LatencyStage::HttpConnect, ns);
+    }
+    if (!warm_up)
+    {
+        const int64_t ns = static_cast<int64_t>(total_us) * 1000;
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        request_ns_.fetch_add(ns, std::memory_order_relaxed);
+        latency_record(LatencyStage::HttpRequest, ns);
+    }
+}
+
+bool RestTransport::warm()
+{
+    std::string sink;
+    std::lock_guard<std::mutex> lg(mu_);
+    const std::string url = base_url_ + kWarmPath;
+    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl_, CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &sink);
+    curl_easy_setopt(curl_, CURLOPT_HEADERDATA, nullptr);
+    const CURLcode rc = curl_easy_perform(curl_);
+    used_ns_.store(latency_now_ns(), std::memory_order_relaxed);
+    if (rc != CURLE_OK)
+        return false;
+    record(curl_, true);
+    return true;
+}
+
+bool RestTransport::warm_pool(std::size_t handles)
+{
+    std::lock_guard<std::mutex> lg(multi_mu_);
+    grow_pool(std::max<std::size_t>(handles, 1));
+    const std::size_t n = handles == 0 ? multi_pool_.size() : handles;
+    const std::string url = base_url_ + kWarmPath;
+    std::vector<std::string> sinks(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        CURL *h = multi_pool_[i];
+        curl_easy_setopt(h, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(h, CURLOPT_HTTPGET, 1L);
+        curl_easy_setopt(h, CURLOPT_WRITEDATA, &sinks[i]);
+        curl_easy_setopt(h, CURLOPT_HEADERDATA, nullptr);
+        curl_multi_add_handle(multi_, h);
+    }
+    run_multi();
+
+    bool reached = false;
+    int left = 0;
+    while (CURLMsg *msg = curl_multi_info_read(multi_, &left))
+    {
+        if (msg->msg != CURLMSG_DONE || msg->data.result != CURLE_OK)
+            continue;
+        reached = true;
+        record(msg->easy_handle, true);
+    }
+    for (std::size_t i = 0; i < n; ++i)
+        curl_multi_remove_handle(multi_, multi_pool_[i]);
+    pool_used_ns_.store(latency_now_ns(), std::memory_order_relaxed);
+    return reached;
+}
+
+void RestTransport::keep_warm(std::chrono::milliseconds idle)
+{
+    const int64_t now = latency_now_ns();
+    const int64_t idle_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(idle).count();
+    const int64_t used = used_ns_.load(std::memory_order_relaxed);
+    if (used > 0 && now - used >= idle_ns)
+        warm();
+    const int64_t pool_used = pool_used_ns_.load(std::memory_order_relaxed);
+    if (pool_used > 0 && now - pool_used >= idle_ns)
+        warm_pool(0);
+}
+
+RestTransport::Stats RestTransport::stats() const
+{
+    Stats s;
+    s.requests = requests_.load(std::memory_order_relaxed);
+    s.connects = connects_.load(std::memory_order_relaxed);
+    s.connect_ns = connect_ns_.load(std::memory_order_relaxed);
+    s.request_ns = request_ns_.load(std::memory_order_relaxed);
+    return s;
+}
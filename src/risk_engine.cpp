@@ -0,0 +1,253 @@
+#include "risk_engine.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+    constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+    constexpr int64_t kBurstNs = 1000000000; // one second of message credit
+
+    // qty * price in 1e-8 units. The raw product of two 1e-8 values overflows 64 bits, so both
+    // operands are split at kFixedScale and the partial products summed; they share the sign of
+    // the result, so none overflows unless the result does, which saturates instead.
+    int64_t notional_units(int64_t qty, int64_t price)
+    {
+        const long double approx = static_cast<long double>(qty) * price / kFixedScale;
+        if (approx >= static_cast<long double>(kMax))
+            return kMax;
+        if (approx <= static_cast<long double>(kMin))
+            return kMin;
+        const int64_t qh = qty / kFixedScale, ql = qty % kFixedScale;
+        const int64_t ph = price / kFixedScale, pl = price % kFixedScale;
+        return qh * ph * kFixedScale + qh * pl + ql * ph + ql * pl / kFixedScale;
+    }
+
+    int64_t bps_of(int64_t mid, double bps)
+    {
+        return static_cast<int64_t>(std::llround(static_cast<double>(mid) * bps * 1e-4));
+    }
+} // namespace
+
+const char *risk_check_name(RiskCheck c)
+{
+    switch (c)
+    {
+    case RiskCheck::Ok:
+        return "ok";
+    case RiskCheck::KillSwitch:
+        return "kill_switch";
+    case RiskCheck::UnknownSymbol:
+        return "unknown_symbol";
+    case RiskCheck::NoReference:
+        return "no_reference";
+    case RiskCheck::OrderSize:
+        return "order_size";
+    case RiskCheck::FatFinger:
+        return "fat_finger";
+    case RiskCheck::PriceBand:
+        return "price_band";
+    case RiskCheck::WorkingNotional:
+        return "working_notional";
+    case RiskCheck::Position:
+        return "position";
+    case RiskCheck::MessageRate:
+        return "message_rate";
+    }
+    return "unknown";
+}
+
+void RiskEngine::configure(Config cfg)
+{
+    cfg_ = cfg;
+    msg_cost_ns_ = cfg_.max_msgs_per_sec > 0.0 ? std::max<int64_t>(1, std::llround(1e9 / cfg_.max_msgs_per_sec)) : 0;
+    credit_ns_ = 0;
+    credit_at_ns_ = 0;
+}
+
+int RiskEngine::add_symbol(std::string_view symbol)
+{
+    return add_symbol(symbol, cfg_.limits);
+}
+
+int RiskEngine::add_symbol(std::string_view symbol, const Limits &limits)
+{
+    const int existing = symbol_index(symbol);
+    if (existing >= 0)
+        return existing;
+    if (count_ == kMaxSymbols)
+        throw std::length_error("RiskEngine: too many symbols");
+    auto &s = symbols_[count_];
+    s.symbol.assign(symbol);
+    s.limits = limits;
+    s.max_working_notional = limits.max_working_notional > 0.0 ? to_fixed(limits.max_working_notional) : kMax;
+    s.needs_mid = limits.max_order_notional > 0.0 || limits.max_position_notional > 0.0 || limits.price_band_bps > 0.0 ||
+                  limits.fat_finger_bps > 0.0;
+    const int index = static_cast<int>(count_++);
+    set_mid(index, Price{});
+    return index;
+}
+
+int RiskEngine::symbol_index(std::string_view symbol) const
+{
+    const SymbolState *s = find(symbol);
+    return s ? static_cast<int>(s - symbols_) : -1;
+}
+
+RiskEngine::SymbolState *RiskEngine::find(std::string_view symbol)
+{
+    for (std::size_t i = 0; i < count_; ++i)
+        if (symbols_[i].symbol == symbol)
+            return &symbols_[i];
+    return nullptr;
+}
+
+const RiskEngine::SymbolState *RiskEngine::find(std::string_view symbol) const
+{
+    return const_cast<RiskEngine *>(this)->find(symbol);
+}
+
+void RiskEngine::set_mid(int index, Price mid)
+{
+    auto &s = symbols_[index];
+    const auto &l = s.limits;
+    auto &b = s.bands;
+    b.mid = mid.raw > 0 ? mid.raw : 0;
+    // Without a mid every mid-relative limit is left open; check() refuses with NoReference instead.
+    const bool have_mid = b.mid > 0;
+    const double m = mid.to_double();
+    b.band_lo = have_mid && l.price_band_bps > 0.0 ? b.mid - bps_of(b.mid, l.price_band_bps) : kMin;
+    b.band_hi = have_mid && l.price_band_bps > 0.0 ? b.mid + bps_of(b.mid, l.price_band_bps) : kMax;
+    b.buy_max = have_mid && l.fat_finger_bps > 0.0 ? b.mid + bps_of(b.mid, l.fat_finger_bps) : kMax;
+    b.sell_min = have_mid && l.fat_finger_bps > 0.0 ? b.mid - bps_of(b.mid, l.fat_finger_bps) : kMin;
+    b.max_order_qty = have_mid && l.max_order_notional > 0.0 ? to_fixed(l.max_order_notional / m) : kMax;
+    b.max_position_qty = have_mid && l.max_position_notional > 0.0 ? to_fixed(l.max_position_notional / m) : kMax;
+}
+
+void RiskEngine::set_position(std::string_view symbol, Qty net)
+{
+    if (SymbolState *s = find(symbol))
+        s->position.store(net.raw, std::memory_order_relaxed);
+}
+
+void RiskEngine::on_exposure(std::string_view symbol, bool is_buy, int64_t open_qty, int64_t open_notional)
+{
+    SymbolState *s = find(symbol);
+    if (!s)
+        return;
+    const int side = is_buy ? 0 : 1;
+    s->open_qty[side].fetch_add(open_qty, std::memory_order_relaxed);
+    s->open_notional[side].fetch_add(open_notional, std::memory_order_relaxed);
+}
+
+RiskCheck RiskEngine::check_new(const OrderRequest &req, int64_t now_ns)
+{
+    SymbolState *s = find(req.symbol.view());
+    if (!s)
+        return refuse(RiskCheck::UnknownSymbol);
+    const bool limit = req.type == OrderType::Limit;
+    const int64_t notional = limit ? notional_units(req.qty.raw, req.price.raw) : 0;
+    return check(*s, req.is_buy(), limit, req.price.raw, req.qty.raw, req.qty.raw, notional, now_ns);
+}
+
+RiskCheck RiskEngine::check_amend(const OrderRequest &req, const OrderRecord &current, int64_t now_ns)
+{
+    if (killed())
+        return refuse(RiskCheck::KillSwitch);
+    SymbolState *s = find(req.symbol.view());
+    if (!s)
+        return refuse(RiskCheck::UnknownSymbol);
+    // Bybit amends carry the new total qty; zero price/qty means "unchanged".
+    const int64_t price = req.price.raw > 0 ? req.price.raw : to_fixed(current.price);
+    const int64_t qty = req.qty.raw > 0 ? req.qty.raw : to_fixed(current.qty);
+    const int64_t new_open = std::max<int64_t>(qty - to_fixed(current.cum_exec_qty), 0);
+    // What the OrderStore currently counts for this order, computed the way it does.
+    int64_t old_open = 0;
+    int64_t old_notional = 0;
+    if (!is_terminal(current.state))
+    {
+        const double open = std::max(current.qty - current.cum_exec_qty, 0.0);
+        old_open = to_fixed(open);
+        old_notional = to_fixed(open * current.price);
+    }
+    return check(*s, current.is_buy, true, price, qty, new_open - old_open,
+                 notional_units(new_open, price) - old_notional, now_ns);
+}
+
+RiskCheck RiskEngine::check(SymbolState &s, bool is_buy, bool limit, int64_t price, int64_t qty, int64_t open_delta,
+                            int64_t notional_delta, int64_t now_ns)
+{
+    const int side = is_buy ? 0 : 1;
+    const int64_t position = s.position.load(std::memory_order_relaxed);
+    const int64_t open = s.open_qty[side].load(std::memory_order_relaxed) + open_delta;
+    // Position if every open order on this side fills, this one included.
+    const int64_t projected = is_buy ? position + open : position - open;
+    // A market exit no larger than the position is judged on the position alone: resting reducing
+    // orders on the same side (take-profits) must not starve the stop-loss.
+    const bool exit = !limit && (is_buy ? position < 0 && qty <= -position : position > 0 && qty <= position);
+    if (killed_.load(std::memory_order_acquire) && !exit && (is_buy ? projected > 0 : projected < 0))
+        return refuse(RiskCheck::KillSwitch);
+    const Bands &b = s.bands;
+    if (b.mid == 0 && s.needs_mid)
+        return refuse(RiskCheck::NoReference);
+    if (qty > b.max_order_qty)
+        return refuse(RiskCheck::OrderSize);
+    if (limit)
+    {
+        if (is_buy ? price > b.buy_max : price < b.sell_min)
+            return refuse(RiskCheck::FatFinger);
+        if (price < b.band_lo || price > b.band_hi)
+            return refuse(RiskCheck::PriceBand);
+        // Orders that only shrink what is working always pass, even above the cap.
+        if (notional_delta > 0 && s.open_notional[side].load(std::memory_order_relaxed) + notional_delta > s.max_working_notional)
+            return refuse(RiskCheck::WorkingNotional);
+    }
+    if (open_delta > 0 && !exit && (is_buy ? projected > b.max_position_qty : projected < -b.max_position_qty))
+        return refuse(RiskCheck::Position);
+    if (!take_token(now_ns))
+        return refuse(RiskCheck::MessageRate);
+    accepted_.store(accepted_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return RiskCheck::Ok;
+}
+
+bool RiskEngine::take_token(int64_t now_ns)
+{
+    if (msg_cost_ns_ == 0)
+        return true;
+    const int64_t burst = std::max(kBurstNs, msg_cost_ns_);
+    credit_ns_ = std::min(burst, credit_ns_ + std::max<int64_t>(now_ns - credit_at_ns_, 0));
+    credit_at_ns_ = now_ns;
+    if (credit_ns_ < msg_cost_ns_)
+        return false;
+    credit_ns_ -= msg_cost_ns_;
+    return true;
+}
+
+RiskCheck RiskEngine::refuse(RiskCheck c)
+{
+    auto &n = refused_[static_cast<std::size_t>(c)];
+    n.store(n.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return c;
+}
+
+RiskEngine::Exposure RiskEngine::exposure(int index) const
+{
+    const auto &s = symbols_[index];
+    Exposure e;
+    e.position = Qty::from_raw(s.position.load(std::memory_order_relaxed));
+    e.open_buy = Qty::from_raw(s.open_qty[0].load(std::memory_order_relaxed));
+    e.open_sell = Qty::from_raw(s.open_qty[1].load(std::memory_order_relaxed));
+    e.open_buy_notional = s.open_notional[0].load(std::memory_order_relaxed);
+    e.open_sell_notional = s.open_notional[1].load(std::memory_order_relaxed);
+    return e;
+}
+
+uint64_t RiskEngine::refused_total() const
+{
+    uint64_t n = 0;
+    for (const auto &r : refused_)
+        n += r.load(std::memory_order_relaxed);
+    return n;
+}
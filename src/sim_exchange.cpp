@@ -0,0 +1,483 @@
+#include "sim_exchange.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    constexpr int kOk = 0;
+    constexpr int kBadParams = 10001;
+    constexpr int kOrderNotExists = 110001;
+    constexpr int kDuplicateLinkId = 110072;
+
+    std::string str_field(const nlohmann::json &o, const char *key)
+    {
+        auto it = o.find(key);
+        return it != o.end() && it->is_string() ? it->get<std::string>() : std::string{};
+    }
+
+    int int_field(const nlohmann::json &o, const char *key)
+    {
+        auto it = o.find(key);
+        if (it == o.end())
+            return 0;
+        if (it->is_number_integer())
+            return it->get<int>();
+        if (it->is_string())
+            return std::atoi(it->get_ref<const std::string &>().c_str());
+        return 0;
+    }
+
+    template <typename T>
+    bool fixed_field(const nlohmann::json &o, const char *key, T &out)
+    {
+        auto it = o.find(key);
+        return it != o.end() && it->is_string() && T::parse(it->get_ref<const std::string &>(), out);
+    }
+
+    nlohmann::json item_result(const std::string &order_id, const std::string &link)
+    {
+        return {{"orderId", order_id}, {"orderLinkId", link}};
+    }
+
+    nlohmann::json item_status(int code)
+    {
+        return {{"code", code}, {"msg", code == kOk ? "OK" : "rejected by simulator"}};
+    }
+
+    void open_leg(double &size, double &entry, double price, double qty)
+    {
+        entry = (entry * size + price * qty) / (size + qty);
+        size += qty;
+    }
+} // namespace
+
+SimExchange::SimExchange(std::string symbol, Config cfg, OrderStore &orders)
+    : symbol_(std::move(symbol)), cfg_(cfg), store_(orders) {}
+
+SimExchange::Order *SimExchange::find(const std::string &link)
+{
+    for (auto &o : orders_)
+        if (!o.done && o.link == link)
+            return &o;
+    return nullptr;
+}
+
+std::string SimExchange::request(const std::string &op, const std::string &args_json)
+{
+    const auto args = nlohmann::json::parse(args_json, nullptr, false);
+    nlohmann::json resp{{"retCode", kOk}, {"retMsg", "OK"}, {"result", nlohmann::json::object()},
+                        {"retExtInfo", nlohmann::json::object()}, {"time", now_ns_ / 1000000}};
+    if (args.is_discarded() || !args.is_object())
+    {
+        resp["retCode"] = kBadParams;
+        resp["retMsg"] = "bad args";
+        return resp.dump();
+    }
+
+    if (op == "order.cancel-all")
+    {
+        nlohmann::json list = nlohmann::json::array();
+        for (const auto &o : orders_)
+        {
+            if (o.done)
+                continue;
+            list.push_back(item_result(o.order_id, o.link));
+            schedule({now_ns_ + cfg_.cancel_latency_ns, EventKind::Cancel, o.link, {}, {}});
+        }
+        resp["result"]["list"] = std::move(list);
+        return resp.dump();
+    }
+
+    const bool batch = op.size() > 6 && op.compare(op.size() - 6, 6, "-batch") == 0;
+    const std::string action = batch ? op.substr(0, op.size() - 6) : op;
+    auto one = [&](const nlohmann::json &item, std::string &order_id) -> int
+    {
+        if (action == "order.create")
+            return create(item, order_id);
+        if (action == "order.amend")
+            return amend(item);
+        if (action == "order.cancel")
+            return cancel(item);
+        return kBadParams;
+    };
+
+    if (!batch)
+    {
+        std::string order_id;
+        const int code = one(args, order_id);
+        resp["retCode"] = code;
+        if (code != kOk)
+            resp["retMsg"] = "rejected by simulator";
+        resp["result"] = item_result(order_id, str_field(args, "orderLinkId"));
+        return resp.dump();
+    }
+
+    auto it = args.find("request");
+    if (it == args.end() || !it->is_array())
+    {
+        resp["retCode"] = kBadParams;
+        resp["retMsg"] = "missing request list";
+        return resp.dump();
+    }
+    nlohmann::json list = nlohmann::json::array();
+    nlohmann::json status = nlohmann::json::array();
+    for (const auto &item : *it)
+    {
+        std::string order_id;
+        const int code = one(item, order_id);
+        list.push_back(item_result(order_id, str_field(item, "orderLinkId")));
+        status.push_back(item_status(code));
+    }
+    resp["result"]["list"] = std::move(list);
+    resp["retExtInfo"]["list"] = std::move(status);
+    return resp.dump();
+}
+
+int SimExchange::create(const nlohmann::json &args, std::string &order_id)
+{
+    Order o;
+    o.link = str_field(args, "orderLinkId");
+    const std::string side = str_field(args, "side");
+    const std::string type = str_field(args, "orderType");
+    o.is_buy = side == "Buy";
+    o.market = type == "Market";
+    o.post_only = str_field(args, "timeInForce") == "PostOnly";
+    o.position_idx = int_field(args, "positionIdx");
+    if (str_field(args, "symbol") != symbol_ || (side != "Buy" && side != "Sell") || (!o.market && type != "Limit"))
+        return kBadParams;
+    // Same filters the exchange applies: lot step, minimum size and tick grid.
+    const auto &meta = cfg_.meta;
+    if (!fixed_field(args, "qty", o.qty) || o.qty.raw <= 0 || !o.qty.on_grid(meta.lot_size) || o.qty < meta.min_qty)
+        return kBadParams;
+    if (!o.market && (!fixed_field(args, "price", o.price) || o.price.raw <= 0 || !o.price.on_grid(meta.tick_size)))
+        return kBadParams;
+    if (!o.link.empty() && find(o.link))
+        return kDuplicateLinkId;
+    o.order_id = "sim-" + std::to_string(++next_order_id_);
+    if (o.link.empty())
+        o.link = o.order_id;
+    order_id = o.order_id;
+    schedule({now_ns_ + cfg_.ack_latency_ns, EventKind::Activate, o.link, {}, {}});
+    orders_.push_back(std::move(o));
+    return kOk;
+}
+
+int SimExchange::amend(const nlohmann::json &args)
+{
+    const Order *o = find(str_field(args, "orderLinkId"));
+    if (!o)
+        return kOrderNotExists;
+    Event ev{now_ns_ + cfg_.ack_latency_ns, EventKind::Amend, o->link, o->price, o->qty};
+    if (args.contains("price") && (!fixed_field(args, "price", ev.price) || !ev.price.on_grid(cfg_.meta.tick_size)))
+        return kBadParams;
+    if (args.contains("qty") && (!fixed_field(args, "qty", ev.qty) || ev.qty.raw <= 0 || !ev.qty.on_grid(cfg_.meta.lot_size)))
+        return kBadParams;
+    schedule(std::move(ev));
+    return kOk;
+}
+
+int SimExchange::cancel(const nlohmann::json &args)
+{
+    const Order *o = find(str_field(args, "orderLinkId"));
+    if (!o)
+        return kOrderNotExists;
+    schedule({now_ns_ + cfg_.cancel_latency_ns, EventKind::Cancel, o->link, {}, {}});
+    return kOk;
+}
+
+void SimExchange::schedule(Event ev)
+{
+    auto pos = std::upper_bound(events_.begin(), events_.end(), ev.due_ns,
+                                [](int64_t due, const Event &e)
+                                { return due < e.due_ns; });
+    events_.insert(pos, std::move(ev));
+}
+
+void SimExchange::advance(int64_t now_ns)
+{
+    std::size_t n = 0;
+    while (n < events_.size() && events_[n].due_ns <= now_ns)
+    {
+        now_ns_ = std::max(now_ns_, events_[n].due_ns);
+        apply(events_[n]);
+        ++n;
+    }
+    events_.erase(events_.begin(), events_.begin() + static_cast<std::ptrdiff_t>(n));
+    now_ns_ = std::max(now_ns_, now_ns);
+    sweep();
+}
+
+void SimExchange::sweep()
+{
+    orders_.erase(std::remove_if(orders_.begin(), orders_.end(),
+                                 [](const Order &o)
+                                 { return o.done; }),
+                  orders_.end());
+}
+
+void SimExchange::apply(const Event &ev)
+{
+    Order *o = find(ev.link);
+    if (!o)
+        return;
+    switch (ev.kind)
+    {
+    case EventKind::Activate:
+    {
+        o->active = true;
+        const bool crosses = o->market ||
+                             (o->is_buy ? book_.ask_count && book_.asks[0].price <= o->price
+                                        : book_.bid_count && book_.bids[0].price >= o->price);
+        if (crosses && o->post_only)
+        {
+            publish(*o, OrderState::Cancelled);
+            return;
+        }
+        if (crosses)
+            take(*o);
+        if (o->market && o->filled < o->qty)
+        {
+            // Market orders are IOC: whatever the displayed book could not absorb is cancelled.
+            publish(*o, o->filled.raw ? OrderState::Cancelled : OrderState::Rejected);
+            return;
+        }
+        if (o->filled == o->qty)
+        {
+            publish(*o, OrderState::Filled);
+            return;
+        }
+        o->queue_ahead = Qty::from_raw(std::max<int64_t>(0, level_qty(o->is_buy, o->price)));
+        publish(*o, o->filled.raw ? OrderState::PartiallyFilled : OrderState::New);
+        break;
+    }
+    case EventKind::Amend:
+    {
+        if (ev.qty <= o->filled)
+        {
+            // Shrinking below the executed size closes the order.
+            o->qty = o->filled;
+            publish(*o, OrderState::Filled);
+            return;
+        }
+        // A new price or a larger size loses queue priority; a smaller size keeps it.
+        const bool requeue = ev.price != o->price || ev.qty > o->qty;
+        o->price = ev.price;
+        o->qty = ev.qty;
+        if (!o->active)
+            return;
+        const bool crosses = o->is_buy ? book_.ask_count && book_.asks[0].price <= o->price
+                                       : book_.bid_count && book_.bids[0].price >= o->price;
+        if (crosses)
+            take(*o);
+        if (o->filled == o->qty)
+        {
+            publish(*o, OrderState::Filled);
+            return;
+        }
+        if (requeue)
+            o->queue_ahead = Qty::from_raw(std::max<int64_t>(0, level_qty(o->is_buy, o->price)));
+        publish(*o, o->filled.raw ? OrderState::PartiallyFilled : OrderState::New);
+        break;
+    }
+    case EventKind::Cancel:
+        publish(*o, OrderState::Cancelled);
+        break;
+    }
+}
+
+int64_t SimExchange::level_qty(bool is_buy, Price price) const
+{
+    const BookLevel *levels = is_buy ? book_.bids : book_.asks;
+    const uint32_t count = is_buy ? book_.bid_count : book_.ask_count;
+    if (count == 0)
+        return -1;
+    // Sides are best first: bids descending, asks ascending.
+    auto better = [&](Price a, Price b)
+    { return is_buy ? a > b : a < b; };
+    if (better(price, levels[0].price))
+        return 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (levels[i].price == price)
+            return levels[i].qty.raw;
+        if (better(price, levels[i].price))
+            return 0;
+    }
+    // Beyond the snapshot: unknown unless the snapshot already shows the whole side.
+    return count < kBookSnapshotDepth ? 0 : -1;
+}
+
+void SimExchange::take(Order &o)
+{
+    const BookLevel *levels = o.is_buy ? book_.asks : book_.bids;
+    const uint32_t count = o.is_buy ? book_.ask_count : book_.bid_count;
+    for (uint32_t i = 0; i < count && o.filled < o.qty; ++i)
+    {
+        const Price px = levels[i].price;
+        if (!o.market && (o.is_buy ? px > o.price : px < o.price))
+            break;
+        fill(o, px, std::min(levels[i].qty, o.qty - o.filled), false);
+    }
+}
+
+void SimExchange::fill(Order &o, Price price, Qty qty, bool maker)
+{
+    if (qty.raw <= 0)
+        return;
+    const double notional = price.to_double() * qty.to_double();
+    const double fee = notional * (maker ? cfg_.maker_fee_bps : cfg_.taker_fee_bps) * 1e-4;
+    o.filled += qty;
+    o.filled_notional += notional;
+    fees_ += fee;
+    notional_ += notional;
+    const double realized_before = realized_;
+    book_position(o.position_idx, o.is_buy, price.to_double(), qty.to_double());
+    fills_.push_back({now_ns_, o.link, o.is_buy, maker, price, qty, fee, o.position_idx, o.order_id, realized_ - realized_before});
+    if (listener_)
+        listener_->on_fill(fills_.back());
+}
+
+void SimExchange::publish(Order &o, OrderState state)
+{
+    OrderUpdate u;
+    u.order_link_id = o.link;
+    u.order_id = o.order_id;
+    u.symbol = symbol_;
+    u.state = state;
+    u.is_buy = o.is_buy;
+    u.price = o.price.to_double();
+    u.qty = o.qty.to_double();
+    u.cum_exec_qty = o.filled.to_double();
+    u.avg_price = o.filled.raw ? o.filled_notional / u.cum_exec_qty : 0.0;
+    u.updated_ms = now_ns_ / 1000000;
+    store_.apply(u);
+    if (listener_)
+        listener_->on_order(u, o.position_idx);
+    if (is_terminal(state))
+        o.done = true;
+}
+
+void SimExchange::on_book(int64_t now_ns, const BookSnapshot &book)
+{
+    advance(now_ns);
+    book_ = book;
+    for (auto &o : orders_)
+    {
+        if (o.done || !o.active)
+            continue;
+        // The opposite side reaching our price means the market traded through us.
+        const bool through = o.is_buy ? book_.ask_count && book_.asks[0].price <= o.price
+                                      : book_.bid_count && book_.bids[0].price >= o.price;
+        if (through)
+        {
+            fill(o, o.price, o.qty - o.filled, true);
+            publish(o, OrderState::Filled);
+            continue;
+        }
+        const int64_t shown = level_qty(o.is_buy, o.price);
+        if (shown >= 0 && shown < o.queue_ahead.raw)
+            o.queue_ahead = Qty::from_raw(shown);
+    }
+    sweep();
+}
+
+void SimExchange::on_trade(int64_t now_ns, const PublicTrade &trade)
+{
+    advance(now_ns);
+    Qty left = trade.qty; // volume at our price not yet attributed to the queue or to us
+    for (auto &o : orders_)
+    {
+        // A taker buy lifts asks (our sells); a taker sell hits bids (our buys).
+        if (o.done || !o.active || o.is_buy == trade.is_buy)
+            continue;
+        const bool at_price = trade.price == o.price;
+        const bool through = o.is_buy ? trade.price < o.price : trade.price > o.price;
+        if (!at_price && !through)
+            continue;
+        Qty q = o.qty - o.filled;
+        if (at_price)
+        {
+            const Qty ahead = std::min(o.queue_ahead, left);
+            o.queue_ahead -= ahead;
+            left -= ahead;
+            q = std::min(q, left);
+            left -= q;
+        }
+        if (q.raw <= 0)
+            continue;
+        fill(o, o.price, q, true);
+        publish(o, o.filled == o.qty ? OrderState::Filled : OrderState::PartiallyFilled);
+    }
+    sweep();
+}
+
+void SimExchange::book_position(int position_idx, bool is_buy, double price, double qty)
+{
+    auto close_long = [&](double q)
+    {
+        q = std::min(q, long_.size);
+        realized_ += (price - long_.entry) * q;
+        long_.size -= q;
+        if (long_.size <= 0.0)
+            long_ = Leg{};
+        return q;
+    };
+    auto close_short = [&](double q)
+    {
+        q = std::min(q, short_.size);
+        realized_ += (short_.entry - price) * q;
+        short_.size -= q;
+        if (short_.size <= 0.0)
+            short_ = Leg{};
+        return q;
+    };
+    switch (position_idx)
+    {
+    case 1: // hedge-mode long leg; a sell reduces it
+        if (is_buy)
+            open_leg(long_.size, long_.entry, price, qty);
+        else
+            close_long(qty);
+        break;
+    case 2: // hedge-mode short leg; a buy reduces it
+        if (!is_buy)
+            open_leg(short_.size, short_.entry, price, qty);
+        else
+            close_short(qty);
+        break;
+    default: // one-way: reduce the opposite side first, the remainder opens
+        if (is_buy)
+        {
+            const double rest = qty - close_short(qty);
+            if (rest > 0.0)
+                open_leg(long_.size, long_.entry, price, rest);
+        }
+        else
+        {
+            const double rest = qty - close_long(qty);
+            if (rest > 0.0)
+                open_leg(short_.size, short_.entry, price, rest);
+        }
+        break;
+    }
+}
+
+PositionView SimExchange::position() const
+{
+    PositionView v;
+    v.long_size = long_.size;
+    v.long_entry = long_.entry;
+    v.short_size = short_.size;
+    v.short_entry = short_.entry;
+    return v;
+}
+
+double SimExchange::net_qty() const { return long_.size - short_.size; }
+
+double SimExchange::unrealized_pnl(double mark) const
+{
+    return (mark - long_.entry) * long_.size + (short_.entry - mark) * short_.size;
+}
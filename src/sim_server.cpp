@@ -0,0 +1,174 @@
+#include "sim_server.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <ixwebsocket/IXHttpServer.h>
+#include <ixwebsocket/IXNetSystem.h>
+#include <ixwebsocket/IXWebSocketServer.h>
+
+namespace
+{
+    constexpr auto kTick = std::chrono::milliseconds{1};
+}
+
+SimServer::SimServer(Config cfg)
+    : cfg_(std::move(cfg)),
+      venue_(cfg_.symbol, cfg_.venue, [this](uint64_t session, const std::string &text)
+             { send(session, text); }),
+      readers_(cfg_.files.size()) {}
+
+SimServer::~SimServer() { stop(); }
+
+void SimServer::start()
+{
+    if (running_)
+        return;
+    for (std::size_t i = 0; i < cfg_.files.size(); ++i)
+        readers_[i].open(cfg_.files[i]);
+    ix::initNetSystem();
+
+    http_ = std::make_unique<ix::HttpServer>(cfg_.rest_port, cfg_.host);
+    http_->setOnConnectionCallback([this](ix::HttpRequestPtr req, std::shared_ptr<ix::ConnectionState>) -> ix::HttpResponsePtr
+                                   {
+        const auto reply = venue_.handle_http(req->method, req->uri, req->body);
+        ix::WebSocketHttpHeaders headers;
+        headers["Content-Type"] = "application/json";
+        return std::make_shared<ix::HttpResponse>(reply.status, reply.status == 200 ? "OK" : "Not Found",
+                                                  ix::HttpErrorCode::Ok, headers, reply.body); });
+
+    ws_ = std::make_unique<ix::WebSocketServer>(cfg_.ws_port, cfg_.host);
+    ws_->setOnClientMessageCallback([this](std::shared_ptr<ix::ConnectionState> state, ix::WebSocket &ws, const ix::WebSocketMessagePtr &msg)
+                                    {
+        if (msg->type == ix::WebSocketMessageType::Open)
+        {
+            SimVenue::Channel channel;
+            if (!SimVenue::channel_for_path(msg->openInfo.uri, channel))
+            {
+                ws.close();
+                return;
+            }
+            uint64_t id = 0;
+            {
+                std::lock_guard<std::mutex> lk(conns_mu_);
+                id = ++next_session_;
+                conns_[id] = &ws;
+                sessions_[state.get()] = id;
+            }
+            venue_.open_session(id, channel);
+            return;
+        }
+        uint64_t id = 0;
+        {
+            std::lock_guard<std::mutex> lk(conns_mu_);
+            auto it = sessions_.find(state.get());
+            if (it == sessions_.end())
+                return;
+            id = it->second;
+        }
+        if (msg->type == ix::WebSocketMessageType::Message)
+        {
+            venue_.handle_ws(id, msg->str);
+        }
+        else if (msg->type == ix::WebSocketMessageType::Close)
+        {
+            venue_.close_session(id);
+            std::lock_guard<std::mutex> lk(conns_mu_);
+            conns_.erase(id);
+            sessions_.erase(state.get());
+        } });
+
+    auto res = http_->listen();
+    if (!res.first)
+        throw std::runtime_error("SimServer: REST listen on port " + std::to_string(cfg_.rest_port) + ": " + res.second);
+    res = ws_->listen();
+    if (!res.first)
+        throw std::runtime_error("SimServer: WS listen on port " + std::to_string(cfg_.ws_port) + ": " + res.second);
+    http_->start();
+    ws_->start();
+
+    running_ = true;
+    replay_thread_ = std::thread([this]
+                                 { replay(); });
+}
+
+void SimServer::stop()
+{
+    if (!running_.exchange(false))
+        return;
+    if (replay_thread_.joinable())
+        replay_thread_.join();
+    ws_->stop();
+    http_->stop();
+}
+
+std::string SimServer::rest_url() const { return "http://" + cfg_.host + ":" + std::to_string(cfg_.rest_port); }
+
+std::string SimServer::ws_url(const char *path) const { return "ws://" + cfg_.host + ":" + std::to_string(cfg_.ws_port) + path; }
+
+void SimServer::send(uint64_t session, const std::string &text)
+{
+    std::lock_guard<std::mutex> lk(conns_mu_);
+    auto it = conns_.find(session);
+    if (it != conns_.end())
+        it->second->sendText(text);
+}
+
+void SimServer::replay()
+{
+    // Hold the tape until someone listens, so every client sees it from the start.
+    while (running_ && venue_.public_sessions() == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    using Clock = std::chrono::steady_clock;
+    const double speed = cfg_.speed;
+    auto start = Clock::now();
+    int64_t first_ns = -1;
+    int64_t now = 0;
+    // Recorded time that corresponds to the wall clock, at the configured speed.
+    auto paced = [&](int64_t origin, Clock::time_point since)
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count();
+        return origin + static_cast<int64_t>(static_cast<double>(elapsed) * (speed > 0.0 ? speed : 1.0));
+    };
+
+    for (const auto &reader : readers_)
+    {
+        // Files from different sessions have unrelated steady clocks; wall time orders them.
+        const int64_t to_wall = reader.file_header().wall_ns - reader.file_header().steady_ns;
+        RecordView r;
+        for (std::size_t pos = reader.begin(); running_ && reader.next(pos, r);)
+        {
+            if (r.header.type != RecordType::RawPublic)
+                continue;
+            const int64_t t = std::max(now, r.header.recv_ns + to_wall);
+            if (first_ns < 0)
+            {
+                first_ns = t;
+                start = Clock::now();
+            }
+            while (speed > 0.0 && running_)
+            {
+                const int64_t at = paced(first_ns, start);
+                if (at >= t)
+                    break;
+                venue_.advance(at);
+                std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(
+                    kTick, std::chrono::nanoseconds{static_cast<int64_t>(static_cast<double>(t - at) / speed)}));
+            }
+            now = t;
+            venue_.on_market(now, r.payload);
+            replayed_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    done_.store(true, std::memory_order_release);
+
+    // Keep the clock running so orders sent after the tape ends are still acked and cancelled.
+    const auto end = Clock::now();
+    while (running_)
+    {
+        venue_.advance(paced(now, end));
+        std::this_thread::sleep_for(kTick);
+    }
+}
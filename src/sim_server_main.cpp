@@ -0,0 +1,81 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+#include "backtest_env.hpp"
+#include "sim_server.hpp"
+
+namespace
+{
+    std::atomic<bool> g_stop{false};
+
+    void on_signal(int) { g_stop = true; }
+
+    void usage()
+    {
+        std::cerr << "usage: bybit_sim_server <symbol> <recording.bmd | directory>...\n"
+                     "  Instrument steps: BYBIT_BT_TICK_SIZE, BYBIT_BT_LOT_SIZE, BYBIT_BT_MIN_QTY (required)\n"
+                     "  Latency and fees: BYBIT_BT_ACK_LATENCY_MS, BYBIT_BT_CANCEL_LATENCY_MS, BYBIT_BT_*_FEE_BPS\n"
+                     "  Server: BYBIT_SIM_HOST, BYBIT_SIM_REST_PORT, BYBIT_SIM_WS_PORT, BYBIT_SIM_SPEED, BYBIT_SIM_WALLET_USDT\n";
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    load_env_file(".env");
+    if (argc < 3)
+    {
+        usage();
+        return 2;
+    }
+
+    try
+    {
+        const auto bt = backtest_config_from_env(argv[1], expand_recordings(argc, argv, 2));
+        SimServer::Config cfg;
+        cfg.symbol = bt.symbol;
+        cfg.files = bt.files;
+        cfg.venue.sim = bt.sim;
+        cfg.venue.wallet_usdt = std::stod(get_env("BYBIT_SIM_WALLET_USDT", "10000"));
+        cfg.host = get_env("BYBIT_SIM_HOST", "127.0.0.1");
+        cfg.rest_port = std::stoi(get_env("BYBIT_SIM_REST_PORT", "18080"));
+        cfg.ws_port = std::stoi(get_env("BYBIT_SIM_WS_PORT", "18081"));
+        cfg.speed = std::stod(get_env("BYBIT_SIM_SPEED", "1"));
+
+        SimServer server(cfg);
+        server.start();
+        std::signal(SIGINT, on_signal);
+        std::signal(SIGTERM, on_signal);
+        std::cout << "[SIM] " << cfg.symbol << " files=" << cfg.files.size() << " speed=" << cfg.speed << "\n"
+                  << "[SIM] BYBIT_BASE_URL=" << server.rest_url() << "\n"
+                  << "[SIM] BYBIT_WS_PUBLIC_URL=" << server.ws_url("/v5/public/linear") << "\n"
+                  << "[SIM] BYBIT_WS_PRIVATE_URL=" << server.ws_url("/v5/private") << "\n"
+                  << "[SIM] BYBIT_WS_TRADE_URL=" << server.ws_url("/v5/trade") << "\n"
+                  << "[SIM] replay starts when the first public stream subscribes; Ctrl-C to stop" << std::endl;
+
+        auto next_report = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        bool reported_done = false;
+        while (!g_stop)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            const bool done = server.replay_done();
+            if (std::chrono::steady_clock::now() < next_report && done == reported_done)
+                continue;
+            next_report = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+            reported_done = done;
+            std::cout << "[SIM] messages=" << server.replayed() << " fills=" << server.venue().fill_count()
+                      << " net_pnl=" << server.venue().net_pnl() << (done ? " (replay finished)" : "") << std::endl;
+        }
+        server.stop();
+        std::cout << "[SIM] stopped: messages=" << server.replayed() << " fills=" << server.venue().fill_count()
+                  << " net_pnl=" << server.venue().net_pnl() << std::endl;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,539 @@
+#include "sim_venue.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    // Deepest book Bybit serves for linear contracts; the replay book never truncates below it.
+    constexpr int kMaxBookDepth = 500;
+
+    std::string num(double v)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.10g", v);
+        return buf;
+    }
+
+    const char *status_name(OrderState s)
+    {
+        switch (s)
+        {
+        case OrderState::PartiallyFilled:
+            return "PartiallyFilled";
+        case OrderState::Filled:
+            return "Filled";
+        case OrderState::Cancelled:
+            return "Cancelled";
+        case OrderState::Rejected:
+            return "Rejected";
+        default:
+            return "New";
+        }
+    }
+
+    // "orderbook.<depth>.<symbol>"
+    bool book_topic(std::string_view topic, int &depth, std::string_view &symbol)
+    {
+        constexpr std::string_view kPrefix = "orderbook.";
+        if (topic.substr(0, kPrefix.size()) != kPrefix)
+            return false;
+        topic.remove_prefix(kPrefix.size());
+        const auto dot = topic.find('.');
+        if (dot == std::string_view::npos || dot == 0)
+            return false;
+        depth = std::atoi(std::string(topic.substr(0, dot)).c_str());
+        symbol = topic.substr(dot + 1);
+        return depth > 0;
+    }
+
+    // Query parameter from "a=1&b=2"; empty if absent.
+    std::string query_param(std::string_view query, std::string_view key)
+    {
+        while (!query.empty())
+        {
+            const auto amp = query.find('&');
+            const auto pair = query.substr(0, amp);
+            const auto eq = pair.find('=');
+            if (eq != std::string_view::npos && pair.substr(0, eq) == key)
+                return std::string(pair.substr(eq + 1));
+            if (amp == std::string_view::npos)
+                break;
+            query.remove_prefix(amp + 1);
+        }
+        return {};
+    }
+
+    nlohmann::json envelope(nlohmann::json result, int64_t now_ms)
+    {
+        return {{"retCode", 0}, {"retMsg", "OK"}, {"result", std::move(result)}, {"retExtInfo", nlohmann::json::object()}, {"time", now_ms}};
+    }
+
+    nlohmann::json levels_json(const BookLevel *levels, uint32_t count, int depth)
+    {
+        nlohmann::json out = nlohmann::json::array();
+        for (uint32_t i = 0; i < count && static_cast<int>(i) < depth; ++i)
+            out.push_back({levels[i].price.str(), levels[i].qty.str()});
+        return out;
+    }
+} // namespace
+
+bool SimVenue::Session::subscribed(std::string_view topic) const
+{
+    return std::find(topics.begin(), topics.end(), topic) != topics.end();
+}
+
+SimVenue::SimVenue(std::string symbol, Config cfg, Sender send)
+    : symbol_(std::move(symbol)), cfg_(std::move(cfg)), send_(std::move(send)), feed_(""), sim_(symbol_, cfg_.sim, orders_)
+{
+    feed_.prepare({symbol_}, kMaxBookDepth);
+    sim_.set_listener(this);
+}
+
+void SimVenue::advance(int64_t now_ns)
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    sim_.advance(now_ns);
+}
+
+void SimVenue::on_market(int64_t now_ns, std::string_view raw)
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    sim_.advance(now_ns);
+    feed_.ingest(raw, now_ns);
+    bool book_changed = false;
+    const uint64_t seq = feed_.update_seq();
+    if (seq != seen_seq_)
+    {
+        seen_seq_ = seq;
+        if (!feed_.read_book(symbol_, book_))
+            book_ = BookSnapshot{};
+        book_changed = true;
+        sim_.on_book(now_ns, book_);
+    }
+    if (!parse_public_message(raw, msg_) || msg_.symbol != symbol_)
+        return;
+    if (msg_.kind == PublicTopic::PublicTrade)
+        for_each_trade(msg_.data, [&](const PublicTrade &t)
+                       { sim_.on_trade(now_ns, t); });
+
+    const std::string text(raw);
+    for (auto &[id, s] : sessions_)
+    {
+        if (s.channel != Channel::Public)
+            continue;
+        for (const auto &topic : s.topics)
+        {
+            int depth = 0;
+            std::string_view sym;
+            if (topic == msg_.topic)
+                send_(id, text);
+            else if (book_changed && msg_.kind == PublicTopic::Orderbook && book_topic(topic, depth, sym))
+                send_(id, book_snapshot_message(topic, depth));
+        }
+    }
+}
+
+SimVenue::HttpReply SimVenue::handle_http(const std::string &method, const std::string &target, const std::string &body)
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    const auto qpos = target.find('?');
+    const std::string path = target.substr(0, qpos);
+    const std::string_view query = qpos == std::string::npos ? std::string_view{} : std::string_view(target).substr(qpos + 1);
+
+    if (method == "POST" && path.rfind("/v5/order/", 0) == 0)
+        return {200, sim_.request("order." + path.substr(10), body)};
+    if (method != "GET")
+        return {404, R"({"retCode":10404,"retMsg":"not found"})"};
+
+    const std::string sym = query_param(query, "symbol");
+    const bool ours = sym.empty() || sym == symbol_;
+    nlohmann::json list = nlohmann::json::array();
+    if (path == "/v5/market/instruments-info")
+    {
+        if (ours)
+        {
+            const auto &meta = cfg_.sim.meta;
+            list.push_back({{"symbol", symbol_},
+                            {"contractType", "LinearPerpetual"},
+                            {"status", "Trading"},
+                            {"quoteCoin", "USDT"},
+                            {"settleCoin", "USDT"},
+                            {"priceFilter", {{"tickSize", meta.tick_size.str()}, {"minPrice", meta.tick_size.str()}}},
+                            {"lotSizeFilter", {{"qtyStep", meta.lot_size.str()}, {"minOrderQty", meta.min_qty.str()}}}});
+        }
+        return {200, envelope({{"category", "linear"}, {"list", std::move(list)}, {"nextPageCursor", ""}}, now_ms()).dump()};
+    }
+    if (path == "/v5/market/time")
+    {
+        const int64_t ms = now_ms();
+        return {200, envelope({{"timeSecond", std::to_string(ms / 1000)}, {"timeNano", std::to_string(ms * 1000000)}}, ms).dump()};
+    }
+    if (path == "/v5/market/tickers")
+    {
+        const auto msg = ticker_snapshot_message();
+        if (ours && !msg.empty())
+            list.push_back(nlohmann::json::parse(msg)["data"]);
+        return {200, envelope({{"category", "linear"}, {"list", std::move(list)}}, now_ms()).dump()};
+    }
+    if (path == "/v5/market/orderbook")
+    {
+        if (!ours)
+            return {200, R"({"retCode":10001,"retMsg":"unknown symbol"})"};
+        const int limit = std::max(1, std::atoi(query_param(query, "limit").c_str()));
+        return {200, envelope(nlohmann::json::parse(book_snapshot_message("", limit))["data"], now_ms()).dump()};
+    }
+    if (path == "/v5/position/list")
+        return {200, envelope({{"category", "linear"}, {"list", ours ? positions_json() : list}}, now_ms()).dump()};
+    if (path == "/v5/account/wallet-balance")
+    {
+        const double upl = book_.valid() ? sim_.unrealized_pnl(book_.mid()) : 0.0;
+        const double balance = cfg_.wallet_usdt + sim_.realized_pnl() - sim_.fees();
+        list.push_back({{"accountType", "UNIFIED"},
+                        {"totalEquity", num(balance + upl)},
+                        {"totalWalletBalance", num(balance)},
+                        {"totalPerpUPL", num(upl)},
+                        {"coin", {{{"coin", "USDT"}, {"walletBalance", num(balance)}, {"equity", num(balance + upl)}, {"unrealisedPnl", num(upl)}, {"cumRealisedPnl", num(sim_.realized_pnl() - sim_.fees())}}}}});
+        return {200, envelope({{"list", std::move(list)}}, now_ms()).dump()};
+    }
+    return {404, R"({"retCode":10404,"retMsg":"not found"})"};
+}
+
+bool SimVenue::channel_for_path(std::string_view path, Channel &out)
+{
+    path = path.substr(0, path.find('?'));
+    if (path.rfind("/v5/public/", 0) == 0)
+        out = Channel::Public;
+    else if (path == "/v5/private")
+        out = Channel::Private;
+    else if (path == "/v5/trade")
+        out = Channel::Trade;
+    else
+        return false;
+    return true;
+}
+
+void SimVenue::open_session(uint64_t session, Channel channel)
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    sessions_[session] = Session{channel, false, {}};
+}
+
+void SimVenue::close_session(uint64_t session)
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    sessions_.erase(session);
+}
+
+void SimVenue::handle_ws(uint64_t session, const std::string &text)
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = sessions_.find(session);
+    if (it == sessions_.end())
+        return;
+    const auto req = nlohmann::json::parse(text, nullptr, false);
+    if (req.is_discarded() || !req.is_object())
+        return;
+    switch (it->second.channel)
+    {
+    case Channel::Public:
+        handle_public(session, it->second, req);
+        break;
+    case Channel::Private:
+        handle_private(session, it->second, req);
+        break;
+    case Channel::Trade:
+        handle_trade(session, it->second, req);
+        break;
+    }
+}
+
+void SimVenue::handle_public(uint64_t id, Session &s, const nlohmann::json &req)
+{
+    const auto op = req.value("op", std::string{});
+    nlohmann::json resp{{"success", true}, {"ret_msg", op}, {"conn_id", "sim-" + std::to_string(id)}, {"op", op}};
+    if (req.contains("req_id"))
+        resp["req_id"] = req["req_id"];
+    if (op == "ping")
+    {
+        resp["ret_msg"] = "pong";
+        send_(id, resp.dump());
+        return;
+    }
+    if (op != "subscribe" && op != "unsubscribe")
+        return;
+
+    std::vector<std::string> added;
+    for (const auto &arg : req.value("args", nlohmann::json::array()))
+    {
+        if (!arg.is_string())
+            continue;
+        const auto topic = arg.get<std::string>();
+        if (op == "unsubscribe")
+        {
+            s.topics.erase(std::remove(s.topics.begin(), s.topics.end(), topic), s.topics.end());
+            continue;
+        }
+        int depth = 0;
+        std::string_view sym;
+        const bool known = (book_topic(topic, depth, sym) && sym == symbol_) || topic == "tickers." + symbol_ ||
+                           topic == "publicTrade." + symbol_;
+        if (!known)
+        {
+            resp["success"] = false;
+            resp["ret_msg"] = "error:handler not found,topic:" + topic;
+            continue;
+        }
+        if (!s.subscribed(topic))
+        {
+            s.topics.push_back(topic);
+            added.push_back(topic);
+        }
+    }
+    send_(id, resp.dump());
+
+    // Late subscribers start from the current state, like Bybit's initial snapshot.
+    for (const auto &topic : added)
+    {
+        int depth = 0;
+        std::string_view sym;
+        if (book_topic(topic, depth, sym))
+        {
+            if (book_.valid())
+                send_(id, book_snapshot_message(topic, depth));
+        }
+        else if (topic.rfind("tickers.", 0) == 0)
+        {
+            const auto msg = ticker_snapshot_message();
+            if (!msg.empty())
+                send_(id, msg);
+        }
+    }
+}
+
+void SimVenue::handle_private(uint64_t id, Session &s, const nlohmann::json &req)
+{
+    const auto op = req.value("op", std::string{});
+    const std::string conn = "sim-" + std::to_string(id);
+    nlohmann::json resp{{"success", true}, {"ret_msg", ""}, {"conn_id", conn}, {"op", op}};
+    if (req.contains("req_id"))
+        resp["req_id"] = req["req_id"];
+    if (op == "auth")
+    {
+        s.authed = true;
+    }
+    else if (op == "ping")
+    {
+        resp = {{"op", "pong"}, {"args", {std::to_string(now_ms())}}, {"conn_id", conn}};
+        if (req.contains("req_id"))
+            resp["req_id"] = req["req_id"];
+    }
+    else if (op == "subscribe" || op == "unsubscribe")
+    {
+        if (!s.authed)
+        {
+            resp["success"] = false;
+            resp["ret_msg"] = "Request not authorized";
+        }
+        else
+        {
+            for (const auto &arg : req.value("args", nlohmann::json::array()))
+            {
+                if (!arg.is_string())
+                    continue;
+                const auto topic = arg.get<std::string>();
+                s.topics.erase(std::remove(s.topics.begin(), s.topics.end(), topic), s.topics.end());
+                if (op == "subscribe")
+                    s.topics.push_back(topic);
+            }
+        }
+    }
+    else
+    {
+        return;
+    }
+    send_(id, resp.dump());
+}
+
+void SimVenue::handle_trade(uint64_t id, Session &s, const nlohmann::json &req)
+{
+    const auto op = req.value("op", std::string{});
+    const std::string conn = "sim-" + std::to_string(id);
+    if (op == "auth")
+    {
+        s.authed = true;
+        send_(id, nlohmann::json{{"op", "auth"}, {"retCode", 0}, {"retMsg", "OK"}, {"connId", conn}}.dump());
+        return;
+    }
+    if (op == "ping")
+    {
+        send_(id, nlohmann::json{{"op", "pong"}, {"retCode", 0}, {"retMsg", "OK"}, {"connId", conn}, {"data", {std::to_string(now_ms())}}}.dump());
+        return;
+    }
+    if (op.rfind("order.", 0) != 0)
+        return;
+
+    nlohmann::json ack{{"op", op}, {"connId", conn}};
+    if (req.contains("reqId"))
+        ack["reqId"] = req["reqId"];
+    const auto args = req.value("args", nlohmann::json::array());
+    if (!s.authed || args.empty())
+    {
+        ack["retCode"] = s.authed ? 10001 : 10003;
+        ack["retMsg"] = s.authed ? "missing args" : "not authorized";
+        ack["data"] = nlohmann::json::object();
+        send_(id, ack.dump());
+        return;
+    }
+    const auto resp = nlohmann::json::parse(sim_.request(op, args[0].dump()));
+    ack["retCode"] = resp["retCode"];
+    ack["retMsg"] = resp["retMsg"];
+    ack["data"] = resp["result"];
+    ack["retExtInfo"] = resp["retExtInfo"];
+    ack["header"] = {{"Timenow", std::to_string(now_ms())}};
+    send_(id, ack.dump());
+}
+
+std::string SimVenue::book_snapshot_message(const std::string &topic, int depth) const
+{
+    nlohmann::json data{{"s", symbol_},
+                        {"b", levels_json(book_.bids, book_.bid_count, depth)},
+                        {"a", levels_json(book_.asks, book_.ask_count, depth)},
+                        {"u", book_.update_id},
+                        {"seq", book_.seq},
+                        {"ts", book_.ts_ms}};
+    return nlohmann::json{{"topic", topic}, {"type", "snapshot"}, {"ts", book_.ts_ms}, {"data", std::move(data)}}.dump();
+}
+
+std::string SimVenue::ticker_snapshot_message() const
+{
+    TickerSnapshot t;
+    if (!feed_.read_ticker(symbol_, t) || !t.valid())
+    {
+        // No recorded tickers: derive the prices from the book.
+        if (!book_.valid())
+            return {};
+        t.last_price = t.mark_price = t.index_price = book_.mid();
+        t.ts_ms = book_.ts_ms;
+    }
+    if (book_.valid())
+    {
+        t.bid1_price = book_.bids[0].price.to_double();
+        t.bid1_size = book_.bids[0].qty.to_double();
+        t.ask1_price = book_.asks[0].price.to_double();
+        t.ask1_size = book_.asks[0].qty.to_double();
+    }
+    nlohmann::json data{{"symbol", symbol_},
+                        {"lastPrice", num(t.last_price)},
+                        {"markPrice", num(t.mark_price)},
+                        {"indexPrice", num(t.index_price)},
+                        {"bid1Price", num(t.bid1_price)},
+                        {"bid1Size", num(t.bid1_size)},
+                        {"ask1Price", num(t.ask1_price)},
+                        {"ask1Size", num(t.ask1_size)},
+                        {"fundingRate", num(t.funding_rate)},
+                        {"openInterest", num(t.open_interest)},
+                        {"volume24h", num(t.volume_24h)},
+                        {"turnover24h", num(t.turnover_24h)},
+                        {"nextFundingTime", std::to_string(t.next_funding_time_ms)}};
+    return nlohmann::json{{"topic", "tickers." + symbol_}, {"type", "snapshot"}, {"cs", 0}, {"ts", t.ts_ms}, {"data", std::move(data)}}.dump();
+}
+
+void SimVenue::on_order(const OrderUpdate &u, int position_idx)
+{
+    const bool done = is_terminal(u.state);
+    push_private("order", nlohmann::json::array({{{"category", "linear"},
+                                                  {"symbol", u.symbol},
+                                                  {"orderId", u.order_id},
+                                                  {"orderLinkId", u.order_link_id},
+                                                  {"side", u.is_buy ? "Buy" : "Sell"},
+                                                  {"orderType", u.price > 0.0 ? "Limit" : "Market"},
+                                                  {"price", num(u.price)},
+                                                  {"qty", num(u.qty)},
+                                                  {"cumExecQty", num(u.cum_exec_qty)},
+                                                  {"cumExecValue", num(u.cum_exec_qty * u.avg_price)},
+                                                  {"leavesQty", num(done ? 0.0 : u.qty - u.cum_exec_qty)},
+                                                  {"avgPrice", num(u.avg_price)},
+                                                  {"orderStatus", status_name(u.state)},
+                                                  {"positionIdx", position_idx},
+                                                  {"updatedTime", std::to_string(u.updated_ms)}}}));
+}
+
+void SimVenue::on_fill(const SimFill &f)
+{
+    const double px = f.price.to_double();
+    const double qty = f.qty.to_double();
+    push_private("execution", nlohmann::json::array({{{"category", "linear"},
+                                                      {"symbol", symbol_},
+                                                      {"orderId", f.order_id},
+                                                      {"orderLinkId", f.order_link_id},
+                                                      {"side", f.is_buy ? "Buy" : "Sell"},
+                                                      {"execId", "sim-exec-" + std::to_string(next_push_id_)},
+                                                      {"execPrice", f.price.str()},
+                                                      {"execQty", f.qty.str()},
+                                                      {"execValue", num(px * qty)},
+                                                      {"execFee", num(f.fee)},
+                                                      {"execPnl", num(f.closed_pnl)},
+                                                      {"execType", "Trade"},
+                                                      {"isMaker", f.maker},
+                                                      {"execTime", std::to_string(f.time_ns / 1000000)}}}));
+    push_position();
+}
+
+void SimVenue::push_private(const char *topic, nlohmann::json data)
+{
+    const auto text = nlohmann::json{{"id", "sim-" + std::to_string(++next_push_id_)},
+                                     {"topic", topic},
+                                     {"creationTime", now_ms()},
+                                     {"data", std::move(data)}}
+                          .dump();
+    for (const auto &[id, s] : sessions_)
+        if (s.channel == Channel::Private && s.authed && s.subscribed(topic))
+            send_(id, text);
+}
+
+void SimVenue::push_position() { push_private("position", positions_json()); }
+
+nlohmann::json SimVenue::positions_json() const
+{
+    const auto pos = sim_.position();
+    const double mark = book_.valid() ? book_.mid() : 0.0;
+    nlohmann::json list = nlohmann::json::array();
+    auto leg = [&](int idx, const char *side, double size, double entry, double upl)
+    {
+        list.push_back({{"category", "linear"},
+                        {"symbol", symbol_},
+                        {"positionIdx", idx},
+                        {"side", size > 0.0 ? side : ""},
+                        {"size", num(size)},
+                        {"avgPrice", num(entry)},
+                        {"entryPrice", num(entry)},
+                        {"markPrice", num(mark)},
+                        {"positionValue", num(size * entry)},
+                        {"unrealisedPnl", num(mark > 0.0 ? upl : 0.0)},
+                        {"updatedTime", std::to_string(now_ms())}});
+    };
+    leg(1, "Buy", pos.long_size, pos.long_entry, (mark - pos.long_entry) * pos.long_size);
+    leg(2, "Sell", pos.short_size, pos.short_entry, (pos.short_entry - mark) * pos.short_size);
+    return list;
+}
+
+std::size_t SimVenue::public_sessions() const
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    return static_cast<std::size_t>(std::count_if(sessions_.begin(), sessions_.end(), [](const auto &kv)
+                                                  { return kv.second.channel == Channel::Public; }));
+}
+
+std::size_t SimVenue::fill_count() const
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    return sim_.fills().size();
+}
+
+double SimVenue::net_pnl() const
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    return sim_.realized_pnl() - sim_.fees() + (book_.valid() ? sim_.unrealized_pnl(book_.mid()) : 0.0);
+}
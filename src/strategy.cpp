@@ -1,56 +1,42 @@
 #include "strategy.hpp"
 
 #include <cmath>
-#include <iostream>
-#include <sstream>
 #include <chrono>
 
+#include "async_logger.hpp"
+
 namespace
 {
-    double round_down(double value, double step)
-    {
-        if (step <= 0)
-            return value;
-        return std::floor(value / step) * step;
-    }
-
-    std::string to_string_prec(double v)
-    {
-        std::ostringstream oss;
-        oss.setf(std::ios::fixed);
-        oss.precision(8);
-        oss << v;
-        return oss.str();
-    }
+    // Exact: the double is only used to get onto the 1e-8 grid, the tick floor is integer math.
+    Price round_down(double value, Price tick) { return Price::from_double(value).floor_to(tick); }
+
+    constexpr LogFormat kLogEmptyBook{LogLevel::Warn, "", LogColor::None, "Orderbook empty for {}"};
+    constexpr LogFormat kLogBadSpread{LogLevel::Warn, "", LogColor::None, "Non-positive spread for {}"};
+    constexpr LogFormat kLogQuote{LogLevel::Info, "MM", LogColor::None,
+                                  "{} mid={} live_spread_bps={} target_spread_bps={} bid@{} ask@{} base_qty={} net={} [{}]"};
+    constexpr LogFormat kLogFlattenDeferred{LogLevel::Warn, "SL", LogColor::Red, "order queue full, flatten of {} deferred"};
+    constexpr LogFormat kLogGrossCap{LogLevel::Info, "MM", LogColor::None, "gross cap hit, skip new quotes gross={} cap={}"};
+    constexpr LogFormat kLogStopCheck{LogLevel::Info, "SLDBG", LogColor::None, "{} mid={} entry={} stop={} size={}"};
+    constexpr LogFormat kLogStop{LogLevel::Info, "SL", LogColor::Red, "flattening {} size={} at mid={} stop={}"};
+    constexpr LogFormat kLogSnapshotError{LogLevel::Error, "", LogColor::None, "Error processing snapshot for {}: {}"};
 } // namespace
 
 void ExampleMarketMakerStrategy::on_snapshot(const MarketDataSnapshot &snapshot, TradingHelper &helper, bool live_trading, const PositionView &pos)
 {
-    const nlohmann::json *ob_ptr = &snapshot.orderbook;
-    if (snapshot.orderbook.contains("result"))
-        ob_ptr = &snapshot.orderbook["result"];
-    const auto &ob = *ob_ptr;
-    if (!ob.contains("b") || !ob.contains("a"))
+    const auto &book = snapshot.book;
+    if (!book.valid())
     {
-        std::cerr << "Orderbook missing b/a for " << snapshot.symbol << "\n";
+        log_event(kLogEmptyBook, snapshot.symbol);
         return;
     }
     try
     {
-        // Bybit orderbook: "b" bids, "a" asks. Each entry: [price, size].
-        const auto &bids = ob["b"];
-        const auto &asks = ob["a"];
-        if (bids.empty() || asks.empty())
-        {
-            std::cerr << "Orderbook empty for " << snapshot.symbol << "\n";
-            return;
-        }
-        const double best_bid = std::stod(bids[0][0].get<std::string>());
-        const double best_ask = std::stod(asks[0][0].get<std::string>());
+        const double best_bid = book.best_bid().to_double();
+        const double best_ask = book.best_ask().to_double();
         const double live_spread = best_ask - best_bid;
         if (live_spread <= 0)
         {
-            std::cerr << "Non-positive spread for " << snapshot.symbol << "\n";
+            log_event(kLogBadSpread, snapshot.symbol);
             return;
         }
         const double mid = 0.5 * (best_ask + best_bid);
@@ -63,13 +49,13 @@ void ExampleMarketMakerStrategy::on_snapshot(const MarketDataSnapshot &snapshot,
         // Price rounding to tick size.
         const double raw_bid_px = mid - half_spread_abs;
         const double raw_ask_px = mid + half_spread_abs;
-        const double bid_px = round_down(raw_bid_px, meta_.tick_size);
-        const double ask_px = round_down(raw_ask_px, meta_.tick_size);
+        const Price bid_px = round_down(raw_bid_px, meta_.tick_size);
+        const Price ask_px = round_down(raw_ask_px, meta_.tick_size);
 
         // Base size: min tradable size.
-        double base_qty = round_down(meta_.min_qty, meta_.lot_size);
-        if (base_qty < meta_.min_qty)
-            base_qty = meta_.min_qty;
+        const Qty base_qty = meta_.min_qty.ceil_to(meta_.lot_size);
+
+        const double min_qty = meta_.min_qty.to_double();
 
         // Inventory skew: if net long, reduce/suspend new bids; if net short, reduce/suspend asks.
         double net_qty = pos.long_size - pos.short_size;
@@ -91,16 +77,29 @@ void ExampleMarketMakerStrategy::on_snapshot(const MarketDataSnapshot &snapshot,
                 ask_scale = std::max(0.2, skew_factor);
         }
 
-        std::cout << "[MM] " << snapshot.symbol << " mid=" << mid << " live_spread_bps=" << live_spread_bps
-                  << " target_spread_bps=" << target_spread_bps << " bid@" << bid_px << " ask@" << ask_px
-                  << " base_qty=" << base_qty << " net=" << net_qty << (live_trading ? " [live]" : " [dry-run]") << "\n";
+        log_event(kLogQuote, snapshot.symbol, mid, live_spread_bps, target_spread_bps, bid_px, ask_px, base_qty, net_qty,
+                  live_trading ? "live" : "dry-run");
 
         auto make_link = [&](const std::string &side)
         {
             const auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                                     std::chrono::system_clock::now().time_since_epoch())
                                     .count();
-            return side + "_mm_" + std::to_string(now_ms) + "_" + std::to_string(++order_counter_);
+            return side + "_mm_" + std::to_string(now_ms) + "_" + std::to_string(next_order_link_counter());
+        };
+        // Market exits go through the async gateway when enabled so the strategy thread never blocks on HTTP.
+        auto flatten = [&](const std::string &side, double qty, int pos_idx, const std::string &link)
+        {
+            const std::string lots = Qty::from_double(qty).round_to(meta_.lot_size).str();
+            if (helper.async_enabled())
+            {
+                if (!helper.async_submit_market_order(symbol_, side, lots, pos_idx, link, {}))
+                    log_event(kLogFlattenDeferred, symbol_);
+            }
+            else
+            {
+                helper.submit_market_order(symbol_, side, lots, pos_idx, link);
+            }
         };
 
         if (!live_trading || !helper.has_credentials())
@@ -108,114 +107,80 @@ void ExampleMarketMakerStrategy::on_snapshot(const MarketDataSnapshot &snapshot,
             return;
         }
 
-        // Cancel previous working orders before placing fresh quotes to avoid stacking margin.
-        helper.cancel_all(symbol_);
-
         // Gross notional guard: if both sides consume too much margin, skip making markets but still allow TP/SL.
         double gross_notional = (pos.long_size + pos.short_size) * mid;
         bool skip_new_quotes = (gross_notional_cap_ > 0.0 && gross_notional >= gross_notional_cap_);
         if (skip_new_quotes)
         {
-            std::cout << "[MM] gross cap hit, skip new quotes gross=" << gross_notional << " cap=" << gross_notional_cap_ << "\n";
+            log_event(kLogGrossCap, gross_notional, gross_notional_cap_);
         }
 
-        // Collect all orders for batch submission
-        std::vector<std::vector<std::pair<std::string, std::string>>> batch_orders;
-
-        // Place laddered quotes per side.
+        // Desired ladder; QuoteManager amends/cancels/places only what differs from the working orders.
+        desired_.clear();
         if (!skip_new_quotes)
         {
             for (int level = 1; level <= ladder_levels_; ++level)
             {
                 double level_offset = half_spread_abs * level;
-                double bid_ladder_px = round_down(mid - level_offset, meta_.tick_size);
-                double ask_ladder_px = round_down(mid + level_offset, meta_.tick_size);
-                double lvl_qty = base_qty;
+                Price bid_ladder_px = round_down(mid - level_offset, meta_.tick_size);
+                Price ask_ladder_px = round_down(mid + level_offset, meta_.tick_size);
                 if (bid_scale > 0.0)
-                {
-                    batch_orders.push_back({{"symbol", symbol_},
-                                            {"side", "Buy"},
-                                            {"orderType", "Limit"},
-                                            {"qty", to_string_prec(lvl_qty * bid_scale)},
-                                            {"price", to_string_prec(bid_ladder_px)},
-                                            {"positionIdx", std::to_string(buy_pos_idx_)},
-                                            {"orderLinkId", make_link("bid")},
-                                            {"timeInForce", "GTC"}});
-                }
+                    desired_.push_back({"bid" + std::to_string(level), "Buy", bid_ladder_px, scaled_qty(meta_, base_qty, bid_scale), buy_pos_idx_});
                 if (ask_scale > 0.0)
-                {
-                    batch_orders.push_back({{"symbol", symbol_},
-                                            {"side", "Sell"},
-                                            {"orderType", "Limit"},
-                                            {"qty", to_string_prec(lvl_qty * ask_scale)},
-                                            {"price", to_string_prec(ask_ladder_px)},
-                                            {"positionIdx", std::to_string(sell_pos_idx_)},
-                                            {"orderLinkId", make_link("ask")},
-                                            {"timeInForce", "GTC"}});
-                }
+                    desired_.push_back({"ask" + std::to_string(level), "Sell", ask_ladder_px, scaled_qty(meta_, base_qty, ask_scale), sell_pos_idx_});
             }
         }
 
         // Take-profit: if net long, place a small ask at tp_spread_bps above mid; if net short, place a small bid below mid.
-        if (net_qty > meta_.min_qty && ask_scale > 0.0)
+        if (net_qty > min_qty && ask_scale > 0.0)
         {
-            double tp_px = round_down(mid + (tp_spread_bps_ * 0.0001) * mid, meta_.tick_size);
-            batch_orders.push_back({{"symbol", symbol_},
-                                    {"side", "Sell"},
-                                    {"orderType", "Limit"},
-                                    {"qty", to_string_prec(base_qty)},
-                                    {"price", to_string_prec(tp_px)},
-                                    {"positionIdx", std::to_string(sell_pos_idx_)},
-                                    {"orderLinkId", make_link("tp_sell")},
-                                    {"timeInForce", "GTC"}});
+            Price tp_px = round_down(mid + (tp_spread_bps_ * 0.0001) * mid, meta_.tick_size);
+            desired_.push_back({"tp_sell", "Sell", tp_px, base_qty, sell_pos_idx_});
         }
-        else if (net_qty < -meta_.min_qty && bid_scale > 0.0)
+        else if (net_qty < -min_qty && bid_scale > 0.0)
         {
-            double tp_px = round_down(mid - (tp_spread_bps_ * 0.0001) * mid, meta_.tick_size);
-            batch_orders.push_back({{"symbol", symbol_},
-                                    {"side", "Buy"},
-                                    {"orderType", "Limit"},
-                                    {"qty", to_string_prec(base_qty)},
-                                    {"price", to_string_prec(tp_px)},
-                                    {"positionIdx", std::to_string(buy_pos_idx_)},
-                                    {"orderLinkId", make_link("tp_buy")},
-                                    {"timeInForce", "GTC"}});
+            Price tp_px = round_down(mid - (tp_spread_bps_ * 0.0001) * mid, meta_.tick_size);
+            desired_.push_back({"tp_buy", "Buy", tp_px, base_qty, buy_pos_idx_});
         }
 
-        // Submit all orders in one batch request
-        if (!batch_orders.empty())
-        {
-            helper.batch_submit_orders(batch_orders);
-        }
+        quotes_.sync(desired_, helper);
 
         // Stop-loss: flatten if price moves past threshold from entry.
         if (stop_loss_bps_ > 0.0)
         {
             double stop_mult = stop_loss_bps_ * 0.0001;
-            if (pos.long_size > meta_.min_qty && pos.long_entry > 0.0)
+            if (pos.long_size > min_qty && pos.long_entry > 0.0)
             {
                 double stop_px = pos.long_entry * (1.0 - stop_mult);
-                std::cout << "[SLDBG] long mid=" << mid << " entry=" << pos.long_entry << " stop=" << stop_px << " size=" << pos.long_size << "\n";
-                if (mid <= stop_px)
+                log_event(kLogStopCheck, "long", mid, pos.long_entry, stop_px, pos.long_size);
+                if (mid <= stop_px && long_exit_.due(pos.long_size, helper.orders()))
                 {
-                    helper.submit_market_order(symbol_, "Sell", to_string_prec(pos.long_size), sell_pos_idx_, make_link("sl_long"));
-                    std::cout << "[SL] flattening long size=" << pos.long_size << " at mid=" << mid << " stop=" << stop_px << "\n";
+                    long_exit_ = {make_link("sl_long"), pos.long_size};
+                    flatten("Sell", pos.long_size, sell_pos_idx_, long_exit_.link);
+                    log_event(kLogStop, "long", pos.long_size, mid, stop_px);
                 }
             }
-            if (pos.short_size > meta_.min_qty && pos.short_entry > 0.0)
+            if (pos.short_size > min_qty && pos.short_entry > 0.0)
             {
                 double stop_px = pos.short_entry * (1.0 + stop_mult);
-                std::cout << "[SLDBG] short mid=" << mid << " entry=" << pos.short_entry << " stop=" << stop_px << " size=" << pos.short_size << "\n";
-                if (mid >= stop_px)
+                log_event(kLogStopCheck, "short", mid, pos.short_entry, stop_px, pos.short_size);
+                if (mid >= stop_px && short_exit_.due(pos.short_size, helper.orders()))
                 {
-                    helper.submit_market_order(symbol_, "Buy", to_string_prec(pos.short_size), buy_pos_idx_, make_link("sl_short"));
-                    std::cout << "[SL] flattening short size=" << pos.short_size << " at mid=" << mid << " stop=" << stop_px << "\n";
+                    short_exit_ = {make_link("sl_short"), pos.short_size};
+                    flatten("Buy", pos.short_size, buy_pos_idx_, short_exit_.link);
+                    log_event(kLogStop, "short", pos.short_size, mid, stop_px);
                 }
             }
         }
     }
     catch (const std::exception &ex)
     {
-        std::cerr << "Error processing snapshot for " << snapshot.symbol << ": " << ex.what() << "\n";
+        log_event(kLogSnapshotError, snapshot.symbol, ex.what());
     }
 }
+
+void ExampleMarketMakerStrategy::on_instrument_meta(const InstrumentMeta &meta)
+{
+    meta_ = meta;
+    quotes_.set_tolerance(requote_tolerance(meta_, requote_tol_ticks_), Qty::from_raw(meta_.lot_size.raw / 2));
+}
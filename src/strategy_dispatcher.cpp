@@ -0,0 +1,89 @@
+#include "strategy_dispatcher.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+StrategyDispatcher::StrategyDispatcher(MarketDataFeed &feed, std::string symbol, Config cfg)
+    : feed_(feed), symbol_(std::move(symbol)), index_(feed_.symbol_index(symbol_)), cfg_(cfg) {}
+
+bool StrategyDispatcher::read_latest(MarketDataSnapshot &snap)
+{
+    const uint64_t seq = feed_.update_seq();
+    if (seq > seen_seq_ + 1)
+        coalesced_ += seq - seen_seq_ - 1;
+    seen_seq_ = seq;
+    return feed_.read_book(index_, snap.book) && feed_.read_ticker(index_, snap.tick);
+}
+
+bool StrategyDispatcher::is_urgent(double mid) const
+{
+    return cfg_.urgent_mid_move > 0.0 && last_mid_ > 0.0 && std::abs(mid - last_mid_) >= cfg_.urgent_mid_move;
+}
+
+bool StrategyDispatcher::next(MarketDataSnapshot &snap)
+{
+    if (feed_.wait_for_update(seen_seq_, cfg_.idle_timeout) == seen_seq_)
+        return false;
+    if (!read_latest(snap))
+        return false;
+
+    const auto due = last_dispatch_ + cfg_.min_requote_interval;
+    auto now = std::chrono::steady_clock::now();
+    bool urgent = is_urgent(snap.book.mid());
+    while (!urgent && now < due)
+    {
+        // Too early: keep folding updates in until the interval elapses or the mid jumps.
+        const auto left = std::chrono::duration_cast<std::chrono::microseconds>(due - now);
+        if (feed_.wait_for_update(seen_seq_, left) != seen_seq_)
+        {
+            if (!read_latest(snap))
+                return false;
+            urgent = is_urgent(snap.book.mid());
+        }
+        now = std::chrono::steady_clock::now();
+    }
+
+    dispatched(snap);
+    return true;
+}
+
+bool StrategyDispatcher::poll(MarketDataSnapshot &snap, std::chrono::steady_clock::time_point now,
+                              std::chrono::steady_clock::time_point &wake_at)
+{
+    const uint64_t seq = feed_.symbol_seq(index_);
+    if (seq != seen_symbol_seq_)
+    {
+        const uint64_t fresh = seq - seen_symbol_seq_;
+        coalesced_ += pending_ ? fresh : fresh - 1; // every update but the dispatched one is folded
+        seen_symbol_seq_ = seq;
+        pending_ = true;
+    }
+    if (!pending_)
+        return false;
+    if (!feed_.read_book(index_, snap.book) || !feed_.read_ticker(index_, snap.tick))
+    {
+        pending_ = false; // resync in progress; the fresh snapshot will bump the sequence again
+        return false;
+    }
+    const auto due = last_dispatch_ + cfg_.min_requote_interval;
+    if (now < due && !is_urgent(snap.book.mid()))
+    {
+        if (due < wake_at)
+            wake_at = due;
+        return false;
+    }
+    pending_ = false;
+    dispatched(snap);
+    return true;
+}
+
+void StrategyDispatcher::dispatched(const MarketDataSnapshot &snap)
+{
+    last_dispatch_ = std::chrono::steady_clock::now();
+    last_mid_ = snap.book.mid();
+    origin_ns_ = std::max(snap.book.recv_ns, snap.tick.recv_ns);
+    if (origin_ns_ > 0)
+        latency_record(LatencyStage::FeedToStrategy, latency_now_ns() - origin_ns_);
+}
+
+void StrategyDispatcher::reset_stats() { coalesced_ = 0; }
@@ -0,0 +1,253 @@
+#include "strategy_shard.hpp"
+
+#include "async_logger.hpp"
+
+namespace
+{
+    constexpr LogFormat kLogDispatch{LogLevel::Info, "DISPATCH", LogColor::Cyan, "shard={} dispatches={} coalesced={}"};
+    constexpr LogFormat kLogGateway{LogLevel::Info, "GW", LogColor::Cyan, "shard={} submitted={} in_flight={} failed={} queue_full={} superseded={} throttled={}"};
+    constexpr LogFormat kLogRisk{LogLevel::Warn, "RISK", LogColor::Yellow, "shard={} accepted={} refused={} killed={}"};
+    constexpr LogFormat kLogMeta{LogLevel::Warn, "META", LogColor::Yellow, "shard={} {} now tick={} lot={} min_qty={}"};
+    constexpr LogFormat kLogKillCancel{LogLevel::Warn, "RISK", LogColor::Yellow, "shard={} kill switch: cancel_all {} failed: {}"};
+    constexpr LogFormat kLogFailed{LogLevel::Error, "", LogColor::None, "shard {} stopped: {}"};
+} // namespace
+
+StrategyShard::Slot::Slot(MarketDataFeed &feed, const std::string &symbol, StrategyDispatcher::Config dispatch,
+                          std::unique_ptr<IStrategy> strategy)
+    : strategy(std::move(strategy)), dispatcher(feed, symbol, dispatch)
+{
+    snap.symbol = symbol;
+}
+
+StrategyShard::StrategyShard(Config cfg, MarketDataFeed &feed, std::unique_ptr<TradingHelper> helper)
+    : cfg_(cfg), feed_(feed), helper_(std::move(helper))
+{
+    helper_->risk().configure(cfg_.risk);
+}
+
+StrategyShard::~StrategyShard() { stop(); }
+
+void StrategyShard::add_symbol(const std::string &symbol, const InstrumentMeta &meta, std::unique_ptr<IStrategy> strategy)
+{
+    StrategyDispatcher::Config dispatch = cfg_.dispatch;
+    dispatch.urgent_mid_move = cfg_.drift_threshold_ticks * meta.tick_size.to_double();
+    slots_.push_back(std::make_unique<Slot>(feed_, symbol, dispatch, std::move(strategy)));
+    slots_.back()->risk_index = helper_->risk().add_symbol(symbol);
+}
+
+std::vector<std::string> StrategyShard::symbols() const
+{
+    std::vector<std::string> out;
+    for (const auto &s : slots_)
+        out.push_back(s->snap.symbol);
+    return out;
+}
+
+StrategyShard::Slot *StrategyShard::find(const std::string &symbol) const
+{
+    for (const auto &s : slots_)
+        if (s->snap.symbol == symbol)
+            return s.get();
+    return nullptr;
+}
+
+void StrategyShard::clear_position(const std::string &symbol)
+{
+    if (Slot *s = find(symbol))
+    {
+        std::lock_guard<std::mutex> lg(s->pos_mu);
+        s->pos = PositionView{};
+        helper_->risk().set_position(symbol, Qty{});
+    }
+}
+
+void StrategyShard::set_position(const std::string &symbol, const std::string &side, double size, double entry)
+{
+    Slot *s = find(symbol);
+    if (!s)
+        return;
+    std::lock_guard<std::mutex> lg(s->pos_mu);
+    if (side == "Buy")
+    {
+        s->pos.long_size = size;
+        s->pos.long_entry = entry;
+    }
+    else if (side == "Sell")
+    {
+        s->pos.short_size = size;
+        s->pos.short_entry = entry;
+    }
+    helper_->risk().set_position(symbol, Qty::from_double(s->pos.long_size - s->pos.short_size));
+}
+
+void StrategyShard::update_meta(const std::string &symbol, const InstrumentMeta &meta)
+{
+    Slot *s = find(symbol);
+    if (!s)
+        return;
+    {
+        std::lock_guard<std::mutex> lg(s->meta_mu);
+        s->pending_meta = meta;
+    }
+    s->meta_pending.store(true, std::memory_order_release);
+}
+
+void StrategyShard::apply_pending_meta(Slot &slot)
+{
+    InstrumentMeta meta;
+    {
+        std::lock_guard<std::mutex> lg(slot.meta_mu);
+        meta = slot.pending_meta;
+    }
+    slot.dispatcher.set_urgent_mid_move(cfg_.drift_threshold_ticks * meta.tick_size.to_double());
+    slot.strategy->on_instrument_meta(meta);
+    log_event(kLogMeta, cfg_.id, slot.snap.symbol, meta.tick_size.str(), meta.lot_size.str(), meta.min_qty.str());
+}
+
+PositionView StrategyShard::position(const std::string &symbol) const
+{
+    const Slot *s = find(symbol);
+    if (!s)
+        return PositionView{};
+    std::lock_guard<std::mutex> lg(s->pos_mu);
+    return s->pos;
+}
+
+void StrategyShard::kill()
+{
+    helper_->risk().kill();
+    kill_pending_.store(true, std::memory_order_release);
+}
+
+void StrategyShard::cancel_all_symbols()
+{
+    for (const auto &slot : slots_)
+    {
+        const std::string &symbol = slot->snap.symbol;
+        if (helper_->async_enabled())
+        {
+            const int shard = cfg_.id;
+            const bool queued = helper_->async_cancel_all(symbol, [shard, symbol](const GatewayResult &r)
+                                                          {
+                if (!r.ok)
+                    log_event(kLogKillCancel, shard, symbol, r.error.empty() ? r.body : r.error); });
+            if (!queued)
+                log_event(kLogKillCancel, cfg_.id, symbol, "gateway queue full");
+            continue;
+        }
+        // The strategies' own cancel_all follows on their next sync; one failure must not stop the rest.
+        try
+        {
+            helper_->cancel_all(symbol);
+        }
+        catch (const std::exception &ex)
+        {
+            log_event(kLogKillCancel, cfg_.id, symbol, ex.what());
+        }
+    }
+}
+
+void StrategyShard::start()
+{
+    if (worker_.joinable())
+        return;
+    stop_.store(false, std::memory_order_relaxed);
+    worker_ = std::thread([this]
+                          { run(); });
+}
+
+void StrategyShard::stop()
+{
+    stop_.store(true, std::memory_order_release);
+    if (worker_.joinable())
+        worker_.join();
+}
+
+void StrategyShard::run()
+{
+    apply_thread_role(cfg_.thread);
+    const bool live = cfg_.live && helper_->has_credentials();
+    last_report_ = std::chrono::steady_clock::now();
+    try
+    {
+        while (!stop_.load(std::memory_order_acquire))
+        {
+            // Read the feed sequence before polling: anything published after this wakes the wait below.
+            const uint64_t seen = feed_.update_seq();
+            // Order acks that arrived while idle; the strategy polls again before each re-quote.
+            helper_->poll_async();
+            if (kill_pending_.load(std::memory_order_relaxed) && kill_pending_.exchange(false, std::memory_order_acquire) && live)
+                cancel_all_symbols();
+            auto now = std::chrono::steady_clock::now();
+            auto wake_at = now + cfg_.dispatch.idle_timeout;
+            for (auto &slot : slots_)
+            {
+                if (slot->meta_pending.load(std::memory_order_relaxed) && slot->meta_pending.exchange(false, std::memory_order_acquire))
+                    apply_pending_meta(*slot);
+                if (!slot->dispatcher.poll(slot->snap, now, wake_at))
+                    continue;
+                ++report_dispatches_;
+                dispatches_.fetch_add(1, std::memory_order_relaxed);
+                PositionView pos;
+                {
+                    std::lock_guard<std::mutex> lg(slot->pos_mu);
+                    pos = slot->pos;
+                }
+                // Risk bands follow the book the strategy is about to quote against.
+                const auto &book = slot->snap.book;
+                const Price mid = book.valid() ? Price::from_raw((book.bids[0].price.raw + book.asks[0].price.raw) / 2) : Price{};
+                helper_->risk().set_mid(slot->risk_index, mid);
+                const int64_t entry_ns = latency_now_ns();
+                helper_->set_tick_origin(slot->dispatcher.origin_ns());
+                slot->strategy->on_snapshot(slot->snap, *helper_, live, pos);
+                helper_->set_tick_origin(0);
+                latency_record(LatencyStage::Strategy, latency_now_ns() - entry_ns);
+                now = std::chrono::steady_clock::now();
+            }
+            if (now - last_report_ >= cfg_.report_interval)
+                report(now);
+            if (live)
+                helper_->keep_warm();
+            // Wait until any symbol updates or the earliest throttled update falls due.
+            if (cfg_.busy_poll)
+            {
+                while (feed_.update_seq() == seen && !stop_.load(std::memory_order_relaxed) &&
+                       std::chrono::steady_clock::now() < wake_at)
+                    cpu_relax();
+            }
+            else if (wake_at > now)
+            {
+                feed_.wait_for_update(seen, std::chrono::duration_cast<std::chrono::microseconds>(wake_at - now));
+            }
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        error_ = ex.what();
+        failed_.store(true, std::memory_order_release);
+        log_event(kLogFailed, cfg_.id, ex.what());
+    }
+}
+
+void StrategyShard::report(std::chrono::steady_clock::time_point now)
+{
+    last_report_ = now;
+    uint64_t coalesced = 0;
+    for (auto &slot : slots_)
+    {
+        coalesced += slot->dispatcher.coalesced();
+        slot->dispatcher.reset_stats();
+    }
+    log_event(kLogDispatch, cfg_.id, report_dispatches_, coalesced);
+    report_dispatches_ = 0;
+    if (const auto *gw = helper_->gateway())
+        log_event(kLogGateway, cfg_.id, gw->submitted(), gw->in_flight(), gw->failed(), gw->rejected_full(), gw->superseded(),
+                  helper_->rate_limiter().throttled());
+    const auto &risk = helper_->risk();
+    const uint64_t refused = risk.refused_total();
+    if (refused != reported_refusals_ || risk.killed())
+    {
+        reported_refusals_ = refused;
+        log_event(kLogRisk, cfg_.id, risk.accepted(), refused, risk.killed());
+    }
+}
@@ -0,0 +1,100 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+
+#include "backtest_env.hpp"
+#include "feed_record.hpp"
+#include "param_sweep.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace
+{
+    void usage()
+    {
+        std::cerr << "usage: market_maker_sweep <symbol> <spec> <recording.bmd | directory>...\n"
+                     "  Spec: one 'BYBIT_X = v1, v2' or 'BYBIT_X = lo:hi:step' per line, plus optional\n"
+                     "  'mode = grid|random', 'samples = N', 'seed = N'. Unswept settings come from the env.\n"
+                     "  Instrument steps: BYBIT_BT_TICK_SIZE, BYBIT_BT_LOT_SIZE, BYBIT_BT_MIN_QTY (required)\n"
+                     "  BYBIT_SWEEP_THREADS (default: all cores), BYBIT_SWEEP_OUT (default sweep_results.csv)\n";
+    }
+
+    // Swallows everything without touching stream state, so concurrent replays can log to it.
+    class DiscardBuf : public std::streambuf
+    {
+    protected:
+        int overflow(int c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+    };
+} // namespace
+
+int main(int argc, char **argv)
+{
+    load_env_file(".env");
+    if (argc < 4)
+    {
+        usage();
+        return 2;
+    }
+
+    try
+    {
+        const auto spec = SweepSpec::load(argv[2]);
+        const auto points = spec.expand();
+        const auto bt = backtest_config_from_env(argv[1], expand_recordings(argc, argv, 3));
+        const auto base = StrategyParams::from_env();
+        const std::string out_path = get_env("BYBIT_SWEEP_OUT", "sweep_results.csv");
+
+        // Every replay walks the same mappings through its own cursor.
+        std::vector<RecordFileReader> readers(bt.files.size());
+        std::vector<const RecordFileReader *> inputs;
+        for (std::size_t i = 0; i < bt.files.size(); ++i)
+        {
+            readers[i].open(bt.files[i]);
+            readers[i].share();
+            inputs.push_back(&readers[i]);
+        }
+
+        WorkStealingPool pool(static_cast<std::size_t>(std::stoul(get_env("BYBIT_SWEEP_THREADS", "0"))));
+        std::cout << "[SWEEP] " << points.size() << " runs of " << bt.symbol << " over " << bt.files.size()
+                  << " file(s) on " << pool.size() << " threads" << std::endl;
+
+        DiscardBuf discard;
+        auto *cout_buf = std::cout.rdbuf(&discard);
+        const auto wall_start = std::chrono::steady_clock::now();
+        const auto runs = run_sweep(bt, base, points, inputs, pool);
+        const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        std::cout.rdbuf(cout_buf);
+
+        std::ofstream out(out_path);
+        if (!out)
+            throw std::runtime_error("cannot create " + out_path);
+        write_sweep_csv(out, spec.axes, runs);
+
+        std::size_t failed = 0;
+        const SweepRun *best = nullptr;
+        for (const auto &run : runs)
+        {
+            if (!run.error.empty())
+                ++failed;
+            else if (!best || run.net_pnl() > best->net_pnl())
+                best = &run;
+        }
+        std::cout << "[SWEEP] done in " << wall_s << "s (" << pool.steals() << " steals), " << failed << " failed\n";
+        if (best)
+        {
+            std::cout << "[SWEEP] best run " << best->index << ": net_pnl=" << best->net_pnl()
+                      << " max_dd=" << best->result.max_drawdown << " fills=" << best->result.fills;
+            for (const auto &[name, value] : best->point)
+                std::cout << ' ' << name << '=' << value;
+            std::cout << "\n";
+        }
+        std::cout << "[SWEEP] wrote " << out_path << std::endl;
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "symbol_table.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+SymbolTable &SymbolTable::global()
+{
+    static SymbolTable table;
+    return table;
+}
+
+uint32_t SymbolTable::hash(std::string_view s)
+{
+    // FNV-1a: symbols are a dozen bytes, so a byte loop beats anything fancier.
+    uint32_t h = 2166136261u;
+    for (const char c : s)
+        h = (h ^ static_cast<uint8_t>(c)) * 16777619u;
+    return h;
+}
+
+SymbolId SymbolTable::find(std::string_view symbol) const
+{
+    if (symbol.empty() || symbol.size() > kMaxLength)
+        return kNoSymbol;
+    for (std::size_t i = hash(symbol) & (kSlots - 1);; i = (i + 1) & (kSlots - 1))
+    {
+        const uint16_t slot = slots_[i].load(std::memory_order_acquire);
+        if (slot == 0)
+            return kNoSymbol;
+        const Name &n = names_[slot - 1];
+        if (n.length == symbol.size() && std::memcmp(n.text, symbol.data(), symbol.size()) == 0)
+            return static_cast<SymbolId>(slot - 1);
+    }
+}
+
+SymbolId SymbolTable::intern(std::string_view symbol)
+{
+    if (symbol.empty() || symbol.size() > kMaxLength)
+        throw std::invalid_argument("symbol length must be 1.." + std::to_string(kMaxLength) + ": " + std::string(symbol));
+    std::lock_guard<std::mutex> lg(mu_);
+    const SymbolId existing = find(symbol);
+    if (existing != kNoSymbol)
+        return existing;
+    const std::size_t id = size_.load(std::memory_order_relaxed);
+    if (id >= kCapacity)
+        throw std::length_error("symbol table full");
+    Name &n = names_[id];
+    std::memcpy(n.text, symbol.data(), symbol.size());
+    n.text[symbol.size()] = '\0';
+    n.length = static_cast<uint8_t>(symbol.size());
+    std::size_t i = hash(symbol) & (kSlots - 1);
+    while (slots_[i].load(std::memory_order_relaxed) != 0)
+        i = (i + 1) & (kSlots - 1);
+    // The name is complete before the slot that leads readers to it is published.
+    slots_[i].store(static_cast<uint16_t>(id + 1), std::memory_order_release);
+    size_.store(id + 1, std::memory_order_release);
+    return static_cast<SymbolId>(id);
+}
+
+std::string_view SymbolTable::name(SymbolId id) const
+{
+    if (id >= size())
+        return {};
+    const Name &n = names_[id];
+    return std::string_view(n.text, n.length);
+}
@@ -0,0 +1,119 @@
+#include "thread_affinity.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include "async_logger.hpp"
+
+namespace
+{
+    constexpr LogFormat kLogPinFailed{LogLevel::Warn, "", LogColor::None, "thread {}: could not pin to CPU {}"};
+    constexpr LogFormat kLogFifoFailed{LogLevel::Warn, "", LogColor::None,
+                                       "thread {}: SCHED_FIFO {} not permitted (needs CAP_SYS_NICE or RLIMIT_RTPRIO); using default policy"};
+    constexpr LogFormat kLogLockFailed{LogLevel::Warn, "", LogColor::None,
+                                       "mlockall failed ({}); memory stays pageable, raise RLIMIT_MEMLOCK or run with CAP_IPC_LOCK"};
+
+    // Touch every page of a stack frame this size; noinline so the frame is really allocated.
+    __attribute__((noinline)) void prefault_stack(std::size_t bytes)
+    {
+        constexpr std::size_t kChunk = 64 * 1024;
+        char frame[kChunk];
+        volatile char *page = frame;
+        if (bytes > kChunk)
+            prefault_stack(bytes - kChunk); // before the loop, so the frame stays live (no tail call)
+        for (std::size_t i = 0; i < kChunk; i += 4096)
+            page[i] = 0;
+    }
+} // namespace
+
+bool pin_current_thread(int cpu)
+{
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+bool set_current_thread_fifo(int priority)
+{
+#ifdef __linux__
+    if (priority < sched_get_priority_min(SCHED_FIFO) || priority > sched_get_priority_max(SCHED_FIFO))
+        return false;
+    sched_param param{};
+    param.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#else
+    (void)priority;
+    return false;
+#endif
+}
+
+bool apply_thread_role(const ThreadRole &role)
+{
+    bool ok = true;
+#ifdef __linux__
+    if (!role.name.empty())
+        pthread_setname_np(pthread_self(), role.name.substr(0, 15).c_str());
+#endif
+    if (role.cpu >= 0 && !pin_current_thread(role.cpu))
+    {
+        log_event(kLogPinFailed, role.name, role.cpu);
+        ok = false;
+    }
+    if (role.fifo_priority > 0 && !set_current_thread_fifo(role.fifo_priority))
+    {
+        log_event(kLogFifoFailed, role.name, role.fifo_priority);
+        ok = false;
+    }
+    return ok;
+}
+
+bool lock_process_memory(std::size_t heap_bytes, std::size_t stack_bytes)
+{
+#ifdef __linux__
+    // Keep freed chunks in the arena (no trimming, no per-allocation mmap), so the pre-faulted and
+    // locked pages are the ones later allocations reuse.
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+#endif
+    if (heap_bytes > 0)
+    {
+        if (void *p = std::malloc(heap_bytes))
+        {
+            // Through volatile like prefault_stack: a memset before free() is a dead store the
+            // compiler drops, leaving the pages untouched.
+            volatile char *page = static_cast<char *>(p);
+            for (std::size_t i = 0; i < heap_bytes; i += 4096)
+                page[i] = 0;
+            page[heap_bytes - 1] = 0;
+            std::free(p);
+        }
+    }
+    if (stack_bytes > 0)
+        prefault_stack(stack_bytes);
+#ifdef __linux__
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        log_event(kLogLockFailed, std::strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
@@ -1,16 +1,104 @@
 #include "trading_helper.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <thread>
 
 #include <bybit/rest_client.hpp>
 
+#include "async_logger.hpp"
+#include "latency_stats.hpp"
+
 namespace
 {
+    constexpr LogFormat kLogTradeFallback{LogLevel::Warn, "TRADE", LogColor::Yellow, "{} via trade transport failed, falling back to REST: {}"};
+    constexpr LogFormat kLogTradeUnknown{LogLevel::Warn, "TRADE", LogColor::Yellow, "{} via trade transport failed, cancelling by orderLinkId: {}"};
+    constexpr LogFormat kLogRiskRefused{LogLevel::Warn, "RISK", LogColor::Yellow, "{} {} qty={} px={} refused: {} ({} refused in total)"};
+    constexpr int64_t kRiskLogIntervalNs = 1000000000; // at most one refusal line per second
+
     constexpr const char *kDefaultCategory = "linear";
     constexpr const char *kDefaultBaseUrl = "https://api.bybit.com";
+
+    template <typename T>
+    T fixed_field(const nlohmann::json &v)
+    {
+        T out;
+        if (v.is_string())
+            T::parse(v.get_ref<const std::string &>(), out);
+        else if (v.is_number())
+            out = T::from_double(v.get<double>());
+        return out;
+    }
+
+    using OrderFields = std::vector<std::pair<std::string, std::string>>;
+
+    std::string request_field(const OrderFields &req, const char *key)
+    {
+        for (const auto &kv : req)
+            if (kv.first == key)
+                return kv.second;
+        return std::string{};
+    }
+
+    // The risk-relevant fields of a string-API order.
+    OrderRequest request_from_fields(const OrderFields &req)
+    {
+        OrderRequest r;
+        r.symbol.assign(request_field(req, "symbol"));
+        r.order_link_id.assign(request_field(req, "orderLinkId"));
+        Price::parse(request_field(req, "price"), r.price);
+        Qty::parse(request_field(req, "qty"), r.qty);
+        r.side = request_field(req, "side") == "Buy" ? OrderSide::Buy : OrderSide::Sell;
+        r.type = request_field(req, "orderType") == "Market" ? OrderType::Market : OrderType::Limit;
+        return r;
+    }
+
+    std::string risk_refusal(RiskCheck c)
+    {
+        return nlohmann::json{{"retCode", kRiskRejectCode}, {"retMsg", std::string("risk: ") + risk_check_name(c)}}.dump();
+    }
+
+    std::string rate_refusal()
+    {
+        return nlohmann::json{{"retCode", kRateLimitedCode}, {"retMsg", "rate limit: held back locally"}}.dump();
+    }
+
+    // The "header" object a trade WebSocket ack carries (kept by ITradeTransport's REST shaping).
+    RateLimitHeaders ws_rate_limits(const std::string &raw)
+    {
+        RateLimitHeaders limits;
+        const auto j = nlohmann::json::parse(raw, nullptr, false);
+        if (!j.is_object() || !j.contains("header") || !j["header"].is_object())
+            return limits;
+        for (const auto &kv : j["header"].items())
+            if (kv.value().is_string())
+                parse_rate_limit_header(kv.key(), kv.value().get_ref<const std::string &>(), limits);
+        return limits;
+    }
+
+    int64_t wall_ms_now()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // REST orderbook levels are already sorted best first.
+    uint32_t copy_levels(const nlohmann::json &levels, BookLevel *out)
+    {
+        uint32_t n = 0;
+        for (const auto &lvl : levels)
+        {
+            if (n >= kBookSnapshotDepth)
+                break;
+            out[n++] = BookLevel{fixed_field<Price>(lvl[0]), fixed_field<Qty>(lvl[1])};
+        }
+        return n;
+    }
 }
 
 TradingHelper::TradingHelper(std::string api_key,
@@ -24,6 +112,9 @@ TradingHelper::TradingHelper(std::string api_key,
       api_secret_(std::move(api_secret))
 {
     rest_client_ = std::make_unique<bybit::RestClient>(api_key_, api_secret_, category_, base_url_);
+    transport_ = std::make_unique<RestTransport>(api_key_, api_secret_, base_url_);
+    limiter_ = std::make_shared<RateLimiter>();
+    orders_.set_exposure_sink(&risk_);
 }
 
 nlohmann::json TradingHelper::fetch_ticker(const std::string &symbol)
@@ -46,33 +137,55 @@ nlohmann::json TradingHelper::fetch_instruments_info()
 
 nlohmann::json TradingHelper::fetch_instruments_info_for_category(const std::string &category_override, int limit)
 {
-    // Temporarily construct a short-lived RestClient with the override category, reusing creds/base_url.
-    bybit::RestClient temp_client(api_key_, api_secret_, category_override, base_url_);
-    const auto raw = temp_client.get_instruments_info(limit);
+    // Over the persistent transport rather than a short-lived RestClient, so startup calls share
+    // (and warm) the connection orders use.
+    const auto raw = transport_->get("/v5/market/instruments-info",
+                                     "category=" + category_override + "&limit=" + std::to_string(limit));
     return nlohmann::json::parse(raw);
 }
 
 nlohmann::json TradingHelper::fetch_wallet_balance(const std::optional<std::string> &coin)
 {
-    bybit::RestClient temp_client(api_key_, api_secret_, category_, base_url_);
-    const auto raw = temp_client.get_wallet_balance(category_, coin);
-    return nlohmann::json::parse(raw);
+    return fetch_wallet_balance_for_category(category_, coin);
 }
 
 nlohmann::json TradingHelper::fetch_wallet_balance_for_category(const std::string &category_override,
                                                                 const std::optional<std::string> &coin)
 {
-    bybit::RestClient temp_client(api_key_, api_secret_, category_override, base_url_);
-    const auto raw = temp_client.get_wallet_balance(category_override, coin);
+    std::string query = "accountType=" + category_override;
+    if (coin)
+        query += "&coin=" + *coin;
+    const auto raw = transport_->get("/v5/account/wallet-balance", query);
     return nlohmann::json::parse(raw);
 }
 
+bool TradingHelper::warm_connections()
+{
+    // The gateway warms its own pool from its I/O thread.
+    if (gateway_)
+        return true;
+    return transport_->warm();
+}
+
+void TradingHelper::keep_warm() { transport_->keep_warm(); }
+
 MarketDataSnapshot TradingHelper::fetch_snapshot(const std::string &symbol, int orderbook_limit)
 {
     MarketDataSnapshot snap;
     snap.symbol = symbol;
     snap.ticker = fetch_ticker(symbol);
     snap.orderbook = fetch_orderbook(symbol, orderbook_limit);
+    if (snap.orderbook.contains("result"))
+    {
+        const auto &ob = snap.orderbook["result"];
+        snap.book.update_id = ob.value("u", uint64_t{0});
+        snap.book.seq = ob.value("seq", uint64_t{0});
+        snap.book.ts_ms = ob.value("ts", int64_t{0});
+        if (ob.contains("b"))
+            snap.book.bid_count = copy_levels(ob["b"], snap.book.bids);
+        if (ob.contains("a"))
+            snap.book.ask_count = copy_levels(ob["a"], snap.book.asks);
+    }
     return snap;
 }
 
@@ -88,7 +201,36 @@ std::string TradingHelper::submit_limit_order(const std::string &symbol,
     {
         throw std::runtime_error("submit_limit_order requires API key/secret");
     }
-    return rest_client_->submit_order(symbol, side, order_type, qty, order_link_id, position_idx, price);
+    OrderRequest req;
+    req.symbol.assign(symbol);
+    req.order_link_id.assign(order_link_id);
+    Price::parse(price, req.price);
+    Qty::parse(qty, req.qty);
+    req.side = side == "Buy" ? OrderSide::Buy : OrderSide::Sell;
+    req.type = order_type == "Market" ? OrderType::Market : OrderType::Limit;
+    if (!throttle(RateEndpoint::Create, 1, req.type == OrderType::Market ? RatePriority::Exit : RatePriority::Quote))
+        return rate_refusal();
+    const Admitted a = admit(OrderAction::Create, &req, 1);
+    if (a.refused)
+        return risk_refusal(risk_result_[0]);
+    OrderFields fields{{"symbol", symbol}, {"side", side}, {"orderType", order_type}, {"qty", qty}, {"price", price},
+                       {"positionIdx", std::to_string(position_idx)}};
+    if (!order_link_id.empty())
+        fields.push_back({"orderLinkId", order_link_id});
+    std::string raw;
+    try
+    {
+        if (!via_trade_transport("order.create", RateEndpoint::Create, order_create_args(fields).dump(), raw))
+            raw = rest_client_->submit_order(symbol, side, order_type, qty, order_link_id, position_idx, price);
+    }
+    catch (...)
+    {
+        abandon_creates(a);
+        throw;
+    }
+    if (!order_link_id.empty())
+        orders_.on_ack(order_link_id, batch_item_results(raw, 1)[0]);
+    return raw;
 }
 
 std::string TradingHelper::submit_market_order(const std::string &symbol,
@@ -101,8 +243,35 @@ std::string TradingHelper::submit_market_order(const std::string &symbol,
     {
         throw std::runtime_error("submit_market_order requires API key/secret");
     }
+    OrderRequest req;
+    req.symbol.assign(symbol);
+    req.order_link_id.assign(order_link_id);
+    Qty::parse(qty, req.qty);
+    req.side = side == "Buy" ? OrderSide::Buy : OrderSide::Sell;
+    req.type = OrderType::Market;
+    throttle(RateEndpoint::Create, 1, RatePriority::Exit);
+    const Admitted a = admit(OrderAction::Create, &req, 1);
+    if (a.refused)
+        return risk_refusal(risk_result_[0]);
     // price omitted for market; time_in_force left default (GTC acceptable for market per client).
-    return rest_client_->submit_order(symbol, side, "Market", qty, order_link_id, position_idx);
+    OrderFields fields{{"symbol", symbol}, {"side", side}, {"orderType", "Market"}, {"qty", qty},
+                       {"positionIdx", std::to_string(position_idx)}};
+    if (!order_link_id.empty())
+        fields.push_back({"orderLinkId", order_link_id});
+    std::string raw;
+    try
+    {
+        if (!via_trade_transport("order.create", RateEndpoint::Create, order_create_args(fields).dump(), raw))
+            raw = rest_client_->submit_order(symbol, side, "Market", qty, order_link_id, position_idx);
+    }
+    catch (...)
+    {
+        abandon_creates(a);
+        throw;
+    }
+    if (!order_link_id.empty())
+        orders_.on_ack(order_link_id, batch_item_results(raw, 1)[0]);
+    return raw;
 }
 
 std::string TradingHelper::cancel_all(const std::string &symbol)
@@ -111,6 +280,14 @@ std::string TradingHelper::cancel_all(const std::string &symbol)
     {
         throw std::runtime_error("cancel_all requires API key/secret");
     }
+    throttle(RateEndpoint::CancelAll, 1, RatePriority::Cancel);
+    if (trade_transport_ && trade_transport_->supports_cancel_all())
+    {
+        const nlohmann::json args{{"category", category_}, {"symbol", symbol}};
+        std::string raw;
+        if (via_trade_transport("order.cancel-all", RateEndpoint::CancelAll, args.dump(), raw))
+            return raw;
+    }
     return rest_client_->cancel_all(symbol);
 }
 
@@ -120,7 +297,37 @@ std::string TradingHelper::batch_submit_orders(const std::vector<std::vector<std
     {
         throw std::runtime_error("batch_submit_orders requires API key/secret");
     }
-    return rest_client_->batch_submit_orders(order_requests);
+    if (!throttle(RateEndpoint::Create, order_requests.size(), RatePriority::Quote))
+        return rate_refusal();
+    std::vector<OrderRequest> reqs;
+    reqs.reserve(order_requests.size());
+    for (const auto &req : order_requests)
+        reqs.push_back(request_from_fields(req));
+    const Admitted a = admit(OrderAction::Create, reqs.data(), reqs.size());
+    if (a.refused)
+    {
+        // All or nothing: release the items admitted ahead of the refused one.
+        abandon_creates(a);
+        std::size_t first = 0;
+        while (!(a.refused & (1u << first)))
+            ++first;
+        return risk_refusal(risk_result_[first]);
+    }
+    std::string raw;
+    try
+    {
+        if (!via_trade_transport("order.create-batch", RateEndpoint::Create, batch_args(order_requests).dump(), raw))
+            raw = rest_client_->batch_submit_orders(order_requests);
+    }
+    catch (...)
+    {
+        abandon_creates(a);
+        throw;
+    }
+    const auto ok = batch_item_results(raw, a.count);
+    for (std::size_t i = 0; i < a.count; ++i)
+        orders_.on_ack(a.reqs[i].order_link_id.view(), ok[i]);
+    return raw;
 }
 
 std::string TradingHelper::batch_cancel_orders(const std::vector<std::vector<std::pair<std::string, std::string>>> &cancel_requests)
@@ -129,5 +336,439 @@ std::string TradingHelper::batch_cancel_orders(const std::vector<std::vector<std
     {
         throw std::runtime_error("batch_cancel_orders requires API key/secret");
     }
-    return rest_client_->batch_cancel_orders(cancel_requests);
+    throttle(RateEndpoint::Cancel, cancel_requests.size(), RatePriority::Cancel);
+    std::string raw;
+    if (!via_trade_transport("order.cancel-batch", RateEndpoint::Cancel, batch_args(cancel_requests).dump(), raw))
+        raw = rest_client_->batch_cancel_orders(cancel_requests);
+    return raw;
+}
+
+std::string TradingHelper::batch_amend_orders(const std::vector<std::vector<std::pair<std::string, std::string>>> &amend_requests)
+{
+    if (!has_keys_)
+    {
+        throw std::runtime_error("batch_amend_orders requires API key/secret");
+    }
+    if (!throttle(RateEndpoint::Amend, amend_requests.size(), RatePriority::Quote))
+        return rate_refusal();
+    if (risk_.enabled())
+    {
+        const int64_t now_ns = latency_now_ns();
+        for (const auto &req : amend_requests)
+        {
+            const OrderRequest r = request_from_fields(req);
+            OrderRecord current;
+            const RiskCheck c = orders_.get(r.order_link_id.view(), current) ? risk_.check_amend(r, current, now_ns)
+                                                                             : risk_.check_new(r, now_ns);
+            if (c != RiskCheck::Ok)
+                return risk_refusal(c);
+        }
+    }
+    const auto body = batch_args(amend_requests).dump();
+    std::string raw;
+    if (!via_trade_transport("order.amend-batch", RateEndpoint::Amend, body, raw))
+    {
+        RateLimitHeaders limits;
+        raw = transport_->post("/v5/order/amend-batch", body, &limits);
+        note_limits(RateEndpoint::Amend, limits);
+    }
+    const auto ok = batch_item_results(raw, amend_requests.size());
+    for (std::size_t i = 0; i < amend_requests.size(); ++i)
+    {
+        if (!ok[i])
+            continue;
+        const auto &req = amend_requests[i];
+        orders_.on_amend_ack(request_field(req, "orderLinkId"),
+                             std::strtod(request_field(req, "price").c_str(), nullptr),
+                             std::strtod(request_field(req, "qty").c_str(), nullptr));
+    }
+    return raw;
+}
+
+std::string TradingHelper::send_batch(OrderAction action, const OrderRequest *reqs, std::size_t n)
+{
+    static constexpr struct
+    {
+        const char *ws_op;
+        const char *path;
+        RateEndpoint endpoint;
+    } kRoutes[] = {
+        {"order.create-batch", "/v5/order/create-batch", RateEndpoint::Create},
+        {"order.amend-batch", "/v5/order/amend-batch", RateEndpoint::Amend},
+        {"order.cancel-batch", "/v5/order/cancel-batch", RateEndpoint::Cancel},
+    };
+    if (!has_keys_)
+        throw std::runtime_error("batch order calls require API key/secret");
+    const auto &route = kRoutes[static_cast<std::size_t>(action)];
+    encode_batch(action, category_, reqs, n, body_buf_);
+    const int64_t sent_ns = latency_now_ns();
+    if (tick_origin_ns_ > 0)
+        latency_record(LatencyStage::TickToTrade, sent_ns - tick_origin_ns_);
+    std::string raw;
+    if (!via_trade_transport(route.ws_op, route.endpoint, body_buf_, raw))
+    {
+        RateLimitHeaders limits;
+        raw = transport_->post(route.path, body_buf_, &limits);
+        note_limits(route.endpoint, limits);
+    }
+    latency_record(LatencyStage::OrderAck, latency_now_ns() - sent_ns);
+    return raw;
+}
+
+std::string TradingHelper::batch_submit_orders(const OrderRequest *reqs, std::size_t n)
+{
+    if (!throttle(RateEndpoint::Create, n, RatePriority::Quote))
+        return rate_refusal();
+    const Admitted a = admit(OrderAction::Create, reqs, n);
+    std::string raw;
+    if (a.count > 0)
+    {
+        try
+        {
+            raw = send_batch(OrderAction::Create, a.reqs, a.count);
+        }
+        catch (...)
+        {
+            abandon_creates(a);
+            throw;
+        }
+        const auto ok = batch_item_results(raw, a.count);
+        for (std::size_t i = 0; i < a.count; ++i)
+            orders_.on_ack(a.reqs[i].order_link_id.view(), ok[i]);
+    }
+    return a.refused ? refused_response(a, n, raw) : raw;
+}
+
+std::string TradingHelper::batch_amend_orders(const OrderRequest *reqs, std::size_t n)
+{
+    if (!throttle(RateEndpoint::Amend, n, RatePriority::Quote))
+        return rate_refusal();
+    const Admitted a = admit(OrderAction::Amend, reqs, n);
+    std::string raw;
+    if (a.count > 0)
+    {
+        raw = send_batch(OrderAction::Amend, a.reqs, a.count);
+        const auto ok = batch_item_results(raw, a.count);
+        for (std::size_t i = 0; i < a.count; ++i)
+            if (ok[i])
+                orders_.on_amend_ack(a.reqs[i].order_link_id.view(), a.reqs[i].price.to_double(), a.reqs[i].qty.to_double());
+    }
+    return a.refused ? refused_response(a, n, raw) : raw;
+}
+
+std::string TradingHelper::batch_cancel_orders(const OrderRequest *reqs, std::size_t n)
+{
+    throttle(RateEndpoint::Cancel, n, RatePriority::Cancel);
+    return send_batch(OrderAction::Cancel, reqs, n);
+}
+
+void TradingHelper::set_trade_transport(std::unique_ptr<ITradeTransport> transport)
+{
+    trade_transport_ = std::move(transport);
+}
+
+void TradingHelper::set_rate_limiter(std::shared_ptr<RateLimiter> limiter)
+{
+    if (!limiter)
+        throw std::invalid_argument("set_rate_limiter: null limiter");
+    if (gateway_)
+        throw std::logic_error("set_rate_limiter must be called before enable_async_gateway");
+    limiter_ = std::move(limiter);
+}
+
+bool TradingHelper::throttle(RateEndpoint ep, std::size_t cost, RatePriority prio)
+{
+    for (;;)
+    {
+        const int64_t wait_ns = limiter_->acquire(ep, static_cast<uint32_t>(std::max<std::size_t>(cost, 1)), prio, latency_now_ns());
+        if (wait_ns == 0)
+            return true;
+        if (prio == RatePriority::Quote)
+            return false; // the next requote will carry fresher prices anyway
+        std::this_thread::sleep_for(std::chrono::nanoseconds{wait_ns});
+    }
+}
+
+void TradingHelper::note_limits(RateEndpoint ep, const RateLimitHeaders &limits)
+{
+    limiter_->on_response(ep, limits, latency_now_ns(), wall_ms_now());
+}
+
+nlohmann::json TradingHelper::order_create_args(const OrderFields &fields) const
+{
+    auto args = order_fields_json(fields);
+    args["category"] = category_;
+    return args;
+}
+
+nlohmann::json TradingHelper::batch_args(const OrderBatch &requests) const
+{
+    nlohmann::json args;
+    args["category"] = category_;
+    args["request"] = nlohmann::json::array();
+    for (const auto &req : requests)
+        args["request"].push_back(order_fields_json(req));
+    return args;
+}
+
+bool TradingHelper::via_trade_transport(const char *op, RateEndpoint ep, const std::string &args_json, std::string &raw)
+{
+    if (!trade_transport_)
+        return false;
+    if (!trade_transport_->ready())
+    {
+        ++trade_fallbacks_;
+        return false;
+    }
+    try
+    {
+        raw = trade_transport_->request(op, args_json);
+        note_limits(ep, ws_rate_limits(raw));
+        return true;
+    }
+    catch (const std::exception &ex)
+    {
+        ++trade_fallbacks_;
+        if (std::strncmp(op, "order.create", 12) != 0)
+        {
+            // Cancel and amend are idempotent: retrying over REST is safe.
+            log_event(kLogTradeFallback, op, ex.what());
+            return false;
+        }
+        // The create may be live already, and a REST retry with its orderLinkId would be refused as
+        // a duplicate while the order rests untracked. Cancel it instead so the outcome is known.
+        log_event(kLogTradeUnknown, op, ex.what());
+        raw = cancel_unknown_creates(args_json);
+        return true;
+    }
+}
+
+std::string TradingHelper::cancel_unknown_creates(const std::string &args_json)
+{
+    const auto args = nlohmann::json::parse(args_json);
+    nlohmann::json cancel{{"category", category_}, {"request", nlohmann::json::array()}};
+    auto add = [&](const nlohmann::json &item)
+    {
+        const std::string link = item.value("orderLinkId", std::string{});
+        if (link.empty())
+            throw std::runtime_error("create outcome unknown and it has no orderLinkId to cancel by");
+        cancel["request"].push_back({{"symbol", item.value("symbol", std::string{})}, {"orderLinkId", link}});
+    };
+    if (args.contains("request"))
+        for (const auto &item : args["request"])
+            add(item);
+    else
+        add(args);
+    RateLimitHeaders limits;
+    const std::string resp = transport_->post("/v5/order/cancel-batch", cancel.dump(), &limits);
+    note_limits(RateEndpoint::Cancel, limits);
+    for (const int code : parse_batch_codes(resp, cancel["request"].size()))
+        if (code != 0 && !order_gone_code(code))
+            throw std::runtime_error("create outcome unknown, cancel by orderLinkId failed: " + resp.substr(0, 200));
+    // Cancelled, not placed yet, or filled (which the execution stream reports). A create still in
+    // flight can land after this cancel; QuoteManager watches the order stream for it.
+    return nlohmann::json{{"retCode", kUnknownOutcomeCode}, {"retMsg", "create outcome unknown, cancelled by orderLinkId"}}.dump();
+}
+
+std::vector<bool> TradingHelper::batch_item_results(const std::string &raw, std::size_t n)
+{
+    return parse_batch_results(raw, n);
+}
+
+TradingHelper::Admitted TradingHelper::admit(OrderAction action, const OrderRequest *reqs, std::size_t n)
+{
+    if (!risk_.enabled() || action == OrderAction::Cancel)
+    {
+        if (action == OrderAction::Create)
+            for (std::size_t i = 0; i < n; ++i)
+                orders_.on_submitted(reqs[i].order_link_id.view(), reqs[i].symbol.view(), reqs[i].is_buy(),
+                                     reqs[i].price.to_double(), reqs[i].qty.to_double());
+        return Admitted{reqs, n, 0};
+    }
+    if (n > kMaxGatewayBatch)
+        throw std::invalid_argument("risk-checked batch exceeds kMaxGatewayBatch");
+    const int64_t now_ns = latency_now_ns();
+    Admitted a{risk_pass_, 0, 0};
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const auto &r = reqs[i];
+        RiskCheck c;
+        OrderRecord current;
+        if (action == OrderAction::Amend && orders_.get(r.order_link_id.view(), current))
+            c = risk_.check_amend(r, current, now_ns);
+        else
+            c = risk_.check_new(r, now_ns); // an amend of an order we never saw is checked as new
+        risk_result_[i] = c;
+        if (c == RiskCheck::Ok)
+        {
+            risk_pass_[a.count++] = r;
+            if (action == OrderAction::Create)
+                orders_.on_submitted(r.order_link_id.view(), r.symbol.view(), r.is_buy(), r.price.to_double(), r.qty.to_double());
+            continue;
+        }
+        a.refused |= 1u << i;
+        if (now_ns - risk_log_ns_ >= kRiskLogIntervalNs)
+        {
+            risk_log_ns_ = now_ns;
+            log_event(kLogRiskRefused, action == OrderAction::Create ? "create" : "amend", r.symbol, r.qty, r.price,
+                      risk_check_name(c), risk_.refused_total());
+        }
+    }
+    return a;
+}
+
+void TradingHelper::abandon_creates(const Admitted &a)
+{
+    for (std::size_t i = 0; i < a.count; ++i)
+        orders_.on_ack(a.reqs[i].order_link_id.view(), false);
+}
+
+std::string TradingHelper::refused_response(const Admitted &a, std::size_t n, const std::string &raw) const
+{
+    const auto sent = a.count > 0 ? nlohmann::json::parse(raw, nullptr, false) : nlohmann::json{};
+    const int sent_code = sent.is_object() ? sent.value("retCode", kRiskRejectCode) : kRiskRejectCode;
+    const nlohmann::json *sent_ext = nullptr;
+    const nlohmann::json *sent_list = nullptr;
+    if (sent.is_object() && sent.contains("retExtInfo") && sent["retExtInfo"].contains("list"))
+        sent_ext = &sent["retExtInfo"]["list"];
+    if (sent.is_object() && sent.contains("result") && sent["result"].contains("list"))
+        sent_list = &sent["result"]["list"];
+    const auto ok = batch_item_results(raw, a.count);
+    nlohmann::json ext = nlohmann::json::array();
+    nlohmann::json list = nlohmann::json::array();
+    for (std::size_t i = 0, j = 0; i < n; ++i)
+    {
+        if (a.refused & (1u << i))
+        {
+            ext.push_back({{"code", kRiskRejectCode}, {"msg", std::string("risk: ") + risk_check_name(risk_result_[i])}});
+            list.push_back(nlohmann::json::object());
+            continue;
+        }
+        if (sent_ext && j < sent_ext->size())
+            ext.push_back((*sent_ext)[j]);
+        else
+            ext.push_back({{"code", ok[j] ? 0 : (sent_code != 0 ? sent_code : kRiskRejectCode)}, {"msg", ok[j] ? "OK" : "failed"}});
+        list.push_back(sent_list && j < sent_list->size() ? (*sent_list)[j] : nlohmann::json::object());
+        ++j;
+    }
+    return nlohmann::json{{"retCode", 0}, {"retMsg", "OK"}, {"result", {{"list", list}}}, {"retExtInfo", {{"list", ext}}}}.dump();
+}
+
+void TradingHelper::enable_async_gateway(std::size_t queue_capacity)
+{
+    if (!has_keys_)
+        throw std::runtime_error("enable_async_gateway requires API key/secret");
+    if (!gateway_)
+        gateway_ = std::make_unique<OrderGateway>(api_key_, api_secret_, category_, base_url_, &orders_, queue_capacity,
+                                                  limiter_.get());
+}
+
+bool TradingHelper::enqueue(GatewayOp op, std::string_view symbol, const OrderRequest *reqs, std::size_t n, GatewayCallback on_done)
+{
+    if (!gateway_)
+        throw std::runtime_error("async order gateway is not enabled");
+    if (n > kMaxGatewayBatch)
+        throw std::invalid_argument("gateway batch exceeds kMaxGatewayBatch");
+    GatewayRequest req;
+    req.op = op;
+    req.symbol.assign(symbol);
+    req.count = static_cast<uint32_t>(n);
+    std::copy(reqs, reqs + n, req.orders);
+    req.on_done = std::move(on_done);
+    req.origin_ns = tick_origin_ns_;
+    return gateway_->submit(std::move(req));
+}
+
+bool TradingHelper::enqueue_admitted(GatewayOp op, std::string_view symbol, const Admitted &a, std::size_t n, GatewayCallback on_done)
+{
+    // A full queue means the admitted creates are never sent.
+    auto settle = [&](bool queued)
+    {
+        if (!queued && op != GatewayOp::AmendBatch)
+            abandon_creates(a);
+        return queued;
+    };
+    if (!a.refused)
+        return settle(enqueue(op, symbol, a.reqs, a.count, std::move(on_done)));
+    GatewayResult refused;
+    refused.op = op;
+    refused.item_ok.assign(n, false);
+    if (a.count == 0)
+    {
+        // Nothing to send; complete from the next poll_async() like any other request.
+        refused.body = risk_refusal(risk_result_[0]);
+        risk_deferred_.emplace_back(std::move(on_done), std::move(refused));
+        return true;
+    }
+    // Spread the exchange's per-item results back over the caller's items.
+    return settle(enqueue(op, symbol, a.reqs, a.count,
+                          [on_done = std::move(on_done), refused = std::move(refused), mask = a.refused](const GatewayResult &r) mutable
+                          {
+                              if (!on_done)
+                                  return;
+                              GatewayResult out = r;
+                              out.ok = false;
+                              out.item_ok = std::move(refused.item_ok);
+                              for (std::size_t i = 0, j = 0; i < out.item_ok.size(); ++i)
+                                  if (!(mask & (1u << i)))
+                                      out.item_ok[i] = j < r.item_ok.size() && r.item_ok[j++];
+                              on_done(out);
+                          }));
+}
+
+bool TradingHelper::async_batch_submit_orders(const OrderRequest *reqs, std::size_t n, GatewayCallback on_done)
+{
+    if (n == 0)
+        return true;
+    return enqueue_admitted(GatewayOp::CreateBatch, reqs[0].symbol.view(), admit(OrderAction::Create, reqs, n), n,
+                            std::move(on_done));
+}
+
+bool TradingHelper::async_batch_amend_orders(const OrderRequest *reqs, std::size_t n, GatewayCallback on_done)
+{
+    return n == 0 || enqueue_admitted(GatewayOp::AmendBatch, reqs[0].symbol.view(), admit(OrderAction::Amend, reqs, n), n,
+                                      std::move(on_done));
+}
+
+bool TradingHelper::async_batch_cancel_orders(const OrderRequest *reqs, std::size_t n, GatewayCallback on_done)
+{
+    return n == 0 || enqueue(GatewayOp::CancelBatch, reqs[0].symbol.view(), reqs, n, std::move(on_done));
+}
+
+bool TradingHelper::async_cancel_all(const std::string &symbol, GatewayCallback on_done)
+{
+    return enqueue(GatewayOp::CancelAll, symbol, nullptr, 0, std::move(on_done));
+}
+
+bool TradingHelper::async_submit_market_order(const std::string &symbol,
+                                              const std::string &side,
+                                              const std::string &qty,
+                                              int position_idx,
+                                              const std::string &order_link_id,
+                                              GatewayCallback on_done)
+{
+    OrderRequest req;
+    req.symbol.assign(symbol);
+    req.order_link_id.assign(order_link_id);
+    Qty::parse(qty, req.qty);
+    req.side = side == "Buy" ? OrderSide::Buy : OrderSide::Sell;
+    req.type = OrderType::Market;
+    req.position_idx = static_cast<int8_t>(position_idx);
+    return enqueue_admitted(GatewayOp::CreateOrder, symbol, admit(OrderAction::Create, &req, 1), 1, std::move(on_done));
+}
+
+std::size_t TradingHelper::poll_async()
+{
+    std::size_t n = gateway_ ? gateway_->poll() : 0;
+    if (!risk_deferred_.empty())
+    {
+        // Callbacks may queue new requests (and refusals); deliver only the ones pending on entry.
+        auto deferred = std::move(risk_deferred_);
+        risk_deferred_.clear();
+        for (auto &d : deferred)
+            if (d.first)
+                d.first(d.second);
+        n += deferred.size();
+    }
+    return n;
 }
@@ -27,3 +27,12 @@ void WsHelper::subscribe_orderbook(const std::vector<std::string> &symbols, int
 {
     client_->subscribe_orderbook(symbols, depth);
 }
+
+void WsHelper::subscribe_trades(const std::vector<std::string> &symbols)
+{
+    std::vector<std::string> topics;
+    topics.reserve(symbols.size());
+    for (const auto &s : symbols)
+        topics.push_back("publicTrade." + s);
+    client_->subscribe_topics(topics, "public");
+}
@@ -0,0 +1,116 @@
+#include "ws_message_parser.hpp"
+
+#include <charconv>
+#include <type_traits>
+
+namespace
+{
+    PublicTopic classify(std::string_view topic)
+    {
+        if (topic.rfind("orderbook.", 0) == 0)
+            return PublicTopic::Orderbook;
+        if (topic.rfind("tickers.", 0) == 0)
+            return PublicTopic::Ticker;
+        if (topic.rfind("publicTrade.", 0) == 0)
+            return PublicTopic::PublicTrade;
+        return PublicTopic::Unknown;
+    }
+
+    bool parse_book_data(std::string_view data, PublicMessage &out)
+    {
+        bool ok = true;
+        bool has_u = false;
+        const bool shaped = for_each_member(data, [&](std::string_view key, std::string_view value)
+                                            {
+            if (key == "b")
+                out.bids = value;
+            else if (key == "a")
+                out.asks = value;
+            else if (key == "u")
+                ok = ok && (has_u = ws_scan::parse_int(value, out.update_id));
+            else if (key == "seq")
+                ok = ok && ws_scan::parse_int(value, out.seq); });
+        return shaped && ok && has_u;
+    }
+} // namespace
+
+bool parse_public_message(std::string_view msg, PublicMessage &out)
+{
+    out = PublicMessage{};
+    bool ok = true;
+    const bool shaped = for_each_member(msg, [&](std::string_view key, std::string_view value)
+                                        {
+        if (key == "topic")
+            out.topic = ws_scan::unquote(value);
+        else if (key == "type")
+            out.is_snapshot = ws_scan::unquote(value) == "snapshot";
+        else if (key == "ts")
+            ok = ok && ws_scan::parse_int(value, out.ts_ms);
+        else if (key == "data")
+            out.data = value; });
+    if (!shaped || !ok || out.topic.empty() || out.data.empty())
+        return false;
+
+    out.kind = classify(out.topic);
+    const auto dot = out.topic.rfind('.');
+    out.symbol = out.topic.substr(dot + 1);
+    switch (out.kind)
+    {
+    case PublicTopic::Orderbook:
+        return out.data.front() == '{' && parse_book_data(out.data, out);
+    case PublicTopic::Ticker:
+        return out.data.front() == '{';
+    case PublicTopic::PublicTrade:
+        return out.data.front() == '[';
+    case PublicTopic::Unknown:
+        break;
+    }
+    return false;
+}
+
+bool merge_ticker_fields(std::string_view data, int64_t ts_ms, TickerSnapshot &out)
+{
+    TickerSnapshot t = out; // a member that fails to scan must not leave earlier ones applied
+    auto set = [](std::string_view raw, auto &out)
+    {
+        if (raw == "null")
+            return;
+        raw = ws_scan::unquote(raw);
+        double v = 0.0;
+        auto res = std::from_chars(raw.data(), raw.data() + raw.size(), v);
+        if (res.ec == std::errc{})
+            out = static_cast<std::decay_t<decltype(out)>>(v);
+    };
+    const bool ok = for_each_member(data, [&](std::string_view key, std::string_view raw)
+                                    {
+        if (key == "lastPrice")
+            set(raw, t.last_price);
+        else if (key == "markPrice")
+            set(raw, t.mark_price);
+        else if (key == "indexPrice")
+            set(raw, t.index_price);
+        else if (key == "bid1Price")
+            set(raw, t.bid1_price);
+        else if (key == "bid1Size")
+            set(raw, t.bid1_size);
+        else if (key == "ask1Price")
+            set(raw, t.ask1_price);
+        else if (key == "ask1Size")
+            set(raw, t.ask1_size);
+        else if (key == "fundingRate")
+            set(raw, t.funding_rate);
+        else if (key == "openInterest")
+            set(raw, t.open_interest);
+        else if (key == "volume24h")
+            set(raw, t.volume_24h);
+        else if (key == "turnover24h")
+            set(raw, t.turnover_24h);
+        else if (key == "nextFundingTime")
+            set(raw, t.next_funding_time_ms); });
+    if (!ok)
+        return false;
+    t.ts_ms = ts_ms;
+    ++t.updates;
+    out = t;
+    return true;
+}
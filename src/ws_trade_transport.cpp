@@ -0,0 +1,168 @@
+#include "ws_trade_transport.hpp"
+
+#include <stdexcept>
+
+#include <ixwebsocket/IXWebSocket.h>
+
+#include "async_logger.hpp"
+#include "rest_transport.hpp"
+
+namespace
+{
+    constexpr LogFormat kLogAuthFailed{LogLevel::Error, "TRADE-WS", LogColor::Red, "auth failed: {}"};
+    constexpr LogFormat kLogDisconnected{LogLevel::Warn, "TRADE-WS", LogColor::Yellow, "{}"};
+
+    int64_t now_ms()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Trade WS acks carry the payload in "data"; reshape to the REST envelope callers already parse.
+    // "header" (rate-limit status) is kept as is.
+    std::string to_rest_shape(const nlohmann::json &ack)
+    {
+        nlohmann::json out;
+        out["retCode"] = ack.value("retCode", -1);
+        out["retMsg"] = ack.value("retMsg", std::string{});
+        out["result"] = ack.contains("data") ? ack["data"] : nlohmann::json::object();
+        out["retExtInfo"] = ack.contains("retExtInfo") ? ack["retExtInfo"] : nlohmann::json::object();
+        if (ack.contains("header"))
+            out["header"] = ack["header"];
+        return out.dump();
+    }
+} // namespace
+
+WsTradeTransport::WsTradeTransport(Config cfg) : cfg_(std::move(cfg)), ws_(std::make_unique<ix::WebSocket>()) {}
+
+WsTradeTransport::~WsTradeTransport() { stop(); }
+
+bool WsTradeTransport::start(std::chrono::milliseconds timeout)
+{
+    ws_->setUrl(cfg_.url);
+    // Bybit drops idle trade connections after ~30s without a ping.
+    ws_->setPingInterval(20);
+    ws_->enableAutomaticReconnection();
+    ws_->setOnMessageCallback([this](const ix::WebSocketMessagePtr &msg)
+                              {
+        switch (msg->type)
+        {
+        case ix::WebSocketMessageType::Open:
+            send_auth();
+            break;
+        case ix::WebSocketMessageType::Message:
+            on_text(msg->str);
+            break;
+        case ix::WebSocketMessageType::Close:
+            on_disconnect("closed: " + msg->closeInfo.reason);
+            break;
+        case ix::WebSocketMessageType::Error:
+            on_disconnect("error: " + msg->errorInfo.reason);
+            break;
+        default:
+            break;
+        } });
+    ws_->start();
+
+    std::unique_lock<std::mutex> lk(mu_);
+    return cv_.wait_for(lk, timeout, [this]
+                        { return ready(); });
+}
+
+void WsTradeTransport::stop()
+{
+    ws_->stop();
+    on_disconnect("stopped");
+}
+
+void WsTradeTransport::send_auth()
+{
+    const auto expires = std::to_string(now_ms() + 10000);
+    nlohmann::json msg;
+    msg["op"] = "auth";
+    msg["args"] = {cfg_.api_key, expires, RestTransport::hmac_sha256_hex(cfg_.api_secret, "GET/realtime" + expires)};
+    ws_->sendText(msg.dump());
+}
+
+void WsTradeTransport::on_text(const std::string &text)
+{
+    auto j = nlohmann::json::parse(text, nullptr, false);
+    if (j.is_discarded())
+        return;
+    const auto op = j.value("op", std::string{});
+    if (op == "auth")
+    {
+        if (j.value("retCode", -1) == 0)
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            authed_.store(true, std::memory_order_release);
+            cv_.notify_all();
+        }
+        else
+        {
+            log_event(kLogAuthFailed, j.value("retMsg", std::string{}));
+        }
+        return;
+    }
+    if (!j.contains("reqId") || !j["reqId"].is_string())
+        return; // pong and other control frames
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = pending_.find(j["reqId"].get<std::string>());
+    if (it == pending_.end())
+        return; // ack for a request that already timed out
+    it->second->response = to_rest_shape(j);
+    it->second->done = true;
+    cv_.notify_all();
+}
+
+void WsTradeTransport::on_disconnect(const std::string &reason)
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    if (authed_.exchange(false, std::memory_order_acq_rel))
+        log_event(kLogDisconnected, reason);
+    for (auto &kv : pending_)
+    {
+        kv.second->done = true;
+        kv.second->failed = true;
+    }
+    cv_.notify_all();
+}
+
+std::string WsTradeTransport::request(const std::string &op, const std::string &args_json)
+{
+    if (!ready())
+        throw std::runtime_error("trade websocket not authenticated");
+
+    const auto req_id = "r" + std::to_string(next_req_id_.fetch_add(1, std::memory_order_relaxed) + 1);
+    // args_json is already encoded; splice it in rather than re-parsing it.
+    std::string msg;
+    msg.reserve(args_json.size() + 160);
+    msg.append("{\"reqId\":\"").append(req_id);
+    msg.append("\",\"header\":{\"X-BAPI-TIMESTAMP\":\"").append(std::to_string(now_ms()));
+    msg.append("\",\"X-BAPI-RECV-WINDOW\":\"").append(std::to_string(cfg_.recv_window_ms));
+    msg.append("\"},\"op\":\"").append(op);
+    msg.append("\",\"args\":[").append(args_json).append("]}");
+
+    auto pending = std::make_shared<Pending>();
+    std::unique_lock<std::mutex> lk(mu_);
+    pending_.emplace(req_id, pending);
+    lk.unlock();
+    const bool sent = ws_->sendText(msg).success;
+    lk.lock();
+    if (sent)
+        cv_.wait_for(lk, cfg_.ack_timeout, [&]
+                     { return pending->done; });
+    pending_.erase(req_id);
+
+    if (!sent)
+        throw std::runtime_error("trade websocket send failed for " + op);
+    if (!pending->done)
+    {
+        timeouts_.fetch_add(1, std::memory_order_relaxed);
+        throw std::runtime_error("trade websocket ack timeout for " + op + " " + req_id);
+    }
+    if (pending->failed)
+        throw std::runtime_error("trade websocket disconnected before ack for " + op);
+    return std::move(pending->response);
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_logger.hpp"
+
+namespace
+{
+    constexpr LogFormat kQuote{LogLevel::Info, "MM", LogColor::Cyan, "{} bid@{} qty={} n={} id={} mid={} {}"};
+    constexpr LogFormat kPnl{LogLevel::Info, "PNL", LogColor::Magenta, "net={} flat={}"};
+    constexpr LogFormat kWarn{LogLevel::Warn, "", LogColor::None, "gap for \"{}\"\n{}"};
+    constexpr LogFormat kTick{LogLevel::Info, "T", LogColor::None, "thread={} i={}"};
+
+    std::string body(const std::string &line)
+    {
+        // Text lines start with "HH:MM:SS.uuuuuu ".
+        REQUIRE(line.size() > 16);
+        REQUIRE(line[2] == ':');
+        REQUIRE(line[8] == '.');
+        return line.substr(16);
+    }
+} // namespace
+
+TEST_CASE("log_record_renders_arguments_in_order", "[log]")
+{
+    LogRecord rec;
+    const std::string symbol = "BTCUSDT";
+    encode_log(rec, kQuote, 0, symbol, Price::from_double(65000.1), Qty::from_double(0.001), -3, uint64_t{7}, 0.5,
+               std::string_view("dry-run"));
+    REQUIRE(rec.argc == 7);
+
+    AsyncLogger::Config plain;
+    plain.color = false;
+    std::string out;
+    AsyncLogger::render(rec, plain, 0, out);
+    REQUIRE(body(out) == "[MM] BTCUSDT bid@65000.1 qty=0.001 n=-3 id=7 mid=0.5 dry-run");
+
+    AsyncLogger::Config colored;
+    out.clear();
+    encode_log(rec, kPnl, 0, LogSigned{1.5}, LogSigned{0.0});
+    AsyncLogger::render(rec, colored, 0, out);
+    REQUIRE(body(out) == "\033[35m[PNL]\033[0m net=\033[32m1.500000\033[0m flat=0.000000");
+}
+
+TEST_CASE("log_record_truncates_strings_and_surplus_arguments", "[log]")
+{
+    LogRecord rec;
+    const std::string big(300, 'x');
+    encode_log(rec, kTick, 0, big, big, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12);
+    REQUIRE(rec.argc == kMaxLogArgs);
+    REQUIRE(rec.text_len == kLogTextBytes);
+    REQUIRE(rec.args[0].len == 192);
+    REQUIRE(rec.args[1].len == 0);
+
+    AsyncLogger::Config plain;
+    plain.color = false;
+    std::string out;
+    AsyncLogger::render(rec, plain, 0, out);
+    REQUIRE(body(out) == "[T] thread=" + std::string(192, 'x') + " i=");
+}
+
+TEST_CASE("log_record_renders_json_lines", "[log]")
+{
+    LogRecord rec;
+    encode_log(rec, kWarn, 1500, "BTC\\USDT", "resync");
+    AsyncLogger::Config cfg;
+    cfg.json = true;
+    std::string out;
+    AsyncLogger::render(rec, cfg, 1700000000000000000, out);
+    REQUIRE(out == R"({"ts_ns":1700000000000001500,"level":"warn","tag":"","msg":"gap for \"BTC\\USDT\"\nresync"})");
+}
+
+TEST_CASE("async_logger_writes_every_record_from_every_thread", "[log]")
+{
+    auto &logger = AsyncLogger::instance();
+    std::ostringstream sink;
+    AsyncLogger::Config cfg;
+    cfg.color = false;
+    cfg.ring_capacity = 1 << 14;
+    logger.start(cfg, sink);
+    REQUIRE(logger.running());
+
+    constexpr int kThreads = 3;
+    constexpr int kPerThread = 2000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+        threads.emplace_back([t]
+                             {
+                                 for (int i = 0; i < kPerThread; ++i)
+                                     log_event(kTick, t, i);
+                             });
+    for (auto &th : threads)
+        th.join();
+    logger.stop();
+    REQUIRE_FALSE(logger.running());
+    REQUIRE(logger.dropped() == 0);
+
+    std::istringstream lines(sink.str());
+    std::vector<int> next(kThreads, 0);
+    int total = 0;
+    for (std::string line; std::getline(lines, line); ++total)
+    {
+        int t = -1;
+        int i = -1;
+        REQUIRE(std::sscanf(body(line).c_str(), "[T] thread=%d i=%d", &t, &i) == 2);
+        REQUIRE(t >= 0);
+        REQUIRE(t < kThreads);
+        REQUIRE(i == next[t]++); // per-thread order is preserved
+    }
+    REQUIRE(total == kThreads * kPerThread);
+}
+
+TEST_CASE("async_logger_writes_synchronously_when_not_started", "[log]")
+{
+    REQUIRE_FALSE(AsyncLogger::instance().running());
+    std::ostringstream captured;
+    auto *saved = std::cout.rdbuf(captured.rdbuf());
+    log_event(kPnl, LogSigned{-2.0}, LogSigned{0.0});
+    std::cout.rdbuf(saved);
+    REQUIRE(body(captured.str()) == "[PNL] net=-2.000000 flat=0.000000\n");
+}
@@ -0,0 +1,191 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "feed_recorder.hpp"
+
+namespace
+{
+    std::filesystem::path temp_dir(const char *name)
+    {
+        auto dir = std::filesystem::temp_directory_path() / (std::string(name) + "_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(dir);
+        return dir;
+    }
+
+    int64_t steady_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    const std::string kBook = R"({"topic":"orderbook.50.BTCUSDT","type":"snapshot","ts":1000,)"
+                              R"("data":{"s":"BTCUSDT","b":[["100.5","2"]],"a":[["101","1.5"],["102","3"]],"u":7,"seq":9}})";
+    const std::string kTicker = R"({"topic":"tickers.BTCUSDT","type":"snapshot","data":{"lastPrice":"100.75"},"ts":1001})";
+    const std::string kTrades = R"({"topic":"publicTrade.BTCUSDT","type":"snapshot","ts":1002,)"
+                                R"("data":[{"T":1002,"s":"BTCUSDT","S":"Sell","v":"0.25","p":"100.5"}]})";
+    const std::string kPrivate = R"({"topic":"order","data":[]})";
+}
+
+TEST_CASE("feed_recorder_round_trips_raw_and_normalized_records", "[recorder]")
+{
+    const auto dir = temp_dir("feed_recorder_test");
+    FeedRecorder::Config cfg;
+    cfg.dir = dir.string();
+    FeedRecorder rec(cfg);
+    rec.start();
+    const int64_t t0 = steady_ns();
+    rec.record_public(t0, kBook);
+    rec.record_public(t0 + 1, kTicker);
+    rec.record_public(t0 + 2, kTrades);
+    rec.record_private(t0 + 3, kPrivate);
+    rec.record_public(t0 + 4, R"({"success":true,"op":"subscribe"})");
+    rec.stop();
+    REQUIRE(rec.recorded() == 5);
+    REQUIRE(rec.dropped() == 0);
+
+    RecordFileReader reader;
+    reader.open(rec.current_path());
+    std::vector<RecordView> records;
+    RecordView r;
+    while (reader.next(r))
+        records.push_back(r);
+
+    // Each understood public message is followed by its typed record.
+    REQUIRE(records.size() == 8);
+    REQUIRE(records[0].header.type == RecordType::RawPublic);
+    REQUIRE(records[0].payload == kBook);
+    REQUIRE(records[0].header.recv_ns == t0);
+
+    REQUIRE(records[1].header.type == RecordType::BookUpdate);
+    const auto &book = records[1].book();
+    REQUIRE(record_symbol(book.symbol) == "BTCUSDT");
+    REQUIRE(book.update_id == 7);
+    REQUIRE(book.is_snapshot == 1);
+    REQUIRE(book.bid_count == 1);
+    REQUIRE(book.ask_count == 2);
+    REQUIRE(records[1].levels()[0].price_raw == Price::from_double(100.5).raw);
+    REQUIRE(records[1].levels()[2].qty_raw == Qty::from_double(3.0).raw);
+
+    REQUIRE(records[3].header.type == RecordType::Ticker);
+    REQUIRE(records[3].ticker().ticker.last_price == 100.75);
+
+    REQUIRE(records[5].header.type == RecordType::Trades);
+    REQUIRE(records[5].trades().count == 1);
+    REQUIRE(records[5].trade_list()[0].is_buy == 0);
+    REQUIRE(records[5].trade_list()[0].qty_raw == Qty::from_double(0.25).raw);
+
+    REQUIRE(records[6].header.type == RecordType::RawPrivate);
+    REQUIRE(records[6].payload == kPrivate);
+    REQUIRE(records[7].header.type == RecordType::RawPublic);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("feed_recorder_reader_stops_at_truncated_tail", "[recorder]")
+{
+    const auto dir = temp_dir("feed_recorder_trunc");
+    FeedRecorder::Config cfg;
+    cfg.dir = dir.string();
+    cfg.normalize = false;
+    FeedRecorder rec(cfg);
+    rec.start();
+    rec.record_public(steady_ns(), kBook);
+    rec.record_public(steady_ns(), kTicker);
+    rec.stop();
+
+    const auto path = rec.current_path();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+    RecordFileReader reader;
+    reader.open(path);
+    RecordView r;
+    REQUIRE(reader.next(r));
+    REQUIRE(r.payload == kBook);
+    REQUIRE_FALSE(reader.next(r));
+
+    std::ofstream(dir / "junk.bmd") << "not a recording at all";
+    REQUIRE_THROWS(reader.open((dir / "junk.bmd").string()));
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("feed_recorder_drops_instead_of_blocking_when_full", "[recorder]")
+{
+    FeedRecorder::Config cfg;
+    cfg.dir = temp_dir("feed_recorder_full").string();
+    cfg.ring_bytes = 4096;
+    FeedRecorder rec(cfg);
+    // Not started: nothing drains, and nothing is accepted.
+    rec.record_public(0, kBook);
+    REQUIRE(rec.dropped() == 1);
+
+    rec.start();
+    rec.record_public(steady_ns(), std::string(8192, 'x')); // larger than the ring
+    REQUIRE(rec.dropped() == 2);
+    rec.stop();
+    std::filesystem::remove_all(cfg.dir);
+}
+
+TEST_CASE("feed_recorder_starts_a_session_file_instead_of_appending_to_another_sessions", "[recorder]")
+{
+    const auto dir = temp_dir("feed_recorder_sessions");
+    FeedRecorder::Config cfg;
+    cfg.dir = dir.string();
+    std::string paths[2];
+    FileHeader headers[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        FeedRecorder rec(cfg);
+        rec.start();
+        rec.record_private(steady_ns(), kPrivate);
+        rec.stop();
+        paths[i] = rec.current_path();
+        RecordFileReader reader;
+        reader.open(paths[i]);
+        headers[i] = reader.file_header();
+        RecordView r;
+        REQUIRE(reader.next(r)); // exactly this session's record, timed against its own anchor
+        REQUIRE_FALSE(reader.next(r));
+    }
+    // A restart within the same hour (the test could straddle an hour boundary instead).
+    if (paths[0].substr(0, paths[0].size() - 4) + "_01.bmd" == paths[1])
+        REQUIRE(headers[0].steady_ns != headers[1].steady_ns);
+    else
+        REQUIRE(paths[1].find("_01.bmd") == std::string::npos);
+    REQUIRE(paths[0] != paths[1]);
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("feed_recorder_keeps_running_when_the_hour_file_cannot_be_opened", "[recorder]")
+{
+    const auto dir = temp_dir("feed_recorder_unopenable");
+    FeedRecorder::Config cfg;
+    cfg.dir = dir.string();
+    FeedRecorder rec(cfg);
+    rec.start();
+    // A directory where the hour file should be: open(2) fails with EISDIR.
+    const int64_t wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::filesystem::create_directories(FeedRecorder::file_name(cfg.dir, cfg.prefix, wall_ns));
+    for (int i = 0; i < 100; ++i)
+        rec.record_public(steady_ns(), kBook);
+    rec.stop();
+    REQUIRE(rec.recorded() == 100);
+    REQUIRE(rec.bytes_written() == 0);
+    REQUIRE(rec.current_path().empty());
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("feed_recorder_names_files_per_utc_hour", "[recorder]")
+{
+    // 2024-01-02T03:04:05Z
+    const int64_t wall_ns = int64_t{1704164645} * 1000000000;
+    REQUIRE(FeedRecorder::file_name("rec", "md", wall_ns) == "rec/md-20240102-03.bmd");
+    REQUIRE(FeedRecorder::file_name("rec", "md", wall_ns, 2) == "rec/md-20240102-03_02.bmd");
+    // Later sessions of an hour sort between it and the next hour.
+    REQUIRE(FeedRecorder::file_name("rec", "md", wall_ns) < FeedRecorder::file_name("rec", "md", wall_ns, 1));
+    REQUIRE(FeedRecorder::file_name("rec", "md", wall_ns, 1) < FeedRecorder::file_name("rec", "md", wall_ns + int64_t{3600} * 1000000000));
+}
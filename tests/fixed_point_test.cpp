@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+#include "fixed_point.hpp"
+
+TEST_CASE("fixed_point_parses_decimals_exactly", "[fixed]")
+{
+    Price p;
+    REQUIRE(Price::parse("65432.1", p));
+    REQUIRE(p.raw == 6543210000000);
+    REQUIRE(Price::parse("0.00000001", p));
+    REQUIRE(p.raw == 1);
+    REQUIRE(Price::parse("-0.5", p));
+    REQUIRE(p.raw == -50000000);
+    REQUIRE(Price::parse("7", p));
+    REQUIRE(p.raw == 700000000);
+    REQUIRE(Price::parse("1.234567891", p)); // beyond 8 decimals truncates
+    REQUIRE(p.raw == 123456789);
+
+    REQUIRE_FALSE(Price::parse("", p));
+    REQUIRE_FALSE(Price::parse("-", p));
+    REQUIRE_FALSE(Price::parse("1e5", p));
+    REQUIRE_FALSE(Price::parse("12a", p));
+}
+
+TEST_CASE("fixed_point_rejects_values_beyond_int64", "[fixed]")
+{
+    Price p;
+    REQUIRE(Price::parse("92233720368.54775807", p));
+    REQUIRE(p.raw == INT64_MAX);
+    REQUIRE(Price::parse("-92233720368.54775807", p));
+    REQUIRE(p.raw == -INT64_MAX);
+
+    REQUIRE_FALSE(Price::parse("92233720368.54775808", p));
+    REQUIRE_FALSE(Price::parse("92233720369", p));
+    REQUIRE_FALSE(Price::parse("92233720369.0", p));
+    REQUIRE_FALSE(Price::parse("922337203690", p));
+    REQUIRE_FALSE(Price::parse("99999999999999999999999", p));
+}
+
+TEST_CASE("fixed_point_formats_without_trailing_zeros", "[fixed]")
+{
+    Qty q;
+    REQUIRE(Qty::parse("1.2340", q));
+    REQUIRE(q.str() == "1.234");
+    REQUIRE(Qty::from_raw(0).str() == "0");
+    REQUIRE(Price::from_double(-2.25).str() == "-2.25");
+}
+
+TEST_CASE("fixed_point_rounds_to_step_exactly", "[fixed]")
+{
+    Price tick;
+    REQUIRE(Price::parse("0.001", tick));
+
+    // 1.2345 floors to 1.234 with no residue, unlike std::floor(v / step) * step.
+    const Price v = Price::from_double(1.2345);
+    REQUIRE(v.floor_to(tick).str() == "1.234");
+    REQUIRE(v.ceil_to(tick).str() == "1.235");
+    REQUIRE(v.round_to(tick).str() == "1.235");
+    REQUIRE(v.floor_to(tick).on_grid(tick));
+    REQUIRE_FALSE(v.on_grid(tick));
+
+    // Negative values floor towards -inf.
+    REQUIRE(Price::from_double(-1.2345).floor_to(tick).str() == "-1.235");
+
+    // Values already on the grid and a zero step are left alone.
+    REQUIRE(Price::from_double(1.234).ceil_to(tick).str() == "1.234");
+    REQUIRE(v.floor_to(Price{}) == v);
+
+    Qty lot, min_qty;
+    REQUIRE(Qty::parse("0.1", lot));
+    REQUIRE(Qty::parse("0.25", min_qty));
+    REQUIRE(min_qty.ceil_to(lot).str() == "0.3");
+}
@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "instrument_registry.hpp"
+
+namespace
+{
+    nlohmann::json instrument(const char *symbol, const char *tick, const char *step, const char *min_qty)
+    {
+        return {{"symbol", symbol},
+                {"status", "Trading"},
+                {"priceFilter", {{"tickSize", tick}, {"minPrice", tick}}},
+                {"lotSizeFilter", {{"qtyStep", step}, {"minOrderQty", min_qty}}}};
+    }
+
+    nlohmann::json response(std::vector<nlohmann::json> list)
+    {
+        return {{"retCode", 0}, {"retMsg", "OK"}, {"result", {{"category", "linear"}, {"list", std::move(list)}}}};
+    }
+
+    std::string cache_path(const char *name)
+    {
+        const auto path = std::filesystem::temp_directory_path() / (std::string(name) + "_" + std::to_string(::getpid()) + ".cache");
+        std::filesystem::remove(path);
+        return path.string();
+    }
+} // namespace
+
+TEST_CASE("instrument_items_parse_exact_filters", "[instruments]")
+{
+    InstrumentMeta meta;
+    REQUIRE(parse_instrument_item(instrument("BTCUSDT", "0.10", "0.001", "0.001"), meta));
+    REQUIRE(meta.tick_size == Price::from_double(0.1));
+    REQUIRE(meta.lot_size == Qty::from_double(0.001));
+
+    auto no_min = instrument("BTCUSDT", "0.1", "0.001", "0.001");
+    no_min["lotSizeFilter"].erase("minOrderQty");
+    REQUIRE_FALSE(parse_instrument_item(no_min, meta));
+    REQUIRE_FALSE(parse_instrument_item(instrument("BTCUSDT", "abc", "0.001", "0.001"), meta));
+    REQUIRE_FALSE(parse_instrument_item(nlohmann::json{{"symbol", "BTCUSDT"}}, meta));
+}
+
+TEST_CASE("instrument_registry_starts_from_its_cache_without_fetching", "[instruments]")
+{
+    const auto path = cache_path("instrument_registry_cache");
+    int fetches = 0;
+    InstrumentRegistry::Config cfg;
+    cfg.cache_path = path;
+    {
+        InstrumentRegistry registry(cfg, [&]
+                                    { ++fetches; return response({instrument("SOLUSDT", "0.01", "0.1", "0.1"), instrument("BTCUSDT", "0.1", "0.001", "0.001"), nlohmann::json{{"symbol", "BADUSDT"}}}); });
+        REQUIRE_FALSE(registry.load_cache());
+        REQUIRE(registry.refresh() == 0);
+        REQUIRE(registry.size() == 2); // BADUSDT has no filters
+        REQUIRE(registry.fetched_ms() > 0);
+    }
+    REQUIRE(fetches == 1);
+
+    InstrumentRegistry cached(cfg, [&]() -> nlohmann::json
+                              { ++fetches; throw std::runtime_error("offline"); });
+    REQUIRE(cached.load_cache());
+    REQUIRE(fetches == 1);
+    REQUIRE(cached.size() == 2);
+    REQUIRE(cached.find("BTCUSDT")->tick_size == Price::from_double(0.1));
+    REQUIRE(cached.find("SOLUSDT")->min_qty == Qty::from_double(0.1));
+    REQUIRE_FALSE(cached.find("ETHUSDT"));
+    const int sol = cached.watch("SOLUSDT");
+    REQUIRE(cached.watch("SOLUSDT") == sol);
+    REQUIRE(cached.meta(sol)->lot_size == Qty::from_double(0.1));
+
+    // A failed refresh keeps the cached list.
+    REQUIRE_THROWS(cached.refresh());
+    REQUIRE(cached.size() == 2);
+
+    // Truncated or foreign files are ignored.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    REQUIRE_FALSE(cached.load_cache());
+    std::ofstream(path, std::ios::trunc) << "not a cache file, just some text long enough";
+    REQUIRE_FALSE(cached.load_cache());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("instrument_registry_reports_changed_filters_of_watched_symbols", "[instruments]")
+{
+    const auto path = cache_path("instrument_registry_changes");
+    std::string btc_tick = "0.1";
+    std::string eth_tick = "0.01";
+    InstrumentRegistry::Config cfg;
+    cfg.cache_path = path;
+    InstrumentRegistry registry(cfg, [&]
+                                { return response({instrument("BTCUSDT", btc_tick.c_str(), "0.001", "0.001"), instrument("ETHUSDT", eth_tick.c_str(), "0.01", "0.01")}); });
+    std::vector<std::pair<int, std::string>> seen;
+    Price seen_tick;
+    registry.set_listener([&](int id, const std::string &symbol, const InstrumentMeta &meta)
+                          { seen.emplace_back(id, symbol); seen_tick = meta.tick_size; });
+    const int btc = registry.watch("BTCUSDT"); // before the first list: nothing to compare against yet
+    REQUIRE_FALSE(registry.meta(btc));
+    REQUIRE(registry.refresh() == 0);
+    REQUIRE(registry.meta(btc)->tick_size == Price::from_double(0.1));
+    REQUIRE(registry.refresh() == 0);
+
+    btc_tick = "0.5";
+    eth_tick = "0.05"; // not watched
+    REQUIRE(registry.refresh() == 1);
+    REQUIRE(seen == std::vector<std::pair<int, std::string>>{{btc, "BTCUSDT"}});
+    REQUIRE(seen_tick == Price::from_double(0.5));
+    REQUIRE(registry.refreshes() == 3);
+
+    // The rewritten cache carries the new filters.
+    InstrumentRegistry reloaded(cfg, []
+                                { return nlohmann::json{}; });
+    REQUIRE(reloaded.load_cache());
+    REQUIRE(reloaded.find("BTCUSDT")->tick_size == Price::from_double(0.5));
+    REQUIRE(reloaded.find("ETHUSDT")->tick_size == Price::from_double(0.05));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("instrument_registry_refreshes_in_the_background", "[instruments]")
+{
+    InstrumentRegistry::Config cfg;
+    cfg.refresh_interval = std::chrono::seconds{3600};
+    InstrumentRegistry registry(cfg, []
+                                { return response({instrument("BTCUSDT", "0.1", "0.001", "0.001")}); });
+    registry.start(true);
+    for (int i = 0; i < 2000 && registry.refreshes() == 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    registry.stop(); // wakes the hour-long wait
+    REQUIRE(registry.refreshes() == 1);
+    REQUIRE(registry.find("BTCUSDT"));
+}
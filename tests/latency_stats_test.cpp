@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "latency_stats.hpp"
+
+TEST_CASE("latency_histogram_buckets_stay_within_one_sixteenth", "[latency]")
+{
+    for (uint64_t v : {0ull, 1ull, 15ull, 16ull, 17ull, 31ull, 32ull, 33ull, 999ull, 1000ull, 123456789ull, 1ull << 62, ~0ull})
+    {
+        const int b = LatencyHistogram::bucket_of(v);
+        REQUIRE(b >= 0);
+        REQUIRE(b < LatencyHistogram::kBuckets);
+        const uint64_t high = LatencyHistogram::bucket_high(b);
+        REQUIRE(high >= v);
+        REQUIRE(high - v <= v / 16);
+        if (b > 0)
+            REQUIRE(LatencyHistogram::bucket_high(b - 1) < v);
+    }
+}
+
+TEST_CASE("latency_histogram_reports_percentiles_and_resets", "[latency]")
+{
+    LatencyHistogram h;
+    for (int i = 1; i <= 1000; ++i)
+        h.record(i * 1000); // 1us .. 1ms
+    h.record(-5);           // clock went backwards: counted as 0
+
+    auto s = h.summary();
+    REQUIRE(s.count == 1001);
+    REQUIRE(s.max == 1000000);
+    auto near = [](int64_t got, int64_t want)
+    { return got >= want && got - want <= want / 16; };
+    REQUIRE(near(s.p50, 500000));
+    REQUIRE(near(s.p99, 990000));
+    REQUIRE(s.p999 == 1000000); // capped at the exact max
+
+    s = h.summary(true);
+    REQUIRE(s.count == 1001);
+    s = h.summary();
+    REQUIRE(s.count == 0);
+    REQUIRE(s.max == 0);
+    REQUIRE(s.p99 == 0);
+}
+
+TEST_CASE("latency_histogram_counts_concurrent_records", "[latency]")
+{
+    LatencyHistogram h;
+    std::vector<std::thread> threads;
+    uint64_t drained = 0;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&h, t]
+                             {
+            for (int i = 0; i < 50000; ++i)
+                h.record(t * 100000 + i); });
+    // A reporter draining while the writers run loses nothing.
+    for (int i = 0; i < 20; ++i)
+        drained += h.summary(true).count;
+    for (auto &th : threads)
+        th.join();
+    const auto rest = h.summary(true);
+    REQUIRE(drained + rest.count == 200000);
+}
+
+TEST_CASE("latency_reporter_logs_and_appends_csv", "[latency]")
+{
+    const auto path = std::filesystem::temp_directory_path() / ("latency_stats_test_" + std::to_string(::getpid()) + ".csv");
+    std::filesystem::remove(path);
+    LatencyReporter reporter(path.string());
+    latency_histogram(LatencyStage::WsParse).summary(true);
+    latency_histogram(LatencyStage::TickToTrade).summary(true);
+
+    latency_record(LatencyStage::WsParse, 2000);
+    latency_record(LatencyStage::TickToTrade, 40000);
+    std::ostringstream log;
+    reporter.report(log);
+    REQUIRE(log.str().find("[T2T] ws_parse n=1 p50_us=2 ") != std::string::npos);
+    REQUIRE(log.str().find("[T2T] tick_to_trade n=1 ") != std::string::npos);
+    REQUIRE(log.str().find("order_ack") == std::string::npos); // no samples, no line
+
+    latency_record(LatencyStage::WsParse, 3000);
+    reporter.report(log);
+
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);)
+        lines.push_back(line);
+    REQUIRE(lines.size() == 4);
+    REQUIRE(lines[0] == "wall_ms,stage,count,p50_ns,p99_ns,p999_ns,max_ns");
+    REQUIRE(lines[1].find(",ws_parse,1,2000,2000,2000,2000") != std::string::npos);
+    REQUIRE(lines[3].find(",ws_parse,1,3000,") != std::string::npos);
+    std::filesystem::remove(path);
+}
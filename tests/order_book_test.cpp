@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "order_book.hpp"
+
+namespace
+{
+    Price px(double v) { return Price::from_double(v); }
+    Qty sz(double v) { return Qty::from_double(v); }
+
+    void apply_snapshot(OrderBook &book, uint64_t u)
+    {
+        REQUIRE(book.begin_update(true, u, 100, 0) == OrderBook::ApplyResult::Applied);
+        book.set_bid(px(100.0), sz(1.0));
+        book.set_bid(px(99.5), sz(2.0));
+        book.set_bid(px(99.0), sz(3.0));
+        book.set_ask(px(100.5), sz(1.5));
+        book.set_ask(px(101.0), sz(2.5));
+        REQUIRE(book.end_update() == OrderBook::ApplyResult::Applied);
+    }
+}
+
+TEST_CASE("order_book_snapshot_orders_levels_best_first", "[book]")
+{
+    OrderBook book(50);
+    apply_snapshot(book, 10);
+
+    BookSnapshot snap;
+    book.snapshot(snap);
+    REQUIRE(snap.update_id == 10);
+    REQUIRE(snap.bid_count == 3);
+    REQUIRE(snap.ask_count == 2);
+    REQUIRE(snap.bids[0].price == px(100.0));
+    REQUIRE(snap.bids[2].price == px(99.0));
+    REQUIRE(snap.asks[0].price == px(100.5));
+    REQUIRE(snap.asks[1].price == px(101.0));
+    REQUIRE(snap.mid() == 100.25);
+}
+
+TEST_CASE("order_book_delta_inserts_updates_and_removes", "[book]")
+{
+    OrderBook book(50);
+    apply_snapshot(book, 10);
+
+    REQUIRE(book.begin_update(false, 11, 101, 0) == OrderBook::ApplyResult::Applied);
+    book.set_bid(px(100.0), sz(0.0));  // remove best bid
+    book.set_bid(px(99.75), sz(4.0));  // new best bid
+    book.set_ask(px(101.0), sz(9.0));  // update
+    book.set_ask(px(100.25), sz(1.0)); // new best ask
+    REQUIRE(book.end_update() == OrderBook::ApplyResult::Applied);
+
+    BookLevel bid, ask;
+    REQUIRE(book.best_bid(bid));
+    REQUIRE(book.best_ask(ask));
+    REQUIRE(bid.price == px(99.75));
+    REQUIRE(bid.qty == sz(4.0));
+    REQUIRE(ask.price == px(100.25));
+
+    BookLevel asks[4];
+    REQUIRE(book.asks(asks, 4) == 3);
+    REQUIRE(asks[2].price == px(101.0));
+    REQUIRE(asks[2].qty == sz(9.0));
+}
+
+TEST_CASE("order_book_detects_update_id_gap", "[book]")
+{
+    OrderBook book(50);
+    REQUIRE(book.begin_update(false, 5, 0, 0) == OrderBook::ApplyResult::Ignored);
+
+    apply_snapshot(book, 10);
+    REQUIRE(book.begin_update(false, 10, 0, 0) == OrderBook::ApplyResult::Ignored);
+    REQUIRE(book.begin_update(false, 12, 0, 0) == OrderBook::ApplyResult::Gap);
+    REQUIRE_FALSE(book.in_sync());
+    REQUIRE(book.begin_update(false, 13, 0, 0) == OrderBook::ApplyResult::Ignored);
+
+    apply_snapshot(book, 20);
+    REQUIRE(book.in_sync());
+}
+
+TEST_CASE("order_book_crossed_update_forces_resync", "[book]")
+{
+    OrderBook book(50);
+    apply_snapshot(book, 1);
+    REQUIRE(book.begin_update(false, 2, 0, 0) == OrderBook::ApplyResult::Applied);
+    book.set_bid(px(101.5), sz(1.0));
+    REQUIRE(book.end_update() == OrderBook::ApplyResult::Gap);
+    REQUIRE_FALSE(book.in_sync());
+}
+
+TEST_CASE("order_book_trims_to_max_depth", "[book]")
+{
+    OrderBook book(2);
+    apply_snapshot(book, 1);
+    REQUIRE(book.bid_depth() == 2);
+    BookLevel bids[2];
+    REQUIRE(book.bids(bids, 2) == 2);
+    REQUIRE(bids[1].price == px(99.5));
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "order_request.hpp"
+#include "quote_manager.hpp"
+
+// Replacement operator new/delete counting every heap allocation; bench/alloc_counter.cpp is linked
+// into this test (its header pulls in Google Benchmark, so only the counter is declared here).
+uint64_t allocation_count();
+
+namespace
+{
+    struct AllocCounter
+    {
+        uint64_t start{allocation_count()};
+        uint64_t count() const { return allocation_count() - start; }
+    };
+
+    std::string fixed(int64_t v)
+    {
+        char buf[kMaxFixedChars];
+        return std::string(buf, write_fixed(buf, v));
+    }
+
+    OrderRequest limit(const char *link, double px, double qty, OrderSide side, int pos_idx)
+    {
+        OrderRequest r;
+        r.symbol.assign("BTCUSDT");
+        r.order_link_id.assign(link);
+        r.price = Price::from_double(px);
+        r.qty = Qty::from_double(qty);
+        r.side = side;
+        r.position_idx = static_cast<int8_t>(pos_idx);
+        return r;
+    }
+} // namespace
+
+TEST_CASE("write_fixed_prints_minimal_decimals", "[order_request]")
+{
+    REQUIRE(fixed(to_fixed(100.5)) == "100.5");
+    REQUIRE(fixed(to_fixed(0.01)) == "0.01");
+    REQUIRE(fixed(to_fixed(3.0)) == "3");
+    REQUIRE(fixed(to_fixed(0.00000001)) == "0.00000001");
+    REQUIRE(fixed(to_fixed(-2.25)) == "-2.25");
+    REQUIRE(fixed(0) == "0");
+    REQUIRE(fixed(to_fixed(65432.1)) == "65432.1");
+}
+
+TEST_CASE("fixed_string_truncates_and_compares", "[order_request]")
+{
+    FixedString<8> s("abcdefghij");
+    REQUIRE(s == "abcdefg");
+    REQUIRE(s.size() == 7);
+    OrderLinkId link;
+    format_order_link(link, "bid1", "mm", 1700000000123, 42);
+    REQUIRE(link == "bid1_mm_1700000000123_42");
+
+    // Never above Bybit's 36 characters; the unique suffix survives, the prefix is cut.
+    format_order_link(link, "bid10", "averyverylongtag", 1700000000123, 123456789);
+    REQUIRE(link.size() == kMaxOrderLinkIdLen);
+    REQUIRE(link == "bid10_averyv_1700000000123_123456789");
+    REQUIRE_THROWS_AS(QuoteManager("BTCUSDT", QuoteManager::Config{Price{}, Qty{}, "ninechars"}), std::invalid_argument);
+    REQUIRE_THROWS_AS(QuoteManager("BTCUSDT", QuoteManager::Config{Price{}, Qty{}, "m_m"}), std::invalid_argument);
+    REQUIRE_NOTHROW(QuoteManager("BTCUSDT", QuoteManager::Config{Price{}, Qty{}, "mmlo"}));
+}
+
+TEST_CASE("encode_batch_matches_v5_request_shape", "[order_request]")
+{
+    OrderRequest reqs[2] = {limit("bid1_x", 100.1, 0.01, OrderSide::Buy, 1),
+                            limit("ask1_x", 100.3, 0.02, OrderSide::Sell, 2)};
+    std::string body;
+    encode_batch(OrderAction::Create, "linear", reqs, 2, body);
+    auto j = nlohmann::json::parse(body);
+    REQUIRE(j["category"] == "linear");
+    REQUIRE(j["request"].size() == 2);
+    REQUIRE(j["request"][0]["symbol"] == "BTCUSDT");
+    REQUIRE(j["request"][0]["side"] == "Buy");
+    REQUIRE(j["request"][0]["orderType"] == "Limit");
+    REQUIRE(j["request"][0]["price"] == "100.1");
+    REQUIRE(j["request"][0]["qty"] == "0.01");
+    REQUIRE(j["request"][0]["positionIdx"] == 1);
+    REQUIRE(j["request"][0]["timeInForce"] == "GTC");
+    REQUIRE(j["request"][1]["orderLinkId"] == "ask1_x");
+
+    encode_batch(OrderAction::Amend, "linear", reqs, 1, body);
+    j = nlohmann::json::parse(body);
+    REQUIRE(j["request"][0] == nlohmann::json{{"symbol", "BTCUSDT"}, {"orderLinkId", "bid1_x"}, {"price", "100.1"}, {"qty", "0.01"}});
+
+    encode_batch(OrderAction::Cancel, "linear", reqs + 1, 1, body);
+    j = nlohmann::json::parse(body);
+    REQUIRE(j["request"][0] == nlohmann::json{{"symbol", "BTCUSDT"}, {"orderLinkId", "ask1_x"}});
+
+    OrderRequest market = limit("sl_long_1", 0.0, 0.5, OrderSide::Sell, 2);
+    market.type = OrderType::Market;
+    encode_create("linear", market, body);
+    j = nlohmann::json::parse(body);
+    REQUIRE(j["category"] == "linear");
+    REQUIRE(j["orderType"] == "Market");
+    REQUIRE_FALSE(j.contains("price"));
+}
+
+TEST_CASE("encoding_a_ladder_does_not_allocate", "[order_request]")
+{
+    OrderRequest reqs[kMaxGatewayBatch];
+    for (std::size_t i = 0; i < kMaxGatewayBatch; ++i)
+        reqs[i] = limit("bid1_mm_1700000000000_1", 100.0 - static_cast<double>(i) * 0.1, 0.01, OrderSide::Buy, 1);
+    std::string body;
+    body.reserve(4096);
+
+    AllocCounter counter;
+    for (int tick = 0; tick < 100; ++tick)
+    {
+        for (auto &r : reqs)
+        {
+            r.price += Price::from_raw(10000000);
+            format_order_link(r.order_link_id, "bid1", "mm", 1700000000000 + tick, static_cast<uint64_t>(tick));
+        }
+        encode_batch(OrderAction::Create, "linear", reqs, kMaxGatewayBatch, body);
+        encode_batch(OrderAction::Amend, "linear", reqs, kMaxGatewayBatch, body);
+    }
+    REQUIRE(counter.count() == 0);
+}
+
+TEST_CASE("quote_diff_reaches_zero_allocations_in_steady_state", "[order_request]")
+{
+    // 3-level two-sided ladder plus a take-profit, moving one tick every round.
+    QuoteManager qm("BTCUSDT", QuoteManager::Config{Price::from_double(0.05), Qty::from_double(0.005), "mm"});
+    std::vector<DesiredQuote> desired;
+    const char *slots[] = {"bid1", "ask1", "bid2", "ask2", "bid3", "ask3", "tp_sell"};
+    for (int i = 0; i < 7; ++i)
+    {
+        desired.push_back({slots[i], (i % 2 == 0 && i < 6) ? "Buy" : "Sell", Price::from_double(100.0 + i), Qty::from_double(0.01), 1});
+        qm.on_placed(desired.back(), std::string(slots[i]) + "_link");
+    }
+    QuotePlan plan;
+    std::size_t amends = 0;
+    auto round = [&]
+    {
+        for (auto &d : desired)
+            d.price += Price::from_double(0.1);
+        qm.diff_into(desired, plan);
+        amends += plan.amend.size();
+        for (const auto &a : plan.amend)
+            qm.on_amended(a.order_link_id.view(), a.quote);
+    };
+    round(); // first full re-quote sizes the plan's vectors
+
+    AllocCounter counter;
+    for (int tick = 0; tick < 100; ++tick)
+        round();
+    REQUIRE(counter.count() == 0);
+    REQUIRE(amends == 707);
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "order_store.hpp"
+
+TEST_CASE("order_store_tracks_lifecycle", "[orders]")
+{
+    OrderStore store(16);
+    store.on_submitted("bid1_mm_1", "BTCUSDT", true, 100.0, 0.01);
+
+    OrderRecord rec;
+    REQUIRE(store.get("bid1_mm_1", rec));
+    REQUIRE(rec.state == OrderState::PendingNew);
+    REQUIRE(std::string(rec.symbol) == "BTCUSDT");
+
+    store.on_ack("bid1_mm_1", true, "abc-123");
+    OrderState st;
+    REQUIRE(store.state_of("bid1_mm_1", st));
+    REQUIRE(st == OrderState::New);
+
+    auto d = nlohmann::json::parse(R"({"orderLinkId":"bid1_mm_1","orderId":"abc-123","symbol":"BTCUSDT","side":"Buy",
+        "orderStatus":"PartiallyFilled","price":"100","qty":"0.01","cumExecQty":"0.004","avgPrice":"100","updatedTime":"1700000000100"})");
+    OrderUpdate u;
+    REQUIRE(parse_order_update(d, u));
+    store.apply(u);
+    REQUIRE(store.get("bid1_mm_1", rec));
+    REQUIRE(rec.state == OrderState::PartiallyFilled);
+    REQUIRE(rec.cum_exec_qty == 0.004);
+
+    // Older update arriving late must not regress the state.
+    u.state = OrderState::New;
+    u.updated_ms = 1700000000000;
+    store.apply(u);
+    REQUIRE(store.state_of("bid1_mm_1", st));
+    REQUIRE(st == OrderState::PartiallyFilled);
+
+    u.state = OrderState::Filled;
+    u.updated_ms = 1700000000200;
+    store.apply(u);
+    REQUIRE(store.state_of("bid1_mm_1", st));
+    REQUIRE(is_terminal(st));
+}
+
+TEST_CASE("order_store_rest_rejection", "[orders]")
+{
+    OrderStore store(16);
+    store.on_submitted("ask1_mm_2", "BTCUSDT", false, 101.0, 0.01);
+    store.on_ack("ask1_mm_2", false);
+    OrderState st;
+    REQUIRE(store.state_of("ask1_mm_2", st));
+    REQUIRE(st == OrderState::Rejected);
+}
+
+TEST_CASE("order_store_maps_exchange_statuses", "[orders]")
+{
+    OrderUpdate u;
+    REQUIRE(parse_order_update(nlohmann::json::parse(R"({"orderLinkId":"x","orderStatus":"PartiallyFilledCanceled"})"), u));
+    REQUIRE(u.state == OrderState::Cancelled);
+    REQUIRE_FALSE(parse_order_update(nlohmann::json::parse(R"({"orderStatus":"New"})"), u));
+}
+
+TEST_CASE("order_store_evicts_terminal_orders_when_full", "[orders]")
+{
+    OrderStore store(4);
+    for (int i = 0; i < 4; ++i)
+        store.on_submitted("o" + std::to_string(i), "BTCUSDT", true, 100.0, 1.0);
+    REQUIRE(store.size() == 4);
+
+    // Full of live orders: the insert is dropped.
+    store.on_submitted("o4", "BTCUSDT", true, 100.0, 1.0);
+    REQUIRE(store.dropped() == 1);
+    OrderRecord rec;
+    REQUIRE_FALSE(store.get("o4", rec));
+
+    store.on_ack("o1", false); // rejected -> terminal, evictable
+    store.on_submitted("o5", "BTCUSDT", true, 100.0, 1.0);
+    REQUIRE(store.get("o5", rec));
+    REQUIRE_FALSE(store.get("o1", rec));
+    REQUIRE(store.get("o0", rec));
+    REQUIRE(store.size() == 4);
+}
+
+TEST_CASE("order_store_erase_and_reuse", "[orders]")
+{
+    OrderStore store(8);
+    for (int round = 0; round < 100; ++round)
+    {
+        const std::string id = "link_" + std::to_string(round);
+        store.on_submitted(id, "ETHUSDT", false, 2000.0, 0.1);
+        OrderRecord rec;
+        REQUIRE(store.get(id, rec));
+        REQUIRE(store.erase(id));
+        REQUIRE_FALSE(store.get(id, rec));
+    }
+    REQUIRE(store.size() == 0);
+}
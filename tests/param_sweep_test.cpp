@@ -0,0 +1,197 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include "feed_record.hpp"
+#include "feed_recorder.hpp"
+#include "param_sweep.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace
+{
+    constexpr int64_t kMs = 1000000;
+
+    SweepSpec spec_of(const std::string &text)
+    {
+        std::istringstream in(text);
+        return SweepSpec::parse(in);
+    }
+
+    std::string parse_error(const std::string &text)
+    {
+        try
+        {
+            spec_of(text);
+        }
+        catch (const std::runtime_error &ex)
+        {
+            return ex.what();
+        }
+        return {};
+    }
+}
+
+TEST_CASE("sweep_spec_expands_lists_and_ranges_into_a_grid", "[sweep]")
+{
+    const auto spec = spec_of("# tuning run\n"
+                              "BYBIT_MIN_SPREAD_BPS = 0.1:0.3:0.1\n"
+                              "\n"
+                              "BYBIT_SIDE_MODE = both, long_only  # both strategies\n");
+    REQUIRE_FALSE(spec.random);
+    REQUIRE(spec.axes.size() == 2);
+    REQUIRE(spec.axes[0].values == std::vector<std::string>{"0.1", "0.2", "0.3"});
+
+    const auto points = spec.expand();
+    REQUIRE(points.size() == 6);
+    REQUIRE(points[0] == SweepPoint{{"BYBIT_MIN_SPREAD_BPS", "0.1"}, {"BYBIT_SIDE_MODE", "both"}});
+    REQUIRE(points[1] == SweepPoint{{"BYBIT_MIN_SPREAD_BPS", "0.1"}, {"BYBIT_SIDE_MODE", "long_only"}});
+    REQUIRE(points[5] == SweepPoint{{"BYBIT_MIN_SPREAD_BPS", "0.3"}, {"BYBIT_SIDE_MODE", "long_only"}});
+
+    REQUIRE(parse_error("BYBIT_MIN_SPREAD_BPS = 1\nBYBIT_NOT_A_SETTING = 1\n").find("line 2") != std::string::npos);
+    REQUIRE(parse_error("BYBIT_LADDER_LEVELS = 1.5\n").find("line 1") != std::string::npos);
+    REQUIRE_FALSE(parse_error("BYBIT_SPREAD_FACTOR = 2:1:0.5\n").empty());
+    REQUIRE_FALSE(parse_error("BYBIT_SPREAD_FACTOR = 1, , 2\n").empty());
+    REQUIRE_FALSE(parse_error("BYBIT_SPREAD_FACTOR = 1\nBYBIT_SPREAD_FACTOR = 2\n").empty());
+}
+
+TEST_CASE("sweep_spec_random_mode_draws_distinct_points", "[sweep]")
+{
+    const std::string axes = "BYBIT_MIN_SPREAD_BPS = 0:9:1\nBYBIT_LADDER_LEVELS = 1:10:1\n";
+    const auto a = spec_of("mode = random\nsamples = 25\nseed = 3\n" + axes).expand();
+    const auto b = spec_of("mode = random\nsamples = 25\nseed = 3\n" + axes).expand();
+    REQUIRE(a.size() == 25);
+    REQUIRE(a == b);
+    REQUIRE(std::set<SweepPoint>(a.begin(), a.end()).size() == 25);
+
+    // Asking for more than the grid holds runs the whole grid.
+    REQUIRE(spec_of("mode = random\nsamples = 1000\n" + axes).expand().size() == 100);
+}
+
+TEST_CASE("work_stealing_pool_runs_every_task_and_reports_errors", "[sweep]")
+{
+    WorkStealingPool pool(4);
+    REQUIRE(pool.size() == 4);
+    std::atomic<int> done{0};
+    for (int i = 0; i < 200; ++i)
+        pool.submit([&]
+                    {
+            // Tasks that spawn tasks land on the spawning worker's deque.
+            for (int k = 0; k < 5; ++k)
+                pool.submit([&] { done.fetch_add(1); });
+            done.fetch_add(1); });
+    pool.wait();
+    REQUIRE(done.load() == 1200);
+
+    pool.submit([]
+                { throw std::runtime_error("boom"); });
+    pool.submit([&]
+                { done.fetch_add(1); });
+    REQUIRE_THROWS_AS(pool.wait(), std::runtime_error);
+    REQUIRE(done.load() == 1201);
+    pool.wait();
+}
+
+TEST_CASE("parallel_sweep_matches_serial_replays", "[sweep]")
+{
+    const auto dir = std::filesystem::temp_directory_path() / ("param_sweep_test_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+    {
+        FeedRecorder::Config rc;
+        rc.dir = dir.string();
+        FeedRecorder rec(rc);
+        rec.start();
+        int64_t t = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        rec.record_public(t, R"({"topic":"orderbook.50.BTCUSDT","type":"snapshot","ts":1,"data":{"s":"BTCUSDT","b":[["100.0","5"]],"a":[["100.2","5"]],"u":1,"seq":1}})");
+        for (int i = 0; i < 200; ++i)
+        {
+            const bool up = (i / 10) % 2 == 0;
+            const std::string bid = up ? "100.1" : "99.9";
+            const std::string ask = up ? "100.3" : "100.1";
+            rec.record_public(t += 100 * kMs, R"({"topic":"orderbook.50.BTCUSDT","type":"snapshot","ts":1,"data":{"s":"BTCUSDT","b":[[")" + bid +
+                                                    R"(","5"]],"a":[[")" + ask + R"(","5"]],"u":)" + std::to_string(i + 2) + R"(,"seq":1}})");
+            rec.record_public(t += 50 * kMs, R"({"topic":"publicTrade.BTCUSDT","type":"snapshot","ts":3,"data":[{"T":3,"s":"BTCUSDT","S":")" +
+                                                    std::string(up ? "Sell" : "Buy") + R"(","v":"9","p":")" + (up ? "99.7" : "100.5") + R"("}]})");
+        }
+        rec.stop();
+    }
+
+    Backtester::Config bt;
+    bt.symbol = "BTCUSDT";
+    for (const auto &e : std::filesystem::directory_iterator(dir))
+        bt.files.push_back(e.path().string());
+    std::sort(bt.files.begin(), bt.files.end());
+    bt.sim.meta = InstrumentMeta{Price::from_double(0.1), Qty::from_double(0.01), Qty::from_double(0.01)};
+    std::vector<RecordFileReader> readers(bt.files.size());
+    std::vector<const RecordFileReader *> inputs;
+    for (std::size_t i = 0; i < bt.files.size(); ++i)
+    {
+        readers[i].open(bt.files[i]);
+        readers[i].share();
+        inputs.push_back(&readers[i]);
+    }
+
+    StrategyParams base;
+    base.budget_usd = 100.0;
+    base.max_net_qty = 1.0;
+    const auto spec = spec_of("BYBIT_MIN_SPREAD_BPS = 1, 5, 50\nBYBIT_SIDE_MODE = both, long_only\n");
+    const auto points = spec.expand();
+
+    WorkStealingPool wide(4);
+    WorkStealingPool narrow(1);
+    const auto parallel = run_sweep(bt, base, points, inputs, wide);
+    const auto serial = run_sweep(bt, base, points, inputs, narrow);
+    REQUIRE(parallel.size() == points.size());
+    bool any_fills = false;
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        REQUIRE(parallel[i].error.empty());
+        REQUIRE(parallel[i].index == i);
+        REQUIRE(parallel[i].point == points[i]);
+        REQUIRE(parallel[i].result.messages == 401);
+        REQUIRE(parallel[i].result.fills == serial[i].result.fills);
+        REQUIRE(parallel[i].net_pnl() == serial[i].net_pnl());
+        REQUIRE(parallel[i].result.max_drawdown == serial[i].result.max_drawdown);
+        any_fills = any_fills || parallel[i].result.fills > 0;
+    }
+    REQUIRE(any_fills);
+
+    // The shared readers replay exactly like files opened by the run itself.
+    StrategyParams p0 = base;
+    for (const auto &[name, value] : points[0])
+        REQUIRE(p0.set(name, value));
+    const auto strategy = make_strategy(bt.symbol, bt.sim.meta, p0);
+    const auto direct = Backtester(bt).run(*strategy);
+    REQUIRE(direct.fills == parallel[0].result.fills);
+    REQUIRE(direct.realized == parallel[0].result.realized);
+
+    std::ostringstream csv;
+    write_sweep_csv(csv, spec.axes, parallel);
+    std::istringstream lines(csv.str());
+    std::string line;
+    std::getline(lines, line);
+    REQUIRE(line.rfind("rank,run,BYBIT_MIN_SPREAD_BPS,BYBIT_SIDE_MODE,net_pnl,", 0) == 0);
+    double prev = 1e300;
+    std::size_t rows = 0;
+    while (std::getline(lines, line))
+    {
+        std::istringstream row(line);
+        std::string field;
+        for (int i = 0; i < 5; ++i)
+            std::getline(row, field, ',');
+        const double pnl = std::stod(field);
+        REQUIRE(pnl <= prev);
+        prev = pnl;
+        ++rows;
+    }
+    REQUIRE(rows == points.size());
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "pnl_tracker.hpp"
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    const SymbolId kBtc = SymbolTable::global().intern("BTCUSDT");
+    const SymbolId kEth = SymbolTable::global().intern("ETHUSDT");
+} // namespace
+
+TEST_CASE("pnl_totals_are_exact_running_sums", "[pnl]")
+{
+    PnlTracker pnl;
+    for (int i = 0; i < 100000; ++i)
+        pnl.add_execution("bid1_mm_" + std::to_string(i), 0.1, 0.01, kBtc);
+    pnl.add_funding(-0.25);
+    pnl.set_unrealized(kBtc, 1, 2.0);
+    pnl.set_unrealized(kEth, 2, -0.5);
+    pnl.set_unrealized(kBtc, 1, 1.0); // replaces, does not add
+
+    const auto t = pnl.totals();
+    REQUIRE(t.realized == 10000.0); // fixed-point sum: no drift after 1e5 additions
+    REQUIRE(t.fees == 1000.0);
+    REQUIRE(t.funding == -0.25);
+    REQUIRE(t.unrealized == 0.5);
+
+    pnl.clear_unrealized();
+    REQUIRE(pnl.totals().unrealized == 0.0);
+    REQUIRE(pnl.totals().realized == 10000.0);
+}
+
+TEST_CASE("pnl_evicts_orders_beyond_the_count_limit_into_buckets", "[pnl]")
+{
+    PnlTracker::Config cfg;
+    cfg.max_orders = 3;
+    PnlTracker pnl(cfg);
+    const auto t0 = clock::now();
+    pnl.add_execution("a", 1.0, 0.1, kBtc, t0);
+    pnl.add_execution("b", 2.0, 0.1, kEth, t0);
+    pnl.add_execution("c", 3.0, 0.1, kBtc, t0);
+    pnl.add_execution("a", 1.0, 0.1, kBtc, t0); // touch: "b" is now the oldest
+    pnl.add_execution("d", 4.0, 0.1, kBtc, t0);
+
+    REQUIRE(pnl.tracked_orders() == 3);
+    REQUIRE_FALSE(pnl.order("b"));
+    const auto a = pnl.order("a");
+    REQUIRE(a);
+    REQUIRE(a->realized == 2.0);
+    REQUIRE(a->fills == 2);
+    const auto eth = pnl.bucket(kEth);
+    REQUIRE(eth);
+    REQUIRE(eth->realized == 2.0);
+    REQUIRE(eth->orders == 1);
+    REQUIRE(pnl.bucket(kBtc)->orders == 0); // known, nothing evicted yet
+    REQUIRE_FALSE(pnl.bucket(SymbolTable::global().intern("SOLUSDT")));
+    REQUIRE_FALSE(pnl.bucket(kNoSymbol));
+    // Totals include evicted orders.
+    REQUIRE(pnl.totals().realized == 11.0);
+    REQUIRE(pnl.totals().fees == 0.5);
+}
+
+TEST_CASE("pnl_evicts_idle_orders_by_age", "[pnl]")
+{
+    PnlTracker::Config cfg;
+    cfg.max_order_age = std::chrono::seconds{60};
+    PnlTracker pnl(cfg);
+    const auto t0 = clock::now();
+    pnl.add_execution("old", 1.0, 0.0, kBtc, t0);
+    pnl.add_execution("kept", 1.0, 0.0, kBtc, t0 + std::chrono::seconds{30});
+    pnl.add_execution("new", 1.0, 0.0, kBtc, t0 + std::chrono::seconds{61});
+
+    REQUIRE_FALSE(pnl.order("old"));
+    REQUIRE(pnl.order("kept"));
+    REQUIRE(pnl.tracked_orders() == 2);
+    REQUIRE(pnl.bucket(kBtc)->fills == 1);
+    REQUIRE(pnl.totals().realized == 3.0);
+}
+
+TEST_CASE("pnl_totals_read_consistently_while_written", "[pnl]")
+{
+    PnlTracker pnl;
+    std::atomic<bool> done{false};
+    std::thread writer([&]
+                       {
+                           for (int i = 0; i < 20000; ++i)
+                               pnl.add_execution("o" + std::to_string(i % 5000), 1.0, 1.0, kBtc);
+                           done = true;
+                       });
+    bool consistent = true;
+    while (!done)
+    {
+        const auto t = pnl.totals();
+        consistent = consistent && t.realized == t.fees; // both fields come from the same update
+    }
+    writer.join();
+    REQUIRE(consistent);
+    REQUIRE(pnl.totals().realized == 20000.0);
+    REQUIRE(pnl.tracked_orders() == 4096);
+}
@@ -0,0 +1,293 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "latency_stats.hpp"
+#include "quote_manager.hpp"
+#include "strategy.hpp"
+
+namespace
+{
+    Price px(double v) { return Price::from_double(v); }
+    Qty sz(double v) { return Qty::from_double(v); }
+
+    QuoteManager make_manager()
+    {
+        // tick 0.1: tolerance half a tick so any one-tick move amends; lot 0.01.
+        return QuoteManager("BTCUSDT", QuoteManager::Config{px(0.05), sz(0.005), "mm"});
+    }
+
+    // Acks every order call, except that cancels get `cancel_code` per item. Records the ops sent.
+    class ScriptedTransport : public ITradeTransport
+    {
+    public:
+        explicit ScriptedTransport(int &cancel_code, std::vector<std::string> *ops = nullptr) : cancel_code_(cancel_code), ops_(ops) {}
+
+        bool ready() const override { return true; }
+        bool supports_cancel_all() const override { return true; }
+
+        std::string request(const std::string &op, const std::string &args_json) override
+        {
+            if (ops_)
+                ops_->push_back(op);
+            const auto args = nlohmann::json::parse(args_json);
+            nlohmann::json ext = nlohmann::json::array();
+            if (args.contains("request"))
+                for (std::size_t i = 0; i < args["request"].size(); ++i)
+                    ext.push_back({{"code", op == "order.cancel-batch" ? cancel_code_ : 0}, {"msg", ""}});
+            return nlohmann::json{{"retCode", 0}, {"retMsg", "OK"}, {"result", nlohmann::json::object()}, {"retExtInfo", {{"list", ext}}}}.dump();
+        }
+
+    private:
+        int &cancel_code_;
+        std::vector<std::string> *ops_;
+    };
+
+    MarketDataSnapshot snapshot(double bid, double ask)
+    {
+        MarketDataSnapshot snap;
+        snap.symbol = "BTCUSDT";
+        snap.book.bid_count = 1;
+        snap.book.ask_count = 1;
+        snap.book.bids[0] = {px(bid), sz(1.0)};
+        snap.book.asks[0] = {px(ask), sz(1.0)};
+        return snap;
+    }
+} // namespace
+
+TEST_CASE("quote_manager_places_everything_when_flat", "[quotes]")
+{
+    auto qm = make_manager();
+    std::vector<DesiredQuote> desired{{"bid1", "Buy", px(100.0), sz(0.01), 1}, {"ask1", "Sell", px(100.2), sz(0.01), 2}};
+    auto plan = qm.diff(desired);
+    REQUIRE(plan.place.size() == 2);
+    REQUIRE(plan.amend.empty());
+    REQUIRE(plan.cancel.empty());
+}
+
+TEST_CASE("quote_manager_keeps_amends_and_cancels_minimally", "[quotes]")
+{
+    auto qm = make_manager();
+    qm.on_placed({"bid1", "Buy", px(100.0), sz(0.01), 1}, "bid1_a");
+    qm.on_placed({"ask1", "Sell", px(100.2), sz(0.01), 2}, "ask1_a");
+    qm.on_placed({"bid2", "Buy", px(99.9), sz(0.01), 1}, "bid2_a");
+
+    std::vector<DesiredQuote> desired{
+        {"bid1", "Buy", px(100.0), sz(0.01), 1},     // unchanged -> keep
+        {"ask1", "Sell", px(100.3), sz(0.01), 2},    // moved one tick -> amend
+        {"tp_sell", "Sell", px(100.4), sz(0.01), 2}, // new slot -> place
+    };                                       // bid2 no longer wanted -> cancel
+    auto plan = qm.diff(desired);
+
+    REQUIRE(plan.place.size() == 1);
+    REQUIRE(plan.place[0].slot == "tp_sell");
+    REQUIRE(plan.amend.size() == 1);
+    REQUIRE(plan.amend[0].order_link_id == "ask1_a");
+    REQUIRE(plan.amend[0].quote.price == px(100.3));
+    REQUIRE(plan.cancel.size() == 1);
+    REQUIRE(plan.cancel[0] == "bid2_a");
+}
+
+TEST_CASE("quote_manager_ignores_moves_within_tolerance", "[quotes]")
+{
+    auto qm = make_manager();
+    qm.on_placed({"bid1", "Buy", px(100.0), sz(0.01), 1}, "bid1_a");
+    auto plan = qm.diff({{"bid1", "Buy", px(100.0000001), sz(0.0100001), 1}});
+    REQUIRE(plan.empty());
+}
+
+TEST_CASE("quote_manager_replaces_slot_that_changes_side", "[quotes]")
+{
+    auto qm = make_manager();
+    qm.on_placed({"tp", "Sell", px(100.4), sz(0.01), 2}, "tp_a");
+    auto plan = qm.diff({{"tp", "Buy", px(99.6), sz(0.01), 1}});
+    REQUIRE(plan.cancel.size() == 1);
+    REQUIRE(plan.cancel[0] == "tp_a");
+    REQUIRE(plan.place.size() == 1);
+    REQUIRE(plan.amend.empty());
+}
+
+TEST_CASE("quote_manager_forgets_gone_orders", "[quotes]")
+{
+    auto qm = make_manager();
+    qm.on_placed({"bid1", "Buy", px(100.0), sz(0.01), 1}, "bid1_a");
+    qm.on_gone("bid1_a");
+    REQUIRE(qm.working().empty());
+    auto plan = qm.diff({{"bid1", "Buy", px(100.0), sz(0.01), 1}});
+    REQUIRE(plan.place.size() == 1);
+}
+
+TEST_CASE("quote_manager_reconciles_against_order_store", "[quotes]")
+{
+    auto qm = make_manager();
+    OrderStore store(16);
+    qm.on_placed({"bid1", "Buy", px(100.0), sz(0.01), 1}, "bid1_a");
+    qm.on_placed({"ask1", "Sell", px(100.2), sz(0.01), 2}, "ask1_a");
+    store.on_submitted("bid1_a", "BTCUSDT", true, 100.0, 0.01);
+    store.on_ack("bid1_a", true);
+
+    OrderUpdate filled;
+    filled.order_link_id = "ask1_a";
+    filled.state = OrderState::Filled;
+    filled.updated_ms = 1;
+    store.apply(filled);
+
+    qm.reconcile(store);
+    REQUIRE(qm.working().size() == 1);
+    REQUIRE(qm.working()[0].order_link_id == "bid1_a");
+}
+
+TEST_CASE("quote_manager_retries_cancels_that_did_not_take", "[quotes]")
+{
+    int cancel_code = 0;
+    TradingHelper helper("key", "secret", "linear", "http://127.0.0.1:1");
+    helper.set_trade_transport(std::make_unique<ScriptedTransport>(cancel_code));
+    auto qm = make_manager();
+    qm.sync({{"bid1", "Buy", px(100.0), sz(0.01), 1}}, helper);
+    REQUIRE(qm.working().size() == 1);
+    const OrderLinkId link = qm.working()[0].order_link_id;
+
+    // Rate limited: the order still rests, so the next round cancels it again.
+    cancel_code = 10006;
+    qm.sync({}, helper);
+    REQUIRE(qm.working().empty());
+    auto plan = qm.diff({});
+    REQUIRE(plan.cancel.size() == 1);
+    REQUIRE(plan.cancel[0] == link);
+
+    // Already filled or cancelled: nothing left to cancel.
+    cancel_code = 110001;
+    qm.sync({}, helper);
+    REQUIRE(qm.diff({}).cancel.empty());
+}
+
+TEST_CASE("quote_manager_keeps_slots_whose_amend_was_rate_limited", "[quotes]")
+{
+    int cancel_code = 0;
+    std::vector<std::string> ops;
+    TradingHelper helper("key", "secret", "linear", "http://127.0.0.1:1");
+    helper.set_trade_transport(std::make_unique<ScriptedTransport>(cancel_code, &ops));
+    auto qm = make_manager();
+    qm.sync({{"bid1", "Buy", px(100.0), sz(0.01), 1}}, helper);
+    REQUIRE(qm.working().size() == 1);
+    const OrderLinkId link = qm.working()[0].order_link_id;
+
+    // The exchange reported the amend window exhausted for the next minute.
+    RateLimitHeaders blocked;
+    blocked.remaining = 0;
+    const int64_t wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    blocked.reset_ms = wall_ms + 60000;
+    helper.rate_limiter().on_response(RateEndpoint::Amend, blocked, latency_now_ns(), wall_ms);
+
+    ops.clear();
+    qm.sync({{"bid1", "Buy", px(100.1), sz(0.01), 1}}, helper);
+    REQUIRE(ops.empty()); // refused locally, nothing sent
+    REQUIRE(qm.working().size() == 1);
+    REQUIRE(qm.working()[0].order_link_id == link);
+    REQUIRE(qm.working()[0].quote.price == px(100.0));
+    const auto plan = qm.diff({{"bid1", "Buy", px(100.1), sz(0.01), 1}});
+    REQUIRE(plan.cancel.empty()); // no cancel + create
+    REQUIRE(plan.place.empty());
+    REQUIRE(plan.amend.size() == 1);
+}
+
+TEST_CASE("quote_manager_cancels_resting_quotes_when_the_kill_switch_trips", "[quotes]")
+{
+    int cancel_code = 0;
+    std::vector<std::string> ops;
+    TradingHelper helper("key", "secret", "linear", "http://127.0.0.1:1");
+    helper.set_trade_transport(std::make_unique<ScriptedTransport>(cancel_code, &ops));
+    auto qm = make_manager();
+    const std::vector<DesiredQuote> ladder{{"bid1", "Buy", px(100.0), sz(0.01), 1}};
+    qm.sync(ladder, helper);
+    REQUIRE(qm.working().size() == 1);
+
+    // The quote has not moved, so without the kill switch there is nothing to send.
+    ops.clear();
+    qm.sync(ladder, helper);
+    REQUIRE(ops.empty());
+
+    helper.risk().kill();
+    qm.sync(ladder, helper);
+    REQUIRE(ops == std::vector<std::string>{"order.cancel-all"});
+    REQUIRE(qm.working().empty());
+
+    // Nothing is quoted again while the switch stays tripped.
+    ops.clear();
+    qm.sync(ladder, helper);
+    REQUIRE(ops.empty());
+    REQUIRE(qm.working().empty());
+}
+
+TEST_CASE("quote_manager_cancels_unknown_creates_that_land_late", "[quotes]")
+{
+    auto qm = make_manager();
+    OrderStore store(16);
+    // The helper recorded both creates and resolved them as refused after cancelling by orderLinkId.
+    for (const char *link : {"bid1_a", "ask1_a"})
+    {
+        store.on_submitted(link, "BTCUSDT", true, 100.0, 0.01);
+        store.on_ack(link, false);
+        qm.on_create_unknown(link);
+    }
+    qm.reconcile(store);
+    REQUIRE(qm.diff({}).cancel.empty()); // nothing reported by the order stream yet
+
+    // bid1_a reached the matching engine after the cancel; ask1_a filled on arrival.
+    OrderUpdate u;
+    u.order_link_id = "bid1_a";
+    u.symbol = "BTCUSDT";
+    u.state = OrderState::New;
+    u.updated_ms = 1;
+    store.apply(u);
+    u.order_link_id = "ask1_a";
+    u.state = OrderState::Filled;
+    store.apply(u);
+
+    qm.reconcile(store);
+    const auto plan = qm.diff({});
+    REQUIRE(plan.cancel.size() == 1);
+    REQUIRE(plan.cancel[0] == "bid1_a");
+    REQUIRE(qm.working().empty()); // not a ladder slot: the order is cancelled, not adopted
+
+    // Once the stream reports it cancelled, nothing is queued for it any more.
+    u.order_link_id = "bid1_a";
+    u.state = OrderState::Cancelled;
+    u.updated_ms = 2;
+    store.apply(u);
+    qm.reconcile(store);
+    REQUIRE(qm.diff({}).cancel.empty());
+}
+
+TEST_CASE("stop_loss_sends_one_exit_until_the_position_changes", "[quotes]")
+{
+    int cancel_code = 0;
+    std::vector<std::string> ops;
+    TradingHelper helper("key", "secret", "linear", "http://127.0.0.1:1");
+    helper.set_trade_transport(std::make_unique<ScriptedTransport>(cancel_code, &ops));
+    const InstrumentMeta meta{px(0.1), sz(0.01), sz(0.01)};
+    // 100 bps stop: a long entered at 100 stops out below 99.
+    ExampleMarketMakerStrategy strategy("BTCUSDT", meta, 100.0, 1.0, 1.0, 1, 2, 50.0, 0.5, 1, 100.0);
+    PositionView pos;
+    pos.long_size = 0.5;
+    pos.long_entry = 100.0;
+    auto exits = [&]
+    { return std::count(ops.begin(), ops.end(), "order.create"); }; // quotes go out as create-batch
+
+    // The stop stays triggered on every dispatch until the position update arrives.
+    for (int i = 0; i < 5; ++i)
+        strategy.on_snapshot(snapshot(98.0, 98.2), helper, true, pos);
+    REQUIRE(exits() == 1);
+
+    // Partly filled: the rest is flattened once.
+    pos.long_size = 0.2;
+    for (int i = 0; i < 5; ++i)
+        strategy.on_snapshot(snapshot(98.0, 98.2), helper, true, pos);
+    REQUIRE(exits() == 2);
+}
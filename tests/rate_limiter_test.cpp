@@ -0,0 +1,156 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "latency_stats.hpp"
+#include "rate_limiter.hpp"
+#include "trading_helper.hpp"
+
+namespace
+{
+    constexpr int64_t kMs = 1000000;
+    constexpr int64_t kSec = 1000 * kMs;
+
+    int64_t wall_ms()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    OrderRequest limit(const char *link, double price)
+    {
+        OrderRequest r;
+        r.symbol.assign("BTCUSDT");
+        r.order_link_id.assign(link);
+        r.side = OrderSide::Buy;
+        r.price = Price::from_double(price);
+        r.qty = Qty::from_double(1.0);
+        return r;
+    }
+} // namespace
+
+TEST_CASE("rate_limit_headers_are_parsed_from_rest_and_h2_lines", "[rate]")
+{
+    RateLimitHeaders h;
+    REQUIRE_FALSE(h.present());
+    REQUIRE(parse_rate_limit_header("X-Bapi-Limit: 20\r\n", h));
+    REQUIRE(parse_rate_limit_header("x-bapi-limit-status: 7\r\n", h));
+    REQUIRE(parse_rate_limit_header("X-Bapi-Limit-Reset-Timestamp:1700000000123", h));
+    REQUIRE_FALSE(parse_rate_limit_header("Content-Type: application/json\r\n", h));
+    REQUIRE_FALSE(parse_rate_limit_header("HTTP/2 200\r\n", h));
+    REQUIRE(h.present());
+    REQUIRE(h.limit == 20);
+    REQUIRE(h.remaining == 7);
+    REQUIRE(h.reset_ms == 1700000000123);
+}
+
+TEST_CASE("rate_limiter_keeps_a_reserve_for_cancels_and_exits", "[rate]")
+{
+    RateLimiter limiter; // 10/s per endpoint, quotes leave 2 untouched
+    const int64_t t = 5 * kSec;
+    REQUIRE(limiter.acquire(RateEndpoint::Create, 5, RatePriority::Quote, t) == 0);
+    REQUIRE(limiter.acquire(RateEndpoint::Create, 4, RatePriority::Quote, t) > 0); // would dip into the reserve
+    REQUIRE(limiter.acquire(RateEndpoint::Create, 4, RatePriority::Exit, t) == 0);
+    REQUIRE(limiter.acquire(RateEndpoint::Cancel, 10, RatePriority::Cancel, t) == 0); // its own bucket
+
+    // One token left; a quote of one needs three, i.e. 200 ms of refill.
+    REQUIRE(limiter.acquire(RateEndpoint::Create, 1, RatePriority::Quote, t) == 200 * kMs);
+    REQUIRE(limiter.acquire(RateEndpoint::Create, 1, RatePriority::Quote, t + 200 * kMs) == 0);
+    REQUIRE(limiter.throttled() == 2);
+    REQUIRE(limiter.granted() == 4);
+}
+
+TEST_CASE("rate_limiter_follows_the_exchange_headers", "[rate]")
+{
+    RateLimiter limiter;
+    const int64_t t = 5 * kSec;
+    const int64_t wall = 1700000000000;
+
+    // Remaining below our own count wins; above it is ignored (sends since then are not in it).
+    RateLimitHeaders h;
+    h.limit = 10;
+    h.remaining = 3;
+    limiter.on_response(RateEndpoint::Amend, h, t, wall);
+    REQUIRE(limiter.available(RateEndpoint::Amend, t) == 3.0);
+    h.remaining = 9;
+    limiter.on_response(RateEndpoint::Amend, h, t, wall);
+    REQUIRE(limiter.available(RateEndpoint::Amend, t) == 3.0);
+
+    // An exhausted window blocks even cancels until its reset; a larger limit resizes the bucket.
+    h.limit = 20;
+    h.remaining = 0;
+    h.reset_ms = wall + 400;
+    limiter.on_response(RateEndpoint::Cancel, h, t, wall);
+    REQUIRE(limiter.acquire(RateEndpoint::Cancel, 1, RatePriority::Cancel, t) == 400 * kMs);
+    REQUIRE(limiter.acquire(RateEndpoint::Cancel, 8, RatePriority::Cancel, t + 400 * kMs) == 0); // 20/s * 0.4 s
+    REQUIRE(limiter.header_updates() == 3);
+
+    // Responses without the headers change nothing.
+    limiter.on_response(RateEndpoint::Create, RateLimitHeaders{}, t, wall);
+    REQUIRE(limiter.header_updates() == 3);
+}
+
+TEST_CASE("rate_limiter_shares_the_ip_budget_across_endpoints", "[rate]")
+{
+    RateLimiter::Config cfg;
+    cfg.ip_per_sec = 1.0;
+    cfg.ip_burst = 3.0;
+    RateLimiter limiter(cfg);
+    const int64_t t = 5 * kSec;
+    REQUIRE(limiter.acquire(RateEndpoint::Create, 1, RatePriority::Exit, t) == 0);
+    REQUIRE(limiter.acquire(RateEndpoint::Amend, 1, RatePriority::Exit, t) == 0);
+    REQUIRE(limiter.acquire(RateEndpoint::Cancel, 1, RatePriority::Cancel, t) == 0);
+    REQUIRE(limiter.acquire(RateEndpoint::CancelAll, 1, RatePriority::Cancel, t) == kSec);
+}
+
+TEST_CASE("throttled_quotes_are_refused_or_superseded_without_being_sent", "[rate]")
+{
+    // Unroutable base URL: only the final cancel-all ever reaches the network (and fails there).
+    TradingHelper helper("key", "secret", "linear", "http://127.0.0.1:1");
+    RateLimitHeaders blocked;
+    blocked.remaining = 0;
+    blocked.reset_ms = wall_ms() + 60000;
+    helper.rate_limiter().on_response(RateEndpoint::Create, blocked, latency_now_ns(), wall_ms());
+    helper.rate_limiter().on_response(RateEndpoint::Amend, blocked, latency_now_ns(), wall_ms());
+
+    const OrderRequest create[1] = {limit("b1", 100.0)};
+    const auto raw = helper.batch_submit_orders(create, 1);
+    REQUIRE(raw.find("10006") != std::string::npos);
+    REQUIRE(TradingHelper::batch_item_results(raw, 1) == std::vector<bool>{false});
+    OrderRecord rec;
+    REQUIRE_FALSE(helper.orders().get("b1", rec));
+
+    helper.enable_async_gateway();
+    std::vector<GatewayResult> done;
+    auto collect = [&](const GatewayResult &r)
+    { done.push_back(r); };
+    const OrderRequest amend1[1] = {limit("b0", 99.0)};
+    const OrderRequest amend2[1] = {limit("b0", 98.0)};
+    REQUIRE(helper.async_batch_submit_orders(create, 1, collect));
+    REQUIRE(helper.async_batch_amend_orders(amend1, 1, collect));
+    REQUIRE(helper.async_batch_amend_orders(amend2, 1, collect)); // supersedes amend1
+    REQUIRE(helper.async_cancel_all("BTCUSDT", collect));        // supersedes the rest
+    for (int i = 0; i < 2000 && done.size() < 4; ++i)
+    {
+        helper.poll_async();
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    }
+    REQUIRE(done.size() == 4);
+    REQUIRE(done[0].op == GatewayOp::AmendBatch);
+    REQUIRE(done[0].superseded);
+    for (std::size_t i = 1; i < 3; ++i)
+    {
+        REQUIRE(done[i].superseded);
+        REQUIRE_FALSE(done[i].ok);
+        REQUIRE(done[i].error.empty());
+    }
+    REQUIRE(done[3].op == GatewayOp::CancelAll);
+    REQUIRE_FALSE(done[3].superseded);
+    REQUIRE(helper.gateway()->superseded() == 3);
+    // The never-sent create no longer counts as working.
+    OrderState st;
+    REQUIRE(helper.orders().state_of("b1", st));
+    REQUIRE(is_terminal(st));
+}
@@ -0,0 +1,275 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "risk_engine.hpp"
+#include "trading_helper.hpp"
+
+namespace
+{
+    constexpr int64_t kSec = 1000000000;
+
+    Price px(double v) { return Price::from_double(v); }
+    Qty sz(double v) { return Qty::from_double(v); }
+
+    OrderRequest limit(const char *link, OrderSide side, double price, double qty, const char *symbol = "BTCUSDT")
+    {
+        OrderRequest r;
+        r.symbol.assign(symbol);
+        r.order_link_id.assign(link);
+        r.side = side;
+        r.price = px(price);
+        r.qty = sz(qty);
+        return r;
+    }
+
+    OrderRequest market(const char *link, OrderSide side, double qty)
+    {
+        OrderRequest r = limit(link, side, 0.0, qty);
+        r.type = OrderType::Market;
+        return r;
+    }
+
+    // An order connection that drops every request, leaving the outcome unknown.
+    class DeadTransport : public ITradeTransport
+    {
+    public:
+        bool ready() const override { return true; }
+        std::string request(const std::string &, const std::string &) override { throw std::runtime_error("connection lost"); }
+    };
+
+    RiskEngine::Config config()
+    {
+        RiskEngine::Config cfg;
+        cfg.limits.max_order_notional = 1000.0;   // 10 @ 100
+        cfg.limits.max_working_notional = 1500.0; // per side
+        cfg.limits.max_position_notional = 2000.0;
+        cfg.limits.price_band_bps = 500.0; // 95 .. 105
+        cfg.limits.fat_finger_bps = 50.0;  // buys <= 100.5, sells >= 99.5
+        return cfg;
+    }
+} // namespace
+
+TEST_CASE("risk_checks_single_order_limits_against_the_mid", "[risk]")
+{
+    RiskEngine risk(config());
+    const int btc = risk.add_symbol("BTCUSDT");
+    REQUIRE(risk.enabled());
+
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 99.0, 1.0), 0) == RiskCheck::NoReference);
+    risk.set_mid(btc, px(100.0));
+
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 99.0, 1.0), 0) == RiskCheck::Ok);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Sell, 101.0, 10.0), 0) == RiskCheck::Ok);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Sell, 101.0, 10.5), 0) == RiskCheck::OrderSize);
+    REQUIRE(risk.check_new(market("a", OrderSide::Buy, 11.0), 0) == RiskCheck::OrderSize);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 100.6, 1.0), 0) == RiskCheck::FatFinger);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Sell, 100.6, 1.0), 0) == RiskCheck::Ok);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Sell, 99.4, 1.0), 0) == RiskCheck::FatFinger);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 94.9, 1.0), 0) == RiskCheck::PriceBand);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Sell, 105.1, 1.0), 0) == RiskCheck::PriceBand);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 99.0, 1.0, "ETHUSDT"), 0) == RiskCheck::UnknownSymbol);
+
+    // Bands move with the mid.
+    risk.set_mid(btc, px(200.0));
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 99.0, 1.0), 0) == RiskCheck::PriceBand);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 199.0, 5.0), 0) == RiskCheck::Ok);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 199.0, 5.1), 0) == RiskCheck::OrderSize);
+
+    REQUIRE(risk.refused(RiskCheck::FatFinger) == 2);
+    REQUIRE(risk.accepted() == 4);
+}
+
+TEST_CASE("risk_counts_open_orders_from_the_order_store", "[risk]")
+{
+    RiskEngine risk(config());
+    const int btc = risk.add_symbol("BTCUSDT");
+    risk.set_mid(btc, px(100.0));
+    OrderStore orders(64);
+    orders.set_exposure_sink(&risk);
+
+    // Working notional per side: 1500.
+    REQUIRE(risk.check_new(limit("b1", OrderSide::Buy, 99.0, 8.0), 0) == RiskCheck::Ok);
+    orders.on_submitted("b1", "BTCUSDT", true, 99.0, 8.0); // 792 working
+    REQUIRE(risk.exposure(btc).open_buy == sz(8.0));
+    REQUIRE(risk.exposure(btc).open_buy_notional == to_fixed(792.0));
+    REQUIRE(risk.check_new(limit("b2", OrderSide::Buy, 99.0, 8.0), 0) == RiskCheck::WorkingNotional);
+    REQUIRE(risk.check_new(limit("s1", OrderSide::Sell, 101.0, 8.0), 0) == RiskCheck::Ok); // other side
+
+    // A rejected or filled order stops counting.
+    orders.on_ack("b1", false);
+    REQUIRE(risk.exposure(btc).open_buy.is_zero());
+    REQUIRE(risk.exposure(btc).open_buy_notional == 0);
+
+    orders.on_submitted("b2", "BTCUSDT", true, 99.0, 8.0);
+    OrderUpdate fill;
+    fill.order_link_id = "b2";
+    fill.symbol = "BTCUSDT";
+    fill.is_buy = true;
+    fill.price = 99.0;
+    fill.qty = 8.0;
+    fill.cum_exec_qty = 3.0;
+    fill.state = OrderState::PartiallyFilled;
+    fill.updated_ms = 1;
+    orders.apply(fill);
+    REQUIRE(risk.exposure(btc).open_buy == sz(5.0));
+
+    // Projected position: max 20 at mid 100, counting the position and every open buy.
+    risk.set_position("BTCUSDT", sz(10.0));
+    REQUIRE(risk.check_new(limit("b3", OrderSide::Buy, 99.0, 5.0), 0) == RiskCheck::Ok);    // 10 + 5 + 5
+    REQUIRE(risk.check_new(limit("b3", OrderSide::Buy, 99.0, 5.5), 0) == RiskCheck::Position); // 10 + 5 + 5.5
+    REQUIRE(risk.check_new(market("s2", OrderSide::Sell, 10.0), 0) == RiskCheck::Ok);
+
+    // Amends are checked net of what the order already counts for (qty is the new total, 3 filled).
+    risk.set_position("BTCUSDT", sz(14.0));
+    OrderRecord b2;
+    REQUIRE(orders.get("b2", b2));
+    REQUIRE(risk.check_amend(limit("b2", OrderSide::Buy, 98.0, 9.0), b2, 0) == RiskCheck::Ok);       // 14 + 6
+    REQUIRE(risk.check_amend(limit("b2", OrderSide::Buy, 98.0, 9.5), b2, 0) == RiskCheck::Position); // 14 + 6.5
+
+    fill.cum_exec_qty = 8.0;
+    fill.state = OrderState::Filled;
+    fill.updated_ms = 2;
+    orders.apply(fill);
+    REQUIRE(risk.exposure(btc).open_buy.is_zero());
+    REQUIRE(risk.exposure(btc).open_buy_notional == 0);
+}
+
+TEST_CASE("risk_limits_the_message_rate", "[risk]")
+{
+    RiskEngine::Config cfg;
+    cfg.max_msgs_per_sec = 10.0;
+    RiskEngine risk(cfg);
+    risk.add_symbol("BTCUSDT");
+
+    int64_t now = 5 * kSec;
+    int passed = 0;
+    for (int i = 0; i < 20; ++i)
+        passed += risk.check_new(limit("a", OrderSide::Buy, 100.0, 1.0), now) == RiskCheck::Ok;
+    REQUIRE(passed == 10); // one second's burst
+    REQUIRE(risk.refused(RiskCheck::MessageRate) == 10);
+
+    now += kSec / 10; // refills one message
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 100.0, 1.0), now) == RiskCheck::Ok);
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 100.0, 1.0), now) == RiskCheck::MessageRate);
+}
+
+TEST_CASE("risk_kill_switch_only_lets_position_reducing_orders_through", "[risk]")
+{
+    RiskEngine risk(config());
+    const int btc = risk.add_symbol("BTCUSDT");
+    risk.set_mid(btc, px(100.0));
+    risk.set_position("BTCUSDT", sz(3.0));
+    risk.kill();
+    REQUIRE(risk.killed());
+
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 99.0, 1.0), 0) == RiskCheck::KillSwitch);
+    REQUIRE(risk.check_new(market("a", OrderSide::Sell, 3.0), 0) == RiskCheck::Ok);
+    REQUIRE(risk.check_new(market("a", OrderSide::Sell, 4.0), 0) == RiskCheck::KillSwitch); // would flip short
+    OrderRecord working;
+    working.state = OrderState::New;
+    working.is_buy = false;
+    working.price = 101.0;
+    working.qty = 1.0;
+    REQUIRE(risk.check_amend(limit("a", OrderSide::Sell, 101.0, 0.5), working, 0) == RiskCheck::KillSwitch);
+
+    risk.reset_kill();
+    REQUIRE(risk.check_new(limit("a", OrderSide::Buy, 99.0, 1.0), 0) == RiskCheck::Ok);
+}
+
+TEST_CASE("risk_kill_switch_admits_the_stop_loss_behind_resting_take_profits", "[risk]")
+{
+    RiskEngine risk(config());
+    const int btc = risk.add_symbol("BTCUSDT");
+    risk.set_mid(btc, px(100.0));
+    OrderStore orders(64);
+    orders.set_exposure_sink(&risk);
+    risk.set_position("BTCUSDT", sz(2.0));
+    orders.on_submitted("tp_sell", "BTCUSDT", false, 101.0, 1.0);
+    risk.kill();
+
+    // Long 2 with 1 resting to sell: the full-size exit projects to -1 but only flattens the position.
+    REQUIRE(risk.check_new(market("sl", OrderSide::Sell, 2.0), 0) == RiskCheck::Ok);
+    REQUIRE(risk.check_new(market("sl", OrderSide::Sell, 2.5), 0) == RiskCheck::KillSwitch); // would flip short
+    REQUIRE(risk.check_new(market("sl", OrderSide::Buy, 1.0), 0) == RiskCheck::KillSwitch);  // adds to the long
+    // Resting reducing orders still count for limits: a second take-profit would overshoot.
+    REQUIRE(risk.check_new(limit("tp2", OrderSide::Sell, 101.0, 1.5), 0) == RiskCheck::KillSwitch);
+    REQUIRE(risk.check_new(limit("tp2", OrderSide::Sell, 101.0, 1.0), 0) == RiskCheck::Ok);
+}
+
+TEST_CASE("trading_helper_does_not_send_refused_orders", "[risk]")
+{
+    // Unroutable base URL: anything that reached the network would throw.
+    TradingHelper helper("key", "secret", "linear", "http://127.0.0.1:1");
+    RiskEngine::Config cfg;
+    cfg.limits.price_band_bps = 100.0;
+    helper.risk().configure(cfg);
+    helper.risk().set_mid(helper.risk().add_symbol("BTCUSDT"), px(100.0));
+
+    const OrderRequest reqs[2] = {limit("b1", OrderSide::Buy, 90.0, 1.0), limit("s1", OrderSide::Sell, 120.0, 1.0)};
+    const auto raw = helper.batch_submit_orders(reqs, 2);
+    REQUIRE(TradingHelper::batch_item_results(raw, 2) == std::vector<bool>{false, false});
+    REQUIRE(raw.find("price_band") != std::string::npos);
+    OrderRecord rec;
+    REQUIRE_FALSE(helper.orders().get("b1", rec)); // never recorded as working
+
+    std::vector<bool> async_ok;
+    REQUIRE(helper.async_batch_submit_orders(reqs, 2, [&](const GatewayResult &r)
+                                             { async_ok = r.item_ok; }));
+    REQUIRE(async_ok.empty()); // completes from poll_async(), like a sent request
+    REQUIRE(helper.poll_async() == 1);
+    REQUIRE(async_ok == std::vector<bool>{false, false});
+    REQUIRE(helper.risk().refused(RiskCheck::PriceBand) == 4);
+}
+
+TEST_CASE("trading_helper_releases_exposure_of_orders_it_failed_to_send", "[risk]")
+{
+    TradingHelper helper("key", "secret", "linear", "http://127.0.0.1:1");
+    helper.risk().configure(config());
+    const int btc = helper.risk().add_symbol("BTCUSDT");
+    helper.risk().set_mid(btc, px(100.0));
+
+    const OrderRequest reqs[2] = {limit("b1", OrderSide::Buy, 99.0, 8.0), limit("b2", OrderSide::Buy, 99.0, 1.0)};
+    REQUIRE_THROWS(helper.batch_submit_orders(reqs, 2)); // connection refused
+    OrderState state;
+    REQUIRE(helper.orders().state_of("b1", state));
+    REQUIRE(state == OrderState::Rejected);
+    REQUIRE(helper.risk().exposure(btc).open_buy.is_zero());
+    REQUIRE(helper.risk().exposure(btc).open_buy_notional == 0);
+    // The same order passes the working-notional check again instead of being refused for good.
+    REQUIRE(helper.risk().check_new(limit("b3", OrderSide::Buy, 99.0, 8.0), 0) == RiskCheck::Ok);
+}
+
+TEST_CASE("trading_helper_string_batches_go_through_the_same_admission", "[risk]")
+{
+    TradingHelper helper("key", "secret", "linear", "http://127.0.0.1:1");
+    helper.risk().configure(config());
+    const int btc = helper.risk().add_symbol("BTCUSDT");
+    helper.risk().set_mid(btc, px(100.0));
+    auto buy = [](const char *link)
+    {
+        return std::vector<std::pair<std::string, std::string>>{{"symbol", "BTCUSDT"}, {"side", "Buy"}, {"orderType", "Limit"}, {"qty", "8"}, {"price", "99"}, {"positionIdx", "1"}, {"orderLinkId", link}};
+    };
+
+    // Each order passes alone; together they exceed the working notional, so the batch is refused whole.
+    const auto raw = helper.batch_submit_orders({buy("b1"), buy("b2")});
+    REQUIRE(raw.find("working_notional") != std::string::npos);
+    OrderState state;
+    REQUIRE(helper.orders().state_of("b1", state));
+    REQUIRE(state == OrderState::Rejected);
+    REQUIRE_FALSE(helper.orders().state_of("b2", state));
+    REQUIRE(helper.risk().exposure(btc).open_buy.is_zero());
+
+    // A transport failure releases the exposure recorded for the batch (the cancel by orderLinkId
+    // that would settle the unknown outcome cannot be sent either).
+    helper.set_trade_transport(std::make_unique<DeadTransport>());
+    REQUIRE_THROWS(helper.batch_submit_orders({buy("b3")}));
+    REQUIRE(helper.orders().state_of("b3", state));
+    REQUIRE(state == OrderState::Rejected);
+    REQUIRE(helper.risk().exposure(btc).open_buy.is_zero());
+    REQUIRE(helper.risk().exposure(btc).open_buy_notional == 0);
+}
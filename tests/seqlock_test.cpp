@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "order_book.hpp"
+#include "seqlock.hpp"
+
+namespace
+{
+    struct Payload
+    {
+        uint64_t a{0};
+        uint64_t b{0};
+        uint64_t c[13]{};
+    };
+}
+
+TEST_CASE("seqlock_round_trip", "[seqlock]")
+{
+    SeqLock<BookSnapshot> lock;
+    BookSnapshot in;
+    in.update_id = 42;
+    in.bid_count = 1;
+    in.bids[0] = BookLevel{Price::from_double(100.5), Qty::from_double(2.0)};
+    lock.store(in);
+
+    BookSnapshot out;
+    lock.load(out);
+    REQUIRE(out.update_id == 42);
+    REQUIRE(out.bid_count == 1);
+    REQUIRE(out.bids[0].price == Price::from_double(100.5));
+    REQUIRE(lock.version() == 2); // constructor publishes the default value once
+}
+
+TEST_CASE("seqlock_readers_never_observe_torn_writes", "[seqlock]")
+{
+    SeqLock<Payload> lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+
+    std::thread reader([&]
+                       {
+        Payload p;
+        while (!done.load())
+        {
+            lock.load(p);
+            for (auto v : p.c)
+                if (v != p.a || p.b != p.a)
+                    ++torn;
+        } });
+
+    Payload w;
+    for (uint64_t i = 1; i <= 200000; ++i)
+    {
+        w.a = w.b = i;
+        for (auto &v : w.c)
+            v = i;
+        lock.store(w);
+    }
+    done = true;
+    reader.join();
+
+    REQUIRE(torn.load() == 0);
+    Payload last;
+    lock.load(last);
+    REQUIRE(last.a == 200000);
+}
@@ -0,0 +1,276 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "backtester.hpp"
+#include "feed_recorder.hpp"
+#include "sim_exchange.hpp"
+
+namespace
+{
+    Price px(double v) { return Price::from_double(v); }
+    Qty sz(double v) { return Qty::from_double(v); }
+
+    constexpr int64_t kMs = 1000000;
+
+    SimExchange::Config sim_config()
+    {
+        SimExchange::Config cfg;
+        cfg.meta = InstrumentMeta{px(0.1), sz(0.01), sz(0.01)};
+        cfg.ack_latency_ns = 5 * kMs;
+        cfg.cancel_latency_ns = 2 * kMs;
+        cfg.maker_fee_bps = 2.0;
+        cfg.taker_fee_bps = 5.0;
+        return cfg;
+    }
+
+    BookSnapshot book(double bid, double bid_qty, double ask, double ask_qty)
+    {
+        BookSnapshot b;
+        b.bid_count = 1;
+        b.ask_count = 1;
+        b.bids[0] = {px(bid), sz(bid_qty)};
+        b.asks[0] = {px(ask), sz(ask_qty)};
+        return b;
+    }
+
+    std::string limit(const char *link, const char *side, const char *price, const char *qty, const char *tif = "GTC")
+    {
+        return std::string(R"({"category":"linear","symbol":"BTCUSDT","side":")") + side +
+               R"(","orderType":"Limit","qty":")" + qty + R"(","price":")" + price + R"(","timeInForce":")" + tif +
+               R"(","positionIdx":0,"orderLinkId":")" + link + "\"}";
+    }
+
+    PublicTrade trade(double price, double qty, bool taker_buy)
+    {
+        PublicTrade t;
+        t.price = px(price);
+        t.qty = sz(qty);
+        t.is_buy = taker_buy;
+        return t;
+    }
+
+    OrderState state(const OrderStore &store, const char *link)
+    {
+        OrderState st{OrderState::PendingNew};
+        REQUIRE(store.state_of(link, st));
+        return st;
+    }
+
+    std::string slurp(const std::filesystem::path &p)
+    {
+        std::ifstream in(p);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+}
+
+TEST_CASE("sim_exchange_fills_after_the_queue_ahead", "[sim]")
+{
+    OrderStore store;
+    SimExchange sim("BTCUSDT", sim_config(), store);
+    sim.on_book(0, book(100.0, 0.05, 100.2, 1.0));
+    REQUIRE(sim.request("order.create", limit("b1", "Buy", "100", "0.02")).find("\"retCode\":0") != std::string::npos);
+
+    // Not on the book until the ack latency has passed.
+    sim.on_trade(1 * kMs, trade(100.0, 1.0, false));
+    REQUIRE(sim.fills().empty());
+    sim.advance(5 * kMs);
+    REQUIRE(state(store, "b1") == OrderState::New);
+
+    // 0.05 ahead of us: the first 0.04 only moves us up the queue, the next 0.02 fills half.
+    sim.on_trade(6 * kMs, trade(100.0, 0.04, false));
+    REQUIRE(sim.fills().empty());
+    sim.on_trade(7 * kMs, trade(100.0, 0.02, false));
+    REQUIRE(sim.fills().size() == 1);
+    REQUIRE(sim.fills()[0].qty == sz(0.01));
+    REQUIRE(sim.fills()[0].maker);
+    REQUIRE(state(store, "b1") == OrderState::PartiallyFilled);
+
+    // A trade through our price takes the rest.
+    sim.on_trade(8 * kMs, trade(99.9, 0.01, false));
+    REQUIRE(state(store, "b1") == OrderState::Filled);
+    REQUIRE(sim.net_qty() == 0.02);
+    REQUIRE(std::abs(sim.fees() - 100.0 * 0.02 * 2.0e-4) < 1e-12);
+    REQUIRE(sim.open_orders() == 0);
+}
+
+TEST_CASE("sim_exchange_queue_shrinks_with_the_displayed_level", "[sim]")
+{
+    OrderStore store;
+    SimExchange sim("BTCUSDT", sim_config(), store);
+    sim.on_book(0, book(100.0, 5.0, 100.2, 1.0));
+    sim.request("order.create", limit("b1", "Buy", "100", "0.01"));
+    sim.advance(5 * kMs);
+    // Everything ahead of us was cancelled; the next print at our price is ours.
+    sim.on_book(6 * kMs, book(100.0, 0.0, 100.2, 1.0));
+    sim.on_trade(7 * kMs, trade(100.0, 0.01, false));
+    REQUIRE(state(store, "b1") == OrderState::Filled);
+
+    // The ask moving onto a resting sell's price fills it without any print.
+    sim.request("order.create", limit("s1", "Sell", "100.3", "0.01"));
+    sim.advance(20 * kMs);
+    sim.on_book(21 * kMs, book(100.3, 1.0, 100.4, 1.0));
+    REQUIRE(state(store, "s1") == OrderState::Filled);
+    REQUIRE(std::abs(sim.realized_pnl() - 0.003) < 1e-9);
+}
+
+TEST_CASE("sim_exchange_crossing_orders_take_and_pay_taker_fees", "[sim]")
+{
+    OrderStore store;
+    SimExchange sim("BTCUSDT", sim_config(), store);
+    BookSnapshot b = book(100.0, 1.0, 100.2, 0.01);
+    b.ask_count = 2;
+    b.asks[1] = {px(100.3), sz(1.0)};
+    sim.on_book(0, b);
+
+    sim.request("order.create", limit("x1", "Buy", "100.3", "0.03"));
+    sim.request("order.create", limit("p1", "Buy", "100.2", "0.01", "PostOnly"));
+    sim.advance(5 * kMs);
+    REQUIRE(sim.fills().size() == 2);
+    REQUIRE(sim.fills()[0].price == px(100.2));
+    REQUIRE(sim.fills()[1].price == px(100.3));
+    REQUIRE_FALSE(sim.fills()[0].maker);
+    REQUIRE(state(store, "x1") == OrderState::Filled);
+    REQUIRE(state(store, "p1") == OrderState::Cancelled);
+
+    // Off-grid prices and sizes are rejected per item like the exchange does.
+    const auto raw = sim.request("order.create-batch",
+                                 R"({"category":"linear","request":[)" + limit("ok", "Sell", "101", "0.01") + "," +
+                                     limit("bad", "Sell", "101.05", "0.01") + "]}");
+    const auto ok = TradingHelper::batch_item_results(raw, 2);
+    REQUIRE(ok[0]);
+    REQUIRE_FALSE(ok[1]);
+}
+
+TEST_CASE("sim_exchange_applies_cancel_latency", "[sim]")
+{
+    OrderStore store;
+    SimExchange sim("BTCUSDT", sim_config(), store);
+    sim.on_book(0, book(100.0, 0.0, 100.2, 1.0));
+    sim.request("order.create", limit("b1", "Buy", "100", "0.02"));
+    sim.advance(10 * kMs);
+    sim.request("order.cancel", R"({"category":"linear","symbol":"BTCUSDT","orderLinkId":"b1"})");
+    // Still working while the cancel is in flight.
+    sim.on_trade(11 * kMs, trade(100.0, 0.01, false));
+    REQUIRE(sim.fills().size() == 1);
+    sim.advance(12 * kMs);
+    REQUIRE(state(store, "b1") == OrderState::Cancelled);
+    sim.on_trade(13 * kMs, trade(99.0, 1.0, false));
+    REQUIRE(sim.fills().size() == 1);
+    REQUIRE(sim.request("order.cancel", R"({"orderLinkId":"b1"})").find("\"retCode\":110001") != std::string::npos);
+}
+
+TEST_CASE("backtester_replays_recordings_deterministically", "[sim]")
+{
+    const auto dir = std::filesystem::temp_directory_path() / ("backtest_test_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+    {
+        FeedRecorder::Config rc;
+        rc.dir = (dir / "rec").string();
+        FeedRecorder rec(rc);
+        rec.start();
+        const int64_t t0 = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch())
+                               .count();
+        const char *msgs[] = {
+            R"({"topic":"orderbook.50.BTCUSDT","type":"snapshot","ts":1,"data":{"s":"BTCUSDT","b":[["100.0","5"]],"a":[["100.2","5"]],"u":1,"seq":1}})",
+            R"({"topic":"orderbook.50.BTCUSDT","type":"delta","ts":2,"data":{"s":"BTCUSDT","b":[["99.9","1"]],"a":[],"u":2,"seq":2}})",
+            R"({"topic":"publicTrade.BTCUSDT","type":"snapshot","ts":3,"data":[{"T":3,"s":"BTCUSDT","S":"Sell","v":"6","p":"99.8"}]})",
+            R"({"topic":"orderbook.50.BTCUSDT","type":"delta","ts":4,"data":{"s":"BTCUSDT","b":[["100.0","0"]],"a":[],"u":3,"seq":3}})",
+            R"({"topic":"publicTrade.BTCUSDT","type":"snapshot","ts":5,"data":[{"T":5,"s":"BTCUSDT","S":"Buy","v":"1","p":"100.3"}]})",
+            R"({"topic":"orderbook.50.BTCUSDT","type":"delta","ts":6,"data":{"s":"BTCUSDT","b":[],"a":[["100.1","2"]],"u":4,"seq":4}})",
+        };
+        int64_t t = t0;
+        for (const char *m : msgs)
+            rec.record_public(t += 300 * kMs, m);
+        rec.stop();
+    }
+
+    auto run = [&](const char *out)
+    {
+        Backtester::Config cfg;
+        cfg.symbol = "BTCUSDT";
+        for (const auto &e : std::filesystem::directory_iterator(dir / "rec"))
+            cfg.files.push_back(e.path().string());
+        std::sort(cfg.files.begin(), cfg.files.end());
+        cfg.sim = sim_config();
+        cfg.out_dir = (dir / out).string();
+        ExampleMarketMakerStrategy strategy("BTCUSDT", cfg.sim.meta, 100.0, 1.0, 1.0, 1, 2, 1.0, 0.5, 1);
+        return Backtester(cfg).run(strategy);
+    };
+    const auto a = run("a");
+    const auto b = run("b");
+    REQUIRE(a.messages == 6);
+    REQUIRE(a.fills >= 2);
+    REQUIRE(a.fills == b.fills);
+    REQUIRE(a.realized == b.realized);
+    REQUIRE(slurp(dir / "a" / "fills.csv") == slurp(dir / "b" / "fills.csv"));
+    REQUIRE(slurp(dir / "a" / "pnl.csv") == slurp(dir / "b" / "pnl.csv"));
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("backtester_orders_are_not_held_back_by_the_live_rate_limit", "[sim]")
+{
+    // Sends one create per dispatch and counts how many the simulator accepted.
+    class CreateEveryTick : public IStrategy
+    {
+    public:
+        void on_snapshot(const MarketDataSnapshot &snap, TradingHelper &helper, bool, const PositionView &) override
+        {
+            OrderRequest r;
+            r.symbol.assign("BTCUSDT");
+            r.order_link_id.assign("bid_" + std::to_string(++sent));
+            r.side = OrderSide::Buy;
+            r.price = Price::from_raw(snap.book.bids[0].price.raw - px(1.0).raw);
+            r.qty = sz(0.01);
+            accepted += TradingHelper::batch_item_results(helper.batch_submit_orders(&r, 1), 1)[0];
+        }
+        int sent{0};
+        int accepted{0};
+    };
+
+    const auto dir = std::filesystem::temp_directory_path() / ("backtest_rate_test_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+    {
+        FeedRecorder::Config rc;
+        rc.dir = dir.string();
+        FeedRecorder rec(rc);
+        rec.start();
+        int64_t t = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        // 400 s of one book update per second, replayed in a fraction of a real second.
+        for (int i = 0; i <= 400; ++i)
+        {
+            const std::string bid = i % 2 ? "100.0" : "100.1";
+            rec.record_public(t += 1000 * kMs, R"({"topic":"orderbook.50.BTCUSDT","type":"snapshot","ts":1,"data":{"s":"BTCUSDT","b":[[")" + bid +
+                                                    R"(","5"]],"a":[["100.2","5"]],"u":)" + std::to_string(i + 1) + R"(,"seq":1}})");
+        }
+        rec.stop();
+    }
+
+    Backtester::Config cfg;
+    cfg.symbol = "BTCUSDT";
+    for (const auto &e : std::filesystem::directory_iterator(dir))
+        cfg.files.push_back(e.path().string());
+    std::sort(cfg.files.begin(), cfg.files.end());
+    cfg.sim = sim_config();
+    CreateEveryTick strategy;
+    const auto start = std::chrono::steady_clock::now();
+    const auto res = Backtester(cfg).run(strategy);
+    const double real_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::filesystem::remove_all(dir);
+
+    REQUIRE(res.dispatches == 401);
+    REQUIRE(res.dispatches > 10 * real_s);
+    REQUIRE(strategy.sent == 401);
+    REQUIRE(strategy.accepted == 401);
+}
@@ -0,0 +1,318 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "market_data_feed.hpp"
+#include "rest_transport.hpp"
+#include "sim_server.hpp"
+#include "sim_venue.hpp"
+#include "trading_helper.hpp"
+#include "ws_trade_transport.hpp"
+
+namespace
+{
+    constexpr int64_t kMs = 1000000;
+
+    SimVenue::Config venue_config()
+    {
+        SimVenue::Config cfg;
+        cfg.sim.meta = InstrumentMeta{Price::from_double(0.1), Qty::from_double(0.01), Qty::from_double(0.01)};
+        cfg.sim.ack_latency_ns = 5 * kMs;
+        cfg.sim.cancel_latency_ns = 5 * kMs;
+        cfg.wallet_usdt = 1000.0;
+        return cfg;
+    }
+
+    std::string book_msg(const char *type, const std::string &bids, const std::string &asks, int u)
+    {
+        return std::string(R"({"topic":"orderbook.50.BTCUSDT","type":")") + type + R"(","ts":1,"data":{"s":"BTCUSDT","b":)" + bids +
+               R"(,"a":)" + asks + R"(,"u":)" + std::to_string(u) + R"(,"seq":)" + std::to_string(u) + "}}";
+    }
+
+    // Captures everything the venue sends, by session.
+    struct Outbox
+    {
+        std::vector<std::pair<uint64_t, nlohmann::json>> sent;
+
+        SimVenue::Sender sender()
+        {
+            return [this](uint64_t session, const std::string &text)
+            { sent.emplace_back(session, nlohmann::json::parse(text)); };
+        }
+
+        std::vector<nlohmann::json> topic(uint64_t session, const std::string &name) const
+        {
+            std::vector<nlohmann::json> out;
+            for (const auto &[id, j] : sent)
+                if (id == session && j.value("topic", std::string{}) == name)
+                    out.push_back(j);
+            return out;
+        }
+    };
+
+    // Trade transport whose creates reach the venue (over REST) but whose acks never come back.
+    class LostAckTransport : public ITradeTransport
+    {
+    public:
+        explicit LostAckTransport(const std::string &rest_url) : rest_("key", "secret", rest_url) {}
+
+        bool ready() const override { return true; }
+
+        std::string request(const std::string &op, const std::string &args_json) override
+        {
+            rest_.post("/v5/order/" + op.substr(6), args_json);
+            throw std::runtime_error("ack timeout");
+        }
+
+    private:
+        RestTransport rest_;
+    };
+
+    nlohmann::json rest(SimVenue &venue, const std::string &method, const std::string &target, const std::string &body = {})
+    {
+        const auto reply = venue.handle_http(method, target, body);
+        REQUIRE(reply.status == 200);
+        return nlohmann::json::parse(reply.body);
+    }
+} // namespace
+
+TEST_CASE("sim_venue_serves_instruments_and_batch_orders_over_rest", "[sim_venue]")
+{
+    Outbox box;
+    SimVenue venue("BTCUSDT", venue_config(), box.sender());
+    venue.on_market(1 * kMs, book_msg("snapshot", R"([["100.0","5"]])", R"([["100.2","5"]])", 1));
+
+    const auto info = rest(venue, "GET", "/v5/market/instruments-info?category=linear&limit=1000");
+    REQUIRE(info["retCode"] == 0);
+    REQUIRE(info["result"]["list"].size() == 1);
+    REQUIRE(info["result"]["list"][0]["priceFilter"]["tickSize"] == "0.1");
+    REQUIRE(info["result"]["list"][0]["lotSizeFilter"]["qtyStep"] == "0.01");
+    REQUIRE(rest(venue, "GET", "/v5/market/instruments-info?category=linear&symbol=ETHUSDT")["result"]["list"].empty());
+
+    const auto book = rest(venue, "GET", "/v5/market/orderbook?category=linear&symbol=BTCUSDT&limit=1");
+    REQUIRE(book["result"]["b"][0][0] == "100");
+    REQUIRE(book["result"]["a"][0][0] == "100.2");
+
+    const auto batch = rest(venue, "POST", "/v5/order/create-batch",
+                            R"({"category":"linear","request":[)"
+                            R"({"symbol":"BTCUSDT","side":"Buy","orderType":"Limit","qty":"0.5","price":"99.9","positionIdx":1,"orderLinkId":"b1"},)"
+                            R"({"symbol":"BTCUSDT","side":"Sell","orderType":"Limit","qty":"0.5","price":"100.05","positionIdx":2,"orderLinkId":"s1"}]})");
+    REQUIRE(batch["retCode"] == 0);
+    REQUIRE(batch["result"]["list"].size() == 2);
+    REQUIRE(batch["retExtInfo"]["list"][0]["code"] == 0);
+    REQUIRE(batch["retExtInfo"]["list"][1]["code"] != 0); // off-tick price
+
+    const auto cancel = rest(venue, "POST", "/v5/order/cancel-all", R"({"category":"linear","symbol":"BTCUSDT"})");
+    REQUIRE(cancel["retCode"] == 0);
+    const auto wallet = rest(venue, "GET", "/v5/account/wallet-balance?accountType=UNIFIED");
+    REQUIRE(wallet["result"]["list"][0]["totalWalletBalance"] == "1000");
+    REQUIRE(rest(venue, "GET", "/v5/market/time")["result"].contains("timeSecond"));
+    REQUIRE(venue.handle_http("GET", "/v5/market/kline?symbol=BTCUSDT", "").status == 404);
+}
+
+TEST_CASE("sim_venue_pushes_order_execution_and_position_after_a_fill", "[sim_venue]")
+{
+    Outbox box;
+    SimVenue venue("BTCUSDT", venue_config(), box.sender());
+    venue.on_market(1 * kMs, book_msg("snapshot", R"([["100.0","5"]])", R"([["100.2","5"]])", 1));
+
+    SimVenue::Channel channel;
+    REQUIRE(SimVenue::channel_for_path("/v5/private?max_active_time=1m", channel));
+    REQUIRE(channel == SimVenue::Channel::Private);
+    REQUIRE_FALSE(SimVenue::channel_for_path("/v5/unknown", channel));
+    venue.open_session(7, channel);
+    venue.handle_ws(7, R"({"op":"subscribe","args":["order"]})");
+    REQUIRE(box.sent.back().second["success"] == false); // not authed yet
+    venue.handle_ws(7, R"({"op":"auth","args":["key",1,"sig"]})");
+    venue.handle_ws(7, R"({"op":"subscribe","args":["order","execution","position"]})");
+    REQUIRE(box.sent.back().second["success"] == true);
+
+    // Marketable buy: fills against the ask once the ack latency has passed.
+    rest(venue, "POST", "/v5/order/create",
+         R"({"category":"linear","symbol":"BTCUSDT","side":"Buy","orderType":"Limit","qty":"0.5","price":"100.2","positionIdx":1,"orderLinkId":"t1"})");
+    venue.advance(10 * kMs);
+
+    const auto orders = box.topic(7, "order");
+    REQUIRE_FALSE(orders.empty());
+    REQUIRE(orders.back()["data"][0]["orderLinkId"] == "t1");
+    REQUIRE(orders.back()["data"][0]["orderStatus"] == "Filled");
+    REQUIRE(orders.back()["data"][0]["positionIdx"] == 1);
+
+    const auto execs = box.topic(7, "execution");
+    REQUIRE(execs.size() == 1);
+    REQUIRE(execs[0]["data"][0]["execQty"] == "0.5");
+    REQUIRE(execs[0]["data"][0]["execPrice"] == "100.2");
+    REQUIRE(execs[0]["data"][0]["isMaker"] == false);
+
+    const auto positions = box.topic(7, "position");
+    REQUIRE(positions.size() == 1);
+    REQUIRE(positions[0]["data"][0]["positionIdx"] == 1);
+    REQUIRE(positions[0]["data"][0]["size"] == "0.5");
+    REQUIRE(positions[0]["data"][0]["side"] == "Buy");
+    REQUIRE(positions[0]["data"][1]["size"] == "0");
+    REQUIRE(venue.fill_count() == 1);
+
+    const auto listed = rest(venue, "GET", "/v5/position/list?category=linear&symbol=BTCUSDT");
+    REQUIRE(listed["result"]["list"][0]["avgPrice"] == "100.2");
+}
+
+TEST_CASE("sim_venue_late_subscriber_book_stays_in_sync", "[sim_venue]")
+{
+    Outbox box;
+    SimVenue venue("BTCUSDT", venue_config(), box.sender());
+    MarketDataFeed direct("");
+    direct.prepare({"BTCUSDT"}, 50);
+    int64_t t = 0;
+    auto replay = [&](const std::string &msg)
+    {
+        venue.on_market(t += kMs, msg);
+        direct.ingest(msg, t);
+    };
+    replay(book_msg("snapshot", R"([["100.0","5"],["99.9","3"]])", R"([["100.2","5"],["100.3","1"]])", 1));
+    replay(book_msg("delta", R"([["100.0","0"],["100.1","2"]])", "[]", 2));
+
+    venue.open_session(1, SimVenue::Channel::Public);
+    venue.open_session(2, SimVenue::Channel::Public);
+    venue.handle_ws(1, R"({"op":"subscribe","req_id":"r1","args":["orderbook.50.BTCUSDT","tickers.BTCUSDT"]})");
+    venue.handle_ws(2, R"({"op":"subscribe","args":["orderbook.1.BTCUSDT","orderbook.50.ETHUSDT"]})");
+    REQUIRE(box.sent[0].second["success"] == true);
+    REQUIRE(box.sent[0].second["req_id"] == "r1");
+    REQUIRE(box.topic(2, "orderbook.1.BTCUSDT").size() == 1);
+    REQUIRE(box.topic(1, "tickers.BTCUSDT").size() == 1);
+    REQUIRE(box.topic(1, "tickers.BTCUSDT")[0]["data"]["bid1Price"] == "100.1");
+
+    replay(book_msg("delta", R"([["100.1","0"]])", R"([["100.2","4"]])", 3));
+    replay(book_msg("delta", "[]", R"([["100.15","1"]])", 4));
+
+    // The late subscriber's snapshot plus the forwarded deltas rebuild the same book.
+    MarketDataFeed late("");
+    late.prepare({"BTCUSDT"}, 50);
+    const auto msgs = box.topic(1, "orderbook.50.BTCUSDT");
+    REQUIRE(msgs.size() == 3);
+    REQUIRE(msgs[0]["type"] == "snapshot");
+    for (const auto &m : msgs)
+        late.ingest(m.dump(), t);
+    BookSnapshot a, b;
+    REQUIRE(direct.read_book("BTCUSDT", a));
+    REQUIRE(late.read_book("BTCUSDT", b));
+    REQUIRE(a.bid_count == b.bid_count);
+    REQUIRE(a.ask_count == b.ask_count);
+    REQUIRE(a.bids[0].price == b.bids[0].price);
+    REQUIRE(a.asks[0].price == b.asks[0].price);
+    REQUIRE(a.asks[0].qty == b.asks[0].qty);
+
+    // The depth-1 stream gets a fresh top-of-book snapshot after every change.
+    const auto top = box.topic(2, "orderbook.1.BTCUSDT");
+    REQUIRE(top.size() == 3);
+    REQUIRE(top.back()["data"]["a"].size() == 1);
+    REQUIRE(top.back()["data"]["a"][0][0] == "100.15");
+}
+
+TEST_CASE("sim_venue_trade_ws_acks_carry_the_req_id", "[sim_venue]")
+{
+    Outbox box;
+    SimVenue venue("BTCUSDT", venue_config(), box.sender());
+    venue.on_market(1 * kMs, book_msg("snapshot", R"([["100.0","5"]])", R"([["100.2","5"]])", 1));
+    venue.open_session(3, SimVenue::Channel::Trade);
+
+    const std::string create = R"({"reqId":"q1","header":{"X-BAPI-TIMESTAMP":"1"},"op":"order.create","args":[)"
+                               R"({"category":"linear","symbol":"BTCUSDT","side":"Buy","orderType":"Limit","qty":"0.1","price":"99.5","positionIdx":1,"orderLinkId":"w1"}]})";
+    venue.handle_ws(3, create);
+    REQUIRE(box.sent.back().second["retCode"] == 10003);
+
+    venue.handle_ws(3, R"({"op":"auth","args":["key",1,"sig"]})");
+    REQUIRE(box.sent.back().second["retCode"] == 0);
+    venue.handle_ws(3, create);
+    const auto ack = box.sent.back().second;
+    REQUIRE(ack["reqId"] == "q1");
+    REQUIRE(ack["op"] == "order.create");
+    REQUIRE(ack["retCode"] == 0);
+    REQUIRE(ack["data"]["orderLinkId"] == "w1");
+    REQUIRE_FALSE(ack["data"]["orderId"].get<std::string>().empty());
+}
+
+TEST_CASE("sim_server_answers_the_trading_helper_on_localhost", "[sim_venue]")
+{
+    SimServer::Config cfg;
+    cfg.symbol = "BTCUSDT";
+    cfg.venue = venue_config();
+    cfg.rest_port = 18941;
+    cfg.ws_port = 18942;
+    SimServer server(cfg);
+    server.start();
+
+    TradingHelper helper("key", "secret", "linear", server.rest_url());
+    const auto instruments = helper.fetch_instruments_info_for_category("linear");
+    REQUIRE(instruments["result"]["list"][0]["symbol"] == "BTCUSDT");
+
+    WsTradeTransport::Config trade;
+    trade.url = server.ws_url("/v5/trade");
+    trade.api_key = "key";
+    trade.api_secret = "secret";
+    auto ws = std::make_unique<WsTradeTransport>(trade);
+    REQUIRE(ws->start(std::chrono::milliseconds{3000}));
+    helper.set_trade_transport(std::move(ws));
+    const auto raw = helper.batch_submit_orders({{{"symbol", "BTCUSDT"}, {"side", "Buy"}, {"orderType", "Limit"}, {"qty", "0.01"}, {"price", "90"}, {"positionIdx", "1"}, {"orderLinkId", "e1"}}});
+    REQUIRE(TradingHelper::batch_item_results(raw, 1)[0]);
+    REQUIRE(helper.trade_fallbacks() == 0);
+
+    const auto cancelled = nlohmann::json::parse(helper.cancel_all("BTCUSDT"));
+    REQUIRE(cancelled["retCode"] == 0);
+    server.stop();
+}
+
+TEST_CASE("rest_transport_warms_its_connection_ahead_of_requests", "[sim_venue]")
+{
+    RestTransport unreachable("key", "secret", "http://127.0.0.1:1");
+    REQUIRE_FALSE(unreachable.warm());
+    REQUIRE(unreachable.stats().connects == 0);
+
+    SimServer::Config cfg;
+    cfg.symbol = "BTCUSDT";
+    cfg.venue = venue_config();
+    cfg.rest_port = 18951;
+    cfg.ws_port = 18952;
+    SimServer server(cfg);
+    server.start();
+
+    RestTransport transport("key", "secret", server.rest_url());
+    REQUIRE(transport.warm());
+    REQUIRE(transport.stats().connects >= 1);
+    REQUIRE(transport.stats().requests == 0);
+    const auto connects = transport.stats().connects;
+
+    // The request reuses the warmed connection.
+    transport.get("/v5/account/wallet-balance", "accountType=UNIFIED");
+    REQUIRE(transport.stats().requests == 1);
+    REQUIRE(transport.stats().connects == connects);
+    REQUIRE(transport.warm_pool(2));
+    server.stop();
+}
+
+TEST_CASE("trading_helper_cancels_creates_whose_trade_ack_was_lost", "[sim_venue]")
+{
+    SimServer::Config cfg;
+    cfg.symbol = "BTCUSDT";
+    cfg.venue = venue_config();
+    cfg.rest_port = 18961;
+    cfg.ws_port = 18962;
+    SimServer server(cfg);
+    server.start();
+
+    TradingHelper helper("key", "secret", "linear", server.rest_url());
+    helper.set_trade_transport(std::make_unique<LostAckTransport>(server.rest_url()));
+    // Not retried over REST (that would be a duplicate orderLinkId while the first may rest), but
+    // cancelled by orderLinkId, after which it is known not to rest.
+    const auto raw = helper.submit_limit_order("BTCUSDT", "Buy", "0.01", "90", 1, "Limit", "lost1");
+    REQUIRE_FALSE(TradingHelper::batch_item_results(raw, 1)[0]);
+    OrderState st;
+    REQUIRE(helper.orders().state_of("lost1", st));
+    REQUIRE(st == OrderState::Rejected);
+    REQUIRE(helper.trade_fallbacks() == 1);
+    server.stop();
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "spsc_queue.hpp"
+
+TEST_CASE("spsc_capacity_and_full", "[spsc]")
+{
+    SpscQueue<int> q(3);
+    REQUIRE(q.capacity() == 4);
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(q.try_push(int{i}));
+    int extra = 99;
+    REQUIRE_FALSE(q.try_push(std::move(extra)));
+    REQUIRE(extra == 99); // not consumed on failure
+    REQUIRE(q.size() == 4);
+
+    int v = -1;
+    for (int i = 0; i < 4; ++i)
+    {
+        REQUIRE(q.try_pop(v));
+        REQUIRE(v == i);
+    }
+    REQUIRE_FALSE(q.try_pop(v));
+    REQUIRE(q.empty());
+}
+
+TEST_CASE("spsc_wraps_around_with_moved_payloads", "[spsc]")
+{
+    SpscQueue<std::string> q(2);
+    std::string out;
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE(q.try_push(std::string("order-") + std::to_string(i)));
+        REQUIRE(q.try_pop(out));
+        REQUIRE(out == "order-" + std::to_string(i));
+    }
+}
+
+TEST_CASE("spsc_producer_consumer_threads_keep_fifo", "[spsc]")
+{
+    constexpr uint64_t kItems = 200000;
+    SpscQueue<uint64_t> q(64);
+
+    std::thread producer([&]
+                         {
+        for (uint64_t i = 1; i <= kItems;)
+        {
+            uint64_t v = i;
+            if (q.try_push(std::move(v)))
+                ++i;
+            else
+                std::this_thread::yield();
+        } });
+
+    uint64_t expected = 1;
+    bool in_order = true;
+    while (expected <= kItems)
+    {
+        uint64_t v = 0;
+        if (!q.try_pop(v))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        in_order = in_order && v == expected;
+        ++expected;
+    }
+    producer.join();
+
+    REQUIRE(in_order);
+    REQUIRE(q.empty());
+}
@@ -0,0 +1,306 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "strategy_shard.hpp"
+
+namespace
+{
+    // Records what the shard hands it; the test thread reads through the mutex.
+    class RecordingStrategy : public IStrategy
+    {
+    public:
+        void on_snapshot(const MarketDataSnapshot &snapshot, TradingHelper &, bool live_trading, const PositionView &pos) override
+        {
+            std::lock_guard<std::mutex> lg(mu);
+            symbols.push_back(snapshot.symbol);
+            last_pos = pos;
+            live = live || live_trading;
+            thread = std::this_thread::get_id();
+            calls.fetch_add(1);
+        }
+
+        void on_instrument_meta(const InstrumentMeta &meta) override
+        {
+            std::lock_guard<std::mutex> lg(mu);
+            tick = meta.tick_size;
+            meta_thread = std::this_thread::get_id();
+            meta_updates.fetch_add(1);
+        }
+
+        std::mutex mu;
+        std::vector<std::string> symbols;
+        bool live{false};
+        PositionView last_pos;
+        std::thread::id thread;
+        std::atomic<int> calls{0};
+        Price tick;
+        std::thread::id meta_thread;
+        std::atomic<int> meta_updates{0};
+    };
+
+    std::string book_msg(const std::string &symbol, const char *type, uint64_t u, const char *bid)
+    {
+        return R"({"topic":"orderbook.1.)" + symbol + R"(","type":")" + type + R"(","ts":1,"data":{"s":")" + symbol +
+               R"(","b":[[")" + bid + R"(","1"]],"a":[["200.0","1"]],"u":)" + std::to_string(u) + R"(,"seq":1}})";
+    }
+
+    std::string ticker_msg(const std::string &symbol)
+    {
+        return R"({"topic":"tickers.)" + symbol + R"(","type":"snapshot","ts":1,"data":{"symbol":")" + symbol +
+               R"(","lastPrice":"150.0","bid1Price":"100.0","ask1Price":"200.0"}})";
+    }
+
+    bool wait_until(const std::function<bool()> &done)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        while (!done())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return true;
+    }
+
+    // Acks every order call and records the ops sent; the test thread reads through the mutex.
+    class RecordingTransport : public ITradeTransport
+    {
+    public:
+        bool ready() const override { return true; }
+        bool supports_cancel_all() const override { return true; }
+
+        std::string request(const std::string &op, const std::string &args_json) override
+        {
+            std::lock_guard<std::mutex> lg(mu);
+            ops.push_back(op + " " + args_json);
+            return R"({"retCode":0,"retMsg":"OK","result":{}})";
+        }
+
+        std::mutex mu;
+        std::vector<std::string> ops;
+    };
+
+    InstrumentMeta meta()
+    {
+        return InstrumentMeta{Price::from_double(0.1), Qty::from_double(0.01), Qty::from_double(0.01)};
+    }
+
+    std::unique_ptr<StrategyShard> make_shard(int id, MarketDataFeed &feed, bool busy_poll = false)
+    {
+        StrategyShard::Config cfg;
+        cfg.id = id;
+        cfg.busy_poll = busy_poll;
+        cfg.dispatch.min_requote_interval = std::chrono::microseconds{0};
+        cfg.dispatch.idle_timeout = std::chrono::milliseconds{20};
+        return std::make_unique<StrategyShard>(cfg, feed, std::make_unique<TradingHelper>("", "", "linear", "http://127.0.0.1:9"));
+    }
+} // namespace
+
+TEST_CASE("feed_counts_updates_per_symbol", "[shard]")
+{
+    MarketDataFeed feed("");
+    feed.prepare({"AAAUSDT", "BBBUSDT"});
+    const int a = feed.symbol_index("AAAUSDT");
+    const int b = feed.symbol_index("BBBUSDT");
+    REQUIRE(a == 0);
+    REQUIRE(b == 1);
+    REQUIRE(feed.symbol_index("CCCUSDT") == -1);
+    REQUIRE(feed.symbol_seq(-1) == 0);
+
+    feed.ingest(book_msg("AAAUSDT", "snapshot", 1, "100.0"), 1);
+    feed.ingest(ticker_msg("AAAUSDT"), 2);
+    feed.ingest(ticker_msg("BBBUSDT"), 3);
+    REQUIRE(feed.symbol_seq(a) == 2);
+    REQUIRE(feed.symbol_seq(b) == 1);
+    REQUIRE(feed.update_seq() == 3);
+
+    BookSnapshot book;
+    REQUIRE(feed.read_book(a, book));
+    REQUIRE_FALSE(feed.read_book(b, book)); // ticker only so far
+}
+
+TEST_CASE("dispatcher_poll_throttles_per_symbol_and_coalesces", "[shard]")
+{
+    MarketDataFeed feed("");
+    feed.prepare({"AAAUSDT", "BBBUSDT"});
+    StrategyDispatcher::Config cfg;
+    cfg.min_requote_interval = std::chrono::milliseconds{100};
+    cfg.urgent_mid_move = 5.0;
+    StrategyDispatcher dispatcher(feed, "AAAUSDT", cfg);
+    MarketDataSnapshot snap;
+    using clock = std::chrono::steady_clock;
+
+    auto now = clock::now();
+    auto wake = now + std::chrono::seconds{1};
+    REQUIRE_FALSE(dispatcher.poll(snap, now, wake)); // nothing published yet
+
+    feed.ingest(book_msg("AAAUSDT", "snapshot", 1, "100.0"), 1);
+    feed.ingest(ticker_msg("AAAUSDT"), 2);
+    REQUIRE(dispatcher.poll(snap, clock::now(), wake));
+    REQUIRE(dispatcher.coalesced() == 1);
+
+    // Other symbols never wake this dispatcher.
+    feed.ingest(ticker_msg("BBBUSDT"), 3);
+    REQUIRE_FALSE(dispatcher.poll(snap, clock::now(), wake));
+
+    // A small move inside the interval is held back and reports when it falls due...
+    feed.ingest(book_msg("AAAUSDT", "delta", 2, "100.1"), 4);
+    now = clock::now();
+    wake = now + std::chrono::seconds{1};
+    REQUIRE_FALSE(dispatcher.poll(snap, now, wake));
+    REQUIRE(wake <= now + std::chrono::milliseconds{100});
+    // ...and a second one folds into the same pending dispatch.
+    feed.ingest(book_msg("AAAUSDT", "delta", 3, "100.2"), 5);
+    REQUIRE_FALSE(dispatcher.poll(snap, now, wake));
+    REQUIRE(dispatcher.poll(snap, now + std::chrono::milliseconds{200}, wake));
+    REQUIRE(snap.book.best_bid() == Price::from_double(100.2));
+    REQUIRE(dispatcher.coalesced() == 2);
+
+    // A mid jump past urgent_mid_move bypasses the interval.
+    feed.ingest(book_msg("AAAUSDT", "delta", 4, "190.0"), 6);
+    REQUIRE(dispatcher.poll(snap, clock::now(), wake));
+}
+
+TEST_CASE("shards_quote_their_own_symbols_on_their_own_threads", "[shard]")
+{
+    const std::vector<std::string> symbols{"AAAUSDT", "BBBUSDT", "CCCUSDT"};
+    MarketDataFeed feed("");
+    feed.prepare(symbols);
+
+    std::vector<std::unique_ptr<StrategyShard>> shards;
+    shards.push_back(make_shard(0, feed));
+    shards.push_back(make_shard(1, feed));
+    std::vector<RecordingStrategy *> strategies;
+    for (std::size_t i = 0; i < symbols.size(); ++i)
+    {
+        auto s = std::make_unique<RecordingStrategy>();
+        strategies.push_back(s.get());
+        shards[i % 2]->add_symbol(symbols[i], meta(), std::move(s));
+    }
+    REQUIRE(shards[0]->symbols() == std::vector<std::string>{"AAAUSDT", "CCCUSDT"});
+
+    // Positions are routed by symbol and only touch that symbol's view.
+    shards[0]->set_position("CCCUSDT", "Buy", 2.0, 150.0);
+    shards[0]->set_position("AAAUSDT", "Sell", 1.0, 151.0);
+    shards[0]->clear_position("AAAUSDT");
+    REQUIRE(shards[0]->position("CCCUSDT").long_size == 2.0);
+    REQUIRE(shards[0]->position("AAAUSDT").short_size == 0.0);
+    REQUIRE(shards[1]->position("CCCUSDT").long_size == 0.0); // not its symbol
+
+    for (auto &shard : shards)
+        shard->start();
+    for (const auto &s : symbols)
+    {
+        feed.ingest(book_msg(s, "snapshot", 1, "100.0"), 1);
+        feed.ingest(ticker_msg(s), 2);
+    }
+    REQUIRE(wait_until([&]
+                       { return strategies[0]->calls > 0 && strategies[1]->calls > 0 && strategies[2]->calls > 0; }));
+    for (auto &shard : shards)
+        shard->stop();
+
+    for (std::size_t i = 0; i < symbols.size(); ++i)
+    {
+        auto &st = *strategies[i];
+        std::lock_guard<std::mutex> lg(st.mu);
+        REQUIRE_FALSE(st.live);
+        for (const auto &seen : st.symbols)
+            REQUIRE(seen == symbols[i]);
+    }
+    REQUIRE(strategies[0]->thread == strategies[2]->thread);
+    REQUIRE(strategies[0]->thread != strategies[1]->thread);
+    REQUIRE(strategies[2]->last_pos.long_size == 2.0);
+    REQUIRE(shards[0]->dispatches() + shards[1]->dispatches() >= 3);
+    REQUIRE_FALSE(shards[0]->failed());
+}
+
+TEST_CASE("busy_polling_shard_dispatches_without_the_condition_variable", "[shard]")
+{
+    MarketDataFeed feed("");
+    feed.prepare({"AAAUSDT"});
+    auto shard = make_shard(0, feed, true);
+    auto strategy = std::make_unique<RecordingStrategy>();
+    auto *recording = strategy.get();
+    shard->add_symbol("AAAUSDT", meta(), std::move(strategy));
+    shard->start();
+    feed.ingest(book_msg("AAAUSDT", "snapshot", 1, "100.0"), 1);
+    feed.ingest(ticker_msg("AAAUSDT"), 2);
+    REQUIRE(wait_until([&]
+                       { return recording->calls > 0; }));
+    feed.ingest(book_msg("AAAUSDT", "delta", 2, "100.1"), 3);
+    REQUIRE(wait_until([&]
+                       { return recording->calls > 1; }));
+    shard->stop();
+    REQUIRE_FALSE(shard->failed());
+}
+
+TEST_CASE("instrument_changes_reach_the_strategy_on_the_shard_thread", "[shard]")
+{
+    MarketDataFeed feed("");
+    feed.prepare({"AAAUSDT"});
+    auto shard = make_shard(0, feed);
+    auto strategy = std::make_unique<RecordingStrategy>();
+    auto *recording = strategy.get();
+    shard->add_symbol("AAAUSDT", meta(), std::move(strategy));
+    shard->start();
+    feed.ingest(book_msg("AAAUSDT", "snapshot", 1, "100.0"), 1);
+    feed.ingest(ticker_msg("AAAUSDT"), 2);
+    REQUIRE(wait_until([&]
+                       { return recording->calls > 0; }));
+
+    InstrumentMeta changed = meta();
+    changed.tick_size = Price::from_double(0.5);
+    shard->update_meta("AAAUSDT", changed);
+    shard->update_meta("ZZZUSDT", changed); // not the shard's symbol
+    REQUIRE(wait_until([&]
+                       { return recording->meta_updates > 0; }));
+    shard->stop();
+    std::lock_guard<std::mutex> lg(recording->mu);
+    REQUIRE(recording->meta_updates == 1);
+    REQUIRE(recording->tick == Price::from_double(0.5));
+    REQUIRE(recording->meta_thread == recording->thread);
+}
+
+TEST_CASE("killed_shard_cancels_its_symbols_without_waiting_for_a_book_update", "[shard]")
+{
+    MarketDataFeed feed("");
+    feed.prepare({"AAAUSDT"});
+    StrategyShard::Config cfg;
+    cfg.live = true;
+    cfg.dispatch.idle_timeout = std::chrono::milliseconds{20};
+    auto helper = std::make_unique<TradingHelper>("key", "secret", "linear", "http://127.0.0.1:9");
+    auto transport = std::make_unique<RecordingTransport>();
+    auto *recorded = transport.get();
+    helper->set_trade_transport(std::move(transport));
+    StrategyShard shard(cfg, feed, std::move(helper));
+    auto strategy = std::make_unique<RecordingStrategy>();
+    auto *recording = strategy.get();
+    shard.add_symbol("AAAUSDT", meta(), std::move(strategy));
+    shard.start();
+    feed.ingest(book_msg("AAAUSDT", "snapshot", 1, "100.0"), 1);
+    feed.ingest(ticker_msg("AAAUSDT"), 2);
+    REQUIRE(wait_until([&]
+                       { return recording->calls > 0; }));
+
+    // The book stays still, so the strategy is not called again; the worker still cancels.
+    shard.kill();
+    REQUIRE(shard.helper().risk().killed());
+    REQUIRE(wait_until([&]
+                       {
+        std::lock_guard<std::mutex> lg(recorded->mu);
+        return !recorded->ops.empty(); }));
+    shard.stop();
+    std::lock_guard<std::mutex> lg(recorded->mu);
+    REQUIRE(recorded->ops.size() == 1);
+    REQUIRE(recorded->ops[0].rfind("order.cancel-all ", 0) == 0);
+    REQUIRE(recorded->ops[0].find("AAAUSDT") != std::string::npos);
+    REQUIRE_FALSE(shard.failed());
+}
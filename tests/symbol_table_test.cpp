@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "symbol_table.hpp"
+
+TEST_CASE("symbols_intern_to_dense_stable_ids", "[symbols]")
+{
+    SymbolTable table;
+    REQUIRE(table.find("BTCUSDT") == kNoSymbol);
+    const SymbolId btc = table.intern("BTCUSDT");
+    const SymbolId eth = table.intern("ETHUSDT");
+    REQUIRE(btc == 0);
+    REQUIRE(eth == 1);
+    REQUIRE(table.intern("BTCUSDT") == btc);
+    REQUIRE(table.find("ETHUSDT") == eth);
+    REQUIRE(table.find("ETHUSD") == kNoSymbol);
+    REQUIRE(table.name(eth) == "ETHUSDT");
+    REQUIRE(table.name(7).empty());
+    REQUIRE(table.size() == 2);
+
+    REQUIRE_THROWS_AS(table.intern(""), std::invalid_argument);
+    REQUIRE_THROWS_AS(table.intern(std::string(SymbolTable::kMaxLength + 1, 'X')), std::invalid_argument);
+    REQUIRE(table.find(std::string(SymbolTable::kMaxLength + 1, 'X')) == kNoSymbol);
+    REQUIRE(table.size() == 2);
+}
+
+TEST_CASE("symbol_table_rejects_symbols_beyond_capacity", "[symbols]")
+{
+    auto table = std::make_unique<SymbolTable>();
+    for (std::size_t i = 0; i < SymbolTable::kCapacity; ++i)
+        REQUIRE(table->intern("S" + std::to_string(i)) == i);
+    REQUIRE_THROWS_AS(table->intern("ONEMORE"), std::length_error);
+    REQUIRE(table->intern("S4095") == 4095); // known symbols still resolve
+    REQUIRE(table->find("S123") == 123);
+}
+
+TEST_CASE("symbol_lookups_run_concurrently_with_interning", "[symbols]")
+{
+    SymbolTable table;
+    table.intern("BTCUSDT");
+    std::atomic<bool> done{false};
+    std::thread writer([&]
+                       {
+                           for (int i = 0; i < 2000; ++i)
+                               table.intern("SYM" + std::to_string(i));
+                           done = true;
+                       });
+    bool ok = true;
+    while (!done)
+    {
+        ok = ok && table.find("BTCUSDT") == 0;
+        // An id, once visible, always leads to its full name.
+        const SymbolId id = table.find("SYM1000");
+        ok = ok && (id == kNoSymbol || table.name(id) == "SYM1000");
+    }
+    writer.join();
+    REQUIRE(ok);
+    REQUIRE(table.find("SYM1999") == 2000);
+}
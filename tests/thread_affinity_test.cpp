@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <thread>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "thread_affinity.hpp"
+
+namespace
+{
+    std::string current_name()
+    {
+        char buf[16] = {};
+        pthread_getname_np(pthread_self(), buf, sizeof(buf));
+        return buf;
+    }
+} // namespace
+
+TEST_CASE("pin_current_thread_rejects_invalid_cpus", "[threads]")
+{
+    REQUIRE_FALSE(pin_current_thread(-1));
+    REQUIRE_FALSE(pin_current_thread(CPU_SETSIZE));
+    REQUIRE_FALSE(set_current_thread_fifo(0));
+    REQUIRE_FALSE(set_current_thread_fifo(100));
+}
+
+TEST_CASE("apply_thread_role_names_and_pins_the_calling_thread", "[threads]")
+{
+    // Catch assertions are not thread-safe; collect on the worker, check here.
+    bool applied = false;
+    bool bad_cpu_applied = true;
+    std::string name;
+    int cpu = -1;
+    std::thread([&]
+                {
+                    applied = apply_thread_role({"role-test-with-a-long-name", 0, 0});
+                    name = current_name();
+                    cpu = sched_getcpu();
+                    bad_cpu_applied = apply_thread_role({"bad-cpu", CPU_SETSIZE, 0});
+                })
+        .join();
+    REQUIRE(applied);
+    REQUIRE(name == "role-test-with-");
+    REQUIRE(cpu == 0);
+    REQUIRE_FALSE(bad_cpu_applied);
+}
+
+TEST_CASE("lazy_thread_role_applies_on_each_new_thread", "[threads]")
+{
+    LazyThreadRole role;
+    role.ensure(); // inactive role: leaves the test thread alone
+    const std::string main_name = current_name();
+
+    role.set({"lazy", 0, 0});
+    for (int i = 0; i < 2; ++i)
+    {
+        std::string first;
+        std::string second;
+        std::thread([&]
+                    {
+                        role.ensure();
+                        first = current_name();
+                        pthread_setname_np(pthread_self(), "renamed");
+                        role.ensure(); // already applied on this thread
+                        second = current_name();
+                    })
+            .join();
+        REQUIRE(first == "lazy");
+        REQUIRE(second == "renamed");
+    }
+    REQUIRE(current_name() == main_name);
+}
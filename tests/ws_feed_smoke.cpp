@@ -28,7 +28,8 @@ TEST_CASE("ws_feed_initial_data", "[smoke][network][ws]")
 
     REQUIRE(ok);
     auto tk = feed.latest_ticker(symbol);
-    auto ob = feed.latest_orderbook(symbol);
+    auto book = feed.latest_book(symbol);
     REQUIRE(tk.has_value());
-    REQUIRE(ob.has_value());
+    REQUIRE(book.has_value());
+    REQUIRE(book->valid());
 }
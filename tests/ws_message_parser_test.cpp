@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+#include "order_book.hpp"
+#include "ws_message_parser.hpp"
+
+namespace
+{
+    const std::string kBookSnapshot =
+        R"({"topic":"orderbook.50.BTCUSDT","type":"snapshot","ts":1672304484978,)"
+        R"("data":{"s":"BTCUSDT","b":[["16493.50","0.006"],["16493.00","0.100"]],)"
+        R"("a":[["16611.00","0.029"],["16612.00","0.213"]],"u":18521288,"seq":7961638724},"cts":1672304484976})";
+
+    std::vector<BookLevel> levels(std::string_view raw)
+    {
+        std::vector<BookLevel> out;
+        REQUIRE(for_each_level(raw, [&](Price px, Qty qty)
+                               { out.push_back(BookLevel{px, qty}); }));
+        return out;
+    }
+}
+
+TEST_CASE("ws_parser_extracts_orderbook_fields", "[ws_parser]")
+{
+    PublicMessage m;
+    REQUIRE(parse_public_message(kBookSnapshot, m));
+    REQUIRE(m.kind == PublicTopic::Orderbook);
+    REQUIRE(m.symbol == "BTCUSDT");
+    REQUIRE(m.is_snapshot);
+    REQUIRE(m.ts_ms == 1672304484978);
+    REQUIRE(m.update_id == 18521288);
+    REQUIRE(m.seq == 7961638724);
+
+    auto bids = levels(m.bids);
+    REQUIRE(bids.size() == 2);
+    REQUIRE(bids[0].price.str() == "16493.5");
+    REQUIRE(bids[1].qty.str() == "0.1");
+    auto asks = levels(m.asks);
+    REQUIRE(asks.size() == 2);
+    REQUIRE(asks[1].price.str() == "16612");
+}
+
+TEST_CASE("ws_parser_handles_delta_with_empty_side_and_whitespace", "[ws_parser]")
+{
+    const std::string msg = R"({ "topic" : "orderbook.1.ETHUSDT", "type" : "delta", "ts" : 5,
+        "data" : { "s" : "ETHUSDT", "b" : [ ], "a" : [ [ "1200.1" , "0" ] ], "u" : 7, "seq" : 9 } })";
+    PublicMessage m;
+    REQUIRE(parse_public_message(msg, m));
+    REQUIRE_FALSE(m.is_snapshot);
+    REQUIRE(m.symbol == "ETHUSDT");
+    REQUIRE(levels(m.bids).empty());
+    auto asks = levels(m.asks);
+    REQUIRE(asks.size() == 1);
+    REQUIRE(asks[0].qty.is_zero());
+}
+
+TEST_CASE("ws_parser_exposes_ticker_data_members", "[ws_parser]")
+{
+    const std::string msg = R"({"topic":"tickers.SUIUSDT","type":"delta","data":{"symbol":"SUIUSDT",)"
+                            R"("bid1Price":"1.2345","fundingRate":null,"nextFundingTime":"1700000000000"},"cs":1,"ts":42})";
+    PublicMessage m;
+    REQUIRE(parse_public_message(msg, m));
+    REQUIRE(m.kind == PublicTopic::Ticker);
+    REQUIRE(m.ts_ms == 42);
+
+    std::vector<std::string> keys;
+    std::string bid;
+    REQUIRE(for_each_member(m.data, [&](std::string_view key, std::string_view raw)
+                            {
+        keys.emplace_back(key);
+        if (key == "bid1Price")
+            bid = std::string(ws_scan::unquote(raw)); }));
+    REQUIRE(keys.size() == 4);
+    REQUIRE(bid == "1.2345");
+}
+
+TEST_CASE("ws_parser_ticker_merge_is_all_or_nothing", "[ws_parser]")
+{
+    TickerSnapshot t;
+    REQUIRE(merge_ticker_fields(R"({"lastPrice":"100.5","bid1Price":"100.0"})", 1, t));
+    REQUIRE(t.updates == 1);
+
+    // The second member is escaped, which the scanner leaves to the DOM parser.
+    REQUIRE_FALSE(merge_ticker_fields(R"({"lastPrice":"101.5","bid1Price":"1\"0"})", 2, t));
+    REQUIRE(t.last_price == 100.5);
+    REQUIRE(t.bid1_price == 100.0);
+    REQUIRE(t.ts_ms == 1);
+    REQUIRE(t.updates == 1);
+}
+
+TEST_CASE("ws_parser_rejects_what_it_does_not_know", "[ws_parser]")
+{
+    PublicMessage m;
+    // Subscription ack: no topic.
+    REQUIRE_FALSE(parse_public_message(R"({"success":true,"ret_msg":"","op":"subscribe","conn_id":"x"})", m));
+    // Unknown topic.
+    REQUIRE_FALSE(parse_public_message(R"({"topic":"kline.1.BTCUSDT","data":[]})", m));
+    // Escaped string: left to the DOM parser.
+    REQUIRE_FALSE(parse_public_message(R"({"topic":"tickers.BTC\"USDT","data":{}})", m));
+    // Truncated.
+    REQUIRE_FALSE(parse_public_message(kBookSnapshot.substr(0, kBookSnapshot.size() / 2), m));
+    // Orderbook without an update id.
+    REQUIRE_FALSE(parse_public_message(R"({"topic":"orderbook.1.BTCUSDT","data":{"b":[],"a":[]}})", m));
+    // Malformed level.
+    REQUIRE_FALSE(for_each_level(R"([["1.0"]])", [](Price, Qty) {}));
+}
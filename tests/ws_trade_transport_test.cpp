@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ixwebsocket/IXNetSystem.h>
+#include <ixwebsocket/IXWebSocketServer.h>
+#include <nlohmann/json.hpp>
+
+#include "trading_helper.hpp"
+#include "ws_trade_transport.hpp"
+
+namespace
+{
+    constexpr int kPort = 18931;
+
+    // Local stand-in for /v5/trade: accepts any auth, replays canned acks keyed by op, and can hold
+    // acks back to exercise out-of-order delivery and timeouts.
+    class MockTradeServer
+    {
+    public:
+        MockTradeServer() : server_(kPort, "127.0.0.1")
+        {
+            ix::initNetSystem();
+            server_.setOnClientMessageCallback([this](std::shared_ptr<ix::ConnectionState>, ix::WebSocket &ws, const ix::WebSocketMessagePtr &msg)
+                                               {
+                if (msg->type != ix::WebSocketMessageType::Message)
+                    return;
+                auto j = nlohmann::json::parse(msg->str);
+                const auto op = j.value("op", std::string{});
+                std::lock_guard<std::mutex> lk(mu_);
+                ops_.push_back(op);
+                if (op == "auth")
+                {
+                    ws.sendText(R"({"op":"auth","retCode":0,"retMsg":"OK","connId":"mock"})");
+                    return;
+                }
+                if (op == "order.cancel")
+                    return; // never acked
+                nlohmann::json ack{{"reqId", j["reqId"]}, {"retCode", 0}, {"retMsg", "OK"}, {"op", op}};
+                if (op == "order.create-batch")
+                {
+                    ack["data"] = {{"list", nlohmann::json::array()}};
+                    ack["retExtInfo"] = {{"list", nlohmann::json::array()}};
+                    int i = 0;
+                    for (const auto &item : j["args"][0]["request"])
+                    {
+                        ack["data"]["list"].push_back({{"orderId", "id" + std::to_string(i)}, {"orderLinkId", item["orderLinkId"]}});
+                        ack["retExtInfo"]["list"].push_back({{"code", i == 1 ? 10001 : 0}, {"msg", i == 1 ? "bad qty" : "OK"}});
+                        ++i;
+                    }
+                }
+                else
+                {
+                    ack["data"] = {{"orderId", "id-" + j["args"][0].value("orderLinkId", std::string{})},
+                                   {"orderLinkId", j["args"][0].value("orderLinkId", std::string{})}};
+                }
+                if (hold_next_)
+                {
+                    hold_next_ = false;
+                    held_ = ack.dump();
+                    return;
+                }
+                ws.sendText(ack.dump());
+                if (!held_.empty())
+                {
+                    ws.sendText(held_); // deliver the earlier ack after the later one
+                    held_.clear();
+                } });
+            auto res = server_.listen();
+            REQUIRE(res.first);
+            server_.start();
+        }
+
+        ~MockTradeServer() { server_.stop(); }
+
+        void hold_next_ack()
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            hold_next_ = true;
+        }
+
+        std::vector<std::string> ops()
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            return ops_;
+        }
+
+        void stop() { server_.stop(); }
+
+    private:
+        ix::WebSocketServer server_;
+        std::mutex mu_;
+        std::vector<std::string> ops_;
+        bool hold_next_{false};
+        std::string held_;
+    };
+
+    WsTradeTransport::Config mock_config()
+    {
+        WsTradeTransport::Config cfg;
+        cfg.url = "ws://127.0.0.1:" + std::to_string(kPort);
+        cfg.api_key = "key";
+        cfg.api_secret = "secret";
+        cfg.ack_timeout = std::chrono::milliseconds{300};
+        return cfg;
+    }
+
+    std::string create_args(const std::string &link)
+    {
+        return nlohmann::json{{"category", "linear"}, {"symbol", "BTCUSDT"}, {"side", "Buy"}, {"orderType", "Limit"},
+                              {"qty", "0.01"}, {"price", "100"}, {"orderLinkId", link}}
+            .dump();
+    }
+} // namespace
+
+TEST_CASE("ws_trade_authenticates_and_correlates_out_of_order_acks", "[trade_ws]")
+{
+    MockTradeServer server;
+    WsTradeTransport ws(mock_config());
+    REQUIRE(ws.start(std::chrono::milliseconds{3000}));
+    REQUIRE(ws.ready());
+
+    server.hold_next_ack();
+    auto first = std::async(std::launch::async, [&]
+                            { return ws.request("order.create", create_args("first")); });
+    // Make sure "first" reaches the server before "second".
+    while (server.ops().size() < 2)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    const auto second = nlohmann::json::parse(ws.request("order.create", create_args("second")));
+    const auto first_ack = nlohmann::json::parse(first.get());
+
+    REQUIRE(second["retCode"] == 0);
+    REQUIRE(second["result"]["orderLinkId"] == "second");
+    REQUIRE(first_ack["result"]["orderLinkId"] == "first");
+    REQUIRE(first_ack["result"]["orderId"] == "id-first");
+}
+
+TEST_CASE("ws_trade_times_out_missing_acks", "[trade_ws]")
+{
+    MockTradeServer server;
+    WsTradeTransport ws(mock_config());
+    REQUIRE(ws.start(std::chrono::milliseconds{3000}));
+    REQUIRE_THROWS_AS(ws.request("order.cancel", R"({"category":"linear","symbol":"BTCUSDT","orderLinkId":"x"})"),
+                      std::runtime_error);
+    REQUIRE(ws.timeouts() == 1);
+}
+
+TEST_CASE("trading_helper_routes_orders_over_trade_ws_with_rest_fallback", "[trade_ws]")
+{
+    MockTradeServer server;
+    // REST points at a closed port so any fallback is observable but harmless.
+    TradingHelper helper("key", "secret", "linear", "http://127.0.0.1:9");
+    auto ws = std::make_unique<WsTradeTransport>(mock_config());
+    REQUIRE(ws->start(std::chrono::milliseconds{3000}));
+    helper.set_trade_transport(std::move(ws));
+
+    const auto raw = helper.batch_submit_orders({{{"symbol", "BTCUSDT"}, {"side", "Buy"}, {"orderType", "Limit"}, {"qty", "0.01"}, {"price", "100"}, {"positionIdx", "1"}, {"orderLinkId", "a"}},
+                                                 {{"symbol", "BTCUSDT"}, {"side", "Sell"}, {"orderType", "Limit"}, {"qty", "0"}, {"price", "101"}, {"positionIdx", "2"}, {"orderLinkId", "b"}}});
+    const auto ok = TradingHelper::batch_item_results(raw, 2);
+    REQUIRE(ok[0]);
+    REQUIRE_FALSE(ok[1]);
+    OrderState st;
+    REQUIRE(helper.orders().state_of("a", st));
+    REQUIRE(st == OrderState::New);
+    REQUIRE(helper.orders().state_of("b", st));
+    REQUIRE(st == OrderState::Rejected);
+    REQUIRE(helper.trade_fallbacks() == 0);
+
+    // With the server gone the helper must not block on the socket; it goes to REST instead.
+    server.stop();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{3};
+    while (helper.trade_fallbacks() == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        try
+        {
+            helper.submit_limit_order("BTCUSDT", "Buy", "0.01", "100", 1, "Limit", "c");
+        }
+        catch (const std::exception &)
+        {
+            // REST to the closed port fails; only the routing decision matters here.
+        }
+    }
+    REQUIRE(helper.trade_fallbacks() >= 1);
+}